@@ -7,13 +7,109 @@ void* CompositeKey::getWritableKey() {
 }
 
 RTS CompositeKey::getKeyLength() const {
-    return this->keyLen + sizeof(int) + sizeof(RTS);
+    return this->keyLen + sizeof(int) + sizeof(RTS) + (isPostingList(this->rid) ? this->rid.slotNum : 0) +
+           this->payloadSize;
 }
 
 RID CompositeKey::getRID() const {
     return this->rid;
 }
 
+/**
+ * getView() - get a non owning view of the key.
+ *
+ * Return : view pointing into the key buffer, valid as long as the key is not modified.
+*/
+KeyView CompositeKey::getView() const {
+    KeyView view;
+    view.key = (const char*)this->key;
+    view.keyLen = this->keyLen;
+    view.rid = this->rid;
+    view.payloadSize = this->payloadSize;
+    return view;
+}
+
+/**
+ * assign() - copy a key view into the key, reusing the key buffer.
+ * @argument1 : type of the key.
+ * @argument2 : view of the key to copy.
+ *
+ * Return : void.
+*/
+void CompositeKey::assign(RTS type, const KeyView& view) {
+    this->keyType = type;
+    this->keyLen = view.keyLen;
+    this->rid = view.rid;
+    this->payloadSize = view.payloadSize;
+    reserve(getKeyLength());
+    memcpy((char*)this->key, view.key, view.getKeyLength());
+}
+
+/**
+ * assign() - copy a prefix compressed VarChar key into the key, restoring the prefix.
+ * @argument1 : type of the key.
+ * @argument2 : view of the key suffix.
+ * @argument3 : prefix shared by the keys of the leaf.
+ * @argument4 : length of the prefix.
+ *
+ * Return : void.
+*/
+void CompositeKey::assign(RTS type, const KeyView& view, const char* prefix, RTS prefixLen) {
+    int len = view.keyLen - sizeof(int) + prefixLen;
+    this->keyType = type;
+    this->keyLen = view.keyLen + prefixLen;
+    this->rid = view.rid;
+    this->payloadSize = view.payloadSize;
+    reserve(getKeyLength());
+    memcpy((char*)this->key, (char*)&len, sizeof(int));
+    memcpy((char*)this->key + sizeof(int), prefix, prefixLen);
+    memcpy((char*)this->key + sizeof(int) + prefixLen, view.key + sizeof(int), view.getKeyLength() - sizeof(int));
+}
+
+/**
+ * assignSeparator() - set the key to the shortest separator of two adjacent keys.
+ * @argument1 : type of the keys.
+ * @argument2 : largest key of the left node.
+ * @argument3 : smallest key of the right node.
+ *
+ * A VarChar separator is the shortest prefix of rightMin greater than leftMax, a proper prefix
+ * sorts before rightMin whatever its rid. Otherwise the separator is leftMax itself.
+ * Separators never carry the INCLUDE columns of the leaf entries.
+ *
+ * Return : void.
+*/
+void CompositeKey::assignSeparator(RTS type, const KeyView& leftMax, const KeyView& rightMin) {
+    if(getValueType(type) == TypeVarChar && compareKeyValues<TypeVarChar>(leftMax.key, rightMin.key) < 0) {
+        int len = getCommonPrefixLength(leftMax.key, rightMin.key) + 1;
+        if((int)(len + sizeof(int)) < rightMin.keyLen) {
+            this->keyType = type;
+            this->keyLen = len + sizeof(int);
+            this->rid.pageNum = 0;
+            this->rid.slotNum = 0;
+            this->payloadSize = 0;
+            reserve(getKeyLength() + sizeof(RTS));
+            memcpy((char*)this->key, (char*)&len, sizeof(int));
+            memcpy((char*)this->key + sizeof(int), rightMin.key + sizeof(int), len);
+            clearPayload();
+            return;
+        }
+    }
+    assign(type, leftMax);
+    clearPayload();
+}
+
+/**
+ * clearPayload() - drop the INCLUDE columns of the key, an index with INCLUDE columns keeps an empty payload.
+ *
+ * Return : void.
+*/
+void CompositeKey::clearPayload() {
+    if(!(this->keyType & INCLUDE_PAYLOAD)) return;
+    RTS size = 0;
+    this->payloadSize = sizeof(RTS);
+    memcpy((char*)this->key + this->keyLen + sizeof(int) + sizeof(RTS), (char*)&size, sizeof(RTS));
+}
+
 void CompositeKey::updateSlotNum(RTS slotNum) {
     this->rid.slotNum = slotNum;
     return;
@@ -24,6 +120,40 @@ void CompositeKey::updatePageNum(int pageNum) {
     return;
 }
 
+/**
+ * setPostingList() - replace the rid of the key with a posting list.
+ * @argument1 : posting list bytes, starting with the rid count.
+ *
+ * Return : void.
+*/
+void CompositeKey::setPostingList(const std::vector<char>& list) {
+    RTS size = this->keyLen + sizeof(int) + sizeof(RTS) + list.size();
+    if(this->keyCapacity < size) {
+        void* newKey = malloc(size);
+        memcpy((char*)newKey, (char*)this->key, this->keyLen);
+        free(this->key);
+        this->key = newKey;
+        this->keyCapacity = size;
+    }
+    this->rid.pageNum = POSTING_LIST;
+    this->rid.slotNum = list.size();
+    getWritableKey();
+    memcpy((char*)this->key + this->keyLen + sizeof(int) + sizeof(RTS), list.data(), list.size());
+}
+
+/**
+ * setMatchAnyRID() - set the rid to (INT_MAX, 0), which is equal to every rid of the key value.
+ *
+ * Separators of an index with posting lists carry it, so that a key value is always
+ * looked up in the one leaf holding its entry.
+ *
+ * Return : void.
+*/
+void CompositeKey::setMatchAnyRID() {
+    this->rid.pageNum = INT_MAX;
+    this->rid.slotNum = 0;
+}
+
 /**
  * getFreeSpace() - get free space in a node.
  *
@@ -95,7 +225,217 @@ bool Node::hasEnoughSpace(const RTS requiredSpace) const {
  * Return : true if underutilized, false otherwise.
 */
 bool Node::checkIfUnderUtilized() const {
-    return this->getFreeSpace() > this->getLastOffset();
+    return this->getFreeSpace() > this->getUsedSpace();
+}
+
+/**
+ * getUsedSpace() - get the space used by the entries and their key slots.
+ *
+ * Return : used space.
+*/
+RTS Node::getUsedSpace() const {
+    return this->getLastOffset() + this->getEntries()*sizeof(RTS);
+}
+
+/**
+ * getKeyDirectoryStart() - get the offset where the key slot directory begins.
+ *
+ * The key slots grow downwards from the node footer, slot i holds the offset
+ * of the i-th smallest key in the node.
+ *
+ * Return : offset of the node footer.
+*/
+RTS Node::getKeyDirectoryStart() const {
+    if(getNodeType() == LEAF) {
+        return PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int) - getPrefixLength();
+    }
+    return PAGE_SIZE - 4*sizeof(RTS) - sizeof(int);
+}
+
+/**
+ * getPrefixLength() - get the length of the prefix shared by all the keys of a leaf.
+ *
+ * A VarChar leaf stores the common prefix of its keys once, below the footer,
+ * and each key without it. Internal nodes and other key types have no prefix.
+ *
+ * Return : prefix length.
+*/
+RTS Node::getPrefixLength() const {
+    if(getNodeType() != LEAF) return 0;
+    RTS prefixLen = 0;
+    memcpy((char*)&prefixLen, (char*)(this->data) + PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int), sizeof(RTS));
+    return prefixLen;
+}
+
+/**
+ * getPrefix() - get the prefix shared by all the keys of a leaf.
+ *
+ * Return : pointer to the prefix bytes in the node.
+*/
+const char* Node::getPrefix() const {
+    return (const char*)(this->data) + PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int) - getPrefixLength();
+}
+
+/**
+ * compareKeyAt() - three way comparison of the key value at an offset with a given key value.
+ * @argument1 : type of the keys present in the node.
+ * @argument2 : offset of the key in the node.
+ * @argument3 : view of the key to compare with.
+ *
+ * Return : < 0, 0 or > 0 as the key in the node is smaller, equal or greater.
+*/
+int Node::compareKeyAt(const RTS indexType, const RTS offset, const KeyView& findKey) const {
+    const char* key = (const char*)(this->data) + offset;
+    RTS prefixLen = getPrefixLength();
+    if(prefixLen == 0) return compareKeyValues(indexType, key, findKey.key);
+
+    int findLen = 0, suffixLen = 0;
+    memcpy((char*)&findLen, findKey.key, sizeof(int));
+    memcpy((char*)&suffixLen, key, sizeof(int));
+    int retVal = memcmp(getPrefix(), findKey.key + sizeof(int), findLen < prefixLen ? findLen : prefixLen);
+    if(retVal != 0) return retVal;
+    if(findLen < prefixLen) return 1;
+
+    int restLen = findLen - prefixLen;
+    retVal = memcmp(key + sizeof(int), findKey.key + sizeof(int) + prefixLen, suffixLen < restLen ? suffixLen : restLen);
+    if(retVal != 0) return retVal;
+    return (suffixLen > restLen) - (suffixLen < restLen);
+}
+
+/**
+ * getKeySlotOffset() - get the offset of the key held in a key slot.
+ * @argument1 : slot number.
+ *
+ * Return : offset of the key.
+*/
+RTS Node::getKeySlotOffset(const RTS slot) const {
+    RTS offset = 0;
+    memcpy((char*)&offset, (char*)(this->data) + getKeyDirectoryStart() - (slot + 1)*sizeof(RTS), sizeof(RTS));
+    return offset;
+}
+
+/**
+ * setKeySlotOffset() - set the offset of the key held in a key slot.
+ * @argument1 : slot number.
+ * @argument2 : offset of the key.
+ *
+ * Return : void.
+*/
+void Node::setKeySlotOffset(const RTS slot, const RTS offset) {
+    memcpy((char*)(this->data) + getKeyDirectoryStart() - (slot + 1)*sizeof(RTS), (char*)&offset, sizeof(RTS));
+}
+
+/**
+ * findKeySlot() - binary search for the first key which is >= the given key.
+ * @argument1 : type of the keys present in the node.
+ * @argument2 : key to be searched.
+ *
+ * Return : slot of the key found, number of entries if all keys are smaller.
+*/
+RTS Node::findKeySlot(const RTS indexType, const CompositeKey& findKey) const {
+    return findKeySlot(indexType, findKey.getView());
+}
+
+/**
+ * findKeySlot() - binary search for the first key which is >= the given key.
+ * @argument1 : type of the keys present in the node.
+ * @argument2 : view of the key to be searched.
+ *
+ * Return : slot of the key found, number of entries if all keys are smaller.
+*/
+RTS Node::findKeySlot(const RTS indexType, const KeyView& findView) const {
+    if(getPrefixLength() > 0) {
+        if(findView.key == NULL) return 0;
+        RTS low = 0;
+        RTS high = getEntries();
+        while(low < high) {
+            RTS mid = low + (high - low)/2;
+            RTS offset = getKeySlotOffset(mid);
+            KeyView key(indexType, this->data, offset);
+            int valueCmp = compareKeyAt(indexType, offset, findView);
+            if(isKeyEqual(valueCmp, key.rid, findView.rid) || isKeyGreater(valueCmp, key.rid, findView.rid)) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    }
+    if(getValueType(indexType) == TypeInt) return findKeySlot<TypeInt>(findView);
+    if(getValueType(indexType) == TypeReal) return findKeySlot<TypeReal>(findView);
+    return findKeySlot<TypeVarChar>(findView);
+}
+
+/**
+ * findKeySlot<T>() - binary search for the first key which is >= the given key,
+ *                    comparing the keys in place in the node.
+ * @argument1 : view of the key to be searched.
+ *
+ * Return : slot of the key found, number of entries if all keys are smaller.
+*/
+template<AttrType T>
+RTS Node::findKeySlot(const KeyView& findKey) const {
+    RTS low = 0;
+    RTS high = getEntries();
+    while(low < high) {
+        RTS mid = low + (high - low)/2;
+        KeyView key(T, this->data, getKeySlotOffset(mid));
+        if(isKeyGreaterOrEqual<T>(key, findKey)) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+/**
+ * findSlotOfOffset() - binary search for the slot holding a key offset.
+ * @argument1 : offset of the key.
+ *
+ * Return : slot of the key.
+*/
+RTS Node::findSlotOfOffset(const RTS offset) const {
+    RTS low = 0;
+    RTS high = getEntries();
+    while(low < high) {
+        RTS mid = low + (high - low)/2;
+        if(getKeySlotOffset(mid) >= offset) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+/**
+ * insertKeySlot() - open a key slot, call before the entries are incremented.
+ * @argument1 : slot to open.
+ * @argument2 : offset of the new key.
+ * @argument3 : length by which the keys after the new key were moved.
+ *
+ * Return : void.
+*/
+void Node::insertKeySlot(const RTS slot, const RTS offset, const RT shift) {
+    for(RTS i = getEntries(); i > slot; i--) {
+        setKeySlotOffset(i, getKeySlotOffset(i - 1) + shift);
+    }
+    setKeySlotOffset(slot, offset);
+}
+
+/**
+ * removeKeySlot() - close a key slot, call before the entries are decremented.
+ * @argument1 : slot to close.
+ * @argument2 : length by which the keys after the removed key were moved.
+ *
+ * Return : void.
+*/
+void Node::removeKeySlot(const RTS slot, const RT shift) {
+    RTS numEntries = getEntries();
+    for(RTS i = slot; i + 1 < numEntries; i++) {
+        setKeySlotOffset(i, getKeySlotOffset(i + 1) + shift);
+    }
 }
 
 /**
@@ -107,8 +447,12 @@ bool Node::checkIfUnderUtilized() const {
  * Return : @argument3 passed as reference variable.
 */
 void Node::getKeyFromOffset(const RTS indexType, RTS offset, CompositeKey& key) const {
-    CompositeKey temp(indexType, this->data, offset);
-    key = temp;
+    RTS prefixLen = getPrefixLength();
+    if(prefixLen > 0) {
+        key.assign(indexType, KeyView(indexType, this->data, offset), getPrefix(), prefixLen);
+        return;
+    }
+    key.assign(indexType, KeyView(indexType, this->data, offset));
     return;
 }
 
@@ -209,6 +553,46 @@ void Node::insertKeyAtOffset(const RTS indexType, RTS offset, CompositeKey& key)
     return;
 }
 
+/**
+ * appendKey() - appends a key after the last entry of a node.
+ * @argument1 : type of the key.
+ * @argument2 : composite key to be appended.
+ *
+ * Return : void.
+*/
+void Node::appendKey(const RTS indexType, CompositeKey& key) {
+    this->appendKey(KeyView(indexType, key.getWritableKey()));
+}
+
+/**
+ * appendKey() - appends a key viewed in another buffer after the last entry of a node.
+ * @argument1 : view of the <key, rid> to be appended.
+ *
+ * Return : void.
+*/
+void Node::appendKey(const KeyView& key) {
+    RTS lastOffset = this->getLastOffset();
+    RTS numEntries = this->getEntries();
+    memcpy((char*)this->data + lastOffset, key.key, key.getKeyLength());
+    this->setKeySlotOffset(numEntries, lastOffset);
+    this->setLastOffset(lastOffset + key.getKeyLength());
+    this->setFreeSpace(this->getFreeSpace() - key.getKeyLength() - sizeof(RTS));
+    this->setEntries(numEntries + 1);
+}
+
+/**
+ * appendPointer() - appends a child pointer after the last entry of an internal node.
+ * @argument1 : page number of the child.
+ *
+ * Return : void.
+*/
+void Node::appendPointer(const int pointer) {
+    RTS lastOffset = this->getLastOffset();
+    memcpy((char*)this->data + lastOffset, (char*)&pointer, sizeof(int));
+    this->setLastOffset(lastOffset + sizeof(int));
+    this->setFreeSpace(this->getFreeSpace() - sizeof(int));
+}
+
 /**
  * splitNode() - splits a node into 2 nodes.
  * @argument1 : type of the key
@@ -226,14 +610,18 @@ RTS Node::splitNode(const RTS indexType, Node& newNode, CompositeKey& keyToPushU
 
     RTS splitOffset = this->getSplitOffset(indexType, totalSpace, leftEntries, keyToPushUp);
     RTS bytesToMove = recordOffset - splitOffset;
+    RTS slotBytes = (numEntries - leftEntries)*sizeof(RTS);
     this->moveDataToNode(newNode, bytesToMove, splitOffset, 0);
+    for(RTS i = leftEntries; i < numEntries; i++) {
+        newNode.setKeySlotOffset(i - leftEntries, this->getKeySlotOffset(i) - splitOffset);
+    }
 
-    this->setFreeSpace(freeSpace + bytesToMove);
+    this->setFreeSpace(freeSpace + bytesToMove + slotBytes);
     this->setEntries(leftEntries);
     this->setLastOffset(splitOffset);
 
     RTS newNodeFreeSpace = newNode.getFreeSpace();
-    newNode.setFreeSpace(newNodeFreeSpace - bytesToMove);
+    newNode.setFreeSpace(newNodeFreeSpace - bytesToMove - slotBytes);
     newNode.setEntries(numEntries - leftEntries);
     newNode.setLastOffset(bytesToMove);
 
@@ -248,6 +636,19 @@ RTS Node::splitNode(const RTS indexType, Node& newNode, CompositeKey& keyToPushU
  * Return : 0.
 */
 RTS Node::mergeNodes(const RTS indexType, Node& b) {
+    // prefix compressed leaves are rebuilt under the prefix common to both
+    if(this->getPrefixLength() > 0 || b.getPrefixLength() > 0) {
+        LeafNode leaf(this->data), leafB(b.data);
+        std::vector<char> buffer;
+        std::vector<unsigned> offsets;
+        leaf.decodeKeys(indexType, buffer, offsets);
+        leafB.decodeKeys(indexType, buffer, offsets);
+        leaf.buildFromKeys(indexType, buffer, offsets, 0, offsets.size());
+        b.setEntries(0);
+        b.setLastOffset(0);
+        return 0;
+    }
+
     RTS recordOffset = this->getLastOffset();
     RTS recordOffset_b = b.getLastOffset();
     RTS freeSpace = this->getFreeSpace();
@@ -256,8 +657,11 @@ RTS Node::mergeNodes(const RTS indexType, Node& b) {
 
     RTS bytesToMove = recordOffset_b;
     b.moveDataToNode(*this, bytesToMove, 0, recordOffset);
+    for(RTS i = 0; i < numEntries_b; i++) {
+        this->setKeySlotOffset(numEntries + i, b.getKeySlotOffset(i) + recordOffset);
+    }
 
-    this->setFreeSpace(freeSpace - recordOffset_b);
+    this->setFreeSpace(freeSpace - recordOffset_b - numEntries_b*sizeof(RTS));
     this->setEntries(numEntries + numEntries_b);
     this->setLastOffset(recordOffset + recordOffset_b);
 
@@ -279,23 +683,27 @@ RTS Node::mergeNodes(const RTS indexType, Node& b) {
 */
 int InternalNode::getNextNodePointer(const RTS indexType, const CompositeKey& newKey,
                                RTS& keyOffset, int& sibling, int& prevSibling) {
-    RTS dataOffset = sizeof(int);
     RTS numEntries = this->getEntries();
     int pageNum = 0;
-    for(int i = 0; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
-        if(key >= newKey) {
-        memcpy((char*)&pageNum, (char*)(this->data) + dataOffset - sizeof(int), sizeof(int));
-        memcpy((char*)&sibling, (char*)(this->data) + dataOffset + key.getKeyLength(), sizeof(int));
-        keyOffset = dataOffset;
+    if(numEntries == 0) {
+        memcpy((char*)&pageNum, (char*)(this->data), sizeof(int));
+        sibling = INT_MAX;
+        return pageNum;
+    }
+
+    RTS slot = findKeySlot(indexType, newKey);
+    if(slot < numEntries) {
+        keyOffset = getKeySlotOffset(slot);
+        // the pointer after a key ends where the next key starts
+        RTS siblingOffset = (slot + 1 < numEntries) ? getKeySlotOffset(slot + 1) : getLastOffset();
+        memcpy((char*)&pageNum, (char*)(this->data) + keyOffset - sizeof(int), sizeof(int));
+        memcpy((char*)&sibling, (char*)(this->data) + siblingOffset - sizeof(int), sizeof(int));
         return pageNum;
-        }
-        keyOffset = dataOffset;
-        dataOffset += key.getKeyLength() + sizeof(int);
     }
 
+    keyOffset = getKeySlotOffset(numEntries - 1);
     memcpy((char*)&prevSibling, (char*)(this->data) + keyOffset - sizeof(int), sizeof(int));
-    memcpy((char*)&pageNum, (char*)(this->data) + dataOffset - sizeof(int), sizeof(int));
+    memcpy((char*)&pageNum, (char*)(this->data) + getLastOffset() - sizeof(int), sizeof(int));
     sibling = INT_MAX;
     return pageNum;
 }
@@ -309,7 +717,7 @@ int InternalNode::getNextNodePointer(const RTS indexType, const CompositeKey& ne
 */
 void InternalNode::getAllPagePointers(const RTS indexType, vector<int>& children) {
     RTS numEntries = this->getEntries();
-    if(numEntries == 0) return;
+    if(this->getLastOffset() == 0) return;
 
     int pagePointer = 0;
     memcpy((char*)&pagePointer, (char*)this->data, sizeof(int));
@@ -317,7 +725,7 @@ void InternalNode::getAllPagePointers(const RTS indexType, vector<int>& children
     RTS dataOffset = sizeof(int);
 
     for(int i = 0; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
+        KeyView key(indexType, this->data, dataOffset);
         dataOffset += key.getKeyLength();
         memcpy((char*)&pagePointer, (char*)this->data + dataOffset, sizeof(int));
         children.push_back(pagePointer);
@@ -333,17 +741,12 @@ void InternalNode::getAllPagePointers(const RTS indexType, vector<int>& children
  * Return : offset at which to insert.
 */
 RTS InternalNode::getInsertOffset(const RTS indexType, const CompositeKey& newKey) {
-    RTS dataOffset = sizeof(int);
     RTS numEntries = this->getEntries();
-    if(numEntries == 0) return 0;
-    for(int i = 0; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
-        if(key >= newKey) {
-            return dataOffset;
-        }
-        dataOffset += key.getKeyLength() + sizeof(int);
-    }
-    return dataOffset;
+    // a new node has no pointer yet, a node of a single child gets the key after its pointer
+    if(numEntries == 0) return getLastOffset();
+    RTS slot = findKeySlot(indexType, newKey);
+    if(slot == numEntries) return getLastOffset();
+    return getKeySlotOffset(slot);
 }
 
 /**
@@ -361,10 +764,10 @@ RTS InternalNode::getSplitOffset(const RTS indexType, const RTS totalSpace,
     RTS numEntries = getEntries();
     RTS halfSpace = totalSpace/2;
     for(RTS i = 0; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
+        KeyView key(indexType, this->data, dataOffset);
         dataOffset += key.getKeyLength() + sizeof(int);
         if(dataOffset >= halfSpace) {
-            keyToPushUp = key;
+            keyToPushUp.assign(indexType, key);
             leftEntries = i+1;
             return dataOffset - sizeof(int);
         }
@@ -383,6 +786,7 @@ RTS InternalNode::getSplitOffset(const RTS indexType, const RTS totalSpace,
 */
 RTS InternalNode::insertEntryInNode(const RTS indexType, CompositeKey& newKey,
                                     int p2 = INT_MAX, int p1 = INT_MAX) {
+    RTS slot = (this->getEntries() == 0) ? 0 : findKeySlot(indexType, newKey);
     RTS offset = getInsertOffset(indexType, newKey);
     int keyLen = newKey.getKeyLength();
     // if its the first record in the internal node then we need space for 2 pointers and a key.
@@ -392,14 +796,16 @@ RTS InternalNode::insertEntryInNode(const RTS indexType, CompositeKey& newKey,
     memcpy((char*)data + offset, (char*)&p1, sizeof(int));
     memcpy((char*)data + offset + sizeof(int), (char*)(newKey.getWritableKey()), keyLen - 2*sizeof(int));
     memcpy((char*)data + offset + sizeof(int) + newKey.getKeyLength(), (char*)&p2, sizeof(int));
+    insertKeySlot(slot, offset + sizeof(int), keyLen);
     } else {
         keyLen += sizeof(int);
         moveKeysByOffset(offset, keyLen);
         memcpy((char*)data + offset, (char*)(newKey.getWritableKey()), keyLen - sizeof(int));
         memcpy((char*)data + offset + keyLen - sizeof(int), (char*)&p2, sizeof(int));
+        insertKeySlot(slot, offset, keyLen);
     }
 
-    RTS newFreeSpace = this->getFreeSpace() - keyLen;
+    RTS newFreeSpace = this->getFreeSpace() - keyLen - sizeof(RTS);
     RTS newEntries = this->getEntries() + 1;
     RTS lastOffset = this->getLastOffset() + keyLen;
     this->setFreeSpace(newFreeSpace);
@@ -416,26 +822,28 @@ RTS InternalNode::insertEntryInNode(const RTS indexType, CompositeKey& newKey,
  * Return : 0 on success.
 */
 int InternalNode::removeKey(const RTS indexType, const RTS keyOffset) {
-    CompositeKey toBeRemoved(indexType, this->data, keyOffset);
+    KeyView toBeRemoved(indexType, this->data, keyOffset);
     RTS numEntries = this->getEntries();
     RTS freeSpace = this->getFreeSpace();
     RTS lastOffset = this->getLastOffset();
 
     if (numEntries == 0) return -1;
-    /* when there is o nly on entry in the internal ode, do not remove the entry, instead make the second pointer as NULL */
+    /* The last key goes with the pointer after it, the node keeps the pointer before it at offset 0
+     * like a node of a single child, the pointer is returned for a root to be replaced by it */
     if (numEntries == 1) {
         int newRoot = INT_MAX;
         memcpy((char *) &newRoot, (char *) (this->data) + keyOffset - sizeof(int), sizeof(int));
-        this->setFreeSpace(freeSpace + 2 * sizeof(int) + toBeRemoved.getKeyLength());
+        memcpy((char *) (this->data), (char *) &newRoot, sizeof(int));
+        this->setFreeSpace(freeSpace + sizeof(int) + toBeRemoved.getKeyLength() + sizeof(RTS));
         this->setEntries(0);
-        this->setLastOffset(0);
-        /* Return newRoot to mark as first entry, if this page was root, then the root need to be updated*/
+        this->setLastOffset(sizeof(int));
         return newRoot;
     }
     this->moveKeysByOffset(keyOffset + toBeRemoved.getKeyLength() + sizeof(int),
                            -(toBeRemoved.getKeyLength() + sizeof(int)));
+    this->removeKeySlot(findSlotOfOffset(keyOffset), -(toBeRemoved.getKeyLength() + sizeof(int)));
     this->setEntries(numEntries - 1);
-    this->setFreeSpace(freeSpace + toBeRemoved.getKeyLength() + sizeof(int));
+    this->setFreeSpace(freeSpace + toBeRemoved.getKeyLength() + sizeof(int) + sizeof(RTS));
     this->setLastOffset(lastOffset - toBeRemoved.getKeyLength() - sizeof(int));
     return -1;
 }
@@ -494,20 +902,15 @@ void LeafNode::setSibling(const int sibling) {
             while returning the last entry in node.
 */
 RC LeafNode::getNextKey(const RTS indexType, const CompositeKey& lowKey, CompositeKey& newKey) {
-    RTS dataOffset = 0;
     RTS numEntries = this->getEntries();
     if(numEntries == 0) return PREV_MERGE;
 
-    for(int i = 0 ; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
-        if(key >= lowKey) {
-            newKey = key;
-            if(i == numEntries - 1) return LAST_ENTRY;
-            return 0;
-        }
-        dataOffset += key.getKeyLength();
-    }
-    return PAGE_SCANNED;
+    RTS slot = findKeySlot(indexType, lowKey);
+    if(slot == numEntries) return PAGE_SCANNED;
+
+    getKeyFromOffset(indexType, getKeySlotOffset(slot), newKey);
+    if(slot == numEntries - 1) return LAST_ENTRY;
+    return 0;
 }
 
 /**
@@ -518,16 +921,9 @@ RC LeafNode::getNextKey(const RTS indexType, const CompositeKey& lowKey, Composi
  * Return : 0 on success, -1 otherwise.
 */
 RTS LeafNode::getInsertOffset(RTS indexType, const CompositeKey& newKey) {
-    RTS dataOffset = 0;
-    RTS numEntries = this->getEntries();
-    for(int i = 0; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
-        if(key >= newKey) {
-            return dataOffset;
-        }
-        dataOffset += key.getKeyLength();
-    }
-    return dataOffset;
+    RTS slot = findKeySlot(indexType, newKey);
+    if(slot == this->getEntries()) return getLastOffset();
+    return getKeySlotOffset(slot);
 }
 
 /**
@@ -545,10 +941,10 @@ RTS LeafNode::getSplitOffset(const RTS indexType, const RTS totalSpace,
     RTS numEntries = getEntries();
     RTS halfSpace = totalSpace/2;
     for(RTS i = 0; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
+        KeyView key(indexType, this->data, dataOffset);
         dataOffset += key.getKeyLength();
         if(dataOffset >= halfSpace) {
-            keyToPushUp = key;
+            getKeyFromOffset(indexType, dataOffset - key.getKeyLength(), keyToPushUp);
             leftEntries = i+1;
             return dataOffset;
         }
@@ -566,14 +962,41 @@ RTS LeafNode::getSplitOffset(const RTS indexType, const RTS totalSpace,
  * Return : 0 on success, -1 otherwise.
 */
 RTS LeafNode::insertEntryInNode(const RTS indexType, CompositeKey& newKey, int p2 = INT_MAX, int p1 = INT_MAX) {
-    RTS offset = getInsertOffset(indexType, newKey);
-    moveKeysByOffset(offset, newKey.getKeyLength());
+    RTS slot = findKeySlot(indexType, newKey);
+    RTS prefixLen = this->getPrefixLength();
+    const char* newKeyData = (const char*)newKey.getWritableKey();
+
+    // the key does not share the prefix, rebuild the leaf under a shorter one
+    if(prefixLen > 0) {
+        int newLen = 0;
+        memcpy((char*)&newLen, newKeyData, sizeof(int));
+        if(getCommonPrefixLength(newKeyData + sizeof(int), newLen, getPrefix(), prefixLen) < prefixLen) {
+            std::vector<char> buffer;
+            std::vector<unsigned> offsets;
+            decodeKeys(indexType, buffer, offsets);
+            offsets.insert(offsets.begin() + slot, buffer.size());
+            buffer.insert(buffer.end(), newKeyData, newKeyData + newKey.getKeyLength());
+            buildFromKeys(indexType, buffer, offsets, 0, offsets.size());
+            return 0;
+        }
+    }
+
+    RTS keyLen = newKey.getKeyLength() - prefixLen;
+    RTS offset = (slot == this->getEntries()) ? getLastOffset() : getKeySlotOffset(slot);
+    moveKeysByOffset(offset, keyLen);
 
-    memcpy((char*)data + offset, (char*)(newKey.getWritableKey()), newKey.getKeyLength());
+    if(prefixLen > 0) {
+        int suffixLen = newKey.getView().keyLen - sizeof(int) - prefixLen;
+        memcpy((char*)data + offset, (char*)&suffixLen, sizeof(int));
+        memcpy((char*)data + offset + sizeof(int), newKeyData + sizeof(int) + prefixLen, keyLen - sizeof(int));
+    } else {
+        memcpy((char*)data + offset, newKeyData, keyLen);
+    }
+    insertKeySlot(slot, offset, keyLen);
 
-    RTS newFreeSpace = this->getFreeSpace() - newKey.getKeyLength();
+    RTS newFreeSpace = this->getFreeSpace() - keyLen - sizeof(RTS);
     RTS newEntries = this->getEntries() + 1;
-    RTS lastOffset = this->getLastOffset() + newKey.getKeyLength();
+    RTS lastOffset = this->getLastOffset() + keyLen;
     this->setFreeSpace(newFreeSpace);
     this->setEntries(newEntries);
     this->setLastOffset(lastOffset);
@@ -588,14 +1011,13 @@ RTS LeafNode::insertEntryInNode(const RTS indexType, CompositeKey& newKey, int p
  * Return : offset at which the key is present, -1 if not present.
 */
 RT LeafNode::findKeyOffset(const RTS indexType, const CompositeKey& findKey) {
-    int dataOffset = 0;
-    RTS numEntries = this->getEntries();
-    for(RTS i = 0 ; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
-        if(findKey == key) {
-            return dataOffset;
-        }
-        dataOffset += key.getKeyLength();
+    RTS slot = findKeySlot(indexType, findKey);
+    if(slot == this->getEntries()) return -1;
+
+    RTS keyOffset = getKeySlotOffset(slot);
+    KeyView key(indexType, this->data, keyOffset);
+    if(isKeyEqual(compareKeyAt(indexType, keyOffset, findKey.getView()), key.rid, findKey.getRID())) {
+        return keyOffset;
     }
     return -1;
 }
@@ -608,7 +1030,7 @@ RT LeafNode::findKeyOffset(const RTS indexType, const CompositeKey& findKey) {
  * Return : 0 on success.
 */
 int LeafNode::removeKey(const RTS indexType, const RTS keyOffset) {
-    CompositeKey toBeRemoved(indexType, this->data, keyOffset);
+    KeyView toBeRemoved(indexType, this->data, keyOffset);
     RTS numEntries = this->getEntries();
     RTS freeSpace = this->getFreeSpace();
     RTS lastOffset = this->getLastOffset();
@@ -617,7 +1039,7 @@ int LeafNode::removeKey(const RTS indexType, const RTS keyOffset) {
     /* when there is o nly on entry in the internal ode, do not remove the entry, instead make the second pointer as NULL */
     if(numEntries == 1) {
         int newRoot = INT_MAX;
-        this->setFreeSpace(freeSpace + toBeRemoved.getKeyLength());
+        this->setFreeSpace(freeSpace + toBeRemoved.getKeyLength() + sizeof(RTS));
         this->setEntries(0);
         this->setLastOffset(0);
         /* Return newRoot to mark as first entry, if this page was root, then the root need to be updated*/
@@ -625,8 +1047,9 @@ int LeafNode::removeKey(const RTS indexType, const RTS keyOffset) {
     }
 
     this->moveKeysByOffset(keyOffset + toBeRemoved.getKeyLength(), -(toBeRemoved.getKeyLength()));
+    this->removeKeySlot(findSlotOfOffset(keyOffset), -(toBeRemoved.getKeyLength()));
     this->setEntries(numEntries - 1);
-    this->setFreeSpace(freeSpace + toBeRemoved.getKeyLength());
+    this->setFreeSpace(freeSpace + toBeRemoved.getKeyLength() + sizeof(RTS));
     this->setLastOffset(lastOffset - toBeRemoved.getKeyLength());
     return -1;
 }
@@ -643,1057 +1066,3770 @@ void LeafNode::printKeys(const RTS indexType) {
     if (numEntries == 0) return;
     cout << "[";
     for (int i = 0; i < numEntries; i++) {
-        CompositeKey key(indexType, this->data, dataOffset);
+        CompositeKey key;
+        getKeyFromOffset(indexType, dataOffset, key);
         std::cout << key;
         if (i < numEntries - 1) {
             std::cout << ",";
         }
-        dataOffset += key.getKeyLength();
+        dataOffset += KeyView(indexType, this->data, dataOffset).getKeyLength();
     }
     cout << "]";
 }
 
-//IX manager singleton
-IndexManager &IndexManager::instance() {
-    static IndexManager _index_manager = IndexManager();
-    return _index_manager;
+/**
+ * decodeKeys() - copy the keys of a leaf with their prefix restored.
+ * @argument1 : type of the keys present in the node.
+ * @argument2 : buffer to which the <key, rid> entries are appended.
+ * @argument3 : offsets of the appended entries in the buffer (out parameter).
+ *
+ * Return : void.
+*/
+void LeafNode::decodeKeys(const RTS indexType, std::vector<char>& buffer, std::vector<unsigned>& offsets) const {
+    RTS numEntries = this->getEntries();
+    RTS prefixLen = this->getPrefixLength();
+    for(RTS i = 0; i < numEntries; i++) {
+        KeyView key(indexType, this->data, getKeySlotOffset(i));
+        unsigned offset = buffer.size();
+        offsets.push_back(offset);
+        buffer.resize(offset + key.getKeyLength() + prefixLen);
+        if(prefixLen > 0) {
+            int len = key.keyLen - sizeof(int) + prefixLen;
+            memcpy(&buffer[offset], (char*)&len, sizeof(int));
+            memcpy(&buffer[offset + sizeof(int)], getPrefix(), prefixLen);
+            memcpy(&buffer[offset + sizeof(int) + prefixLen], key.key + sizeof(int), key.getKeyLength() - sizeof(int));
+        } else {
+            memcpy(&buffer[offset], key.key, key.getKeyLength());
+        }
+    }
 }
 
 /**
- * createFile() - create an index file.
- * @argument1 : name of the file.
+ * buildFromKeys() - rewrite a leaf with a range of sorted keys, VarChar keys are stored
+ *                   without the prefix common to the first and the last key.
+ * @argument1 : type of the keys.
+ * @argument2 : buffer holding the <key, rid> entries.
+ * @argument3 : offsets of the entries in the buffer, in key order.
+ * @argument4 : first entry of the range.
+ * @argument5 : entry after the last one of the range.
  *
- * Return : 0 on success, -1 on fail.
+ * The page number and the sibling of the leaf are kept.
+ *
+ * Return : void.
 */
-RC IndexManager::createFile(const std::string &fileName) {
-    return PagedFileManager::instance().createFile(fileName);
+void LeafNode::buildFromKeys(const RTS indexType, const std::vector<char>& buffer,
+                             const std::vector<unsigned>& offsets, unsigned first, unsigned last) {
+    RTS prefixLen = 0;
+    if(getValueType(indexType) == TypeVarChar && last > first) {
+        prefixLen = getCommonPrefixLength(&buffer[offsets[first]], &buffer[offsets[last - 1]]);
+    }
+    RTS footerStart = PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int);
+    if(prefixLen > 0) {
+        memcpy((char*)data + footerStart - prefixLen, &buffer[offsets[first]] + sizeof(int), prefixLen);
+    }
+    memcpy((char*)data + footerStart, (char*)&prefixLen, sizeof(RTS));
+    this->setEntries(0);
+    this->setLastOffset(0);
+    this->setFreeSpace(footerStart - prefixLen);
+
+    for(unsigned i = first; i < last; i++) {
+        KeyView key(indexType, &buffer[offsets[i]]);
+        if(prefixLen == 0) {
+            this->appendKey(key);
+            continue;
+        }
+        RTS lastOffset = this->getLastOffset();
+        RTS numEntries = this->getEntries();
+        RTS keyLen = key.getKeyLength() - prefixLen;
+        int suffixLen = key.keyLen - sizeof(int) - prefixLen;
+        memcpy((char*)data + lastOffset, (char*)&suffixLen, sizeof(int));
+        memcpy((char*)data + lastOffset + sizeof(int), key.key + sizeof(int) + prefixLen, keyLen - sizeof(int));
+        this->setKeySlotOffset(numEntries, lastOffset);
+        this->setLastOffset(lastOffset + keyLen);
+        this->setFreeSpace(this->getFreeSpace() - keyLen - sizeof(RTS));
+        this->setEntries(numEntries + 1);
+    }
 }
 
 /**
- * destroyFile() - delete an index file.
- * @argument1 : name of the file.
+ * getRequiredSpace() - get the space taken by inserting a key into a leaf.
+ * @argument1 : type of the keys present in the node.
+ * @argument2 : key to be inserted.
  *
- * Return : 0 on success, -1 on fail.
+ * A key sharing the prefix is stored without it, any other key shortens the prefix
+ * and the bytes dropped from the prefix are stored in every key.
+ *
+ * Return : required space.
 */
-RC IndexManager::destroyFile(const std::string &fileName) {
-    return PagedFileManager::instance().destroyFile(fileName);
+RTS LeafNode::getRequiredSpace(const RTS indexType, const CompositeKey& newKey) const {
+    int prefixLen = this->getPrefixLength();
+    if(prefixLen == 0) return newKey.getKeyLength() + sizeof(RTS);
+
+    KeyView key = newKey.getView();
+    int newLen = 0;
+    memcpy((char*)&newLen, key.key, sizeof(int));
+    int common = getCommonPrefixLength(key.key + sizeof(int), newLen, getPrefix(), prefixLen);
+    if(common == prefixLen) return newKey.getKeyLength() - prefixLen + sizeof(RTS);
+
+    int required = newKey.getKeyLength() - common + sizeof(RTS) + ((int)this->getEntries() - 1)*(prefixLen - common);
+    return required > 0 ? required : 0;
 }
 
 /**
- * openFile() - open an index file.
- * @argument1 : name of the file.
- * @argument2 : ixfilehandle (out parameter).
+ * canMerge() - check if the keys of two leaves fit in one leaf.
+ * @argument1 : the other leaf.
  *
- * Return : 0 on success, -1 on fail.
+ * Return : true if the leaves can be merged, false otherwise.
 */
-RC IndexManager::openFile(const std::string &fileName, IXFileHandle &ixFileHandle) {
-    return PagedFileManager::instance().openFile(fileName, ixFileHandle);
+bool LeafNode::canMerge(const Node& b) const {
+    int capacity = PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int);
+    int prefixLen = this->getPrefixLength(), prefixLen_b = b.getPrefixLength();
+    int numEntries = this->getEntries(), numEntries_b = b.getEntries();
+
+    // the merged prefix is atmost the part common to both prefixes
+    int mergedPrefixLen = 0;
+    if(numEntries == 0) {
+        mergedPrefixLen = numEntries_b == 0 ? 0 : prefixLen_b;
+    } else if(numEntries_b == 0) {
+        mergedPrefixLen = prefixLen;
+    } else {
+        mergedPrefixLen = getCommonPrefixLength(getPrefix(), prefixLen, b.getPrefix(), prefixLen_b);
+    }
+    int mergedSpace = this->getUsedSpace() + numEntries*(prefixLen - mergedPrefixLen) +
+                      b.getUsedSpace() + numEntries_b*(prefixLen_b - mergedPrefixLen) + mergedPrefixLen;
+    return mergedSpace <= capacity;
 }
 
 /**
- * openFile() - close an index file.
- * @argument1 : ixfilehandle having the file details.
+ * splitLeaf() - split a full leaf and insert a new key into one of the halves.
+ * @argument1 : type of the keys present in the node.
+ * @argument2 : new empty leaf which gets the upper half.
+ * @argument3 : key to be inserted.
+ * @argument4 : separator of the two leaves to be pushed up (out parameter).
  *
- * Return : 0 on success, -1 on fail.
+ * @argument5 : the new key goes after the last key of the last leaf.
+ *
+ * The keys are split where the two halves, each compressed under its own prefix,
+ * take the closest space, or with an append split where the lower half takes nine
+ * tenth of the space. The separator is suffix truncated.
+ *
+ * Return : 0 on success, -1 if the keys do not fit in two leaves.
 */
-RC IndexManager::closeFile(IXFileHandle &ixFileHandle) {
-    return PagedFileManager::instance().closeFile(ixFileHandle);
+RC LeafNode::splitLeaf(const RTS indexType, LeafNode& newNode, CompositeKey& entry, CompositeKey& keyToPushUp,
+                       const bool appendSplit) {
+    std::vector<char> buffer;
+    std::vector<unsigned> offsets;
+    decodeKeys(indexType, buffer, offsets);
+    const char* entryData = (const char*)entry.getWritableKey();
+    offsets.insert(offsets.begin() + findKeySlot(indexType, entry), buffer.size());
+    buffer.insert(buffer.end(), entryData, entryData + entry.getKeyLength());
+
+    unsigned numKeys = offsets.size();
+    std::vector<int> keySpace(numKeys + 1, 0);
+    for(unsigned i = 0; i < numKeys; i++) {
+        keySpace[i + 1] = keySpace[i] + KeyView(indexType, &buffer[offsets[i]]).getKeyLength() + sizeof(RTS);
+    }
+    // space of the keys [first, last) stored under their common prefix
+    auto getRangeSpace = [&](unsigned first, unsigned last) {
+        int prefixLen = 0;
+        if(getValueType(indexType) == TypeVarChar) {
+            prefixLen = getCommonPrefixLength(&buffer[offsets[first]], &buffer[offsets[last - 1]]);
+        }
+        return keySpace[last] - keySpace[first] - (int)(last - first - 1)*prefixLen;
+    };
+
+    int capacity = PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int);
+    unsigned splitKey = 0;
+    int minDiff = INT_MAX;
+    for(unsigned i = 1; i < numKeys; i++) {
+        int leftSpace = getRangeSpace(0, i);
+        int rightSpace = getRangeSpace(i, numKeys);
+        if(leftSpace > capacity || rightSpace > capacity) continue;
+        if(appendSplit) rightSpace *= 9;
+        int diff = leftSpace > rightSpace ? leftSpace - rightSpace : rightSpace - leftSpace;
+        if(diff < minDiff) {
+            minDiff = diff;
+            splitKey = i;
+        }
+    }
+    if(splitKey == 0) return -1;
+
+    this->buildFromKeys(indexType, buffer, offsets, 0, splitKey);
+    newNode.buildFromKeys(indexType, buffer, offsets, splitKey, numKeys);
+    keyToPushUp.assignSeparator(indexType, KeyView(indexType, &buffer[offsets[splitKey - 1]]),
+                                KeyView(indexType, &buffer[offsets[splitKey]]));
+    return 0;
 }
 
 /**
- * insertEntry() - insert an entry into B tree.
- * @argument1 : ixfilehandle having the Btree details.
- * @argument2 : attribute on which the Btree exists.
- * @argument3 : key to be inserted.
- * @argument4 : rid associated with key.
+ * findValueOffset() - find the entry of a key value whatever its rid, with posting lists
+ *                     a key value has atmost one entry.
+ * @argument1 : type of the keys present in the node.
+ * @argument2 : view of the key to be searched.
  *
- * Return : 0 on success, -1 on fail.
+ * Return : offset of the entry, -1 if the key value is not present.
 */
-RC IndexManager::insertEntry(IXFileHandle &ixFileHandle, const Attribute &attribute,
-                             const void *key, const RID &rid) {
-    int root = ixFileHandle.getRoot();
-    // Root or pages in the index file, create one leaf node and make it the root
-    void* data = malloc(PAGE_SIZE);
-    CompositeKey entry(attribute.type, key, rid);
-    int newChildEntry = INT_MAX;
+RT LeafNode::findValueOffset(const RTS indexType, const KeyView& findKey) const {
+    KeyView matchAny = findKey;
+    matchAny.rid.pageNum = INT_MAX;
+    matchAny.rid.slotNum = 0;
+    RTS slot = findKeySlot(indexType, matchAny);
+    if(slot == this->getEntries()) return -1;
+
+    RTS keyOffset = getKeySlotOffset(slot);
+    if(compareKeyAt(indexType, keyOffset, findKey) != 0) return -1;
+    return keyOffset;
+}
 
-    if(root == INT_MAX) {
-        ixFileHandle.initPageDirectory(data, LEAF);
-        ixFileHandle.appendPage(data);
-        ixFileHandle.setRoot(ixFileHandle.getNumberOfPages()-1);
-    } else {
-        ixFileHandle.readPage(root, data);
+/*********************Posting list helpers *********************************/
+
+/**
+ * encodeRID() - append a rid as varints, the page number as a delta from the previous
+ *               rid and the slot number as a delta when the page is the same.
+ * @argument1 : rid to encode.
+ * @argument2 : previous rid, (0, 0) for the first one.
+ * @argument3 : buffer to append to.
+ *
+ * Return : void.
+*/
+static void encodeRID(const RID& rid, const RID& prev, std::vector<char>& buffer) {
+    unsigned values[2];
+    values[0] = rid.pageNum - prev.pageNum;
+    values[1] = values[0] == 0 ? rid.slotNum - prev.slotNum : rid.slotNum;
+    for(int j = 0; j < 2; j++) {
+        unsigned value = values[j];
+        while(value >= 0x80) {
+            buffer.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((char)value);
     }
+}
 
+/**
+ * encodeRIDs() - append sorted rids as varints.
+ * @argument1 : sorted rids.
+ * @argument2 : buffer to append to.
+ *
+ * Return : void.
+*/
+static void encodeRIDs(const std::vector<RID>& rids, std::vector<char>& buffer) {
+    RID prev;
+    prev.pageNum = 0;
+    prev.slotNum = 0;
+    for(unsigned i = 0; i < rids.size(); i++) {
+        encodeRID(rids[i], prev, buffer);
+        prev = rids[i];
+    }
+}
 
-    CompositeKey keyToPushUp;
-    RTS indexType = attribute.type;
-    if(ixFileHandle.getNodeType(data) == LEAF) {
-        LeafNode leafNode(data);
-        insertEntryRecursively(ixFileHandle, indexType, leafNode, entry, 
-                               newChildEntry, keyToPushUp);
-    } else {
-        InternalNode internalNode(data);
-        insertEntryRecursively(ixFileHandle, indexType, internalNode, entry, 
-                               newChildEntry, keyToPushUp);
+/**
+ * decodeRIDs() - decode rids written by encodeRIDs().
+ * @argument1 : encoded bytes.
+ * @argument2 : number of rids.
+ * @argument3 : rids are appended to it (out parameter).
+ *
+ * Return : void.
+*/
+static void decodeRIDs(const char* data, unsigned count, std::vector<RID>& rids) {
+    RID prev;
+    prev.pageNum = 0;
+    prev.slotNum = 0;
+    for(unsigned i = 0; i < count; i++) {
+        unsigned values[2];
+        for(int j = 0; j < 2; j++) {
+            unsigned value = 0;
+            int shift = 0;
+            unsigned char byte = 0;
+            do {
+                byte = (unsigned char)*data++;
+                value |= (unsigned)(byte & 0x7f) << shift;
+                shift += 7;
+            } while(byte & 0x80);
+            values[j] = value;
+        }
+        RID rid;
+        rid.pageNum = prev.pageNum + values[0];
+        rid.slotNum = values[0] == 0 ? prev.slotNum + values[1] : values[1];
+        rids.push_back(rid);
+        prev = rid;
     }
+}
 
-    free(data);
-    return 0;
+/**
+ * findRID() - binary search for the first rid which is >= a given rid.
+ * @argument1 : sorted rids.
+ * @argument2 : rid to be searched.
+ *
+ * Return : iterator to the rid found.
+*/
+static std::vector<RID>::iterator findRID(std::vector<RID>& rids, const RID& rid) {
+    return std::lower_bound(rids.begin(), rids.end(), rid, [](const RID& a, const RID& b) { return b > a; });
 }
 
 /**
- * insertEntryRecursively() -  helper function to insert an entry into B tree.
- * @argument1 : ixfilehandle having the Btree details.
- * @argument2 : type of the keys present in the node.
- * @argument2 : node in which currently looking to insert.
- * @argument3 : composite key to be inserted.
- * @argument4 : flag to detect if reorganization needs to take place.
- * @argument5 : composite key to be pushed up to upper level if split happened.
+ * getCount() - get the number of rids in a posting page.
  *
- * Return : 0 on success, -1 on fail.
+ * Return : number of rids.
 */
-RC IndexManager::insertEntryRecursively(IXFileHandle& ixFileHandle, const RTS indexType, 
-                                        Node& node, CompositeKey& entry, int& newChildEntry, 
-                                        CompositeKey& keyToPushUp) {
-    if(node.getNodeType() == INTERNAL) {
-        RTS nextKeyOffset;
-        int dummySibling, dummyPrevSibling;
-        int nextPointer = node.getNextNodePointer(indexType, entry, nextKeyOffset, 
-                                                  dummySibling, dummyPrevSibling);
-        void* data = malloc(PAGE_SIZE);
-        ixFileHandle.readPage(nextPointer, data);
-        if(ixFileHandle.getNodeType(data) == LEAF) {
-            LeafNode leafNode(data);
-            insertEntryRecursively(ixFileHandle, indexType, leafNode, entry, 
-                                   newChildEntry, keyToPushUp);
-        } else {
-            InternalNode internalNode(data);
-            insertEntryRecursively(ixFileHandle, indexType, internalNode, entry, 
-                                   newChildEntry, keyToPushUp);
-        }
+RTS PostingPage::getCount() const {
+    RTS count = 0;
+    memcpy((char*)&count, (char*)(this->data) + PAGE_SIZE - 2*sizeof(RTS), sizeof(RTS));
+    return count;
+}
 
-        // No splits happened
-        if(newChildEntry == INT_MAX) {
-            free(data);
-            return 0;
-        }
-        
-        if(node.hasEnoughSpace(keyToPushUp.getKeyLength() + sizeof(int))) {
-            node.insertEntryInNode(indexType, keyToPushUp, newChildEntry);
-            ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-            newChildEntry = INT_MAX;
-            free(data);
-            return 0;
-        } else {
-            void* dataNew = malloc(PAGE_SIZE);
-            ixFileHandle.initPageDirectory(dataNew, INTERNAL);
-            InternalNode newNode(dataNew);
-            CompositeKey newEntry = keyToPushUp;
-            int newChildPointer = newChildEntry;
-            // Split the node
-            node.splitNode(indexType, newNode, keyToPushUp);
-            // set newChildEntry to new page num created
-            newChildEntry = newNode.getPageNum();
-            node.setFreeSpace(node.getFreeSpace() + keyToPushUp.getKeyLength());
-            node.setEntries(node.getEntries() - 1);
-            node.setLastOffset(node.getLastOffset() - keyToPushUp.getKeyLength());
-            // Decide where to insert the new Key
-            if(keyToPushUp >= newEntry) {
-                node.insertEntryInNode(indexType, newEntry, newChildPointer);
-            } else {
-                newNode.insertEntryInNode(indexType, newEntry, newChildPointer);
-            }
+/**
+ * getPageNum() - get the page number of a posting page.
+ *
+ * Return : page number.
+*/
+int PostingPage::getPageNum() const {
+    int pageNum = 0;
+    memcpy((char*)&pageNum, (char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), sizeof(int));
+    return pageNum;
+}
 
-            newChildEntry = newNode.getPageNum();
-            ixFileHandle.appendPage(newNode.getWritableData());
-            ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-            free(dataNew);
-        }
+/**
+ * getNext() - get the next page of the posting list.
+ *
+ * Return : page number, INT_MAX on the last page.
+*/
+int PostingPage::getNext() const {
+    int next = 0;
+    memcpy((char*)&next, (char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), sizeof(int));
+    return next;
+}
 
-        // Root needs to be updated, if in case the node which got split is root
-        if (ixFileHandle.getRoot() == node.getPageNum()) {
-            void* dataRoot = malloc(PAGE_SIZE);
-            ixFileHandle.initPageDirectory(dataRoot, INTERNAL);
-            InternalNode newRoot(dataRoot);
-            newRoot.insertEntryInNode(indexType, keyToPushUp, newChildEntry, node.getPageNum());
-            ixFileHandle.setRoot(newRoot.getPageNum());
-            ixFileHandle.appendPage(newRoot.getWritableData());
-            free(dataRoot);
-        }
-        free(data);
-        return 0;
+/**
+ * setNext() - set the next page of the posting list.
+ * @argument1 : page number, INT_MAX on the last page.
+ *
+ * Return : void.
+*/
+void PostingPage::setNext(const int next) {
+    memcpy((char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), (char*)&next, sizeof(int));
+}
 
-    // node is leaf
-    } else {
-        if(node.hasEnoughSpace(entry.getKeyLength())) {
-            node.insertEntryInNode(indexType, entry);
-            ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-            return 0;
-        } else {
-            void* dataNew = malloc(PAGE_SIZE);
-            ixFileHandle.initPageDirectory(dataNew, LEAF);
-            LeafNode newNode(dataNew);
-            // Split node
-            node.splitNode(indexType, newNode, keyToPushUp);
-            newChildEntry = newNode.getPageNum();
-            newNode.setSibling(node.getSibling());
-            node.setSibling(newNode.getPageNum());
-            // Decide which node to insert new entry
-            if(keyToPushUp >= entry) {
-                node.insertEntryInNode(indexType, entry);
-            } else {
-                newNode.insertEntryInNode(indexType, entry);
-            }
-            ixFileHandle.appendPage(newNode.getWritableData());
-            ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-            free(dataNew);
+/**
+ * getRIDs() - decode the rids of a posting page.
+ * @argument1 : rids are appended to it (out parameter).
+ *
+ * Return : void.
+*/
+void PostingPage::getRIDs(std::vector<RID>& rids) const {
+    decodeRIDs((const char*)this->data, getCount(), rids);
+}
 
-            // update root, if the node which got split is root
-            if (ixFileHandle.getRoot() == node.getPageNum()) {
-                void* dataRoot = malloc(PAGE_SIZE);
-                ixFileHandle.initPageDirectory(dataRoot, INTERNAL);
-                InternalNode newRoot(dataRoot);
-                newRoot.insertEntryInNode(indexType, keyToPushUp, newChildEntry, node.getPageNum());
-                ixFileHandle.setRoot(newRoot.getPageNum());
-                ixFileHandle.appendPage(newRoot.getWritableData());
-                free(dataRoot);
-            }
-            return 0;
+/**
+ * setRIDs() - rewrite a posting page with as many rids of a range as fit.
+ * @argument1 : sorted rids.
+ * @argument2 : first rid to store.
+ * @argument3 : rid after the last one to store.
+ *
+ * Return : index of the first rid which was not stored.
+*/
+unsigned PostingPage::setRIDs(const std::vector<RID>& rids, unsigned first, unsigned last) {
+    RTS capacity = PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int);
+    std::vector<char> buffer;
+    RID prev;
+    prev.pageNum = 0;
+    prev.slotNum = 0;
+    unsigned end = first;
+    while(end < last) {
+        RTS size = buffer.size();
+        encodeRID(rids[end], prev, buffer);
+        if(buffer.size() > capacity) {
+            buffer.resize(size);
+            break;
         }
+        prev = rids[end];
+        end++;
     }
+    RTS count = end - first;
+    RTS used = buffer.size();
+    memcpy((char*)this->data, buffer.data(), used);
+    memcpy((char*)(this->data) + PAGE_SIZE - 2*sizeof(RTS), (char*)&count, sizeof(RTS));
+    memcpy((char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS), (char*)&used, sizeof(RTS));
+    return end;
+}
 
-    return 0;
+/**
+ * getCount() - get the number of buckets listed in a directory page.
+ *
+ * Return : number of buckets.
+*/
+RTS HashDirectoryPage::getCount() const {
+    RTS count = 0;
+    memcpy((char*)&count, (char*)(this->data) + PAGE_SIZE - 2*sizeof(RTS), sizeof(RTS));
+    return count;
 }
 
 /**
- * deleteEntry() - delete an entry from B tree.
- * @argument1 : ixfilehandle having the Btree details.
- * @argument2 : attribute on which the Btree exists.
- * @argument3 : key to be deleted.
- * @argument4 : rid associated with key.
+ * getPageNum() - get the page number of a directory page.
  *
- * Return : 0 on success, -1 on fail.
+ * Return : page number.
 */
-RC IndexManager::deleteEntry(IXFileHandle &ixFileHandle, const Attribute &attribute, 
-                             const void *key, const RID &rid) {
-    int root = ixFileHandle.getRoot();
-    if(root == INT_MAX) return -1;
+int HashDirectoryPage::getPageNum() const {
+    int pageNum = 0;
+    memcpy((char*)&pageNum, (char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), sizeof(int));
+    return pageNum;
+}
+
+/**
+ * getNext() - get the next page of the bucket directory.
+ *
+ * Return : page number, INT_MAX on the last page.
+*/
+int HashDirectoryPage::getNext() const {
+    int next = 0;
+    memcpy((char*)&next, (char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), sizeof(int));
+    return next;
+}
+
+/**
+ * setNext() - set the next page of the bucket directory.
+ * @argument1 : page number, INT_MAX on the last page.
+ *
+ * Return : void.
+*/
+void HashDirectoryPage::setNext(const int next) {
+    memcpy((char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), (char*)&next, sizeof(int));
+}
 
-    void* rootData = malloc(PAGE_SIZE);
-    ixFileHandle.readPage(root, rootData);
+/**
+ * getBuckets() - read the primary pages listed in a directory page.
+ * @argument1 : page numbers are appended to it (out parameter).
+ *
+ * Return : void.
+*/
+void HashDirectoryPage::getBuckets(std::vector<int>& buckets) const {
+    RTS count = getCount();
+    unsigned first = buckets.size();
+    buckets.resize(first + count);
+    if(count > 0) memcpy((char*)&buckets[first], (char*)this->data, count*sizeof(int));
+}
 
-    RTS indexType = attribute.type;
-    CompositeKey deleteKey(indexType, key, rid);
-    int oldNodePointer = INT_MAX;
-    int retVal = 0;
-    if(ixFileHandle.getNodeType(rootData) == LEAF) {
-        LeafNode lNode(rootData);
-        retVal = deleteEntryRecursively(ixFileHandle, indexType, lNode, deleteKey, lNode,
-                                        -1, -1, -1, oldNodePointer);
-    } else {
-        InternalNode intNode(rootData);
-        retVal = deleteEntryRecursively(ixFileHandle, indexType, intNode, deleteKey, intNode, 
-                                        -1, -1, -1, oldNodePointer);
+/**
+ * setBuckets() - rewrite a directory page with as many primary pages as fit.
+ * @argument1 : primary page of each bucket.
+ * @argument2 : first bucket to store.
+ *
+ * Return : index of the first bucket which was not stored.
+*/
+unsigned HashDirectoryPage::setBuckets(const std::vector<int>& buckets, unsigned first) {
+    unsigned capacity = (PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int))/sizeof(int);
+    RTS count = std::min((unsigned)buckets.size() - first, capacity);
+    RTS used = count*sizeof(int);
+    if(count > 0) memcpy((char*)this->data, (char*)&buckets[first], used);
+    memcpy((char*)(this->data) + PAGE_SIZE - 2*sizeof(RTS), (char*)&count, sizeof(RTS));
+    memcpy((char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS), (char*)&used, sizeof(RTS));
+    return first + count;
+}
+
+/**
+ * init() - size a Bloom filter for a number of keys, all its bits are cleared.
+ * @argument1 : number of keys expected, BLOOM_BITS_PER_KEY bits are given to each of them.
+ *
+ * Return : void.
+*/
+void BloomFilter::init(const unsigned expectedKeys) {
+    unsigned blockBits = BLOOM_BLOCK_WORDS*64;
+    this->numBlocks = std::max(1u, (unsigned)(((double)expectedKeys*BLOOM_BITS_PER_KEY + blockBits - 1)/blockBits));
+    this->numKeys = 0;
+    this->words.assign(this->numBlocks*BLOOM_BLOCK_WORDS, 0);
+}
+
+/**
+ * clear() - drop the blocks of a Bloom filter, it is no longer built.
+ *
+ * Return : void.
+*/
+void BloomFilter::clear() {
+    this->numBlocks = 0;
+    this->numKeys = 0;
+    this->words.clear();
+}
+
+/**
+ * getBlock() - get the block of a key, from the high bits of its hash.
+ * @argument1 : hash of the key.
+ *
+ * Return : index of the block.
+*/
+unsigned BloomFilter::getBlock(const unsigned long long hash) const {
+    return (unsigned)(((hash >> 32)*this->numBlocks) >> 32);
+}
+
+/**
+ * getMask() - get the bit set by a key in each word of its block.
+ * @argument1 : hash of the key.
+ * @argument2 : BLOOM_BLOCK_WORDS words receiving the bits (out parameter).
+ *
+ * The low bits of the hash are multiplied by an odd salt per word, the top 6 bits
+ * of each product pick the bit of that word.
+ *
+ * Return : void.
+*/
+void BloomFilter::getMask(const unsigned long long hash, unsigned long long* mask) {
+    static const unsigned salts[BLOOM_BLOCK_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    unsigned key = (unsigned)hash;
+    for(int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+        mask[i] = 1ULL << ((key*salts[i]) >> 26);
     }
+}
 
-    if(retVal == 0) {
-        ixFileHandle.setChanged();
+/**
+ * add() - add a key to a Bloom filter.
+ * @argument1 : hash of the key, see hashValue().
+ *
+ * Return : void.
+*/
+void BloomFilter::add(const unsigned long long hash) {
+    unsigned long long mask[BLOOM_BLOCK_WORDS];
+    getMask(hash, mask);
+    unsigned long long* block = &this->words[getBlock(hash)*BLOOM_BLOCK_WORDS];
+    for(int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+        block[i] |= mask[i];
     }
+    this->numKeys++;
+}
 
-    free(rootData);
-    return retVal;
+/**
+ * mayContain() - look a key up in a Bloom filter.
+ * @argument1 : hash of the key, see hashValue().
+ *
+ * The words of the block are tested without branches so that the compiler can test
+ * them side by side in vector registers.
+ *
+ * Return : false if the key was not added, true if it probably was.
+*/
+bool BloomFilter::mayContain(const unsigned long long hash) const {
+    unsigned long long mask[BLOOM_BLOCK_WORDS];
+    getMask(hash, mask);
+    const unsigned long long* block = &this->words[getBlock(hash)*BLOOM_BLOCK_WORDS];
+    unsigned long long missing = 0;
+    for(int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+        missing |= mask[i] & ~block[i];
+    }
+    return missing == 0;
 }
 
 /**
- * deleteEntryRecursively() - helper to delete an entry from B tree.
- * @argument1 : ixfilehandle having the Btree details.
- * @argument2 : type of the keys present in the node.
- * @argument2 : node in which currently looking to delete.
- * @argument3 : composite key to be delete.
- * @argument4 : parent of the node currently being inspected.
- * @argument5 : sibling of the current node in parent node.
- * @argument6 : previous sibling of the node currently being inspected.
- * @argument7 : flag to check if reorganization is required in each iteration.
+ * isOverloaded() - check if a Bloom filter holds more than twice the keys it was sized for.
  *
- * Return : 0 on success, -1 on fail.
+ * Return : true if the filter should be built again with more blocks.
 */
-RC IndexManager::deleteEntryRecursively(IXFileHandle& ixFileHandle, const RTS indexType, Node& node, 
-                                        CompositeKey& deleteKey, Node& parent, int parentSibling, 
-                                        int parentPrevSibling, int parentKeyOffset, int& oldNodePointer) {
-
-     if(node.getNodeType() == INTERNAL) {
-        int sibling = 0, prevSibling = INT_MAX;
-        RTS keyOffset = 0;
-        int nextPointer = node.getNextNodePointer(indexType, deleteKey, keyOffset, sibling, prevSibling);
-        void* childData = malloc(PAGE_SIZE);
-        ixFileHandle.readPage(nextPointer, childData);
-        if(ixFileHandle.getNodeType(childData) == LEAF) {
-           LeafNode lNode(childData);
-           if(deleteEntryRecursively(ixFileHandle, indexType, lNode, deleteKey, node, sibling, 
-                                     prevSibling, keyOffset, oldNodePointer) == -1) {
-               free(childData);
-               return -1;
-           }
-        } else {
-           InternalNode intNode(childData);
-           if(deleteEntryRecursively(ixFileHandle, indexType, intNode, deleteKey, node, sibling, 
-                                     prevSibling, keyOffset, oldNodePointer) == -1) {
-               free(childData);
-               return -1;
-           }
-        }
+bool BloomFilter::isOverloaded() const {
+    return (double)this->numKeys*BLOOM_BITS_PER_KEY > 2.0*this->words.size()*64;
+}
 
-        if(oldNodePointer == INT_MAX) {
-            free(childData);
-            return 0;
-        }
+/**
+ * assign() - take the words of a Bloom filter.
+ * @argument1 : words of whole blocks.
+ * @argument2 : number of keys added to them.
+ *
+ * Return : void.
+*/
+void BloomFilter::assign(const std::vector<unsigned long long>& words, const unsigned numKeys) {
+    this->numBlocks = words.size()/BLOOM_BLOCK_WORDS;
+    this->numKeys = numKeys;
+    this->words.assign(words.begin(), words.begin() + this->numBlocks*BLOOM_BLOCK_WORDS);
+}
 
-        /* If merge happenned in the child nodes of current nodes*/
-        int newRoot = node.removeKey(indexType, keyOffset); //Handle cases when there is only one child node left.
-        /* If the node is the root of the tree and all the entries 
-         * from the root have been removed, update the root */
-        if(node.getPageNum() == ixFileHandle.getRoot()) {
-            if(newRoot != -1) {
-                ixFileHandle.setRoot(newRoot);
-                oldNodePointer = INT_MAX;
-            } else {
-                oldNodePointer = INT_MAX;
-                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-            }
-            free(childData);
-            return 0;
+/**
+ * hashValue() - 64 bit hash of an attribute value.
+ * @argument1 : type of the value.
+ * @argument2 : value, 4 bytes for an Int/Real, [int length][chars] for a VarChar.
+ *
+ * FNV-1a over the bytes of the value, whose high bits are then folded into the low bits
+ * since the filter takes its block and its bits from both halves of the hash.
+ *
+ * Return : hash of the value.
+*/
+unsigned long long BloomFilter::hashValue(const AttrType type, const void* value) {
+    const char* bytes = (const char*)value;
+    int length = sizeof(int);
+    float real = 0;
+    if(type == TypeVarChar) {
+        memcpy((char*)&length, bytes, sizeof(int));
+        bytes += sizeof(int);
+    } else if(type == TypeReal) {
+        memcpy((char*)&real, bytes, sizeof(float));
+        if(real == 0) {
+            real = 0;
+            bytes = (const char*)&real;
         }
+    }
+    unsigned long long hash = 14695981039346656037ULL;
+    for(int i = 0; i < length; i++) {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash;
+}
 
-        /* if < %50 occupancy*/
-        if(!node.checkIfUnderUtilized()) {
-            oldNodePointer = INT_MAX;
-            ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-            free(childData);
-            return 0;
-        }
+/**
+ * getCount() - get the number of filter words stored in a key filter page.
+ *
+ * Return : number of words.
+*/
+RTS KeyFilterPage::getCount() const {
+    RTS count = 0;
+    memcpy((char*)&count, (char*)(this->data) + PAGE_SIZE - 2*sizeof(RTS), sizeof(RTS));
+    return count;
+}
 
-        void* mergeWith = malloc(PAGE_SIZE);
-        CompositeKey keyToPullDown;
-        parent.getKeyFromOffset(indexType, parentKeyOffset, keyToPullDown);
+/**
+ * getPageNum() - get the page number of a key filter page.
+ *
+ * Return : page number.
+*/
+int KeyFilterPage::getPageNum() const {
+    int pageNum = 0;
+    memcpy((char*)&pageNum, (char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), sizeof(int));
+    return pageNum;
+}
 
-        // If there is no next sibling, try merging with previous sibling
-        if(parentSibling == INT_MAX && parentPrevSibling != INT_MAX) {
-            ixFileHandle.readPage(parentPrevSibling, mergeWith);
-            InternalNode intNode(mergeWith);
-            if(intNode.hasEnoughSpace(node.getLastOffset() + keyToPullDown.getKeyLength())) {
-                intNode.insertKeyAtOffset(indexType, intNode.getLastOffset(), keyToPullDown);
-                intNode.setLastOffset(intNode.getLastOffset() + keyToPullDown.getKeyLength());
-                intNode.setFreeSpace(intNode.getFreeSpace() - keyToPullDown.getKeyLength());
-                intNode.setEntries(intNode.getEntries() + 1);
-                intNode.mergeNodes(indexType, node);
-                oldNodePointer = -1;
-                ixFileHandle.writePage(intNode.getPageNum(), intNode.getWritableData());
-                free(childData);
-                free(mergeWith);
-                return 0;
-            }
-        } else { 
-            ixFileHandle.readPage(parentSibling, mergeWith);
-            InternalNode intNode(mergeWith);
-            /* merge with next sibling */
-            if(node.hasEnoughSpace(intNode.getLastOffset() + keyToPullDown.getKeyLength())) {
-                node.insertKeyAtOffset(indexType, node.getLastOffset(), keyToPullDown);
-                node.setLastOffset(node.getLastOffset() + keyToPullDown.getKeyLength());
-                node.setFreeSpace(node.getFreeSpace() - keyToPullDown.getKeyLength());
-                node.setEntries(node.getEntries() + 1);
-                node.mergeNodes(indexType, intNode);
-                oldNodePointer = -1;
-                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-                free(childData);
-                free(mergeWith);
-                return 0;
-           /* if merge not possible with next node, try with previous node */
-           } else if(parentPrevSibling != INT_MAX) {
-               ixFileHandle.readPage(parentPrevSibling, mergeWith);
-               InternalNode intNode(mergeWith);
-               if(intNode.hasEnoughSpace(node.getLastOffset() + keyToPullDown.getKeyLength())) {
-                   intNode.insertKeyAtOffset(indexType, intNode.getLastOffset(), keyToPullDown);
-                   intNode.setLastOffset(intNode.getLastOffset() + keyToPullDown.getKeyLength());
-                   intNode.setFreeSpace(intNode.getFreeSpace() - keyToPullDown.getKeyLength());
-                   intNode.setEntries(intNode.getEntries() + 1);
-                   intNode.mergeNodes(indexType, node);
-                   oldNodePointer = -1;
-                   ixFileHandle.writePage(intNode.getPageNum(), intNode.getWritableData());
-                   free(childData);
-                   free(mergeWith);
-                   return 0;
-               }
-           }
-       }
-       /* merge required but not possible, doing a lazy delete */
-       ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-       oldNodePointer = INT_MAX;
-       free(childData);
-       free(mergeWith);
-       return 0;
-     /* If node is a leaf node */
-     } else {
-        int keyOffset = node.findKeyOffset(indexType, deleteKey);
-        /* ALready deleted or not present */
-        if(keyOffset == -1) return -1;
-        int newRoot = node.removeKey(indexType, keyOffset); //Handle cases when there is only one child node left.
-        if(node.getPageNum() == ixFileHandle.getRoot()) {
-            if(newRoot != -1) {
-                /* complete Btree deletion has occurred */
-                /* deleteEntry(...) should fail after this */
-                ixFileHandle.setRoot(newRoot);
-                oldNodePointer = INT_MAX;
-            } else {
-                oldNodePointer = INT_MAX;
-                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-            }
+/**
+ * getNext() - get the next page of the key filter.
+ *
+ * Return : page number, INT_MAX on the last page.
+*/
+int KeyFilterPage::getNext() const {
+    int next = 0;
+    memcpy((char*)&next, (char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), sizeof(int));
+    return next;
+}
+
+/**
+ * setNext() - set the next page of the key filter.
+ * @argument1 : page number, INT_MAX on the last page.
+ *
+ * Return : void.
+*/
+void KeyFilterPage::setNext(const int next) {
+    memcpy((char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), (char*)&next, sizeof(int));
+}
+
+/**
+ * getWords() - read the filter words stored in a key filter page.
+ * @argument1 : words are appended to it (out parameter).
+ *
+ * Return : void.
+*/
+void KeyFilterPage::getWords(std::vector<unsigned long long>& words) const {
+    RTS count = getCount();
+    unsigned first = words.size();
+    words.resize(first + count);
+    if(count > 0) memcpy((char*)&words[first], (char*)this->data, count*sizeof(unsigned long long));
+}
+
+/**
+ * setWords() - rewrite a key filter page with as many filter words as fit.
+ * @argument1 : words of the filter.
+ * @argument2 : first word to store.
+ *
+ * Return : index of the first word which was not stored.
+*/
+unsigned KeyFilterPage::setWords(const std::vector<unsigned long long>& words, unsigned first) {
+    unsigned capacity = (PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int))/sizeof(unsigned long long);
+    RTS count = std::min((unsigned)words.size() - first, capacity);
+    RTS used = count*sizeof(unsigned long long);
+    if(count > 0) memcpy((char*)this->data, (char*)&words[first], used);
+    memcpy((char*)(this->data) + PAGE_SIZE - 2*sizeof(RTS), (char*)&count, sizeof(RTS));
+    memcpy((char*)(this->data) + PAGE_SIZE - 4*sizeof(RTS), (char*)&used, sizeof(RTS));
+    return first + count;
+}
+
+/* FNV-1a hash of a key value, -0.0 and 0.0 are equal keys and hash alike */
+static unsigned hashKeyValue(const RTS indexType, const KeyView& key) {
+    const char* value = key.key;
+    float zero = 0;
+    if(getValueType(indexType) == TypeReal && compareKeyValues<TypeReal>(value, (const char*)&zero) == 0) {
+        value = (const char*)&zero;
+    }
+    unsigned hash = 2166136261u;
+    for(RTS i = 0; i < key.keyLen; i++) {
+        hash ^= (unsigned char)value[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//IX manager singleton
+IndexManager &IndexManager::instance() {
+    static IndexManager _index_manager = IndexManager();
+    return _index_manager;
+}
+
+/**
+ * createFile() - create an index file.
+ * @argument1 : name of the file.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::createFile(const std::string &fileName) {
+    return PagedFileManager::instance().createFile(fileName);
+}
+
+/**
+ * createFile() - create an index file, optionally with posting lists.
+ * @argument1 : name of the file.
+ * @argument2 : keep the rids of a key in one posting list entry instead of an entry per rid.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::createFile(const std::string &fileName, const bool postingLists) {
+    if(createFile(fileName) == -1) return -1;
+    IXFileHandle ixFileHandle;
+    if(openFile(fileName, ixFileHandle) == -1) return -1;
+    ixFileHandle.setPostingLists(postingLists);
+    return closeFile(ixFileHandle);
+}
+
+/**
+ * createFile() - create an index file whose entries carry the values of INCLUDE columns.
+ * @argument1 : name of the file.
+ * @argument2 : keep the rids of a key in one posting list entry instead of an entry per rid.
+ * @argument3 : the keys passed to insertEntry() are followed by [RTS n][n bytes] of INCLUDE columns,
+ *              which the scan returns after the key. Can not be combined with posting lists.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::createFile(const std::string &fileName, const bool postingLists, const bool includePayload) {
+    if(postingLists && includePayload) return -1;
+    if(createFile(fileName) == -1) return -1;
+    IXFileHandle ixFileHandle;
+    if(openFile(fileName, ixFileHandle) == -1) return -1;
+    ixFileHandle.setPostingLists(postingLists);
+    ixFileHandle.setIncludePayload(includePayload);
+    return closeFile(ixFileHandle);
+}
+
+/**
+ * createFile() - create an index file of the given kind.
+ * @argument1 : name of the file.
+ * @argument2 : BTREE_INDEX, or HASH_INDEX for a linear hash index whose buckets are chains of
+ *              leaf pages. Equality scans on a hash index read one bucket, other scans read
+ *              every bucket and return the entries in no particular order.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::createFile(const std::string &fileName, const IndexKind indexKind) {
+    if(createFile(fileName) == -1) return -1;
+    if(indexKind == BTREE_INDEX) return 0;
+    IXFileHandle ixFileHandle;
+    if(openFile(fileName, ixFileHandle) == -1) return -1;
+    RC rc = ixFileHandle.createHashBuckets();
+    if(closeFile(ixFileHandle) == -1) return -1;
+    return rc;
+}
+
+/**
+ * destroyFile() - delete an index file.
+ * @argument1 : name of the file.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::destroyFile(const std::string &fileName) {
+    return PagedFileManager::instance().destroyFile(fileName);
+}
+
+/**
+ * openFile() - open an index file.
+ * @argument1 : name of the file.
+ * @argument2 : ixfilehandle (out parameter).
+ *
+ * Return : 0 on success, -1 on fail or if the file has no IX_FORMAT_MARKER.
+*/
+RC IndexManager::openFile(const std::string &fileName, IXFileHandle &ixFileHandle) {
+    if(PagedFileManager::instance().openFile(fileName, ixFileHandle) == -1) return -1;
+    // a file of another format is closed again by the handle
+    return ixFileHandle.isOpen() ? 0 : -1;
+}
+
+/**
+ * openFile() - close an index file.
+ * @argument1 : ixfilehandle having the file details.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::closeFile(IXFileHandle &ixFileHandle) {
+    // the changes held in memory reach the tree first
+    if(ixFileHandle.isOpen() && ixFileHandle.hasDeltaBuffer()) flushDeltaBuffer(ixFileHandle);
+    return PagedFileManager::instance().closeFile(ixFileHandle);
+}
+
+/**
+ * insertEntry() - insert an entry into B tree.
+ * @argument1 : ixfilehandle having the Btree details.
+ * @argument2 : attribute on which the Btree exists.
+ * @argument3 : key to be inserted.
+ * @argument4 : rid associated with key.
+ *
+ * With a delta buffer the entry is only added to it, the buffer is merged into the tree once full.
+ * An entry fitting into its leaf is inserted while the tree latch is shared, the others hold it alone.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::insertEntry(IXFileHandle &ixFileHandle, const Attribute &attribute,
+                             const void *key, const RID &rid) {
+    RTS indexType = ixFileHandle.getIndexType(attribute);
+    CompositeKey entry(indexType, key, rid);
+    {
+        SharedLatchGuard guard(ixFileHandle.getLatch());
+        if(insertIntoLeaf(ixFileHandle, indexType, entry)) {
+            ixFileHandle.addToKeyFilter(BloomFilter::hashValue(attribute.type, key));
             return 0;
         }
+    }
 
-        if(!node.checkIfUnderUtilized()) {
-            oldNodePointer = INT_MAX;
+    std::lock_guard<SharedLatch> guard(ixFileHandle.getLatch());
+    // a failed insert only leaves a false positive in the key filter
+    ixFileHandle.addToKeyFilter(BloomFilter::hashValue(attribute.type, key));
+
+    if(ixFileHandle.hasDeltaBuffer()) {
+        // an insert cancels the delete of the same entry still held
+        std::map<CompositeKey, int>& deltaEntries = ixFileHandle.getDeltaEntries();
+        auto itr = deltaEntries.insert(std::make_pair(entry, 0)).first;
+        if(++itr->second == 0) deltaEntries.erase(itr);
+        return ixFileHandle.isDeltaBufferFull() ? mergeDeltaBuffer(ixFileHandle) : 0;
+    }
+    return insertIntoTree(ixFileHandle, indexType, entry);
+}
+
+/**
+ * insertIntoLeaf() - insert an entry into its leaf when no other node changes.
+ * @argument1 : ixfilehandle having the Btree details, its latch is shared.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : composite key to be inserted.
+ *
+ * Without a split the tree keeps its shape while the latch is shared, the leaf found by the
+ * descent stays the leaf of the entry. Its latch, taken before the leaf is read, orders the
+ * inserts and deletes changing it. Hash indexes, delta buffers, posting lists and empty trees
+ * are left to insertIntoTree().
+ *
+ * Return : true if the entry was inserted.
+*/
+bool IndexManager::insertIntoLeaf(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& entry) {
+    if(ixFileHandle.isHashIndex() || ixFileHandle.hasDeltaBuffer() || ixFileHandle.hasPostingLists() ||
+       ixFileHandle.getRoot() == INT_MAX) {
+        return false;
+    }
+    if(insertIntoRightmostLeaf(ixFileHandle, indexType, entry)) {
+        ixFileHandle.setChanged();
+        return true;
+    }
+
+    TreePath path;
+    std::unique_lock<std::mutex> guard;
+    if(path.descend(ixFileHandle, indexType, entry, &guard) == -1) return false;
+    int pageNum = path.getLeaf();
+    void* data = path.getPage(path.depth - 1);
+
+    LeafNode leafNode(data);
+    Node& leaf = leafNode;
+    if(!leafNode.hasEnoughSpace(leafNode.getRequiredSpace(indexType, entry))) return false;
+    leaf.insertEntryInNode(indexType, entry);
+    ixFileHandle.writePage(pageNum, data);
+    if(leafNode.getSibling() == INT_MAX) ixFileHandle.setRightmostLeaf(pageNum);
+    ixFileHandle.setChanged();
+    return true;
+}
+
+/**
+ * insertIntoTree() - insert an entry into the hash buckets or the BTree of an index.
+ * @argument1 : ixfilehandle having the Btree details, its latch is held alone.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : composite key to be inserted.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::insertIntoTree(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& entry) {
+    int root = ixFileHandle.getRoot();
+    if(ixFileHandle.isHashIndex()) {
+        RC rc = ixFileHandle.insertIntoBucket(indexType, entry);
+        if(rc == 0) ixFileHandle.setChanged();
+        return rc;
+    }
+
+    // keys appended after the last one skip the descent
+    if(root != INT_MAX && insertIntoRightmostLeaf(ixFileHandle, indexType, entry)) {
+        ixFileHandle.setChanged();
+        return 0;
+    }
+
+    TreePath& path = ixFileHandle.getPath();
+    // Root or pages in the index file, create one leaf node and make it the root
+    if(root == INT_MAX) {
+        void* data = path.startAtRoot();
+        ixFileHandle.allocatePage(data, LEAF);
+        ixFileHandle.appendPage(data);
+        path.pageNums[0] = LeafNode(data).getPageNum();
+        ixFileHandle.setRoot(path.pageNums[0]);
+    } else if(path.descend(ixFileHandle, indexType, entry) == -1) {
+        return -1;
+    }
+    RC rc = insertEntryOnPath(ixFileHandle, indexType, path, entry);
+    if(rc == 0) {
+        ixFileHandle.setChanged();
+    }
+    return rc;
+}
+
+/**
+ * insertEntryOnPath() -  helper function to insert an entry into the leaf of a path and split up.
+ * @argument1 : ixfilehandle having the Btree details.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : path from the root to the leaf of the entry, level 0 is the root.
+ * @argument4 : composite key to be inserted.
+ *
+ * A split pushes its separator into the parent found on the path, a split of the
+ * root adds a new root above it.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::insertEntryOnPath(IXFileHandle& ixFileHandle, const RTS indexType, TreePath& path,
+                                   CompositeKey& entry) {
+    int level = path.depth - 1;
+    LeafNode leafNode(path.getPage(level));
+    Node& leaf = leafNode;
+    if(ixFileHandle.hasPostingLists() && addToPostingList(ixFileHandle, indexType, leafNode, entry) == -1) {
+        return -1;
+    }
+    bool isRightmost = leafNode.getSibling() == INT_MAX;
+    if(leafNode.hasEnoughSpace(leafNode.getRequiredSpace(indexType, entry))) {
+        leaf.insertEntryInNode(indexType, entry);
+        ixFileHandle.writePage(leaf.getPageNum(), leaf.getWritableData());
+        if(isRightmost) ixFileHandle.setRightmostLeaf(leaf.getPageNum());
+        return 0;
+    }
+
+    CompositeKey keyToPushUp;
+    void* dataNew = malloc(PAGE_SIZE);
+    ixFileHandle.allocatePage(dataNew, LEAF);
+    LeafNode newLeaf(dataNew);
+    // Split node, the new entry goes into one of the halves. A key past the end of
+    // the last leaf leaves it nearly full, the next keys are likely to follow it.
+    bool appendSplit = isRightmost && leafNode.findKeySlot(indexType, entry) == leafNode.getEntries();
+    if(leafNode.splitLeaf(indexType, newLeaf, entry, keyToPushUp, appendSplit) == -1) {
+        // a page taken from the free list goes back to it
+        if(newLeaf.getPageNum() < ixFileHandle.getNumberOfPages()) ixFileHandle.freePage(newLeaf.getPageNum());
+        free(dataNew);
+        return -1;
+    }
+    if(ixFileHandle.hasPostingLists()) {
+        keyToPushUp.setMatchAnyRID();
+    }
+    int newChildEntry = newLeaf.getPageNum();
+    newLeaf.setSibling(leaf.getSibling());
+    leaf.setSibling(newLeaf.getPageNum());
+    if(isRightmost) ixFileHandle.setRightmostLeaf(newLeaf.getPageNum());
+    ixFileHandle.appendPage(newLeaf.getWritableData());
+    ixFileHandle.writePage(leaf.getPageNum(), leaf.getWritableData());
+
+    /* The separator goes up the path, the parents are already in memory */
+    for(level--; level >= 0; level--) {
+        InternalNode internalNode(path.getPage(level));
+        Node& node = internalNode;
+        if(node.hasEnoughSpace(keyToPushUp.getKeyLength() + sizeof(int) + sizeof(RTS))) {
+            node.insertEntryInNode(indexType, keyToPushUp, newChildEntry);
             ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+            free(dataNew);
             return 0;
         }
 
-        parentSibling = node.getSibling();
-        void* mergeWith = malloc(PAGE_SIZE);
-        /*Check if the node is the last node*/
-        if(parentSibling == INT_MAX && parentPrevSibling != INT_MAX) {
-            ixFileHandle.readPage(parentPrevSibling, mergeWith);
-            LeafNode lNode(mergeWith);
-            if(lNode.hasEnoughSpace(node.getLastOffset())) {
-                lNode.mergeNodes(indexType, node);
-                lNode.setSibling(node.getSibling());
-                oldNodePointer = -1;
-                ixFileHandle.writePage(lNode.getPageNum(), lNode.getWritableData());
-                free(mergeWith);
-                return 0;
-            }
+        ixFileHandle.allocatePage(dataNew, INTERNAL);
+        InternalNode newNode(dataNew);
+        CompositeKey newEntry = keyToPushUp;
+        int newChildPointer = newChildEntry;
+        // Split the node
+        node.splitNode(indexType, newNode, keyToPushUp);
+        node.setFreeSpace(node.getFreeSpace() + keyToPushUp.getKeyLength() + sizeof(RTS));
+        node.setEntries(node.getEntries() - 1);
+        node.setLastOffset(node.getLastOffset() - keyToPushUp.getKeyLength());
+        // Decide where to insert the new Key
+        if(keyToPushUp >= newEntry) {
+            node.insertEntryInNode(indexType, newEntry, newChildPointer);
         } else {
-            ixFileHandle.readPage(parentSibling, mergeWith);
-            LeafNode lNode(mergeWith);
-            /* Merge with sibling node */
-            if(node.hasEnoughSpace(lNode.getLastOffset())) {
-                node.mergeNodes(indexType, lNode);
-                node.setSibling(lNode.getSibling());
-                oldNodePointer = -1;
-                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-                free(mergeWith);
-                return 0;
-            /* if merge with sibling not possible try to merge with previous node */
-            } else if(parentPrevSibling != INT_MAX) {
-                ixFileHandle.readPage(parentPrevSibling, mergeWith);
-                LeafNode lNode(mergeWith);
-                if(lNode.hasEnoughSpace(node.getLastOffset())) {
-                    lNode.mergeNodes(indexType, node);
-                    lNode.setSibling(node.getSibling());
-                    oldNodePointer = -1;
-                    ixFileHandle.writePage(lNode.getPageNum(), lNode.getWritableData());
-                    free(mergeWith);
-                    return 0;
-                }
+            newNode.insertEntryInNode(indexType, newEntry, newChildPointer);
+        }
+
+        // set newChildEntry to new page num created
+        newChildEntry = newNode.getPageNum();
+        ixFileHandle.appendPage(newNode.getWritableData());
+        ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+    }
+
+    // The root got split, a new root is added above it
+    ixFileHandle.allocatePage(dataNew, INTERNAL);
+    InternalNode newRoot(dataNew);
+    newRoot.insertEntryInNode(indexType, keyToPushUp, newChildEntry, path.pageNums[0]);
+    ixFileHandle.setRoot(newRoot.getPageNum());
+    ixFileHandle.appendPage(newRoot.getWritableData());
+    free(dataNew);
+    return 0;
+}
+
+/**
+ * insertIntoRightmostLeaf() - insert an entry into the last leaf without descending from the root.
+ * @argument1 : ixfilehandle having the Btree details.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : composite key to be inserted.
+ *
+ * An entry after the first key of the last leaf belongs to it, the separators above the leaf
+ * are not greater than its first key. Inserts which would split the leaf, and those into an
+ * index with posting lists, go through insertIntoTree(). The leaf latch is taken as the
+ * tree latch may be shared.
+ *
+ * Return : true if the entry was inserted.
+*/
+bool IndexManager::insertIntoRightmostLeaf(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& entry) {
+    int pageNum = ixFileHandle.getRightmostLeaf();
+    if(pageNum == INT_MAX || ixFileHandle.hasPostingLists()) return false;
+
+    std::lock_guard<std::mutex> guard(ixFileHandle.getLeafLatch(pageNum));
+    void* data = malloc(PAGE_SIZE);
+    if(ixFileHandle.readPage(pageNum, data) == -1 || ixFileHandle.getNodeType(data) != LEAF) {
+        ixFileHandle.setRightmostLeaf(INT_MAX);
+        free(data);
+        return false;
+    }
+
+    LeafNode leafNode(data);
+    bool inserted = false;
+    if(leafNode.getSibling() == INT_MAX && leafNode.getEntries() > 0 && leafNode.findKeySlot(indexType, entry) > 0 &&
+       leafNode.hasEnoughSpace(leafNode.getRequiredSpace(indexType, entry))) {
+        leafNode.insertEntryInNode(indexType, entry);
+        ixFileHandle.writePage(pageNum, data);
+        inserted = true;
+    }
+    free(data);
+    return inserted;
+}
+
+/**
+ * addToPostingList() - add the rid of a new entry to the entry of its key value in a leaf.
+ * @argument1 : ixfilehandle having the Btree details.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : leaf in which the entry is to be inserted.
+ * @argument4 : new entry, replaced by the posting list entry to insert (in/out parameter).
+ *
+ * The old entry of the key value is removed from the leaf, the entry to insert
+ * holds its rids and the new one. Nothing changes if the key value is not in the leaf.
+ *
+ * Return : 0 on success, -1 if the entry is already present.
+*/
+RC IndexManager::addToPostingList(IXFileHandle& ixFileHandle, const RTS indexType, LeafNode& leaf,
+                                  CompositeKey& entry) {
+    RT keyOffset = leaf.findValueOffset(indexType, entry.getView());
+    if(keyOffset == -1) return 0;
+
+    CompositeKey postingEntry;
+    leaf.getKeyFromOffset(indexType, keyOffset, postingEntry);
+    if(ixFileHandle.addToPostingList(postingEntry, entry.getRID()) == -1) return -1;
+    leaf.removeKey(indexType, keyOffset);
+    entry = postingEntry;
+    return 0;
+}
+
+/**
+ * deleteEntry() - delete an entry from B tree.
+ * @argument1 : ixfilehandle having the Btree details.
+ * @argument2 : attribute on which the Btree exists.
+ * @argument3 : key to be deleted.
+ * @argument4 : rid associated with key.
+ *
+ * With a delta buffer an entry still held is dropped from it. An entry of the tree is
+ * looked up without changing any page and its delete is held until the next merge.
+ * A delete leaving its leaf at least half full shares the tree latch, the others hold it alone.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::deleteEntry(IXFileHandle &ixFileHandle, const Attribute &attribute, 
+                             const void *key, const RID &rid) {
+    RTS indexType = ixFileHandle.getIndexType(attribute);
+    {
+        SharedLatchGuard guard(ixFileHandle.getLatch());
+        CompositeKey deleteKey(getValueType(indexType), key, rid);
+        if(deleteFromLeaf(ixFileHandle, indexType, deleteKey)) return 0;
+    }
+
+    std::lock_guard<SharedLatch> guard(ixFileHandle.getLatch());
+    if(ixFileHandle.isHashIndex()) {
+        RC rc = ixFileHandle.deleteFromBucket(indexType, CompositeKey(indexType, key, rid));
+        if(rc == 0) ixFileHandle.setChanged();
+        return rc;
+    }
+
+    // only the key value and the rid identify the entry, the INCLUDE columns are not needed
+    CompositeKey deleteKey(getValueType(indexType), key, rid);
+    if(ixFileHandle.hasDeltaBuffer()) {
+        std::map<CompositeKey, int>& deltaEntries = ixFileHandle.getDeltaEntries();
+        auto itr = deltaEntries.find(deleteKey);
+        if(itr != deltaEntries.end()) {
+            if(itr->second < 0) return -1;
+            if(--itr->second == 0) deltaEntries.erase(itr);
+            return 0;
+        }
+        if(!isEntryInTree(ixFileHandle, indexType, deleteKey)) return -1;
+        deltaEntries[deleteKey] = -1;
+        return ixFileHandle.isDeltaBufferFull() ? mergeDeltaBuffer(ixFileHandle) : 0;
+    }
+    return deleteFromTree(ixFileHandle, indexType, deleteKey);
+}
+
+/**
+ * deleteFromLeaf() - delete an entry from its leaf when no other node changes.
+ * @argument1 : ixfilehandle having the Btree details, its latch is shared.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : key value and rid of the entry.
+ *
+ * Like insertIntoLeaf(), the leaf is changed under its latch. A leaf which would be under
+ * utilized, a root leaf left empty and a missing entry are left to deleteFromTree().
+ *
+ * Return : true if the entry was deleted.
+*/
+bool IndexManager::deleteFromLeaf(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& deleteKey) {
+    if(ixFileHandle.isHashIndex() || ixFileHandle.hasDeltaBuffer() || ixFileHandle.hasPostingLists() ||
+       ixFileHandle.getRoot() == INT_MAX) {
+        return false;
+    }
+
+    TreePath path;
+    std::unique_lock<std::mutex> guard;
+    if(path.descend(ixFileHandle, indexType, deleteKey, &guard) == -1) return false;
+    int pageNum = path.getLeaf();
+    void* data = path.getPage(path.depth - 1);
+
+    LeafNode leafNode(data);
+    Node& node = leafNode;
+    int keyOffset = node.findKeyOffset(indexType, deleteKey);
+    if(keyOffset == -1) return false;
+    // a root leaf is never merged, it only changes the root once empty
+    if(node.removeKey(indexType, keyOffset) != -1 || (path.depth > 1 && node.checkIfUnderUtilized())) return false;
+    ixFileHandle.writePage(pageNum, data);
+    ixFileHandle.setChanged();
+    return true;
+}
+
+/**
+ * deleteFromTree() - delete an entry from the BTree of an index.
+ * @argument1 : ixfilehandle having the Btree details, its latch is held alone.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : key value and rid of the entry.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::deleteFromTree(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& deleteKey) {
+    int root = ixFileHandle.getRoot();
+    if(root == INT_MAX) return -1;
+
+    // a merge may drop the last leaf from the tree
+    ixFileHandle.setRightmostLeaf(INT_MAX);
+
+    TreePath& path = ixFileHandle.getPath();
+    if(path.descend(ixFileHandle, indexType, deleteKey) == -1) return -1;
+    /* The leaf first, then the parents while a child of theirs was merged away */
+    int oldNodePointer = INT_MAX;
+    int level = path.depth - 1;
+    int retVal = deleteEntryFromLevel(ixFileHandle, indexType, path, level, deleteKey, oldNodePointer);
+    for(level--; retVal == 0 && level >= 0 && oldNodePointer != INT_MAX; level--) {
+        retVal = deleteEntryFromLevel(ixFileHandle, indexType, path, level, deleteKey, oldNodePointer);
+    }
+
+    if(retVal == 0) {
+        ixFileHandle.setChanged();
+    }
+    return retVal;
+}
+
+/**
+ * deleteEntryFromLevel() - helper to delete an entry from a node of the path of the entry.
+ * @argument1 : ixfilehandle having the Btree details.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : path from the root to the leaf of the entry, level 0 is the root.
+ * @argument4 : level of the node on the path, the leaf first then its parents.
+ * @argument5 : composite key to be deleted.
+ * @argument6 : -1 if the child of the node was merged away, set to -1 if the node was
+ *              merged away, INT_MAX when the parents need no change (in/out parameter).
+ *
+ * The parent of the node and the siblings of the node in it are taken from the path.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::deleteEntryFromLevel(IXFileHandle& ixFileHandle, const RTS indexType, TreePath& path,
+                                      const int level, CompositeKey& deleteKey, int& oldNodePointer) {
+    int parentSibling = level > 0 ? path.siblings[level - 1] : -1;
+    int parentPrevSibling = level > 0 ? path.prevSiblings[level - 1] : -1;
+
+    if(level < path.depth - 1) {
+        InternalNode internalNode(path.getPage(level));
+        Node& node = internalNode;
+        RTS keyOffset = path.keyOffsets[level];
+
+        /* If merge happenned in the child nodes of current nodes*/
+        int newRoot = node.removeKey(indexType, keyOffset); //Handle cases when there is only one child node left.
+        /* If the node is the root of the tree and all the entries
+         * from the root have been removed, update the root */
+        if(level == 0) {
+            if(newRoot != -1) {
+                ixFileHandle.setRoot(newRoot);
+                ixFileHandle.freePage(node.getPageNum());
+                oldNodePointer = INT_MAX;
+            } else {
+                oldNodePointer = INT_MAX;
+                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+            }
+            return 0;
+        }
+
+        /* if < %50 occupancy*/
+        if(!node.checkIfUnderUtilized()) {
+            oldNodePointer = INT_MAX;
+            ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+            return 0;
+        }
+
+        void* mergeWith = malloc(PAGE_SIZE);
+        CompositeKey keyToPullDown;
+        InternalNode parent(path.getPage(level - 1));
+        parent.getKeyFromOffset(indexType, path.keyOffsets[level - 1], keyToPullDown);
+
+        // If there is no next sibling, try merging with previous sibling
+        if(parentSibling == INT_MAX && parentPrevSibling != INT_MAX) {
+            ixFileHandle.readPage(parentPrevSibling, mergeWith);
+            InternalNode intNode(mergeWith);
+            if(intNode.hasEnoughSpace(node.getUsedSpace() + keyToPullDown.getKeyLength() + sizeof(RTS))) {
+                intNode.appendKey(indexType, keyToPullDown);
+                intNode.mergeNodes(indexType, node);
+                oldNodePointer = -1;
+                ixFileHandle.writePage(intNode.getPageNum(), intNode.getWritableData());
+                ixFileHandle.freePage(node.getPageNum());
+                free(mergeWith);
+                return 0;
+            }
+        } else if(parentSibling != INT_MAX) {
+            ixFileHandle.readPage(parentSibling, mergeWith);
+            InternalNode intNode(mergeWith);
+            /* merge with next sibling */
+            if(node.hasEnoughSpace(intNode.getUsedSpace() + keyToPullDown.getKeyLength() + sizeof(RTS))) {
+                node.appendKey(indexType, keyToPullDown);
+                node.mergeNodes(indexType, intNode);
+                oldNodePointer = -1;
+                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+                ixFileHandle.freePage(parentSibling);
+                free(mergeWith);
+                return 0;
+           /* if merge not possible with next node, try with previous node */
+           } else if(parentPrevSibling != INT_MAX) {
+               ixFileHandle.readPage(parentPrevSibling, mergeWith);
+               InternalNode intNode(mergeWith);
+               if(intNode.hasEnoughSpace(node.getUsedSpace() + keyToPullDown.getKeyLength() + sizeof(RTS))) {
+                   intNode.appendKey(indexType, keyToPullDown);
+                   intNode.mergeNodes(indexType, node);
+                   oldNodePointer = -1;
+                   ixFileHandle.writePage(intNode.getPageNum(), intNode.getWritableData());
+                   ixFileHandle.freePage(node.getPageNum());
+                   free(mergeWith);
+                   return 0;
+               }
+           }
+       }
+       /* merge required but not possible, doing a lazy delete */
+       ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+       oldNodePointer = INT_MAX;
+       free(mergeWith);
+       return 0;
+     /* If node is a leaf node */
+     } else {
+        LeafNode leafNode(path.getPage(level));
+        Node& node = leafNode;
+        int keyOffset = node.findKeyOffset(indexType, deleteKey);
+        /* ALready deleted or not present */
+        if(keyOffset == -1) return -1;
+        /* The rid is in a posting list, the entry shrinks and stays in the leaf */
+        if(ixFileHandle.hasPostingLists()) {
+            CompositeKey postingEntry;
+            node.getKeyFromOffset(indexType, keyOffset, postingEntry);
+            if(isPostingList(postingEntry.getRID())) {
+                if(ixFileHandle.removeFromPostingList(postingEntry, deleteKey.getRID()) == -1) return -1;
+                node.removeKey(indexType, keyOffset);
+                node.insertEntryInNode(indexType, postingEntry);
+                oldNodePointer = INT_MAX;
+                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+                return 0;
+            }
+        }
+        int newRoot = node.removeKey(indexType, keyOffset); //Handle cases when there is only one child node left.
+        if(level == 0) {
+            if(newRoot != -1) {
+                /* complete Btree deletion has occurred */
+                /* deleteEntry(...) should fail after this */
+                ixFileHandle.setRoot(newRoot);
+                ixFileHandle.freePage(node.getPageNum());
+                oldNodePointer = INT_MAX;
+            } else {
+                oldNodePointer = INT_MAX;
+                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+            }
+            return 0;
+        }
+
+        if(!node.checkIfUnderUtilized()) {
+            oldNodePointer = INT_MAX;
+            ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+            return 0;
+        }
+
+        /* Only leaves of the same parent are merged, the leaf removed from the parent is freed */
+        void* mergeWith = malloc(PAGE_SIZE);
+        /*Check if the node is the last node*/
+        if(parentSibling == INT_MAX && parentPrevSibling != INT_MAX) {
+            ixFileHandle.readPage(parentPrevSibling, mergeWith);
+            LeafNode lNode(mergeWith);
+            if(lNode.canMerge(node)) {
+                lNode.mergeNodes(indexType, node);
+                lNode.setSibling(node.getSibling());
+                oldNodePointer = -1;
+                ixFileHandle.writePage(lNode.getPageNum(), lNode.getWritableData());
+                ixFileHandle.freePage(node.getPageNum());
+                free(mergeWith);
+                return 0;
+            }
+        } else if(parentSibling != INT_MAX) {
+            ixFileHandle.readPage(parentSibling, mergeWith);
+            LeafNode lNode(mergeWith);
+            /* Merge with sibling node */
+            if(lNode.canMerge(node)) {
+                node.mergeNodes(indexType, lNode);
+                node.setSibling(lNode.getSibling());
+                oldNodePointer = -1;
+                ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+                ixFileHandle.freePage(parentSibling);
+                free(mergeWith);
+                return 0;
+            /* if merge with sibling not possible try to merge with previous node */
+            } else if(parentPrevSibling != INT_MAX) {
+                ixFileHandle.readPage(parentPrevSibling, mergeWith);
+                LeafNode lNode(mergeWith);
+                if(lNode.canMerge(node)) {
+                    lNode.mergeNodes(indexType, node);
+                    lNode.setSibling(node.getSibling());
+                    oldNodePointer = -1;
+                    ixFileHandle.writePage(lNode.getPageNum(), lNode.getWritableData());
+                    ixFileHandle.freePage(node.getPageNum());
+                    free(mergeWith);
+                    return 0;
+                }
+            }
+        }
+        /* merge is required but not possible, do a lazy deletion */
+        oldNodePointer = INT_MAX;
+        ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
+        free(mergeWith);
+        return 0;
+    }
+}
+
+RC IndexManager::scan(IXFileHandle &ixFileHandle,
+                      const Attribute &attribute,
+                      const void *lowKey,
+                      const void *highKey,
+                      bool lowKeyInclusive,
+                      bool highKeyInclusive,
+                      IX_ScanIterator &ix_ScanIterator) {
+
+    
+    return ix_ScanIterator.initializeScanIterator(ixFileHandle, attribute,
+                           lowKey, highKey, lowKeyInclusive,
+                           highKeyInclusive);
+}
+
+/**
+ * compactFile() - rebuild the BTree of an index file with full nodes in key order.
+ * @argument1 : ixfilehandle of the open index file, reopened on the compacted file.
+ * @argument2 : attribute on which the index exists.
+ * @argument3 : fraction of the leaves and internal nodes filled by the rebuild.
+ *
+ * The entries are scanned in order into a bulk load of a new file, which then replaces
+ * the index file. Merged and freed pages are dropped and the leaves are contiguous again.
+ * Scans open on the file have to be restarted and no other thread may use the file meanwhile.
+ * A hash index has no nodes to refill, the splits already free its overflow pages.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::compactFile(IXFileHandle &ixFileHandle, const Attribute &attribute, const float fillFactor) {
+    if(!ixFileHandle.isOpen() || ixFileHandle.isHashIndex()) return -1;
+    std::string fileName = ixFileHandle.fileName;
+    std::string compactFileName = fileName + ".compact";
+    remove(compactFileName.c_str());
+    if(createFile(compactFileName, ixFileHandle.hasPostingLists(), ixFileHandle.hasIncludePayload()) == -1) {
+        return -1;
+    }
+    IXFileHandle compactHandle;
+    if(openFile(compactFileName, compactHandle) == -1) {
+        destroyFile(compactFileName);
+        return -1;
+    }
+
+    IX_BulkLoader bulkLoader;
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = bulkLoader.initialize(compactHandle, attribute, fillFactor);
+    if(rc == 0) rc = scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    if(rc == 0) {
+        RID rid;
+        void* key = malloc(PAGE_SIZE);
+        while(rc == 0 && ix_ScanIterator.getNextEntry(rid, key) != IX_EOF) {
+            rc = bulkLoader.addEntry(key, rid);
+        }
+        free(key);
+        ix_ScanIterator.close();
+    }
+    if(rc == 0) rc = bulkLoader.finish();
+    closeFile(compactHandle);
+    BufferManager::instance().dropFile(compactFileName);
+    if(rc != 0) {
+        destroyFile(compactFileName);
+        return -1;
+    }
+
+    /* the cached pages of the old file are dropped before the new file takes its name */
+    if(closeFile(ixFileHandle) == -1) return -1;
+    BufferManager::instance().dropFile(fileName);
+    if(rename(compactFileName.c_str(), fileName.c_str()) != 0) return -1;
+    return openFile(fileName, ixFileHandle);
+}
+
+/**
+* printBtree() : prints the Btree in JSON format.
+* @argument1 : ixFileHanlde for the BTree file.
+* @argument2 : attribute on which the index exists.
+*
+* Return : void.
+*/
+void IndexManager::printBtree(IXFileHandle &ixFileHandle, const Attribute &attribute) const {
+    SharedLatchGuard guard(ixFileHandle.getLatch());
+    int root = ixFileHandle.getRoot();
+    if(root == INT_MAX) return;
+
+    void* data = malloc(PAGE_SIZE);
+    ixFileHandle.readPage(root, data);
+
+    RTS indexType = ixFileHandle.getIndexType(attribute);
+
+    if (ixFileHandle.getNodeType(data) == LEAF) {
+        LeafNode lNode(data);
+        depthFirstTraversal(ixFileHandle, indexType, lNode);
+    } else {
+        InternalNode intNode(data);
+        depthFirstTraversal(ixFileHandle, indexType, intNode);
+    }
+
+   free(data);
+   return;
+}
+
+/**
+* printBtree() : depth first traversal of Btree to print.
+* @argument1 : ixFileHanlde for the BTree file.
+* @argument2 : type of the keys present in the node.
+* @argument3 : attribute on which the index exists.
+*
+* Return : void.
+*/
+void IndexManager::depthFirstTraversal(IXFileHandle &ixFileHandle, const RTS indexType, Node& node) const {
+
+    if(node.getNodeType() == INTERNAL) {
+        std::cout<<"{"<<std::endl;
+        std::cout<<"\"keys\":";
+        node.printKeys(indexType);
+        std::cout<<endl;
+        std::cout<<"\"children\":["<<std::endl;
+        vector<int> children;
+        node.getAllPagePointers(indexType, children);
+
+        void* data = malloc(PAGE_SIZE); 
+        for(RTS i = 0 ; i < (RTS)children.size(); i++) {
+            ixFileHandle.readPage(children[i], data);
+            if(ixFileHandle.getNodeType(data) == INTERNAL) {
+                if(i != 0)
+                    std::cout<<","<<endl;
+                InternalNode intNode(data);
+                depthFirstTraversal(ixFileHandle, indexType, intNode);
+            } else {
+                LeafNode lNode(data);
+                if(i != 0) {
+                    std::cout<<","<<endl;
+                }
+                std::cout<<"{";
+                std::cout<<"\"keys\":";
+                lNode.printKeys(indexType);
+                std::cout<<"}";
+            }
+        }
+        free(data);
+        std::cout<<"]"<<std::endl;
+        std::cout<<"}";
+    } else {
+       std::cout<<"{"<<std::endl;
+       std::cout<<"\"keys\":";
+       node.printKeys(indexType);
+       std::cout<<"}";
+    }
+}
+
+/**
+ * encodeOrderedBytes() - write 4 bytes big endian, so that their unsigned order is the order of the value.
+ * @argument1 : value with the sign bit already adjusted.
+ * @argument2 : buffer to write to.
+ *
+ * Return : void.
+*/
+static void encodeOrderedBytes(unsigned value, unsigned char* buffer) {
+    for(int i = 0; i < (int)sizeof(unsigned); i++) {
+        buffer[i] = (value >> (8*(sizeof(unsigned) - 1 - i))) & 0xFF;
+    }
+}
+
+/**
+ * encodeCompositeKey() - encode the columns of a multi-column key into one VarChar key.
+ * @argument1 : columns of the key in index order, a prefix of them for a range bound.
+ * @argument2 : tuple with the columns of argument1, in the insertTuple() format.
+ * @argument3 : VarChar key (out parameter).
+ * @argument4 : end the key with a byte above every column marker, the key then sorts after
+ *              every key starting with these columns.
+ *
+ * Each column is a marker byte, 0 for NULL and 1 otherwise, followed by bytes whose unsigned order is
+ * the order of the values. Int and Real are stored big endian with the sign bit flipped, and all the bits
+ * of a negative Real, -0.0 is stored as 0.0. VarChar bytes have 0x00 escaped as 0x00 0xFF and end with 0x00 0x00. Comparing the
+ * keys bytewise and then by length, as the B+ tree does for VarChar, orders them column by column, and
+ * the key of a prefix of the columns sorts before every key starting with it.
+ *
+ * Return : length of the key, with the length field.
+*/
+int IndexManager::encodeCompositeKey(const std::vector<Attribute> &keyAttrs, const void *tuple, void *key,
+                                     const bool prefixEnd) const {
+    int nullBytes = ceil((double)keyAttrs.size()/CHAR_BIT);
+    const unsigned char* nullIndicator = (const unsigned char*)tuple;
+    const char* field = (const char*)tuple + nullBytes;
+    unsigned char* out = (unsigned char*)key + sizeof(int);
+    int len = 0;
+
+    for(int i = 0; i < (int)keyAttrs.size(); i++) {
+        if(nullIndicator[i/CHAR_BIT] & (1 << (7 - i%CHAR_BIT))) {
+            out[len++] = 0;
+            continue;
+        }
+        out[len++] = 1;
+        if(keyAttrs[i].type == TypeInt) {
+            unsigned value = 0;
+            memcpy((char*)&value, field, sizeof(int));
+            encodeOrderedBytes(value ^ 0x80000000u, out + len);
+            len += sizeof(int);
+            field += sizeof(int);
+        } else if(keyAttrs[i].type == TypeReal) {
+            unsigned value = 0;
+            memcpy((char*)&value, field, sizeof(float));
+            // -0.0 equals 0.0, both get the bits of 0.0
+            if(value == 0x80000000u) value = 0;
+            encodeOrderedBytes((value & 0x80000000u) ? ~value : (value ^ 0x80000000u), out + len);
+            len += sizeof(float);
+            field += sizeof(float);
+        } else {
+            int strLen = 0;
+            memcpy((char*)&strLen, field, sizeof(int));
+            const char* str = field + sizeof(int);
+            for(int j = 0; j < strLen; j++) {
+                out[len++] = str[j];
+                if(str[j] == 0) out[len++] = 0xFF;
+            }
+            out[len++] = 0;
+            out[len++] = 0;
+            field += sizeof(int) + strLen;
+        }
+    }
+    if(prefixEnd) out[len++] = 0xFF;
+    memcpy((char*)key, (char*)&len, sizeof(int));
+    return len + sizeof(int);
+}
+
+/**
+ * getCompositeKeyAttribute() - get the VarChar attribute under which a multi-column key is indexed.
+ * @argument1 : columns of the key in index order.
+ *
+ * Return : attribute with the largest length of an encoded key.
+*/
+Attribute IndexManager::getCompositeKeyAttribute(const std::vector<Attribute> &keyAttrs) const {
+    Attribute attr;
+    attr.type = TypeVarChar;
+    attr.length = 1;
+    for(auto keyAttr : keyAttrs) {
+        attr.name += (attr.name.empty() ? "" : "+") + keyAttr.name;
+        attr.length += 1 + (keyAttr.type == TypeVarChar ? 2*keyAttr.length + 2 : sizeof(int));
+    }
+    return attr;
+}
+
+/**
+ * getKeyFilter() - get a copy of the Bloom filter of the keys in an index.
+ * @argument1 : ixfilehandle of the open index file.
+ * @argument2 : attribute on which the index exists.
+ * @argument3 : filter (out parameter).
+ *
+ * The first call reads every entry into a filter sized for them, without holding the latch
+ * alone meanwhile: keys inserted during the scan are added once it is done. The filter is
+ * then kept by the inserts and saved in the file, deletes leave their keys in it. A filter
+ * which outgrew its size is dropped by the inserts and built again by the next call.
+ *
+ * Return : 0 on success, -1 on fail or while another thread builds the filter.
+*/
+RC IndexManager::getKeyFilter(IXFileHandle &ixFileHandle, const Attribute &attribute, BloomFilter &filter) {
+    if(!ixFileHandle.isOpen()) return -1;
+    {
+        std::lock_guard<SharedLatch> guard(ixFileHandle.getLatch());
+        if(ixFileHandle.hasKeyFilter()) {
+            filter = ixFileHandle.getKeyFilter();
+            return 0;
+        }
+        if(!ixFileHandle.startKeyFilter()) return -1;
+    }
+
+    std::vector<unsigned long long> hashes;
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    if(rc == 0) {
+        RID rid;
+        void* key = malloc(PAGE_SIZE);
+        while(ix_ScanIterator.getNextEntry(rid, key) != IX_EOF) {
+            unsigned long long hash = BloomFilter::hashValue(attribute.type, key);
+            // the rids of a key come one after the other in a BTree
+            if(hashes.empty() || hashes.back() != hash) hashes.push_back(hash);
+        }
+        free(key);
+        ix_ScanIterator.close();
+    }
+
+    std::lock_guard<SharedLatch> guard(ixFileHandle.getLatch());
+    ixFileHandle.finishKeyFilter(hashes, rc == 0);
+    if(rc == 0) filter = ixFileHandle.getKeyFilter();
+    return rc;
+}
+
+/**
+ * getTreeShape() - get the height and the number of leaf pages of an index.
+ * @argument1 : ixfilehandle of the open index file.
+ * @argument2 : attribute on which the index exists.
+ * @argument3 : number of levels from the root to the leaves (out parameter).
+ * @argument4 : number of pages on the leaf level (out parameter).
+ *
+ * The leftmost path gives the height, the sibling chain the leaves. Posting pages are not
+ * counted as leaves. A hash index reports one level made of its buckets, an empty tree 0 and 0.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IndexManager::getTreeShape(IXFileHandle &ixFileHandle, const Attribute &attribute, int &height, int &leafPages) {
+    if(!ixFileHandle.isOpen()) return -1;
+    SharedLatchGuard guard(ixFileHandle.getLatch());
+    height = 0;
+    leafPages = 0;
+    if(ixFileHandle.isHashIndex()) {
+        height = 1;
+        leafPages = ixFileHandle.getNumberOfBuckets();
+        return 0;
+    }
+
+    int pageNum = ixFileHandle.getRoot();
+    if(pageNum == INT_MAX) return 0;
+
+    RTS indexType = ixFileHandle.getIndexType(attribute);
+    void* data = malloc(PAGE_SIZE);
+    RC rc = 0;
+    while(rc == 0) {
+        rc = ixFileHandle.readPage(pageNum, data);
+        if(rc != 0) break;
+        height++;
+        if(ixFileHandle.getNodeType(data) != INTERNAL) break;
+        vector<int> children;
+        InternalNode(data).getAllPagePointers(indexType, children);
+        if(children.empty()) rc = -1;
+        else pageNum = children[0];
+    }
+
+    while(rc == 0 && pageNum != INT_MAX) {
+        leafPages++;
+        pageNum = LeafNode(data).getSibling();
+        if(pageNum != INT_MAX) rc = ixFileHandle.readPage(pageNum, data);
+    }
+
+    free(data);
+    return rc == 0 ? 0 : -1;
+}
+
+/**
+ * setDeltaBuffer() - hold the inserts and deletes of an index in memory.
+ * @argument1 : ixfilehandle of the open index file.
+ * @argument2 : attribute on which the index exists.
+ * @argument3 : number of changes held before they are merged into the tree, 0 turns the buffer off.
+ *
+ * The changes are kept sorted on the key and the rid. A merge applies them in that order, so
+ * the leaves are visited one after the other and stay in the buffer pool between their entries
+ * instead of one random descent per change. The buffer is merged when the file is closed and is
+ * not kept by the file, it has to be set again after a reopen. Hash indexes and indexes with
+ * posting lists or INCLUDE columns have no delta buffer.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::setDeltaBuffer(IXFileHandle &ixFileHandle, const Attribute &attribute, const unsigned capacity) {
+    if(!ixFileHandle.isOpen() || ixFileHandle.isHashIndex() || ixFileHandle.hasPostingLists() ||
+       ixFileHandle.hasIncludePayload()) {
+        return -1;
+    }
+    std::lock_guard<SharedLatch> guard(ixFileHandle.getLatch());
+    if(capacity == 0 && mergeDeltaBuffer(ixFileHandle) == -1) return -1;
+    ixFileHandle.setDeltaBuffer(capacity, ixFileHandle.getIndexType(attribute));
+    return 0;
+}
+
+/**
+ * flushDeltaBuffer() - merge the changes held by the delta buffer of an index into its tree.
+ * @argument1 : ixfilehandle of the open index file.
+ *
+ * Return : 0 on success, -1 on fail.
+*/
+RC IndexManager::flushDeltaBuffer(IXFileHandle &ixFileHandle) {
+    if(!ixFileHandle.isOpen()) return -1;
+    std::lock_guard<SharedLatch> guard(ixFileHandle.getLatch());
+    return mergeDeltaBuffer(ixFileHandle);
+}
+
+/**
+ * mergeDeltaBuffer() - apply the changes held by the delta buffer to the tree, in key order.
+ * @argument1 : ixfilehandle having the Btree details, its latch is held alone.
+ *
+ * Every held change leaves the buffer, a failed one does not stop the others.
+ *
+ * Return : 0 on success, -1 if a change could not be applied.
+*/
+RC IndexManager::mergeDeltaBuffer(IXFileHandle& ixFileHandle) {
+    std::map<CompositeKey, int>& deltaEntries = ixFileHandle.getDeltaEntries();
+    RTS indexType = ixFileHandle.getDeltaIndexType();
+    RC rc = 0;
+    for(auto itr = deltaEntries.begin(); itr != deltaEntries.end(); itr = deltaEntries.erase(itr)) {
+        CompositeKey entry = itr->first;
+        if(itr->second < 0 && deleteFromTree(ixFileHandle, indexType, entry) == -1) rc = -1;
+        for(int i = 0; i < itr->second; i++) {
+            if(insertIntoTree(ixFileHandle, indexType, entry) == -1) rc = -1;
+        }
+    }
+    return rc;
+}
+
+/**
+ * isEntryInTree() - check if an entry is in the BTree of an index.
+ * @argument1 : ixfilehandle having the Btree details, its latch is held alone.
+ * @argument2 : type of the keys present in the node.
+ * @argument3 : key value and rid of the entry.
+ *
+ * Return : true if the leaf of the entry holds it.
+*/
+bool IndexManager::isEntryInTree(IXFileHandle& ixFileHandle, const RTS indexType, const CompositeKey& entry) {
+    TreePath& path = ixFileHandle.getPath();
+    if(ixFileHandle.getRoot() == INT_MAX || path.descend(ixFileHandle, indexType, entry) == -1) return false;
+    return LeafNode(path.getPage(path.depth - 1)).findKeyOffset(indexType, entry) != -1;
+}
+
+IX_ScanIterator::IX_ScanIterator() {
+    this->data = NULL;
+    this->dataPage = -1;
+    this->nextSlot = 0;
+    this->postingPos = 0;
+    this->hashBucket = -1;
+    this->hashProbe = false;
+    this->bucketPos = 0;
+    this->started = false;
+    this->treePending = false;
+    this->treeDone = false;
+    this->merging = false;
+}
+
+IX_ScanIterator::~IX_ScanIterator() {
+}
+
+/**
+* initializeScanIterator() : initialization of index scan iterator.
+* @argument1 : ixFileHanlde for the BTree file.
+* @argument2 : attribute on which the index exists.
+* @argument3 : low key for scan.
+* @argument4 : high key for scan.
+* @argument5 : wether to include lowKey or not.
+* @argument6 : wether to include high key.
+
+*
+* Return : 0 on successful initialization, -1 of fail.
+*/
+RC IX_ScanIterator::initializeScanIterator(IXFileHandle& ixFileHandle, const Attribute& attribute,
+                                          const void* lowKey, const void* highKey, bool lowKeyInclusive,
+                                          bool highKeyInclusive) {
+
+    if(!ixFileHandle.isOpen()) return -1;
+    this->ixFileHandle = &ixFileHandle;
+    this->indexType = ixFileHandle.getIndexType(attribute);
+
+    initComparisonKeys(lowKey, highKey, lowKeyInclusive, highKeyInclusive);
+
+    /* A hash index reads the bucket of the key of an equality scan, else every bucket */
+    this->bucketEntries.clear();
+    this->bucketPos = 0;
+    if(ixFileHandle.isHashIndex()) {
+        this->hashBucket = 0;
+        this->hashProbe = lowKey != NULL && highKey != NULL && lowKeyInclusive && highKeyInclusive &&
+                          compareKeyValues(this->indexType, (const char*)lowKey, (const char*)highKey) == 0;
+        this->lastPageNum = INT_MAX;
+        data = NULL;
+        return 0;
+    }
+    this->hashBucket = -1;
+
+    /* Initialize first scan entry */
+    /*get the first node( or page) */
+    SharedLatchGuard guard(ixFileHandle.getLatch());
+    // taken before the pages are read, a leaf changed meanwhile shows as a new version
+    this->version = ixFileHandle.getVersion();
+    this->lastPageNum = searchNode(indexType, lowCKey);
+    this->dataPage = -1;
+    this->nextSlot = 0;
+    this->postingRids.clear();
+    this->postingPos = 0;
+    this->merging = false;
+    data = malloc(PAGE_SIZE);
+    return 0;
+}
+
+/**
+* initComparisonKeys() : initialize comparsion keys.
+* @argument1 : low key for scan.
+* @argument2 : high key for scan.
+* @argument3 : wether to include lowKey or not.
+* @argument4 : wether to include high key.
+
+*
+* Return : 0 on successful initialization, -1 of fail.
+*/
+void IX_ScanIterator::initComparisonKeys(const void* lowKey, const void* highKey, 
+                                         bool lowKeyInclusive, bool highKeyInclusive) {
+    if(lowKey != NULL) {
+    /* Equality included */
+        if(lowKeyInclusive) {
+            RID r;
+            /* By this, the comparator enforces equality */
+            r.pageNum = INT_MAX;
+            r.slotNum = 0;
+            CompositeKey low(getValueType(this->indexType), lowKey, r);
+            this->lowCKey = low;
+        } else {
+            /* NO equality */
+            RID r;
+            /*can be anything */
+            r.pageNum = INT_MAX;
+            /*can be anything but 0 */
+            r.slotNum = USHRT_MAX;
+            CompositeKey low(getValueType(this->indexType), lowKey, r);
+            this->lowCKey = low;
+        }
+    }
+
+    if(highKey != NULL) {
+        if(highKeyInclusive) {
+            RID r;
+            /* By this comparator enforces equality */
+            r.pageNum = INT_MAX;
+            r.slotNum = 0;
+            CompositeKey high(getValueType(this->indexType), highKey, r);
+            this->highCKey = high;
+        } else {
+            /* NO euqlity */
+            RID r;
+            /*can be anything */
+            r.pageNum = INT_MAX;
+            /*can be anything but 0 */
+            r.slotNum = USHRT_MAX;
+            CompositeKey high(getValueType(this->indexType), highKey, r);
+            this->highCKey = high;
+       }
+    }
+    return;
+}
+
+/**
+* searchNode() : find the leaf in which a key is or would be.
+* @argument1 : type of the keys present in the node.
+* @argument2 : key to be searched.
+*
+* The descent reuses the page buffers of the path of the iterator.
+*
+* Return : page number of the leaf, -1 if the BTree is empty.
+*/
+RC IX_ScanIterator::searchNode(const RTS indexType, const CompositeKey& lowKey) {
+    if(this->path.descend(*this->ixFileHandle, indexType, lowKey) == -1) return -1;
+    return this->path.getLeaf();
+}
+
+/**
+* getNextNonEmptySibling() : move the cursor to the next non empty leaf after the one in the buffer.
+* @argument1 : buffer holding the current leaf, gets the leaf moved to (in/out parameter).
+*
+* Return : page number of the leaf moved to, INT_MAX if no sibling found.
+*/
+RC IX_ScanIterator::getNextNonEmptySibling(void* data) {
+    LeafNode currNode(data);
+    int sibling = currNode.getSibling();
+    while(sibling != INT_MAX) {
+        this->ixFileHandle->readPage(sibling, data);
+        this->dataPage = sibling;
+        LeafNode lNode(data);
+        if(lNode.getEntries() != 0) return sibling;
+        sibling = lNode.getSibling();
+    }
+    return INT_MAX;
+}
+
+
+/**
+* getNextEntry() : get the next <key, rid> pair using iterator.
+* @argument1 : rid to be returned (out parameter).
+* @argument2 : buffer to return key (out parameter).
+*
+* Once the index has a delta buffer the entries of the BTree are merged with the changes it holds.
+*
+* Return : IX_EOF if reached EOF, 0 otherwise.
+*/
+RC IX_ScanIterator::getNextEntry(RID &rid, void *key) {
+    if(this->hashBucket != -1) return getNextHashEntry(rid, key);
+
+    if(!this->merging) {
+        {
+            SharedLatchGuard guard(this->ixFileHandle->getLatch());
+            this->merging = this->ixFileHandle->hasDeltaBuffer();
+        }
+        if(!this->merging) return getNextTreeEntry(rid, key);
+        // the scan goes on from the entries not returned yet
+        this->startCKey = this->lowCKey;
+        this->started = false;
+        this->treePending = false;
+        this->treeDone = false;
+    }
+    return getNextMergedEntry(rid, key);
+}
+
+/**
+* getNextTreeEntry() : get the next <key, rid> pair of the BTree.
+* @argument1 : rid to be returned (out parameter).
+* @argument2 : buffer to return key (out parameter).
+*
+* The cursor keeps the leaf and the slot of the next entry and advances in place.
+* The B+ tree is searched for lowKey again only when it was changed since the last call.
+* No latch is held between the calls, inserts and deletes of other threads run in between.
+*
+* Return : IX_EOF if reached EOF, 0 otherwise.
+*/
+RC IX_ScanIterator::getNextTreeEntry(RID &rid, void *key) {
+    // rids left in the posting list of the last key
+    if(this->postingPos < this->postingRids.size()) {
+        rid = this->postingRids[this->postingPos++];
+        memcpy((char*)key, (char*)(this->nextCKey.getWritableKey()), this->nextCKey.getView().keyLen);
+        return 0;
+    }
+
+    //all pages scanned
+    if(this->lastPageNum == INT_MAX || this->lastPageNum == -1) return IX_EOF;
+
+    SharedLatchGuard guard(this->ixFileHandle->getLatch());
+    /* Tree changed under the cursor, the leaf may have been split, merged or freed */
+    if(this->version != this->ixFileHandle->getVersion()) {
+        this->version = this->ixFileHandle->getVersion();
+        this->lastPageNum = searchNode(indexType, this->lowCKey);
+        this->dataPage = -1;
+    }
+
+    LeafNode lNode(data);
+    RTS slot = this->nextSlot;
+    if(this->dataPage != this->lastPageNum) {
+        this->ixFileHandle->readPage(this->lastPageNum, data);
+        this->dataPage = this->lastPageNum;
+        slot = lNode.findKeySlot(this->indexType, this->lowCKey);
+    }
+
+    // Page is completely scanned
+    while(slot == lNode.getEntries()) {
+        this->lastPageNum = getNextNonEmptySibling(data);
+        /* NO sibling EOF */
+        if(this->lastPageNum == INT_MAX) {
+            return IX_EOF;
+        }
+        slot = lNode.findKeySlot(this->indexType, this->lowCKey);
+    }
+
+    CompositeKey& newKey = this->nextCKey;
+    lNode.getKeyFromOffset(this->indexType, lNode.getKeySlotOffset(slot), newKey);
+    this->nextSlot = slot + 1;
+
+    /* A posting list returns all the rids of its key, the scan goes on after the key */
+    if(isPostingList(newKey.getRID())) {
+        this->lowCKey.updatePageNum(INT_MAX);
+        this->lowCKey.updateSlotNum(USHRT_MAX);
+        if(!(this->highCKey >= newKey)) return IX_EOF;
+
+        this->postingRids.clear();
+        this->postingPos = 0;
+        if(this->ixFileHandle->readPostingList(newKey.getView(), this->postingRids) == -1) return IX_EOF;
+        rid = this->postingRids[this->postingPos++];
+        memcpy((char*)key, (char*)(newKey.getWritableKey()), newKey.getView().keyLen);
+        return 0;
+    }
+
+    setLowKeyAfter(newKey);
+
+    if(this->highCKey >= newKey) {
+        rid = newKey.getRID();
+        KeyView view = newKey.getView();
+        memcpy((char*)key, (char*)(newKey.getWritableKey()), view.keyLen);
+        // the INCLUDE columns follow the key value
+        memcpy((char*)key + view.keyLen, view.getPayload(), view.payloadSize);
+        return 0;
+    }
+
+    return IX_EOF;
+}
+
+/**
+* getNextMergedEntry() : get the next <key, rid> pair of the BTree and of the delta buffer.
+* @argument1 : rid to be returned (out parameter).
+* @argument2 : buffer to return key (out parameter).
+*
+* The next entry of the BTree is kept while the changes held before it are returned. An entry
+* deleted by the delta buffer is skipped. A merge of the delta buffer changes the version of the
+* BTree, its scan starts again after the last entry returned.
+*
+* Return : IX_EOF if reached EOF, 0 otherwise.
+*/
+RC IX_ScanIterator::getNextMergedEntry(RID &rid, void *key) {
+    while(true) {
+        bool changed = false;
+        {
+            SharedLatchGuard guard(this->ixFileHandle->getLatch());
+            changed = this->version != this->ixFileHandle->getVersion();
+        }
+        if(changed) restartTreeScan();
+
+        if(!this->treePending && !this->treeDone) {
+            if(getNextTreeEntry(rid, key) == IX_EOF) {
+                this->treeDone = true;
+            } else {
+                this->treeCKey = this->nextCKey;
+                this->treePending = true;
+            }
+        }
+
+        CompositeKey deltaCKey;
+        int change = 0;
+        bool hasDelta = false;
+        {
+            SharedLatchGuard guard(this->ixFileHandle->getLatch());
+            if(this->version != this->ixFileHandle->getVersion()) continue;
+            hasDelta = this->ixFileHandle->getNextDeltaEntry(this->startCKey, !this->started, deltaCKey, change) &&
+                       this->highCKey >= deltaCKey;
+        }
+        if(!this->treePending && !hasDelta) return IX_EOF;
+
+        CompositeKey* entry = &deltaCKey;
+        if(this->treePending && (!hasDelta || this->treeCKey <= deltaCKey)) {
+            this->treePending = false;
+            // the entry of the tree is skipped if the delta buffer holds its delete
+            change = hasDelta && this->treeCKey == deltaCKey && change < 0 ? -1 : 1;
+            entry = &this->treeCKey;
+        }
+        this->startCKey = *entry;
+        this->started = true;
+        if(change < 0) continue;
+
+        rid = entry->getRID();
+        KeyView view = entry->getView();
+        memcpy((char*)key, (char*)(entry->getWritableKey()), view.keyLen);
+        memcpy((char*)key + view.keyLen, view.getPayload(), view.payloadSize);
+        return 0;
+    }
+}
+
+/**
+* setLowKeyAfter() : make the low key of the cursor the first entry after a given one.
+* @argument1 : entry of the BTree.
+*
+* Return : void.
+*/
+void IX_ScanIterator::setLowKeyAfter(const CompositeKey& entry) {
+    this->lowCKey = entry;
+    if(entry.getRID().slotNum == USHRT_MAX) {
+        this->lowCKey.updatePageNum(entry.getRID().pageNum + 1);
+    } else {
+        this->lowCKey.updateSlotNum(entry.getRID().slotNum + 1);
+    }
+}
+
+/**
+* restartTreeScan() : search the BTree again for the entries after the last one returned.
+*
+* Return : void.
+*/
+void IX_ScanIterator::restartTreeScan() {
+    if(this->started) setLowKeyAfter(this->startCKey);
+    else this->lowCKey = this->startCKey;
+    SharedLatchGuard guard(this->ixFileHandle->getLatch());
+    this->version = this->ixFileHandle->getVersion();
+    this->lastPageNum = searchNode(this->indexType, this->lowCKey);
+    this->dataPage = -1;
+    this->nextSlot = 0;
+    this->treePending = false;
+    this->treeDone = false;
+}
+
+/**
+* getNextHashEntry() : get the next <key, rid> pair of a scan of a hash index.
+* @argument1 : rid to be returned (out parameter).
+* @argument2 : buffer to return key (out parameter).
+*
+* The matching entries of a bucket are read at once under the latch and returned one by one.
+* The bucket of an equality scan is found when it is read, after the splits done meanwhile.
+* Entries moved by a split during a scan of every bucket may be missed or returned twice.
+*
+* Return : IX_EOF if reached EOF, 0 otherwise.
+*/
+RC IX_ScanIterator::getNextHashEntry(RID &rid, void *key) {
+    while(this->bucketPos == this->bucketEntries.size()) {
+        this->bucketEntries.clear();
+        this->bucketPos = 0;
+        SharedLatchGuard guard(this->ixFileHandle->getLatch());
+        if(this->hashProbe ? this->hashBucket > 0 : this->hashBucket >= this->ixFileHandle->getNumberOfBuckets()) {
+            return IX_EOF;
+        }
+        int bucket = this->hashProbe ? this->ixFileHandle->getHashBucket(this->indexType, this->lowCKey.getView())
+                                     : this->hashBucket;
+        if(this->ixFileHandle->readBucket(this->indexType, bucket, this->lowCKey, this->highCKey,
+                                          this->bucketEntries) == -1) {
+            return IX_EOF;
+        }
+        this->hashBucket++;
+    }
+
+    CompositeKey& entry = this->bucketEntries[this->bucketPos++];
+    rid = entry.getRID();
+    memcpy((char*)key, (char*)(entry.getWritableKey()), entry.getView().keyLen);
+    return 0;
+}
+
+RC IX_ScanIterator::close() {
+    CompositeKey nullKey;
+    this->lastPageNum = INT_MAX;
+    this->lowCKey = nullKey;
+    this->highCKey = nullKey;
+    this->nextCKey = nullKey;
+    this->dataPage = -1;
+    this->nextSlot = 0;
+    this->postingRids.clear();
+    this->postingPos = 0;
+    this->hashBucket = -1;
+    this->bucketEntries.clear();
+    this->bucketPos = 0;
+    this->startCKey = nullKey;
+    this->treeCKey = nullKey;
+    this->started = false;
+    this->treePending = false;
+    this->treeDone = false;
+    this->merging = false;
+    if(data != NULL) {
+        free(data);
+    }
+    data = NULL;
+    return 0;
+}
+
+IX_BulkLoader::IX_BulkLoader() {
+    this->ixFileHandle = NULL;
+    this->leafData = NULL;
+    this->leafKeySpace = 0;
+    this->lastLeaf = -1;
+}
+
+IX_BulkLoader::~IX_BulkLoader() {
+    if(this->leafData != NULL) {
+        free(this->leafData);
+    }
+    for(unsigned i = 0; i < this->runFiles.size(); i++) {
+        remove(this->runFiles[i].c_str());
+    }
+}
+
+/**
+ * initialize() - prepares a bulk load into an empty index.
+ * @argument1 : handle of the open index file.
+ * @argument2 : attribute on which the index is built.
+ * @argument3 : fraction of each node to fill, the rest is left for later inserts.
+ * @argument4 : bytes of entries sorted in memory before a sorted run is spilled to disk.
+ *
+ * Return : 0 on success, -1 if the index is not open or not empty.
+*/
+RC IX_BulkLoader::initialize(IXFileHandle& ixFileHandle, const Attribute& attribute,
+                             const float fillFactor, const unsigned bufferSize) {
+    // a hash index has no key order to build bottom up
+    if(!ixFileHandle.isOpen() || ixFileHandle.getRoot() != INT_MAX || ixFileHandle.isHashIndex()) {
+        return -1;
+    }
+    if(fillFactor <= 0 || fillFactor > 1) {
+        return -1;
+    }
+    this->ixFileHandle = &ixFileHandle;
+    this->indexType = ixFileHandle.getIndexType(attribute);
+    this->fillFactor = fillFactor;
+    this->bufferSize = bufferSize;
+    this->entries.clear();
+    this->entryOffsets.clear();
+    this->leafEntries.clear();
+    this->leafOffsets.clear();
+    this->leafKeySpace = 0;
+    this->children.clear();
+    this->separators.clear();
+    this->lastLeaf = -1;
+    this->groupRids.clear();
+    return 0;
+}
+
+/**
+ * addEntry() - buffers a <key, rid> entry, spills a sorted run when the buffer is full.
+ * @argument1 : key in the record format (length prefixed for VarChar), followed by the
+ *              INCLUDE columns if the index has them.
+ * @argument2 : rid of the record.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::addEntry(const void* key, const RID& rid) {
+    if(this->ixFileHandle == NULL) {
+        return -1;
+    }
+    int keyLen = sizeof(int);
+    if(getValueType(this->indexType) == TypeVarChar) {
+        int len = 0;
+        memcpy((char*)&len, key, sizeof(int));
+        keyLen += len;
+    }
+    RTS payloadSize = 0;
+    if(this->indexType & INCLUDE_PAYLOAD) {
+        memcpy((char*)&payloadSize, (char*)key + keyLen, sizeof(RTS));
+        payloadSize += sizeof(RTS);
+    }
+    unsigned offset = this->entries.size();
+    this->entries.resize(offset + keyLen + sizeof(int) + sizeof(RTS) + payloadSize);
+    memcpy(&this->entries[offset], key, keyLen);
+    memcpy(&this->entries[offset + keyLen], (char*)&rid.pageNum, sizeof(int));
+    memcpy(&this->entries[offset + keyLen + sizeof(int)], (char*)&rid.slotNum, sizeof(RTS));
+    memcpy(&this->entries[offset + keyLen + sizeof(int) + sizeof(RTS)], (char*)key + keyLen, payloadSize);
+    this->entryOffsets.push_back(offset);
+
+    if(this->entries.size() >= this->bufferSize) {
+        return this->spillRun();
+    }
+    return 0;
+}
+
+/**
+ * sortEntries() - sorts the buffered entries by <key, rid>.
+ *
+ * Return : void.
+*/
+void IX_BulkLoader::sortEntries() {
+    const char* base = this->entries.data();
+    RTS type = this->indexType;
+    std::sort(this->entryOffsets.begin(), this->entryOffsets.end(), [base, type](unsigned a, unsigned b) {
+        KeyView viewA(type, base + a), viewB(type, base + b);
+        int valueCmp = compareKeyValues(type, viewA.key, viewB.key);
+        if(valueCmp != 0) return valueCmp < 0;
+        return viewB.rid > viewA.rid;
+    });
+}
+
+/**
+ * spillRun() - sorts the buffered entries and writes them to a run file.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::spillRun() {
+    this->sortEntries();
+    std::string runFile = this->ixFileHandle->fileName + ".run" + std::to_string(this->runFiles.size());
+    std::ofstream run(runFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!run.is_open()) {
+        return -1;
+    }
+    this->runFiles.push_back(runFile);
+    for(unsigned i = 0; i < this->entryOffsets.size(); i++) {
+        KeyView entry(this->indexType, this->entries.data() + this->entryOffsets[i]);
+        run.write(entry.key, entry.getKeyLength());
+    }
+    run.close();
+    this->entries.clear();
+    this->entryOffsets.clear();
+    return run.fail() ? -1 : 0;
+}
+
+/**
+ * readRunEntry() - reads the next <key, rid> entry of a run file.
+ * @argument1 : run file.
+ * @argument2 : type of the key.
+ * @argument3 : buffer of PAGE_SIZE bytes for the entry.
+ *
+ * Return : true if an entry was read, false at the end of the run.
+*/
+static bool readRunEntry(std::ifstream& run, const RTS indexType, char* entry) {
+    int keyLen = sizeof(int);
+    if(!run.read(entry, sizeof(int))) {
+        return false;
+    }
+    if(getValueType(indexType) == TypeVarChar) {
+        int len = 0;
+        memcpy((char*)&len, entry, sizeof(int));
+        keyLen += len;
+    }
+    if(!run.read(entry + sizeof(int), keyLen - sizeof(int) + sizeof(int) + sizeof(RTS))) {
+        return false;
+    }
+    if(!(indexType & INCLUDE_PAYLOAD)) {
+        return true;
+    }
+    char* payload = entry + keyLen + sizeof(int) + sizeof(RTS);
+    RTS payloadLen = 0;
+    if(!run.read(payload, sizeof(RTS))) {
+        return false;
+    }
+    memcpy((char*)&payloadLen, payload, sizeof(RTS));
+    return (bool)run.read(payload + sizeof(RTS), payloadLen);
+}
+
+/**
+ * mergeRuns() - merges the sorted runs and fills the leaves in order.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::mergeRuns() {
+    unsigned numRuns = this->runFiles.size();
+    std::ifstream* runs = new std::ifstream[numRuns];
+    std::vector<char> heads(numRuns*PAGE_SIZE);
+    RTS type = this->indexType;
+    char* base = heads.data();
+
+    // min heap of runs ordered by their current entry
+    auto greater = [base, type](unsigned a, unsigned b) {
+        KeyView viewA(type, base + a*PAGE_SIZE), viewB(type, base + b*PAGE_SIZE);
+        int valueCmp = compareKeyValues(type, viewA.key, viewB.key);
+        if(valueCmp != 0) return valueCmp > 0;
+        return viewA.rid > viewB.rid;
+    };
+    std::priority_queue<unsigned, std::vector<unsigned>, decltype(greater)> queue(greater);
+
+    for(unsigned i = 0; i < numRuns; i++) {
+        runs[i].open(this->runFiles[i].c_str(), std::ios::in | std::ios::binary);
+        if(readRunEntry(runs[i], type, base + i*PAGE_SIZE)) {
+            queue.push(i);
+        }
+    }
+
+    RC rc = 0;
+    while(!queue.empty() && rc == 0) {
+        unsigned i = queue.top();
+        queue.pop();
+        rc = this->addSortedEntry(KeyView(type, base + i*PAGE_SIZE));
+        if(readRunEntry(runs[i], type, base + i*PAGE_SIZE)) {
+            queue.push(i);
+        }
+    }
+
+    for(unsigned i = 0; i < numRuns; i++) {
+        runs[i].close();
+        remove(this->runFiles[i].c_str());
+    }
+    delete[] runs;
+    this->runFiles.clear();
+    return rc;
+}
+
+/**
+ * addSortedEntry() - takes the next entry in sorted order, with posting lists the rids
+ *                    of a key are gathered and the key is added once all of them are seen.
+ * @argument1 : view of the <key, rid> entry.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::addSortedEntry(const KeyView& entry) {
+    if(!this->ixFileHandle->hasPostingLists()) {
+        return this->addToLeaf(entry);
+    }
+    if(!this->groupRids.empty() && compareKeyValues(this->indexType, this->groupKey.getView().key, entry.key) == 0) {
+        if(entry.rid != this->groupRids.back()) {
+            this->groupRids.push_back(entry.rid);
+        }
+        return 0;
+    }
+    if(this->flushGroup() == -1) {
+        return -1;
+    }
+    this->groupKey.assign(this->indexType, entry);
+    this->groupRids.push_back(entry.rid);
+    return 0;
+}
+
+/**
+ * flushGroup() - adds the gathered key to the current leaf, with a posting list
+ *                if it has more than one rid.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::flushGroup() {
+    if(this->groupRids.empty()) {
+        return 0;
+    }
+    if(this->groupRids.size() > 1 && this->ixFileHandle->buildPostingList(this->groupKey, this->groupRids) == -1) {
+        return -1;
+    }
+    this->groupRids.clear();
+    return this->addToLeaf(this->groupKey.getView());
+}
+
+/**
+ * addToLeaf() - appends the next entry in sorted order to the current leaf,
+ *               the leaf is written and a new one started once it is filled upto the fill factor.
+ * @argument1 : view of the <key, rid> entry.
+ *
+ * The space of a leaf counts its keys stored without their common prefix.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::addToLeaf(const KeyView& entry) {
+    int capacity = PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int);
+    int keySpace = this->leafKeySpace + entry.getKeyLength() + sizeof(RTS);
+    int numKeys = this->leafOffsets.size() + 1;
+    int prefixLen = 0;
+    if(getValueType(this->indexType) == TypeVarChar && numKeys > 1) {
+        prefixLen = getCommonPrefixLength(&this->leafEntries[this->leafOffsets[0]], entry.key);
+    }
+    int leafSpace = keySpace - (numKeys - 1)*prefixLen;
+    if(numKeys > 1 && (leafSpace > this->fillFactor*capacity || leafSpace > capacity)) {
+        if(this->flushLeaf(&entry) == -1) {
+            return -1;
+        }
+    }
+    this->leafOffsets.push_back(this->leafEntries.size());
+    this->leafEntries.insert(this->leafEntries.end(), entry.key, entry.key + entry.getKeyLength());
+    this->leafKeySpace += entry.getKeyLength() + sizeof(RTS);
+    return 0;
+}
+
+/**
+ * flushLeaf() - writes the current leaf and records it for the level above.
+ * @argument1 : first entry of the next leaf, NULL if no leaf follows this one.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::flushLeaf(const KeyView* nextEntry) {
+    if(this->leafData == NULL) {
+        this->leafData = malloc(PAGE_SIZE);
+    }
+    this->ixFileHandle->initPageDirectory(this->leafData, LEAF);
+    LeafNode leaf(this->leafData);
+    leaf.buildFromKeys(this->indexType, this->leafEntries, this->leafOffsets, 0, this->leafOffsets.size());
+
+    // posting pages appended since the previous leaf are between it and this leaf
+    if(this->lastLeaf != -1 && this->lastLeaf + 1 != leaf.getPageNum()) {
+        void* data = malloc(PAGE_SIZE);
+        this->ixFileHandle->readPage(this->lastLeaf, data);
+        LeafNode prevLeaf(data);
+        prevLeaf.setSibling(leaf.getPageNum());
+        RC rc = this->ixFileHandle->writePage(this->lastLeaf, data);
+        free(data);
+        if(rc == -1) {
+            return -1;
+        }
+    }
+    this->lastLeaf = leaf.getPageNum();
+
+    CompositeKey separator;
+    KeyView lastKey(this->indexType, &this->leafEntries[this->leafOffsets.back()]);
+    if(nextEntry != NULL) {
+        // leaves are appended one after the other, the next leaf is the next page
+        leaf.setSibling(leaf.getPageNum() + 1);
+        separator.assignSeparator(this->indexType, lastKey, *nextEntry);
+    } else {
+        separator.assign(this->indexType, lastKey);
+        separator.clearPayload();
+    }
+    if(this->ixFileHandle->hasPostingLists()) {
+        separator.setMatchAnyRID();
+    }
+    this->children.push_back(leaf.getPageNum());
+    this->separators.push_back(separator);
+
+    this->leafEntries.clear();
+    this->leafOffsets.clear();
+    this->leafKeySpace = 0;
+    return this->ixFileHandle->appendPage(this->leafData);
+}
+
+/**
+ * buildInternalLevel() - writes the internal nodes over a level of nodes.
+ * @argument1 : page numbers of the nodes of the level, replaced by the nodes written.
+ * @argument2 : separator after each node of the level, replaced likewise.
+ *
+ * The separator after the last child of an internal node separates it from the next node.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::buildInternalLevel(std::vector<int>& levelChildren, std::vector<CompositeKey>& levelSeparators) {
+    RTS capacity = PAGE_SIZE - 4*sizeof(RTS) - sizeof(int);
+    std::vector<unsigned> groupStart;   // first child of each node
+    unsigned usedSpace = 0, groupSize = 0;
+    for(unsigned i = 0; i < levelChildren.size(); i++) {
+        unsigned requiredSpace = levelSeparators[i - (i > 0)].getKeyLength() + sizeof(int) + sizeof(RTS);
+        if(groupSize >= 2 && (usedSpace + requiredSpace > this->fillFactor*capacity ||
+                              usedSpace + requiredSpace > capacity)) {
+            groupSize = 0;
+        }
+        if(groupSize == 0) {
+            groupStart.push_back(i);
+            usedSpace = sizeof(int);
+            groupSize = 1;
+            continue;
+        }
+        usedSpace += requiredSpace;
+        groupSize++;
+    }
+
+    // every node needs atleast 2 children, borrow one from the previous node or merge with it
+    unsigned numGroups = groupStart.size();
+    if(numGroups > 1 && levelChildren.size() - groupStart[numGroups - 1] == 1) {
+        if(groupStart[numGroups - 1] - groupStart[numGroups - 2] > 2) {
+            groupStart[numGroups - 1]--;
+        } else {
+            groupStart.pop_back();
+        }
+    }
+
+    std::vector<int> nextChildren;
+    std::vector<CompositeKey> nextSeparators;
+    void* data = malloc(PAGE_SIZE);
+    for(unsigned g = 0; g < groupStart.size(); g++) {
+        unsigned first = groupStart[g];
+        unsigned last = g + 1 < groupStart.size() ? groupStart[g + 1] : levelChildren.size();
+        this->ixFileHandle->initPageDirectory(data, INTERNAL);
+        InternalNode node(data);
+        node.appendPointer(levelChildren[first]);
+        for(unsigned i = first + 1; i < last; i++) {
+            node.appendKey(this->indexType, levelSeparators[i - 1]);
+            node.appendPointer(levelChildren[i]);
+        }
+        nextChildren.push_back(node.getPageNum());
+        nextSeparators.push_back(levelSeparators[last - 1]);
+        if(this->ixFileHandle->appendPage(data) == -1) {
+            free(data);
+            return -1;
+        }
+    }
+    free(data);
+    levelChildren.swap(nextChildren);
+    levelSeparators.swap(nextSeparators);
+    return 0;
+}
+
+/**
+ * finish() - sorts all the entries and writes the B+ tree bottom up,
+ *            leaves left to right followed by each internal level.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IX_BulkLoader::finish() {
+    if(this->ixFileHandle == NULL) {
+        return -1;
+    }
+    if(!this->runFiles.empty()) {
+        if(!this->entryOffsets.empty() && this->spillRun() == -1) {
+            return -1;
+        }
+        if(this->mergeRuns() == -1) {
+            return -1;
+        }
+    } else {
+        this->sortEntries();
+        for(unsigned i = 0; i < this->entryOffsets.size(); i++) {
+            if(this->addSortedEntry(KeyView(this->indexType, this->entries.data() + this->entryOffsets[i])) == -1) {
+                return -1;
             }
         }
-        /* merge is required but not possible, do a lazy deletion */
-        oldNodePointer = INT_MAX;
-        ixFileHandle.writePage(node.getPageNum(), node.getWritableData());
-        free(mergeWith);
+        this->entries.clear();
+        this->entryOffsets.clear();
+    }
+
+    if(this->flushGroup() == -1) {
+        return -1;
+    }
+    // no entries, the index stays empty
+    if(this->leafOffsets.empty()) {
         return 0;
     }
-    /*unusual */
-    return -1;
+    if(this->flushLeaf(NULL) == -1) {
+        return -1;
+    }
+    while(this->children.size() > 1) {
+        if(this->buildInternalLevel(this->children, this->separators) == -1) {
+            return -1;
+        }
+    }
+    this->ixFileHandle->setRoot(this->children[0]);
+    this->ixFileHandle->setChanged();
+    return 0;
 }
 
-RC IndexManager::scan(IXFileHandle &ixFileHandle,
-                      const Attribute &attribute,
-                      const void *lowKey,
-                      const void *highKey,
-                      bool lowKeyInclusive,
-                      bool highKeyInclusive,
-                      IX_ScanIterator &ix_ScanIterator) {
+TreePath::TreePath() {
+    this->depth = 0;
+    for(int level = 0; level < MAX_TREE_HEIGHT; level++) {
+        this->pages[level] = NULL;
+    }
+}
 
-    
-    return ix_ScanIterator.initializeScanIterator(ixFileHandle, attribute,
-                           lowKey, highKey, lowKeyInclusive,
-                           highKeyInclusive);
+TreePath::~TreePath() {
+    for(int level = 0; level < MAX_TREE_HEIGHT; level++) {
+        if(this->pages[level] != NULL) free(this->pages[level]);
+    }
 }
 
 /**
-* printBtree() : prints the Btree in JSON format.
-* @argument1 : ixFileHanlde for the BTree file.
-* @argument2 : attribute on which the index exists.
-*
-* Return : void.
+ * startAtRoot() - make the path a single root node, used when the root is created.
+ *
+ * Return : buffer of the root page, to be initialized by the caller.
 */
-void IndexManager::printBtree(IXFileHandle &ixFileHandle, const Attribute &attribute) const {
-    int root = ixFileHandle.getRoot();
-    if(root == INT_MAX) return;
+void* TreePath::startAtRoot() {
+    if(this->pages[0] == NULL) this->pages[0] = malloc(PAGE_SIZE);
+    this->depth = 1;
+    return this->pages[0];
+}
 
-    void* data = malloc(PAGE_SIZE);
-    ixFileHandle.readPage(root, data);
+/**
+ * descend() - find the leaf of a key, keeping the node and the child followed at each level.
+ * @argument1 : ixfilehandle having the Btree details.
+ * @argument2 : type of the keys present in the nodes.
+ * @argument3 : key to be searched.
+ * @argument4 : NULL, or set to hold the latch of the leaf reached (out parameter).
+ *
+ * The pages are read into the buffers of the path, a buffer is allocated the first time
+ * its level is reached and reused by the next descents. With a guard each page is read
+ * under its leaf latch, which is kept for the leaf only.
+ *
+ * Return : 0 on success, -1 if the BTree is empty or a page can not be read.
+*/
+RC TreePath::descend(IXFileHandle& ixFileHandle, const RTS indexType, const CompositeKey& key,
+                     std::unique_lock<std::mutex>* leafGuard) {
+    this->depth = 0;
+    int pageNum = ixFileHandle.getRoot();
+    if(pageNum == INT_MAX) return -1;
+
+    for(int level = 0; level < MAX_TREE_HEIGHT; level++) {
+        if(this->pages[level] == NULL) this->pages[level] = malloc(PAGE_SIZE);
+        if(leafGuard != NULL) {
+            // one latch at a time, the pages of two levels may share it
+            if(leafGuard->owns_lock()) leafGuard->unlock();
+            *leafGuard = std::unique_lock<std::mutex>(ixFileHandle.getLeafLatch(pageNum));
+        }
+        if(ixFileHandle.readPage(pageNum, this->pages[level]) == -1) return -1;
+        this->pageNums[level] = pageNum;
+        this->depth = level + 1;
+        if(ixFileHandle.getNodeType(this->pages[level]) == LEAF) return 0;
+
+        InternalNode node(this->pages[level]);
+        this->keyOffsets[level] = 0;
+        this->siblings[level] = 0;
+        this->prevSiblings[level] = INT_MAX;
+        pageNum = node.getNextNodePointer(indexType, key, this->keyOffsets[level],
+                                          this->siblings[level], this->prevSiblings[level]);
+    }
+    return -1;
+}
+
+IXFileHandle::IXFileHandle() : bm(BufferManager::instance()) {
+    ixReadPageCounter = 0;
+    ixWritePageCounter = 0;
+    ixAppendPageCounter = 0;
+    ixDiskReadPageCounter = 0;
+    numPages = 0;
+    postingLists = 0;
+    includePayload = 0;
+    rightmostLeaf = INT_MAX;
+    version = 0;
+    indexKind = BTREE_INDEX;
+    hashLevel = 0;
+    hashNext = 0;
+    keyFilterHead = INT_MAX;
+    keyFilterKeys = 0;
+    keyFilterChanged = false;
+    keyFilterBuilding = false;
+    deltaCapacity = 0;
+    deltaIndexType = TypeInt;
+}
 
-    RTS indexType = attribute.type;
+IXFileHandle::~IXFileHandle() { }
 
-    if (ixFileHandle.getNodeType(data) == LEAF) {
-        LeafNode lNode(data);
-        depthFirstTraversal(ixFileHandle, indexType, lNode);
-    } else {
-        InternalNode intNode(data);
-        depthFirstTraversal(ixFileHandle, indexType, intNode);
+/**
+ * openFile() - opens a given file
+ * @argument1 : Name of the file to be opened.
+ * 
+ * Opens a file, if the file is opened for the first time creates the hidden page,
+ * reads the performance counter for the file from hidden/header page. A file of
+ * another format is closed again, isOpen() tells the caller.
+ *
+ * Return : none.
+*/
+void IXFileHandle::openFile(const std::string& fileName) {
+    this->fileName = fileName;
+    this->file.open(fileName.c_str(), std::ios::in | std::ios::out);
+    if(this->isEmpty()) this->createHiddenPage(fileName);
+    if(this->readCounterFromHiddenPage() == -1) {
+        this->file.close();
+        return;
     }
+    this->ixDiskReadPageCounter = 0;
+    this->bm.registerFile(fileName, MAX_HIDDEN_IX_PAGES, MAX_CACHE_PAGE_PER_INDEX);
+    int hashDirectory = INT_MAX;
+    memcpy((char*)&hashDirectory, (char*)(this->hiddenData) + 13*sizeof(int), sizeof(int));
+    this->hashBuckets.clear();
+    this->hashDirectoryPages.clear();
+    if(this->isHashIndex()) this->readHashDirectory(hashDirectory);
+    // the key filter is read from its pages when it is first needed
+    memcpy((char*)&(this->keyFilterHead), (char*)(this->hiddenData) + 14*sizeof(int), sizeof(int));
+    memcpy((char*)&(this->keyFilterKeys), (char*)(this->hiddenData) + 15*sizeof(int), sizeof(int));
+    this->keyFilter.clear();
+    this->keyFilterPages.clear();
+    this->keyFilterChanged = false;
+    this->keyFilterBuilding = false;
+    // a delta buffer belongs to the open file, it is set again after a reopen
+    this->deltaEntries.clear();
+    this->deltaCapacity = 0;
+    this->setChanged();
+    return;
+}
 
-   free(data);
-   return;
+/**
+ * closeRoutine() - closes a given file.
+ * @argument1 : name of the file to be closed.
+ * 
+ * Closes a file, updated the performance counter into hidden page,
+ * writes back all the cached pages of the file into the disk.
+ *
+ * Return : none.
+*/
+void IXFileHandle::closeRoutine() {
+    if(this->isHashIndex()) this->writeHashDirectory();
+    if(this->keyFilterChanged) this->writeKeyFilter();
+    this->updateCounterInHiddenPage();
+    this->bm.writeBackFullBufferToFile(fileName);
+    this->file.close();
+    return;
+}
+
+bool IXFileHandle::isEmpty() { 
+    return this->file.peek() == EOF;
+}
+
+bool IXFileHandle::isOpen() {
+    return this->file.is_open();
 }
 
 /**
-* printBtree() : depth first traversal of Btree to print.
-* @argument1 : ixFileHanlde for the BTree file.
-* @argument2 : type of the keys present in the node.
-* @argument3 : attribute on which the index exists.
-*
-* Return : void.
+ * createHiddenPage() - creates the header pages in a file.
+ * @argument1 : Name of the file in which the header page is create.
+ * 
+ * Return : 0 on success.
 */
-void IndexManager::depthFirstTraversal(IXFileHandle &ixFileHandle, const RTS indexType, Node& node) const {
+RC IXFileHandle::createHiddenPage(const std::string& fileName) {
+    std::fstream newFile;
+    newFile.open(fileName.c_str(), std::ios::in | std::ios::out);
+    newFile.seekp(0, std::ios_base::end);
+    void* data = malloc(MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
+    memset(data, 0, MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
 
-    if(node.getNodeType() == INTERNAL) {
-        std::cout<<"{"<<std::endl;
-        std::cout<<"\"keys\":";
-        node.printKeys(indexType);
-        std::cout<<endl;
-        std::cout<<"\"children\":["<<std::endl;
-        vector<int> children;
-        node.getAllPagePointers(indexType, children);
+    int counter = 0;
+    int pageNum = 0;
 
-        void* data = malloc(PAGE_SIZE); 
-        for(RTS i = 0 ; i < (RTS)children.size(); i++) {
-            ixFileHandle.readPage(children[i], data);
-            if(ixFileHandle.getNodeType(data) == INTERNAL) {
-                if(i != 0)
-                    std::cout<<","<<endl;
-                InternalNode intNode(data);
-                depthFirstTraversal(ixFileHandle, indexType, intNode);
-            } else {
-                LeafNode lNode(data);
-                if(i != 0) {
-                    std::cout<<","<<endl;
-                }
-                std::cout<<"{";
-                std::cout<<"\"keys\":";
-                lNode.printKeys(indexType);
-                std::cout<<"}";
-            }
-        }
-        free(data);
-        std::cout<<"]"<<std::endl;
-        std::cout<<"}";
-    } else {
-       std::cout<<"{"<<std::endl;
-       std::cout<<"\"keys\":";
-       node.printKeys(indexType);
-       std::cout<<"}";
+    memcpy((char*)data, (char*)&counter, sizeof(int));
+    memcpy((char*)data + sizeof(int), (char*)&counter, sizeof(int));
+
+    counter = 1;
+    memcpy((char*)data + 2*sizeof(int), (char*)&counter, sizeof(int));
+    memcpy((char*)data + 3*sizeof(int), (char*)&pageNum, sizeof(int));
+
+    int rootDef = INT_MAX, rootTypeDef = INT_MAX, postingListsDef = 0, includePayloadDef = 0, rightmostLeafDef = INT_MAX;
+    memcpy((char*)data + 4*sizeof(int), (char*)&rootDef, sizeof(int));
+    memcpy((char*)data + 5*sizeof(int), (char*)&rootTypeDef, sizeof(int));
+    memcpy((char*)data + 6*sizeof(int), (char*)&postingListsDef, sizeof(int));
+    memcpy((char*)data + 7*sizeof(int), (char*)&includePayloadDef, sizeof(int));
+    memcpy((char*)data + 8*sizeof(int), (char*)&rightmostLeafDef, sizeof(int));
+    // no free pages, the count at 9*sizeof(int) is 0, a BTree index has no hash state at 10 to 12*sizeof(int)
+    int hashDirectoryDef = INT_MAX, keyFilterDef = INT_MAX;
+    memcpy((char*)data + 13*sizeof(int), (char*)&hashDirectoryDef, sizeof(int));
+    // no key filter, its count of keys at 15*sizeof(int) is 0
+    memcpy((char*)data + 14*sizeof(int), (char*)&keyFilterDef, sizeof(int));
+    int marker = IX_FORMAT_MARKER;
+    memcpy((char*)data + PAGE_SIZE - sizeof(int), (char*)&marker, sizeof(int));
+
+    newFile.write((char*)data, MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
+    newFile.close();
+    free(data);
+
+    return 0;
+}
+
+/**
+ * updateCounterInHiddenPage() - updates performance counter to hidden/header page before file close.
+ *
+ *  updated Hidden page counters, root, and other attributes.
+ * 
+ * Return : 0 on success.
+*/
+RC IXFileHandle::updateCounterInHiddenPage() {
+    this->ixWritePageCounter++;
+    unsigned readPageCount = this->ixReadPageCounter, writePageCount = this->ixWritePageCounter;
+    unsigned appendPageCount = this->ixAppendPageCounter;
+    int rightmostLeaf = this->rightmostLeaf;
+    memcpy((char*)(this->hiddenData), (char*)&readPageCount, sizeof(int));
+    memcpy((char*)(this->hiddenData) + sizeof(int), (char*)&writePageCount, sizeof(int));
+    memcpy((char*)(this->hiddenData) + 2*sizeof(int), (char*)&appendPageCount, sizeof(int));
+    memcpy((char*)(this->hiddenData) + 3*sizeof(int), (char*)&(this->numPages), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 4*sizeof(int), (char*)&(this->root), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 5*sizeof(int), (char*)&(this->rootType), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 6*sizeof(int), (char*)&(this->postingLists), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 7*sizeof(int), (char*)&(this->includePayload), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 8*sizeof(int), (char*)&rightmostLeaf, sizeof(int));
+    int freePageCount = this->freePages.size();
+    memcpy((char*)(this->hiddenData) + 9*sizeof(int), (char*)&freePageCount, sizeof(int));
+    if(freePageCount > 0) {
+        memcpy((char*)(this->hiddenData) + 16*sizeof(int), (char*)&(this->freePages[0]), freePageCount*sizeof(int));
     }
+    int hashDirectory = this->hashDirectoryPages.empty() ? INT_MAX : this->hashDirectoryPages[0];
+    memcpy((char*)(this->hiddenData) + 10*sizeof(int), (char*)&(this->indexKind), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 11*sizeof(int), (char*)&(this->hashLevel), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 12*sizeof(int), (char*)&(this->hashNext), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 13*sizeof(int), (char*)&hashDirectory, sizeof(int));
+    memcpy((char*)(this->hiddenData) + 14*sizeof(int), (char*)&(this->keyFilterHead), sizeof(int));
+    memcpy((char*)(this->hiddenData) + 15*sizeof(int), (char*)&(this->keyFilterKeys), sizeof(int));
+
+    file.seekp(0);
+    file.write((char*)(this->hiddenData), MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
+
+    free(this->hiddenData);
+    this->hiddenData = NULL;
+    return 0;
 }
 
-IX_ScanIterator::IX_ScanIterator() {
-    this->data = NULL;
+/**
+ * readCounterFromHiddenPage() - reads the performance counter values from 
+ *                                hidden/header page upon file open.
+ * 
+ * Return : 0 on success, -1 if the header page has no IX_FORMAT_MARKER.
+*/
+RC IXFileHandle::readCounterFromHiddenPage() {
+    this->hiddenData = malloc(MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
+    this->file.seekg(0);
+    this->file.read((char*)hiddenData, MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
+    int marker = 0;
+    memcpy((char*)&marker, (char*)(this->hiddenData) + PAGE_SIZE - sizeof(int), sizeof(int));
+    if(!this->file || marker != IX_FORMAT_MARKER) {
+        free(this->hiddenData);
+        this->hiddenData = NULL;
+        return -1;
+    }
+
+    unsigned readPageCount = 0, writePageCount = 0, appendPageCount = 0;
+    int rightmostLeaf = INT_MAX;
+    memcpy((char*)&readPageCount, (char*)(this->hiddenData), sizeof(int));
+    memcpy((char*)&writePageCount, (char*)(this->hiddenData) + sizeof(int), sizeof(int));
+    memcpy((char*)&appendPageCount, (char*)(this->hiddenData) + 2*sizeof(int), sizeof(int));
+    memcpy((char*)&(this->numPages), (char*)(this->hiddenData) + 3*sizeof(int), sizeof(int));
+    memcpy((char*)&root, (char*)(this->hiddenData) + 4*sizeof(int), sizeof(int));
+    memcpy((char*)&(this->rootType), (char*)(this->hiddenData) + 5*sizeof(int), sizeof(int));
+    memcpy((char*)&(this->postingLists), (char*)(this->hiddenData) + 6*sizeof(int), sizeof(int));
+    memcpy((char*)&(this->includePayload), (char*)(this->hiddenData) + 7*sizeof(int), sizeof(int));
+    memcpy((char*)&rightmostLeaf, (char*)(this->hiddenData) + 8*sizeof(int), sizeof(int));
+    this->ixReadPageCounter = readPageCount;
+    this->ixWritePageCounter = writePageCount;
+    this->ixAppendPageCounter = appendPageCount;
+    this->rightmostLeaf = rightmostLeaf;
+    int freePageCount = 0;
+    memcpy((char*)&freePageCount, (char*)(this->hiddenData) + 9*sizeof(int), sizeof(int));
+    if(freePageCount < 0 || freePageCount > MAX_FREE_IX_PAGES) freePageCount = 0;
+    this->freePages.resize(freePageCount);
+    if(freePageCount > 0) {
+        memcpy((char*)&(this->freePages[0]), (char*)(this->hiddenData) + 16*sizeof(int), freePageCount*sizeof(int));
+    }
+    memcpy((char*)&(this->indexKind), (char*)(this->hiddenData) + 10*sizeof(int), sizeof(int));
+    memcpy((char*)&(this->hashLevel), (char*)(this->hiddenData) + 11*sizeof(int), sizeof(int));
+    memcpy((char*)&(this->hashNext), (char*)(this->hiddenData) + 12*sizeof(int), sizeof(int));
+
+    this->ixReadPageCounter++;
+
+    return 0;
+}
+
+/**
+ * readPage() - reads a given page into buffer.
+ * @argument1 : page number to be read.
+ * @argument2 : buffer in which to read.
+ * 
+ * Looks up the buffer pool first, pages read from the disk are cached,
+ * internal nodes are pinned so that a descent only misses on the leaf.
+ * Only a miss takes the latch of the file.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IXFileHandle::readPage(PageNum pageNum, void *data) {
+    if(pageNum >= this->getNumberOfPages() || pageNum < 0) {
+        return -1;
+    }
+    if(!file.is_open()) return -1;
+
+    this->ixReadPageCounter++;
+    if(bm.pageInBuffer(fileName, pageNum, data) == 0) return 0;
+
+    // a write of the page may have cached it meanwhile, the disk copy would overwrite it
+    std::lock_guard<std::recursive_mutex> guard(this->ioLatch);
+    if(bm.pageInBuffer(fileName, pageNum, data) == 0) return 0;
+    this->ixDiskReadPageCounter++;
+    file.seekg((pageNum + MAX_HIDDEN_IX_PAGES)*PAGE_SIZE, std::ios_base::beg);
+    file.read((char*)data, PAGE_SIZE);
+    bm.storeInBuffer(fileName, pageNum, data, 0, getNodeType(data) == INTERNAL);
+    return 0;
 }
 
-IX_ScanIterator::~IX_ScanIterator() {
+/**
+ * writePage() - writes a given page into cache
+ * @argument1 : page number to be written.
+ * @argument2 : buffer to be written.
+ * 
+ * The page reaches the disk when it is evicted or the file is closed.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IXFileHandle::writePage(PageNum pageNum, const void *data) {
+    if(pageNum >= this->getNumberOfPages()) {
+        return -1;
+    }
+
+    if(!file.is_open()) return -1;
+    std::lock_guard<std::recursive_mutex> guard(this->ioLatch);
+    this->ixWritePageCounter++;
+    return bm.storeInBuffer(fileName, pageNum, data, 1, getNodeType((void*)data) == INTERNAL);
 }
 
 /**
-* initializeScanIterator() : initialization of index scan iterator.
-* @argument1 : ixFileHanlde for the BTree file.
-* @argument2 : attribute on which the index exists.
-* @argument3 : low key for scan.
-* @argument4 : high key for scan.
-* @argument5 : wether to include lowKey or not.
-* @argument6 : wether to include high key.
+ * appendPage() - Appends a new page to the file.
+ * @argument1 : buffer of null data to be appended to file.
+ * 
+ * Neeed to call initPageDirectory() before calling this.
+ * Return : 0 on success, -1 on failure.
+*/
+RC IXFileHandle::appendPage(const void *data) {
+    if(!file.is_open()) {
+        return -1;
+    }
+    std::lock_guard<std::recursive_mutex> guard(this->ioLatch);
+    // a page taken from the free list by allocatePage() is written in place
+    int pageNum = 0;
+    memcpy((char*)&pageNum, (char*)data + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), sizeof(int));
+    if(pageNum < this->numPages) {
+        return this->writePage(pageNum, data);
+    }
+    file.seekp(0,std::ios_base::end);
+    file.write((char*)data,PAGE_SIZE);
+    file.seekp(0,std::ios_base::beg);
+    this->ixAppendPageCounter++;
+    this->numPages++;
+    return 0;
+}
 
-*
-* Return : 0 on successful initialization, -1 of fail.
+/**
+ * initPageDirectory() - initialize the basic page structure of RBFM file.
+ *
+ * calling this function before appenddPage
+ * 
+ * Return : page (*data) with directory initialized to default values.
 */
-RC IX_ScanIterator::initializeScanIterator(IXFileHandle& ixFileHandle, const Attribute& attribute,
-                                          const void* lowKey, const void* highKey, bool lowKeyInclusive,
-                                          bool highKeyInclusive) {
+RC IXFileHandle::initPageDirectory(void* data, RT type) {
+    RTS freeSpace  = 0;
+    RTS entries = 0, offset = 0;
+    int pageNum = getNumberOfPages();
 
-    if(!ixFileHandle.isOpen()) return -1;
-    this->ixFileHandle = &ixFileHandle;
-    this->indexType = attribute.type;
+    // posting, directory and key filter pages link to the next page like a leaf to its sibling
+    if(type == LEAF || type == POSTING || type == HASH_DIRECTORY || type == KEY_FILTER) {
+        freeSpace = PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int);
+        int sibling = INT_MAX;
+        RTS prefixLen = 0;
+        memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), (char*)&sibling, sizeof(int));
+        memcpy((char*)data + PAGE_SIZE - 5*sizeof(RTS) - 2*sizeof(int), (char*)&prefixLen, sizeof(RTS));
+    } else {
+        freeSpace = PAGE_SIZE - 4*sizeof(RTS) - sizeof(int);
+    }
 
-    initComparisonKeys(lowKey, highKey, lowKeyInclusive, highKeyInclusive);
+    memcpy((char*)data + PAGE_SIZE - sizeof(RTS), (char*)&freeSpace, sizeof(RTS));
+    memcpy((char*)data + PAGE_SIZE - 2*sizeof(RTS), (char*)&entries, sizeof(RTS));
+    memcpy((char*)data + PAGE_SIZE - 3*sizeof(RTS), (char*)&type, sizeof(RTS));
+    memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS), (char*)&offset, sizeof(RTS));
+    memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), (char*)&pageNum, sizeof(int));
 
-    /* Initialize first scan entry */
-    /*get the first node( or page) */
-    this->lastPageNum = searchNode(indexType, lowCKey);
-    data = malloc(PAGE_SIZE);
     return 0;
 }
 
 /**
-* initComparisonKeys() : initialize comparsion keys.
-* @argument1 : low key for scan.
-* @argument2 : high key for scan.
-* @argument3 : wether to include lowKey or not.
-* @argument4 : wether to include high key.
+ * allocatePage() - initialize the directory of a new page, reusing a free page if possible.
+ * @argument1 : buffer of the page.
+ * @argument2 : type of the page (leaf/internal/posting).
+ *
+ * The page gets the number of the last freed page, appendPage() then writes it in place
+ * of the free page instead of growing the file.
+ *
+ * Return : page (*data) with directory initialized to default values.
+*/
+RC IXFileHandle::allocatePage(void* data, RT type) {
+    this->initPageDirectory(data, type);
+    if(this->freePages.empty()) return 0;
 
-*
-* Return : 0 on successful initialization, -1 of fail.
+    int pageNum = this->freePages.back();
+    this->freePages.pop_back();
+    memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), (char*)&pageNum, sizeof(int));
+    return 0;
+}
+
+/**
+ * freePage() - add a page no longer in the BTree to the free list.
+ * @argument1 : page number.
+ *
+ * The list is kept in the header page, pages freed when it is full stay unused until
+ * the file is compacted.
+ *
+ * Return : void.
 */
-void IX_ScanIterator::initComparisonKeys(const void* lowKey, const void* highKey, 
-                                         bool lowKeyInclusive, bool highKeyInclusive) {
-    if(lowKey != NULL) {
-    /* Equality included */
-        if(lowKeyInclusive) {
-            RID r;
-            /* By this, the comparator enforces equality */
-            r.pageNum = INT_MAX;
-            r.slotNum = 0;
-            CompositeKey low(this->indexType, lowKey, r);
-            this->lowCKey = low;
-        } else {
-            /* NO equality */
-            RID r;
-            /*can be anything */
-            r.pageNum = INT_MAX;
-            /*can be anything but 0 */
-            r.slotNum = USHRT_MAX;
-            CompositeKey low(this->indexType, lowKey, r);
-            this->lowCKey = low;
-        }
+void IXFileHandle::freePage(const int pageNum) {
+    if((int)this->freePages.size() < MAX_FREE_IX_PAGES) {
+        this->freePages.push_back(pageNum);
     }
+}
 
-    if(highKey != NULL) {
-        if(highKeyInclusive) {
-            RID r;
-            /* By this comparator enforces equality */
-            r.pageNum = INT_MAX;
-            r.slotNum = 0;
-            CompositeKey high(this->indexType, highKey, r);
-            this->highCKey = high;
-        } else {
-            /* NO euqlity */
-            RID r;
-            /*can be anything */
-            r.pageNum = INT_MAX;
-            /*can be anything but 0 */
-            r.slotNum = USHRT_MAX;
-            CompositeKey high(this->indexType, highKey, r);
-            this->highCKey = high;
-       }
-    }
-    return;
+/**
+ * getNodeType() - get the type of a node (leaf/internal).
+ * @argument1 : buffer conatining node data. 
+ *
+ * Return : the type of the node.
+*/
+RTS IXFileHandle::getNodeType(void* data) {
+    RTS type = 0;
+    memcpy((char*)&type, (char*)data + PAGE_SIZE - 3*sizeof(RTS), sizeof(RTS));
+    return type;
 }
 
 /**
-* searchNode() : wrapper on treeSearch method.
-* @argument1 : type of the keys present in the node.
-* @argument2 : key to be searched.
-*
-* Return : 0 on successful initialization, -1 of fail.
+ * readPostingList() - read all the rids of a leaf entry.
+ * @argument1 : view of the entry.
+ * @argument2 : rids are appended to it in sorted order (out parameter).
+ *
+ * Return : 0 on success, -1 on failure.
 */
-RC IX_ScanIterator::searchNode(const RTS indexType, const CompositeKey& lowKey) {
-    int root = this->ixFileHandle->getRoot();
-    if(root == INT_MAX) return -1;
+RC IXFileHandle::readPostingList(const KeyView& entry, std::vector<RID>& rids) {
+    if(!isPostingList(entry.rid)) {
+        rids.push_back(entry.rid);
+        return 0;
+    }
+    int count = 0, head = 0;
+    memcpy((char*)&count, entry.getPostingList(), sizeof(int));
+    memcpy((char*)&head, entry.getPostingList() + sizeof(int), sizeof(int));
+    if(head == INT_MAX) {
+        decodeRIDs(entry.getPostingList() + 2*sizeof(int), count, rids);
+        return 0;
+    }
 
     void* data = malloc(PAGE_SIZE);
-    this->ixFileHandle->readPage(root, data);
-
-    int pageNum = -1;
-
-    if(this->ixFileHandle->getNodeType(data) == LEAF) {
-        LeafNode lNode(data);
-        pageNum = treeSearch(indexType, lNode, lowKey);
-    } else {
-        InternalNode intNode(data);
-        pageNum = treeSearch(indexType, intNode, lowKey);
+    while(head != INT_MAX) {
+        if(this->readPage(head, data) == -1) {
+            free(data);
+            return -1;
+        }
+        PostingPage page(data);
+        page.getRIDs(rids);
+        head = page.getNext();
     }
-
     free(data);
-    return pageNum;
+    return 0;
 }
 
 /**
-* treeSearch() : recursive search of a key in the BTree.
-* @argument1 : type of the keys present in the node.
-* @argument2 : current node being looked into.
-* @argument3 : key to be searched.
-*
-* Return : 0 on successful initialization, -1 of fail.
+ * buildPostingList() - replace the rid of an entry with a posting list of sorted rids.
+ * @argument1 : entry to be changed (in/out parameter).
+ * @argument2 : sorted rids, atleast two.
+ *
+ * The rids are kept in the entry upto POSTING_INLINE_LIMIT bytes, else written to new posting pages.
+ *
+ * Return : 0 on success, -1 on failure.
 */
-RC IX_ScanIterator::treeSearch(const RTS indexType, Node& node, const CompositeKey& lowKey) {
-    if(node.getNodeType() == INTERNAL) {
-        RTS nextKeyOffset = 0;
-        int dummySibling, prevSibling;
-        int nextNode = node.getNextNodePointer(indexType, lowKey, nextKeyOffset, 
-                                               dummySibling, prevSibling);
-        void* data = malloc(PAGE_SIZE);
-        this->ixFileHandle->readPage(nextNode, data);
-        int pageNum = -1;
-        if(this->ixFileHandle->getNodeType(data) == LEAF) {
-            LeafNode lNode(data);
-            pageNum = treeSearch(indexType, lNode, lowKey);
-        } else {
-            InternalNode intNode(data);
-            pageNum = treeSearch(indexType, intNode, lowKey);
-        }
-        free(data);
-        return pageNum;
+RC IXFileHandle::buildPostingList(CompositeKey& entry, const std::vector<RID>& rids) {
+    int count = rids.size(), head = INT_MAX, tail = INT_MAX;
+    std::vector<char> list(2*sizeof(int));
+    encodeRIDs(rids, list);
+    if(list.size() > POSTING_INLINE_LIMIT) {
+        if(this->writePostingPages(rids, head, tail) == -1) return -1;
+        list.resize(3*sizeof(int));
+        memcpy(&list[2*sizeof(int)], (char*)&tail, sizeof(int));
     }
-
-    return node.getPageNum();
+    memcpy(&list[0], (char*)&count, sizeof(int));
+    memcpy(&list[sizeof(int)], (char*)&head, sizeof(int));
+    entry.setPostingList(list);
+    return 0;
 }
 
 /**
-* getNextNonEmptySibling() : get the next non empty leaf node sibling.
-* @argument1 : buffer to return the data of the node to be returned (out parameter).
-*
-* Return : -1 if no sibling found.
+ * getIndexType() - get the type of the keys of the index, with INCLUDE_PAYLOAD set if the
+ *                  entries carry INCLUDE columns.
+ * @argument1 : attribute on which the index exists.
+ *
+ * Return : type of the keys.
 */
-RC IX_ScanIterator::getNextNonEmptySibling(void* data) {
-    LeafNode currNode(data);
-    int entries = currNode.getEntries();
-    if(entries != 0) return currNode.getPageNum();
+RTS IXFileHandle::getIndexType(const Attribute& attribute) {
+    return attribute.type | (this->hasIncludePayload() ? INCLUDE_PAYLOAD : 0);
+}
 
-    int sibling = currNode.getSibling();
-    int prevPage = -1;
+/**
+ * addToPostingList() - add a rid to an entry, a plain entry becomes a posting list.
+ * @argument1 : entry to be changed (in/out parameter).
+ * @argument2 : rid to be added.
+ *
+ * Return : 0 on success, -1 if the rid is already present.
+*/
+RC IXFileHandle::addToPostingList(CompositeKey& entry, const RID& rid) {
+    KeyView view = entry.getView();
+    int count = 0, head = INT_MAX, tail = INT_MAX;
+    if(isPostingList(view.rid)) {
+        memcpy((char*)&count, view.getPostingList(), sizeof(int));
+        memcpy((char*)&head, view.getPostingList() + sizeof(int), sizeof(int));
+    }
 
-    while(entries == 0) {
-        if(sibling == INT_MAX) return INT_MAX;
-        this->ixFileHandle->readPage(sibling, data);
-        LeafNode lNode(data);
-        entries = lNode.getEntries();
-        prevPage = sibling;
-        sibling = lNode.getSibling();
+    // a list in posting pages only changes the page taking the rid
+    if(head != INT_MAX) {
+        memcpy((char*)&tail, view.getPostingList() + 2*sizeof(int), sizeof(int));
+        if(this->insertIntoPostingPages(head, tail, rid) == -1) return -1;
+        count++;
+        std::vector<char> list(view.getPostingList(), view.getPostingList() + 3*sizeof(int));
+        memcpy(&list[0], (char*)&count, sizeof(int));
+        memcpy(&list[2*sizeof(int)], (char*)&tail, sizeof(int));
+        entry.setPostingList(list);
+        return 0;
     }
 
-    return prevPage;
+    std::vector<RID> rids;
+    this->readPostingList(view, rids);
+    std::vector<RID>::iterator it = findRID(rids, rid);
+    if(it != rids.end() && *it == rid) return -1;
+    rids.insert(it, rid);
+    return this->buildPostingList(entry, rids);
 }
 
-
 /**
-* getNextEntry() : get the next <key, rid> pair using iterator.
-* @argument1 : rid to be returned (out parameter).
-* @argument2 : buffer to return key (out parameter).
-*
-* Return : IX_EOF if reached EOF, 0 otherwise.
+ * removeFromPostingList() - remove a rid from a posting list entry, the entry becomes
+ *                           a plain <key, rid> entry when one rid is left.
+ * @argument1 : entry to be changed (in/out parameter).
+ * @argument2 : rid to be removed.
+ *
+ * Return : 0 on success, -1 if the rid is not present.
 */
-RC IX_ScanIterator::getNextEntry(RID &rid, void *key) {
-    
-    //all pages scanned
-    if(this->lastPageNum == INT_MAX || this->lastPageNum == -1) return IX_EOF;
-
-    if(this->lastRet == LAST_ENTRY) {
-        this->ixFileHandle->readPage(this->lastPageNum, data);
-        this->lastPageNum = getNextNonEmptySibling(data);
-        if(this->lastPageNum == INT_MAX) return IX_EOF;
-        this->lastRet = 0;
-    } else if(this->ixFileHandle->isChanged()) {
-        this->ixFileHandle->readPage(this->lastPageNum, data);
-        this->ixFileHandle->resetChanged();
+RC IXFileHandle::removeFromPostingList(CompositeKey& entry, const RID& rid) {
+    KeyView view = entry.getView();
+    int count = 0, head = INT_MAX, tail = INT_MAX;
+    memcpy((char*)&count, view.getPostingList(), sizeof(int));
+    memcpy((char*)&head, view.getPostingList() + sizeof(int), sizeof(int));
+
+    std::vector<RID> rids;
+    if(head != INT_MAX) {
+        memcpy((char*)&tail, view.getPostingList() + 2*sizeof(int), sizeof(int));
+        if(this->deleteFromPostingPages(head, tail, rid) == -1) return -1;
+        count--;
+        std::vector<char> list(3*sizeof(int));
+        memcpy(&list[0], (char*)&count, sizeof(int));
+        memcpy(&list[sizeof(int)], (char*)&head, sizeof(int));
+        memcpy(&list[2*sizeof(int)], (char*)&tail, sizeof(int));
+        entry.setPostingList(list);
+        if(count > 1) return 0;
+        // the last rid goes back into the entry, its page is freed
+        readPostingList(entry.getView(), rids);
+        this->freePage(head);
+    } else {
+        readPostingList(view, rids);
+        std::vector<RID>::iterator it = findRID(rids, rid);
+        if(it == rids.end() || *it != rid) return -1;
+        rids.erase(it);
+        if(rids.size() > 1) return this->buildPostingList(entry, rids);
     }
 
-    LeafNode lNode(data);
-    CompositeKey newKey;
-    int retVal = lNode.getNextKey(this->indexType, this->lowCKey, newKey);
+    entry.updatePageNum(rids[0].pageNum);
+    entry.updateSlotNum(rids[0].slotNum);
+    return 0;
+}
 
-    /* Merged with previous node, rescan required */
-    if(retVal == PREV_MERGE) {
-        this->lastPageNum = searchNode(indexType, this->lowCKey);
-        return getNextEntry(rid, key);
+/**
+ * writePostingPages() - write sorted rids to a new chain of posting pages.
+ * @argument1 : sorted rids.
+ * @argument2 : first page of the chain (out parameter).
+ * @argument3 : last page of the chain (out parameter).
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IXFileHandle::writePostingPages(const std::vector<RID>& rids, int& head, int& tail) {
+    void* data = malloc(PAGE_SIZE);
+    unsigned first = 0;
+    head = this->getNumberOfPages();
+    while(first < rids.size()) {
+        this->initPageDirectory(data, POSTING);
+        PostingPage page(data);
+        first = page.setRIDs(rids, first, rids.size());
+        // the pages are appended one after the other
+        if(first < rids.size()) {
+            page.setNext(page.getPageNum() + 1);
+        }
+        tail = page.getPageNum();
+        if(this->appendPage(data) == -1) {
+            free(data);
+            return -1;
+        }
     }
+    free(data);
+    return 0;
+}
 
- /* Optimization to reduce disk I/Os, basically when we have read the last record, 
- *    update the pageNUm to sibling,
- *   so that next time we just have to read the sibling page instead of first 
- *   reading the last page and then getting the 
- *   sibling */
-    if(retVal == LAST_ENTRY) {
-        this->lastPageNum = lNode.getSibling();
-        this->lastRet = LAST_ENTRY;
+/**
+ * insertIntoPostingPages() - insert a rid into a chain of posting pages.
+ * @argument1 : first page of the chain.
+ * @argument2 : last page of the chain, updated when a page is added after it (in/out parameter).
+ * @argument3 : rid to be inserted.
+ *
+ * A rid greater than all the others goes to the last page, others to the first page
+ * whose last rid is greater. A full page moves the rids that do not fit to a new page after it.
+ *
+ * Return : 0 on success, -1 if the rid is already present.
+*/
+RC IXFileHandle::insertIntoPostingPages(int head, int& tail, const RID& rid) {
+    void* data = malloc(PAGE_SIZE);
+    std::vector<RID> rids;
+    int pageNum = tail;
+    this->readPage(pageNum, data);
+    PostingPage page(data);
+    page.getRIDs(rids);
+    if(!(rid > rids.back())) {
+        pageNum = head;
+        while(true) {
+            this->readPage(pageNum, data);
+            rids.clear();
+            page.getRIDs(rids);
+            if(!(rid > rids.back()) || page.getNext() == INT_MAX) break;
+            pageNum = page.getNext();
+        }
     }
 
-    // Page is completely scanned
-    if(retVal == PAGE_SCANNED) {
-        int sibling = getNextNonEmptySibling(data);
-        /* NO sibling EOF */
-        if(sibling == INT_MAX) {
-            return IX_EOF;
+    std::vector<RID>::iterator it = findRID(rids, rid);
+    if(it != rids.end() && *it == rid) {
+        free(data);
+        return -1;
+    }
+    bool append = it == rids.end();
+    rids.insert(it, rid);
+    unsigned stored = page.setRIDs(rids, 0, rids.size());
+    if(stored < rids.size()) {
+        // a rid appended to the list starts a new page, else the page is split in half
+        if(!append) {
+            stored = page.setRIDs(rids, 0, rids.size()/2);
         }
-
-        LeafNode lNode(data);
-
-        int retVal = lNode.getNextKey(this->indexType, this->lowCKey, newKey);
-        /* unsual case something is wrong */
-        if(retVal == -1) {
-            return IX_EOF;
+        void* newData = malloc(PAGE_SIZE);
+        this->allocatePage(newData, POSTING);
+        PostingPage newPage(newData);
+        newPage.setRIDs(rids, stored, rids.size());
+        newPage.setNext(page.getNext());
+        page.setNext(newPage.getPageNum());
+        if(pageNum == tail) {
+            tail = newPage.getPageNum();
         }
-        this->lastPageNum = sibling;
+        this->appendPage(newData);
+        free(newData);
     }
+    this->writePage(pageNum, data);
+    free(data);
+    return 0;
+}
 
-    this->lowCKey = newKey;
-
-    if(newKey.getRID().slotNum == USHRT_MAX) {
-        this->lowCKey.updatePageNum(newKey.getRID().pageNum + 1);
-    } else {
-        this->lowCKey.updateSlotNum(newKey.getRID().slotNum + 1);
+/**
+ * deleteFromPostingPages() - delete a rid from a chain of posting pages.
+ * @argument1 : first page of the chain, updated when it becomes empty (in/out parameter).
+ * @argument2 : last page of the chain, updated when it becomes empty (in/out parameter).
+ * @argument3 : rid to be deleted.
+ *
+ * An empty page is unlinked from the chain.
+ *
+ * Return : 0 on success, -1 if the rid is not present.
+*/
+RC IXFileHandle::deleteFromPostingPages(int& head, int& tail, const RID& rid) {
+    void* data = malloc(PAGE_SIZE);
+    std::vector<RID> rids;
+    PostingPage page(data);
+    int pageNum = head, prevPage = INT_MAX;
+    while(true) {
+        this->readPage(pageNum, data);
+        rids.clear();
+        page.getRIDs(rids);
+        if(!(rid > rids.back())) break;
+        if(page.getNext() == INT_MAX) {
+            free(data);
+            return -1;
+        }
+        prevPage = pageNum;
+        pageNum = page.getNext();
     }
 
-    if(this->highCKey >= newKey) {
-        rid = newKey.getRID();
-        memcpy((char*)key, (char*)(newKey.getWritableKey()), newKey.getKeyLength() - sizeof(int) - sizeof(RTS));
+    std::vector<RID>::iterator it = findRID(rids, rid);
+    if(it == rids.end() || *it != rid) {
+        free(data);
+        return -1;
+    }
+    rids.erase(it);
+    if(!rids.empty()) {
+        page.setRIDs(rids, 0, rids.size());
+        this->writePage(pageNum, data);
+        free(data);
         return 0;
     }
 
-    return IX_EOF;
-}
-
-RC IX_ScanIterator::close() {
-    CompositeKey nullKey;
-    this->lastPageNum = INT_MAX;
-    this->lowCKey = nullKey;
-    this->highCKey = nullKey;
-    this->lastRet = 0;
-    if(data != NULL) {
-        free(data);
+    int next = page.getNext();
+    this->freePage(pageNum);
+    if(prevPage == INT_MAX) {
+        head = next;
+    } else {
+        this->readPage(prevPage, data);
+        page.setNext(next);
+        this->writePage(prevPage, data);
     }
-    this->ixFileHandle->setChanged();
+    if(pageNum == tail) {
+        tail = prevPage;
+    }
+    free(data);
     return 0;
 }
 
-IXFileHandle::IXFileHandle() {
-    ixReadPageCounter = 0;
-    ixWritePageCounter = 0;
-    ixAppendPageCounter = 0;
-    numPages = 0;
-    changed = true;
+/**
+ * createHashBuckets() - turn an empty index file into a hash index.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IXFileHandle::createHashBuckets() {
+    if(this->getRoot() != INT_MAX || this->getNumberOfPages() != 0) return -1;
+    this->indexKind = HASH_INDEX;
+    this->hashLevel = 0;
+    this->hashNext = 0;
+    void* data = malloc(PAGE_SIZE);
+    for(int bucket = 0; bucket < HASH_INITIAL_BUCKETS; bucket++) {
+        this->hashBuckets.push_back(this->appendBucketPage(data));
+    }
+    free(data);
+    return 0;
 }
 
-IXFileHandle::~IXFileHandle() { }
-
 /**
- * openFile() - opens a given file
- * @argument1 : Name of the file to be opened.
- * 
- * Opens a file, if the file is opened for the first time creates the hidden page,
- * reads the performance counter for the file from hidden/header page.
+ * getHashBucket() - find the bucket of a key in a hash index.
+ * @argument1 : type of the keys present in the index.
+ * @argument2 : view of the key, only the key value is hashed.
  *
- * Return : none.
+ * Buckets before hashNext were split in this round and are addressed with one more bit.
+ *
+ * Return : bucket number.
 */
-void IXFileHandle::openFile(const std::string& fileName) {
-    this->fileName = fileName;
-    this->file.open(fileName.c_str(), std::ios::in | std::ios::out);
-    if(this->isEmpty()) this->createHiddenPage(fileName);
-    this->readCounterFromHiddenPage();
-    this->setChanged();
-    return;
+int IXFileHandle::getHashBucket(const RTS indexType, const KeyView& key) {
+    unsigned hash = hashKeyValue(indexType, key);
+    unsigned buckets = HASH_INITIAL_BUCKETS << this->hashLevel;
+    unsigned bucket = hash % buckets;
+    if(bucket < (unsigned)this->hashNext) {
+        bucket = hash % (2*buckets);
+    }
+    return bucket;
 }
 
 /**
- * closeRoutine() - closes a given file.
- * @argument1 : name of the file to be closed.
- * 
- * Closes a file, updated the performance counter into hidden page,
- * writes back all the cached pages of the file into the disk.
+ * appendBucketPage() - add an empty bucket page to the file.
+ * @argument1 : buffer receiving the page.
  *
- * Return : none.
+ * The page is written at once so that the next page allocated gets another number.
+ *
+ * Return : page number.
 */
-void IXFileHandle::closeRoutine() {
-    this->updateCounterInHiddenPage();
-    this->file.close();
-    return;
+int IXFileHandle::appendBucketPage(void* data) {
+    this->allocatePage(data, LEAF);
+    this->appendPage(data);
+    return LeafNode(data).getPageNum();
 }
 
-bool IXFileHandle::isEmpty() { 
-    return this->file.peek() == EOF;
-}
+/**
+ * insertIntoBucket() - insert an entry into its bucket of a hash index.
+ * @argument1 : type of the keys present in the index.
+ * @argument2 : composite key to be inserted.
+ *
+ * The entry goes into the first page of the bucket with room for it. When the chain is full
+ * an overflow page is linked after it and the next bucket of the round is split.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IXFileHandle::insertIntoBucket(const RTS indexType, CompositeKey& entry) {
+    void* data = malloc(PAGE_SIZE);
+    LeafNode page(data);
+    Node& node = page;
+    int pageNum = this->hashBuckets[this->getHashBucket(indexType, entry.getView())];
+    while(true) {
+        this->readPage(pageNum, data);
+        if(page.hasEnoughSpace(page.getRequiredSpace(indexType, entry))) {
+            node.insertEntryInNode(indexType, entry);
+            this->writePage(pageNum, data);
+            free(data);
+            return 0;
+        }
+        if(page.getSibling() == INT_MAX) break;
+        pageNum = page.getSibling();
+    }
 
-bool IXFileHandle::isOpen() {
-    return this->file.is_open();
+    void* overflowData = malloc(PAGE_SIZE);
+    page.setSibling(this->appendBucketPage(overflowData));
+    this->writePage(pageNum, data);
+    LeafNode overflowPage(overflowData);
+    Node& overflowNode = overflowPage;
+    overflowNode.insertEntryInNode(indexType, entry);
+    this->writePage(overflowPage.getPageNum(), overflowData);
+    free(overflowData);
+    free(data);
+    return this->splitBucket(indexType);
 }
 
 /**
- * createHiddenPage() - creates the header pages in a file.
- * @argument1 : Name of the file in which the header page is create.
- * 
- * Return : 0 on success.
+ * splitBucket() - split the next bucket of the round of a hash index.
+ * @argument1 : type of the keys present in the index.
+ *
+ * Linear hashing: the entries of bucket hashNext are spread over it and a new last bucket
+ * by one more bit of their hash. Its overflow pages are freed and the chains rebuilt.
+ * When every bucket of the round was split the number of buckets has doubled.
+ *
+ * Return : 0 on success, -1 on failure.
 */
-RC IXFileHandle::createHiddenPage(const std::string& fileName) {
-    std::fstream newFile;
-    newFile.open(fileName.c_str(), std::ios::in | std::ios::out);
-    newFile.seekp(0, std::ios_base::end);
-    void* data = malloc(MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
-
-    int counter = 0;
-    int pageNum = 0;
-
-    memcpy((char*)data, (char*)&counter, sizeof(int));
-    memcpy((char*)data + sizeof(int), (char*)&counter, sizeof(int));
-
-    counter = 1;
-    memcpy((char*)data + 2*sizeof(int), (char*)&counter, sizeof(int));
-    memcpy((char*)data + 3*sizeof(int), (char*)&pageNum, sizeof(int));
+RC IXFileHandle::splitBucket(const RTS indexType) {
+    int bucket = this->hashNext;
+    int primary = this->hashBuckets[bucket];
+    std::vector<CompositeKey> entries;
+    void* data = malloc(PAGE_SIZE);
+    LeafNode page(data);
+    for(int pageNum = primary; pageNum != INT_MAX; pageNum = page.getSibling()) {
+        this->readPage(pageNum, data);
+        for(RTS slot = 0; slot < page.getEntries(); slot++) {
+            entries.push_back(CompositeKey());
+            page.getKeyFromOffset(indexType, page.getKeySlotOffset(slot), entries.back());
+        }
+        if(pageNum != primary) this->freePage(pageNum);
+    }
 
-    int rootDef = INT_MAX, rootTypeDef = INT_MAX;
-    memcpy((char*)data + 4*sizeof(int), (char*)&rootDef, sizeof(int));
-    memcpy((char*)data + 5*sizeof(int), (char*)&rootTypeDef, sizeof(int));
+    this->hashNext++;
+    if(this->hashNext == (HASH_INITIAL_BUCKETS << this->hashLevel)) {
+        this->hashLevel++;
+        this->hashNext = 0;
+    }
 
-    newFile.write((char*)data, MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
-    newFile.close();
+    /* chains[0] is the last page of the split bucket, chains[1] of the new bucket */
+    void* chains[2] = {data, malloc(PAGE_SIZE)};
+    this->initPageDirectory(data, LEAF);
+    page.setPageNum(primary);
+    this->hashBuckets.push_back(this->appendBucketPage(chains[1]));
+    void* overflowData = malloc(PAGE_SIZE);
+    for(auto& entry : entries) {
+        void* chain = chains[this->getHashBucket(indexType, entry.getView()) == bucket ? 0 : 1];
+        LeafNode chainPage(chain);
+        Node& chainNode = chainPage;
+        if(!chainPage.hasEnoughSpace(chainPage.getRequiredSpace(indexType, entry))) {
+            chainPage.setSibling(this->appendBucketPage(overflowData));
+            this->writePage(chainPage.getPageNum(), chain);
+            memcpy((char*)chain, (char*)overflowData, PAGE_SIZE);
+        }
+        chainNode.insertEntryInNode(indexType, entry);
+    }
+    this->writePage(LeafNode(chains[0]).getPageNum(), chains[0]);
+    this->writePage(LeafNode(chains[1]).getPageNum(), chains[1]);
+    free(overflowData);
+    free(chains[1]);
     free(data);
-
     return 0;
 }
 
 /**
- * updateCounterInHiddenPage() - updates performance counter to hidden/header page before file close.
+ * deleteFromBucket() - delete an entry from its bucket of a hash index.
+ * @argument1 : type of the keys present in the index.
+ * @argument2 : composite key with the rid of the entry.
  *
- *  updated Hidden page counters, root, and other attributes.
- * 
- * Return : 0 on success.
+ * An overflow page left empty is unlinked from the chain and freed.
+ *
+ * Return : 0 on success, -1 if the entry is not present.
 */
-RC IXFileHandle::updateCounterInHiddenPage() {
-    this->ixWritePageCounter++;
-    memcpy((char*)(this->hiddenData), (char*)&(this->ixReadPageCounter), sizeof(int));
-    memcpy((char*)(this->hiddenData) + sizeof(int), (char*)&(this->ixWritePageCounter), sizeof(int));
-    memcpy((char*)(this->hiddenData) + 2*sizeof(int), (char*)&(this->ixAppendPageCounter), sizeof(int));
-    memcpy((char*)(this->hiddenData) + 3*sizeof(int), (char*)&(this->numPages), sizeof(int));
-    memcpy((char*)(this->hiddenData) + 4*sizeof(int), (char*)&(this->root), sizeof(int));
-    memcpy((char*)(this->hiddenData) + 5*sizeof(int), (char*)&(this->rootType), sizeof(int));
-
-    file.seekp(0);
-    file.write((char*)(this->hiddenData), MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
-
-    free(this->hiddenData);
-    this->hiddenData = NULL;
-    return 0;
+RC IXFileHandle::deleteFromBucket(const RTS indexType, const CompositeKey& entry) {
+    void* data = malloc(PAGE_SIZE);
+    LeafNode page(data);
+    Node& node = page;
+    int prevPage = INT_MAX;
+    int pageNum = this->hashBuckets[this->getHashBucket(indexType, entry.getView())];
+    while(pageNum != INT_MAX) {
+        this->readPage(pageNum, data);
+        RT keyOffset = node.findKeyOffset(indexType, entry);
+        if(keyOffset != -1) {
+            node.removeKey(indexType, keyOffset);
+            if(page.getEntries() != 0 || prevPage == INT_MAX) {
+                this->writePage(pageNum, data);
+            } else {
+                int next = page.getSibling();
+                this->freePage(pageNum);
+                this->readPage(prevPage, data);
+                page.setSibling(next);
+                this->writePage(prevPage, data);
+            }
+            free(data);
+            return 0;
+        }
+        prevPage = pageNum;
+        pageNum = page.getSibling();
+    }
+    free(data);
+    return -1;
 }
 
 /**
- * readCounterFromHiddenPage() - reads the performance counter values from 
- *                                hidden/header page upon file open.
- * 
- * Return : 0 on success.
+ * readBucket() - read the entries of a bucket of a hash index within a range.
+ * @argument1 : type of the keys present in the index.
+ * @argument2 : bucket number.
+ * @argument3 : low key of the range, a NULL key for no bound.
+ * @argument4 : high key of the range, a NULL key for no bound.
+ * @argument5 : matching entries are appended to it, sorted page by page (out parameter).
+ *
+ * Return : 0 on success, -1 on failure.
 */
-RC IXFileHandle::readCounterFromHiddenPage() {
-    this->hiddenData = malloc(MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
-    this->file.seekg(0);
-    this->file.read((char*)hiddenData, MAX_HIDDEN_IX_PAGES*PAGE_SIZE);
-
-    memcpy((char*)&(this->ixReadPageCounter), (char*)(this->hiddenData), sizeof(int));
-    memcpy((char*)&(this->ixWritePageCounter), (char*)(this->hiddenData) + sizeof(int), sizeof(int));
-    memcpy((char*)&(this->ixAppendPageCounter), (char*)(this->hiddenData) + 2*sizeof(int), sizeof(int));
-    memcpy((char*)&(this->numPages), (char*)(this->hiddenData) + 3*sizeof(int), sizeof(int));
-    memcpy((char*)&root, (char*)(this->hiddenData) + 4*sizeof(int), sizeof(int));
-    memcpy((char*)&(this->rootType), (char*)(this->hiddenData) + 5*sizeof(int), sizeof(int));
-
-    this->ixReadPageCounter++;
-
+RC IXFileHandle::readBucket(const RTS indexType, const int bucket, const CompositeKey& lowKey,
+                            const CompositeKey& highKey, std::vector<CompositeKey>& entries) {
+    if(bucket < 0 || bucket >= this->getNumberOfBuckets()) return -1;
+    void* data = malloc(PAGE_SIZE);
+    LeafNode page(data);
+    for(int pageNum = this->hashBuckets[bucket]; pageNum != INT_MAX; pageNum = page.getSibling()) {
+        if(this->readPage(pageNum, data) == -1) {
+            free(data);
+            return -1;
+        }
+        for(RTS slot = page.findKeySlot(indexType, lowKey); slot < page.getEntries(); slot++) {
+            CompositeKey entry;
+            page.getKeyFromOffset(indexType, page.getKeySlotOffset(slot), entry);
+            if(!(highKey >= entry)) break;
+            entries.push_back(entry);
+        }
+    }
+    free(data);
     return 0;
 }
 
 /**
- * readPage() - reads a given page into buffer.
- * @argument1 : page number to be read.
- * @argument2 : buffer in which to read.
- * 
+ * readHashDirectory() - load the primary page of each bucket of a hash index.
+ * @argument1 : first page of the bucket directory.
+ *
  * Return : 0 on success, -1 on failure.
 */
-RC IXFileHandle::readPage(PageNum pageNum, void *data) {
-    if(pageNum >= this->getNumberOfPages() || pageNum < 0) {
-        return -1;
+RC IXFileHandle::readHashDirectory(const int head) {
+    void* data = malloc(PAGE_SIZE);
+    HashDirectoryPage page(data);
+    for(int pageNum = head; pageNum != INT_MAX; pageNum = page.getNext()) {
+        if(this->readPage(pageNum, data) == -1) {
+            free(data);
+            return -1;
+        }
+        this->hashDirectoryPages.push_back(pageNum);
+        page.getBuckets(this->hashBuckets);
     }
-    if(!file.is_open()) return -1;
-
-    this->ixReadPageCounter++;
-    pageNum += MAX_HIDDEN_IX_PAGES;
-    file.seekg(pageNum*PAGE_SIZE, std::ios_base::beg);
-    file.read((char*)data, PAGE_SIZE);
+    free(data);
     return 0;
 }
 
 /**
- * writePage() - writes a given page into cache
- * @argument1 : page number to be written.
- * @argument2 : buffer to be written.
- * 
+ * writeHashDirectory() - write the primary page of each bucket of a hash index before a close.
+ *
+ * The directory only grows with the buckets, pages are added to its chain when needed.
+ *
  * Return : 0 on success, -1 on failure.
 */
-RC IXFileHandle::writePage(PageNum pageNum, const void *data) {
-    if(pageNum >= this->getNumberOfPages()) {
-        return -1;
+RC IXFileHandle::writeHashDirectory() {
+    unsigned capacity = (PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int))/sizeof(int);
+    unsigned pages = (this->hashBuckets.size() + capacity - 1)/capacity;
+    void* data = malloc(PAGE_SIZE);
+    while(this->hashDirectoryPages.size() < pages) {
+        this->allocatePage(data, HASH_DIRECTORY);
+        this->appendPage(data);
+        this->hashDirectoryPages.push_back(HashDirectoryPage(data).getPageNum());
     }
 
-    if(!file.is_open()) return -1;
-    this->ixWritePageCounter++;
-    pageNum += MAX_HIDDEN_IX_PAGES;
-    file.seekp(pageNum*PAGE_SIZE, std::ios_base::beg);
-    file.write((char*)data, PAGE_SIZE);
-
+    unsigned first = 0;
+    HashDirectoryPage page(data);
+    for(unsigned i = 0; i < this->hashDirectoryPages.size(); i++) {
+        this->readPage(this->hashDirectoryPages[i], data);
+        first = page.setBuckets(this->hashBuckets, first);
+        page.setNext(i + 1 < this->hashDirectoryPages.size() ? this->hashDirectoryPages[i + 1] : INT_MAX);
+        this->writePage(this->hashDirectoryPages[i], data);
+    }
+    free(data);
     return 0;
 }
 
 /**
- * appendPage() - Appends a new page to the file.
- * @argument1 : buffer of null data to be appended to file.
- * 
- * Neeed to call initPageDirectory() before calling this.
- * Return : 0 on success, -1 on failure.
+ * hasKeyFilter() - check if an index has a key filter, reading it from the file the first time.
+ *
+ * Return : true if the filter is up to date with the keys of the index.
 */
-RC IXFileHandle::appendPage(const void *data) {
-    if(!file.is_open()) {
-        return -1;
+bool IXFileHandle::hasKeyFilter() {
+    if(this->keyFilter.isEmpty() && this->keyFilterKeys > 0) this->loadKeyFilter(true);
+    return !this->keyFilter.isEmpty();
+}
+
+/**
+ * addToKeyFilter() - add the key of an insert to the key filter.
+ * @argument1 : hash of the key.
+ *
+ * A filter which was not read from the file is only marked out of date, so that inserts
+ * on a freshly opened file do not read it. Its pages are kept for the next build.
+ *
+ * Return : void.
+*/
+void IXFileHandle::addToKeyFilter(const unsigned long long hash) {
+    std::lock_guard<std::mutex> guard(this->keyFilterLatch);
+    if(this->keyFilterBuilding) {
+        this->pendingKeyHashes.push_back(hash);
+        return;
+    }
+    if(this->keyFilter.isEmpty()) {
+        this->keyFilterKeys = 0;
+        return;
+    }
+    this->keyFilter.add(hash);
+    this->keyFilterChanged = true;
+    if(this->keyFilter.isOverloaded()) {
+        this->keyFilter.clear();
+        this->keyFilterKeys = 0;
     }
-    file.seekp(0,std::ios_base::end);
-    file.write((char*)data,PAGE_SIZE);
-    file.seekp(0,std::ios_base::beg);
-    this->ixAppendPageCounter++;
-    this->numPages++;
-    return 0;
 }
 
 /**
- * initPageDirectory() - initialize the basic page structure of RBFM file.
+ * startKeyFilter() - start building the key filter, the keys inserted meanwhile are kept aside.
  *
- * calling this function before appenddPage
- * 
- * Return : page (*data) with directory initialized to default values.
+ * Return : false if another build is running.
 */
-RC IXFileHandle::initPageDirectory(void* data, RT type) {
-    RTS freeSpace  = 0;
-    RTS entries = 0, offset = 0;
-    int pageNum = getNumberOfPages();
+bool IXFileHandle::startKeyFilter() {
+    if(this->keyFilterBuilding) return false;
+    this->keyFilterBuilding = true;
+    this->pendingKeyHashes.clear();
+    return true;
+}
 
-    if(type == LEAF) {
-        freeSpace = PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int);
-        int sibling = INT_MAX;
-        memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int), (char*)&sibling, sizeof(int));
-    } else {
-        freeSpace = PAGE_SIZE - 4*sizeof(RTS) - sizeof(int);
+/**
+ * finishKeyFilter() - size the key filter for the keys read by a build and add them.
+ * @argument1 : hashes of the keys read from the index.
+ * @argument2 : false if the build failed, the filter is left out.
+ *
+ * Return : void.
+*/
+void IXFileHandle::finishKeyFilter(const std::vector<unsigned long long>& hashes, const bool built) {
+    this->keyFilterBuilding = false;
+    if(built) {
+        this->keyFilter.init(hashes.size() + this->pendingKeyHashes.size());
+        for(unsigned long long hash : hashes) this->keyFilter.add(hash);
+        for(unsigned long long hash : this->pendingKeyHashes) this->keyFilter.add(hash);
+        this->keyFilterChanged = true;
     }
+    this->pendingKeyHashes.clear();
+}
 
-    memcpy((char*)data + PAGE_SIZE - sizeof(RTS), (char*)&freeSpace, sizeof(RTS));
-    memcpy((char*)data + PAGE_SIZE - 2*sizeof(RTS), (char*)&entries, sizeof(RTS));
-    memcpy((char*)data + PAGE_SIZE - 3*sizeof(RTS), (char*)&type, sizeof(RTS));
-    memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS), (char*)&offset, sizeof(RTS));
-    memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), (char*)&pageNum, sizeof(int));
-
+/**
+ * loadKeyFilter() - read the chain of key filter pages.
+ * @argument1 : also take the filter kept in the pages, which has to be up to date.
+ *
+ * Files written before the key filters have no chain, their header points to a page of another type.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC IXFileHandle::loadKeyFilter(const bool readFilter) {
+    std::vector<unsigned long long> words;
+    void* data = malloc(PAGE_SIZE);
+    KeyFilterPage page(data);
+    this->keyFilterPages.clear();
+    for(int pageNum = this->keyFilterHead; pageNum != INT_MAX; pageNum = page.getNext()) {
+        if(this->readPage(pageNum, data) == -1 || this->getNodeType(data) != KEY_FILTER) break;
+        this->keyFilterPages.push_back(pageNum);
+        page.getWords(words);
+    }
+    free(data);
+    if(this->keyFilterPages.empty()) this->keyFilterHead = INT_MAX;
+    if(!readFilter) return 0;
+    if(words.size() < BLOOM_BLOCK_WORDS) {
+        this->keyFilterKeys = 0;
+        return -1;
+    }
+    this->keyFilter.assign(words, this->keyFilterKeys);
     return 0;
 }
 
 /**
- * getNodeType() - get the type of a node (leaf/internal).
- * @argument1 : buffer conatining node data. 
+ * writeKeyFilter() - write the key filter into its chain of pages before a close.
  *
- * Return : the type of the node.
+ * The chain is resized to the filter, a dropped filter frees all its pages.
+ *
+ * Return : 0 on success, -1 on failure.
 */
-RTS IXFileHandle::getNodeType(void* data) {
-    RTS type = 0;
-    memcpy((char*)&type, (char*)data + PAGE_SIZE - 3*sizeof(RTS), sizeof(RTS));
-    return type;
+RC IXFileHandle::writeKeyFilter() {
+    if(this->keyFilterPages.empty() && this->keyFilterHead != INT_MAX) this->loadKeyFilter(false);
+    const std::vector<unsigned long long>& words = this->keyFilter.getWords();
+    unsigned capacity = (PAGE_SIZE - 4*sizeof(RTS) - 2*sizeof(int))/sizeof(unsigned long long);
+    unsigned pages = (words.size() + capacity - 1)/capacity;
+    void* data = malloc(PAGE_SIZE);
+    while(this->keyFilterPages.size() > pages) {
+        this->freePage(this->keyFilterPages.back());
+        this->keyFilterPages.pop_back();
+    }
+    while(this->keyFilterPages.size() < pages) {
+        this->allocatePage(data, KEY_FILTER);
+        this->appendPage(data);
+        this->keyFilterPages.push_back(KeyFilterPage(data).getPageNum());
+    }
+
+    unsigned first = 0;
+    KeyFilterPage page(data);
+    for(unsigned i = 0; i < this->keyFilterPages.size(); i++) {
+        this->initPageDirectory(data, KEY_FILTER);
+        memcpy((char*)data + PAGE_SIZE - 4*sizeof(RTS) - sizeof(int), (char*)&(this->keyFilterPages[i]), sizeof(int));
+        first = page.setWords(words, first);
+        page.setNext(i + 1 < this->keyFilterPages.size() ? this->keyFilterPages[i + 1] : INT_MAX);
+        this->writePage(this->keyFilterPages[i], data);
+    }
+    free(data);
+    this->keyFilterHead = this->keyFilterPages.empty() ? INT_MAX : this->keyFilterPages[0];
+    this->keyFilterKeys = this->keyFilter.getNumberOfKeys();
+    this->keyFilterChanged = false;
+    return 0;
 }
 
 /**
@@ -1735,10 +4871,38 @@ void IXFileHandle::setRoot(const int newRoot) {
 RC IXFileHandle::collectCounterValues(unsigned &readPageCount, 
                                       unsigned &writePageCount, 
                                       unsigned &appendPageCount) {
-
     readPageCount = ixReadPageCounter;
     writePageCount = ixWritePageCounter;
     appendPageCount = ixAppendPageCounter;
     return 0;
 }
 
+
+/**
+ * setDeltaBuffer() - set the number of changes the delta buffer of the file holds.
+ * @argument1 : number of changes held before a merge, 0 turns the buffer off.
+ * @argument2 : type of the keys held.
+ *
+ * Return : void.
+*/
+void IXFileHandle::setDeltaBuffer(const unsigned capacity, const RTS indexType) {
+    this->deltaCapacity = capacity;
+    this->deltaIndexType = indexType;
+}
+
+/**
+ * getNextDeltaEntry() - find the first change held for an entry after a given one.
+ * @argument1 : entry to start from.
+ * @argument2 : true if the entry itself is returned when it is held.
+ * @argument3 : entry found.
+ * @argument4 : its change, above 0 for the inserts and -1 for a delete.
+ *
+ * Return : false if no change is held after the key.
+*/
+bool IXFileHandle::getNextDeltaEntry(const CompositeKey& key, const bool inclusive, CompositeKey& entry, int& change) {
+    auto itr = inclusive ? this->deltaEntries.lower_bound(key) : this->deltaEntries.upper_bound(key);
+    if(itr == this->deltaEntries.end()) return false;
+    entry = itr->first;
+    change = itr->second;
+    return true;
+}
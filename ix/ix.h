@@ -3,6 +3,12 @@
 
 #include <vector>
 #include <string>
+#include <fstream>
+#include <algorithm>
+#include <queue>
+#include <map>
+#include <mutex>
+#include <atomic>
 
 #include "../rbf/rbfm.h"
 
@@ -10,25 +16,191 @@
 
 typedef unsigned short RTS;
 const int MAX_HIDDEN_IX_PAGES = 1;
+const int MAX_CACHE_PAGE_PER_INDEX = 256; // internal nodes are pinned, leaves are evicted first
 const int PREV_MERGE = -3;
 const int PAGE_SCANNED = -1;
 const int LAST_ENTRY = -2;
+const float BULK_LOAD_FILL_FACTOR = 0.9;               // fraction of a node filled by the bulk loader
+const unsigned BULK_LOAD_BUFFER_SIZE = 1024*PAGE_SIZE;  // entries sorted in memory before spilling a run
+const int POSTING_LIST = INT_MAX - 1;                   // rid page number of an entry holding a posting list
+const RTS POSTING_INLINE_LIMIT = PAGE_SIZE/8;           // larger posting lists move to posting pages
+const RTS INCLUDE_PAYLOAD = 0x100;                      // index type flag, the entries carry INCLUDE columns
+const int MAX_FREE_IX_PAGES = PAGE_SIZE/sizeof(int) - 17; // free pages listed in the header page, before the format marker
+// Format marker in the last int of the header page, the nodes of the files carrying it have a key slot directory.
+// Files without it are not opened, their nodes would be read through a directory they do not have.
+const int IX_FORMAT_MARKER = 0x31535849;
+const int MAX_TREE_HEIGHT = 32;                         // levels recorded by a descent, far above a real BTree
+const int HASH_INITIAL_BUCKETS = 4;                     // buckets of a new hash index, doubled by each round of splits
+const int BLOOM_BLOCK_WORDS = 8;                        // 64 bit words of a Bloom filter block, one cache line
+const int BLOOM_BITS_PER_KEY = 10;                      // filter bits per expected key, about 1% false positives
+const unsigned DELTA_BUFFER_ENTRIES = 4096;             // changes held by a delta buffer before they are merged
+const int LEAF_LATCHES = 64;                            // latches of the leaves changed in place, shared by page number
 
 enum NodeType {
     LEAF = 0,
     INTERNAL = 1,
+    POSTING = 2,
+    HASH_DIRECTORY = 3,
+    KEY_FILTER = 4,
+};
+
+/* Kind of the index kept in a file, chosen when the file is created */
+enum IndexKind {
+    BTREE_INDEX = 0,
+    HASH_INDEX = 1,
 };
 
 class IXFileHandle;
 class IndexManager;
 class IX_ScanIterator;
 
+/* With posting lists a key with duplicates has a single leaf entry, its rid is (POSTING_LIST, n)
+ * and is followed by n bytes: [int count][int head page][delta encoded rids | int tail page].
+ * The rids are kept in the entry while small, else in a chain of posting pages from head to tail. */
+inline bool isPostingList(const RID& rid) {
+    return rid.pageNum == POSTING_LIST;
+}
+
+/* An index with INCLUDE columns has INCLUDE_PAYLOAD set in its index type. Its leaf entries are
+ * followed by [RTS n][n bytes] of included columns, separators in internal nodes have n = 0. */
+inline RTS getValueType(RTS type) {
+    return type & ~INCLUDE_PAYLOAD;
+}
+
+/* Non owning view of a <key, rid> entry, points into a node page or into a CompositeKey */
+class KeyView {
+public:
+    const char* key = NULL;
+    RTS keyLen = 0;
+    RID rid;
+    RTS payloadSize = 0;            // [RTS n][n bytes] of INCLUDE columns after the rid
+
+    KeyView() {}
+
+    // offset = 0 a <key, rid> is passed, else a whole page is passed.
+    KeyView(RTS type, const void* data, RTS offset = 0) {
+        key = (const char*)data + offset;
+        keyLen = sizeof(int);
+        if(getValueType(type) == TypeVarChar) {
+            int len = 0;
+            memcpy((char*)&len, key, sizeof(int));
+            keyLen += len;
+        }
+        memcpy((char*)&rid.pageNum, key + keyLen, sizeof(int));
+        memcpy((char*)&rid.slotNum, key + keyLen + sizeof(int), sizeof(RTS));
+        if(type & INCLUDE_PAYLOAD) {
+            memcpy((char*)&payloadSize, getPayload(), sizeof(RTS));
+            payloadSize += sizeof(RTS);
+        }
+    }
+
+    RTS getKeyLength() const {
+        return keyLen + sizeof(int) + sizeof(RTS) + (isPostingList(rid) ? rid.slotNum : 0) + payloadSize;
+    }
+
+    const char* getPostingList() const {
+        return key + keyLen + sizeof(int) + sizeof(RTS);
+    }
+
+    const char* getPayload() const {
+        return key + keyLen + sizeof(int) + sizeof(RTS);
+    }
+};
+
+/* Three way comparison of two key values, VarChars are compared bytewise and then by length */
+template<AttrType T> inline int compareKeyValues(const char* a, const char* b);
+
+template<> inline int compareKeyValues<TypeInt>(const char* a, const char* b) {
+    int a_i = 0, b_i = 0;
+    memcpy((char*)&a_i, a, sizeof(int));
+    memcpy((char*)&b_i, b, sizeof(int));
+    return (a_i > b_i) - (a_i < b_i);
+}
+
+template<> inline int compareKeyValues<TypeReal>(const char* a, const char* b) {
+    float a_f = 0, b_f = 0;
+    memcpy((char*)&a_f, a, sizeof(float));
+    memcpy((char*)&b_f, b, sizeof(float));
+    return (a_f > b_f) - (a_f < b_f);
+}
+
+template<> inline int compareKeyValues<TypeVarChar>(const char* a, const char* b) {
+    int len_a = 0, len_b = 0;
+    memcpy((char*)&len_a, a, sizeof(int));
+    memcpy((char*)&len_b, b, sizeof(int));
+    int retVal = memcmp(a + sizeof(int), b + sizeof(int), len_a < len_b ? len_a : len_b);
+    if(retVal != 0) return retVal;
+    return (len_a > len_b) - (len_a < len_b);
+}
+
+inline int compareKeyValues(RTS type, const char* a, const char* b) {
+    type = getValueType(type);
+    if(type == TypeInt) return compareKeyValues<TypeInt>(a, b);
+    if(type == TypeReal) return compareKeyValues<TypeReal>(a, b);
+    return compareKeyValues<TypeVarChar>(a, b);
+}
+
+/* Scan keys carry the rid (INT_MAX, 0) to match every rid of an equal key,
+ * and (INT_MAX, USHRT_MAX) to never be smaller than an equal key.
+ * A posting list entry holds every rid of its key, so it matches them too. */
+inline bool isKeyEqual(int valueCmp, const RID& a, const RID& b) {
+    if(valueCmp != 0) return false;
+    // for insert and deletion
+    if(a == b) return true;
+    // for scan equality, LE_OP and GE_OP
+    if((a.pageNum == INT_MAX && a.slotNum == 0) || (b.pageNum == INT_MAX && b.slotNum == 0)) return true;
+    if((a.pageNum == INT_MAX && a.slotNum == USHRT_MAX) ||
+       (b.pageNum == INT_MAX && b.slotNum == USHRT_MAX)) return false;
+    return isPostingList(a) || isPostingList(b);
+}
+
+inline bool isKeyGreater(int valueCmp, const RID& a, const RID& b) {
+    if(valueCmp != 0) return valueCmp > 0;
+    if((a.pageNum == INT_MAX && a.slotNum == USHRT_MAX) ||
+       (b.pageNum == INT_MAX && b.slotNum == USHRT_MAX)) return false;
+    if(isPostingList(a) || isPostingList(b)) return false;
+    return a > b;
+}
+
+/* a >= b, a NULL key (full scan) matches everything */
+template<AttrType T> inline bool isKeyGreaterOrEqual(const KeyView& a, const KeyView& b) {
+    if(a.key == NULL || b.key == NULL) return true;
+    int valueCmp = compareKeyValues<T>(a.key, b.key);
+    return isKeyEqual(valueCmp, a.rid, b.rid) || isKeyGreater(valueCmp, a.rid, b.rid);
+}
+
+/* Number of leading bytes two byte strings have in common */
+inline int getCommonPrefixLength(const char* a, int len_a, const char* b, int len_b) {
+    int len = len_a < len_b ? len_a : len_b;
+    int i = 0;
+    while(i < len && a[i] == b[i]) i++;
+    return i;
+}
+
+/* Number of leading bytes two VarChar values have in common */
+inline int getCommonPrefixLength(const char* a, const char* b) {
+    int len_a = 0, len_b = 0;
+    memcpy((char*)&len_a, a, sizeof(int));
+    memcpy((char*)&len_b, b, sizeof(int));
+    return getCommonPrefixLength(a + sizeof(int), len_a, b + sizeof(int), len_b);
+}
+
 class CompositeKey {
 private:
     void* key = NULL;
     RID rid;
     RTS keyType;
     RTS keyLen = 0;
+    RTS keyCapacity = 0;
+    RTS payloadSize = 0;
+
+    // makes sure the key buffer holds atleast size bytes, the buffer is reused when possible.
+    void reserve(RTS size) {
+        if(key != NULL && keyCapacity >= size) return;
+        if(key != NULL) free(key);
+        key = malloc(size);
+        keyCapacity = size;
+    }
 public:
     void* getWritableKey();
 
@@ -36,92 +208,79 @@ public:
 
     RID getRID() const;
 
+    KeyView getView() const;
+
+    void assign(RTS type, const KeyView& view);
+
+    void assign(RTS type, const KeyView& view, const char* prefix, RTS prefixLen);
+
+    void assignSeparator(RTS type, const KeyView& leftMax, const KeyView& rightMin);
+
     void updateSlotNum(RTS slotNum);
 
     void updatePageNum(int pageNum);
 
+    void setPostingList(const std::vector<char>& list);
+
+    void setMatchAnyRID();
+
+    void clearPayload();
+
     CompositeKey() {
         key = NULL;
         keyLen = 0;
     }
 
+    // with INCLUDE_PAYLOAD in the type, data is the key value followed by [RTS n][n bytes].
     CompositeKey(RTS type, const void* data, const RID& r) {
         keyType = type;
-        if(keyType == TypeInt) {
-            key = malloc(sizeof(int) + sizeof(int) + sizeof(RTS));
-            memcpy((char*)key, (char*)data, sizeof(int));
-            this->keyLen = sizeof(int);
-        } else if (keyType == TypeReal) {
-            key = malloc(sizeof(float) + sizeof(int) + sizeof(RTS));
-            memcpy((char*)key, (char*)data, sizeof(float));
-            this->keyLen = sizeof(float);
-        } else {
+        if(getValueType(keyType) == TypeVarChar) {
             int len = 0;
             memcpy((char*)&len, (char*)data, sizeof(int));
-            key = malloc(sizeof(int) + len + sizeof(int) + sizeof(RTS));
-            memcpy((char*)key, (char*)data, len + sizeof(int));
             this->keyLen = len + sizeof(int);
+        } else {
+            this->keyLen = sizeof(int);
         }
         rid = r;
+        if(keyType & INCLUDE_PAYLOAD) {
+            memcpy((char*)&payloadSize, (char*)data + keyLen, sizeof(RTS));
+            payloadSize += sizeof(RTS);
+        }
+        reserve(getKeyLength());
+        memcpy((char*)key, (char*)data, keyLen);
+        memcpy((char*)key + keyLen + sizeof(int) + sizeof(RTS), (char*)data + keyLen, payloadSize);
     }
 
-   // offset = 0 a >key, rid> is passed, else a whole page is passed.
+   // offset = 0 a <key, rid> is passed, else a whole page is passed.
    CompositeKey(RTS type, const void* data, RTS offset = 0) {
-        keyType = type;
-        if(keyType == TypeInt) {
-            key = malloc(sizeof(int) + sizeof(int) + sizeof(RTS));
-            memcpy((char*)key, (char*)data + offset, sizeof(int));
-            memcpy((char*)&rid.pageNum, (char*)data + offset + sizeof(int), sizeof(int));
-            memcpy((char*)&rid.slotNum, (char*)data + offset + sizeof(int) + sizeof(int), sizeof(RTS));
-            this->keyLen = sizeof(int);
-        } else if(keyType == TypeReal) {
-            key = malloc(sizeof(float) + sizeof(int) + sizeof(RTS));
-            memcpy((char*)key, (char*)data + offset, sizeof(float));
-            memcpy((char*)&rid.pageNum, (char*)data + offset + sizeof(float), sizeof(int));
-            memcpy((char*)&rid.slotNum, (char*)data + offset +  sizeof(float) + sizeof(int), sizeof(RTS));
-            this->keyLen = sizeof(float);
-        } else {
-            int len = 0;
-            memcpy((char*)&len, (char*)data + offset, sizeof(int));
-            key = malloc(sizeof(int) + len + sizeof(int) + sizeof(RTS));
-            memcpy((char*)key, (char*)data + offset, len + sizeof(int));
-            memcpy((char*)&rid.pageNum, (char*)data + offset + sizeof(int) + len, sizeof(int));
-            memcpy((char*)&rid.slotNum, (char*)data + offset + sizeof(int) + len + sizeof(int), sizeof(RTS));
-            this->keyLen = len + sizeof(int);
-        }
+        assign(type, KeyView(type, data, offset));
    }
 
     /* Assignment and Copy C'tor */
     /* Follows C++ Rule of 3. Note move c'tor and assignement is not reqd. in this case */
     CompositeKey& operator=(const CompositeKey& ckey) {
-        if(this->key != NULL) free(this->key);
+        if(this == &ckey) return *this;
         if(ckey.key == NULL) {
+            if(this->key != NULL) free(this->key);
             this->key = NULL;
             this->keyLen = 0;
+            this->keyCapacity = 0;
+            this->payloadSize = 0;
             return *this;
         }
 
-        this->keyLen = ckey.keyLen;
-        this->key = malloc(ckey.getKeyLength());
-        memcpy((char*)this->key, (char*)ckey.key, ckey.getKeyLength());
-        this->keyType = ckey.keyType;
-        this->rid = ckey.rid;
+        assign(ckey.keyType, ckey.getView());
         return *this;
     }
 
     CompositeKey(const CompositeKey& ckey) {
-        if(this->key != NULL) free(this->key);
         if(ckey.key == NULL) {
             this->key = NULL;
             this->keyLen = 0;
             return;
         }
 
-        this->keyLen = ckey.keyLen;
-        this->key = malloc(ckey.getKeyLength());
-        memcpy((char*)this->key, (char*)ckey.key, ckey.getKeyLength());
-        this->keyType = ckey.keyType;
-        this->rid = ckey.rid;
+        assign(ckey.keyType, ckey.getView());
         return;
     }
 
@@ -136,106 +295,13 @@ public:
         if(this->key == NULL || b.key == NULL) {
             return true;
         }
-
-        if(keyType == TypeInt) {
-            int a_i = 0;
-            int b_i = 0;
-            memcpy((char*)&a_i, (char*)this->key, sizeof(int));
-            memcpy((char*)&b_i, (char*)b.key, sizeof(int));
-            if (a_i == b_i) {
-                // for insert and deletion
-                if(this->rid == b.rid) return true;
-                // for scan equality, LE_OP and GE_OP 
-                if((this->rid.pageNum == INT_MAX && this->rid.slotNum == 0) ||
-                   (b.rid.pageNum == INT_MAX && b.rid.slotNum == 0)) return true;
-            }
-        } else if(keyType == TypeReal) {
-            float a_f = 0;
-            float b_f = 0;
-            memcpy((char*)&a_f, (char*)this->key, sizeof(float));
-            memcpy((char*)&b_f, (char*)b.key, sizeof(float));
-            if ( a_f == b_f ) {
-                if(this->rid == b.rid) return true;
-                if((this->rid.pageNum == INT_MAX && this->rid.slotNum == 0) ||
-                   (b.rid.pageNum == INT_MAX && b.rid.slotNum == 0)) return true;
-            }
-        } else {
-            int len_a = 0, len_b = 0;
-            memcpy((char*)&len_a, (char*)this->key, sizeof(int));
-            memcpy((char*)&len_b, (char*)b.key, sizeof(int));
-            if(len_a != len_b) return false;
-
-            RT retVal = -2;
-            char str1[len_a + 1];
-            char str2[len_b + 1];
-            str1[len_a] = '\0';
-            str2[len_b] = '\0';
-            memcpy((char*)str1, (char*)this->key + sizeof(int), len_a);
-            memcpy((char*)str2, (char*)b.key + sizeof(int), len_b);
-
-            retVal = strcmp(str1, str2);
-
-            if (retVal == 0) {
-                if(this->rid == b.rid) return true;
-                if((this->rid.pageNum == INT_MAX && this->rid.slotNum == 0) ||
-                  (b.rid.pageNum == INT_MAX && b.rid.slotNum == 0)) return true;
-            }
-        }
-        return false;
+        return isKeyEqual(compareKeyValues(keyType, (char*)this->key, (char*)b.key), this->rid, b.rid);
     }
 
     bool operator>(const CompositeKey& b) const {
         /*used for full scan */
         if(this->key == NULL  || b.key == NULL) return true;
-
-        if(keyType == TypeInt) {
-            int a_i = 0;
-            int b_i = 0;
-            memcpy((char*)&a_i, (char*)this->key, sizeof(int));
-            memcpy((char*)&b_i, (char*)b.key, sizeof(int));
-            if(a_i > b_i) {
-                return true;
-            } else if (a_i == b_i) {
-                if((this->rid.pageNum == INT_MAX && this->rid.slotNum == USHRT_MAX) || 
-                   (b.rid.pageNum == INT_MAX && b.rid.slotNum == USHRT_MAX)) return false;
-                return this->rid > b.rid;
-            }
-        } else if(keyType == TypeReal) {
-            float a_f = 0;
-            float b_f = 0;
-            memcpy((char*)&a_f, (char*)this->key, sizeof(float));
-            memcpy((char*)&b_f, (char*)b.key, sizeof(float));
-            if (a_f > b_f) {
-                return true;
-            } else if(a_f == b_f) {
-                if((this->rid.pageNum == INT_MAX && this->rid.slotNum == USHRT_MAX) || 
-                    (b.rid.pageNum == INT_MAX && b.rid.slotNum == USHRT_MAX)) return false;
-                return this->rid > b.rid;
-            }
-        } else {
-            int len_a = 0, len_b = 0;
-            memcpy((char*)&len_a, (char*)this->key, sizeof(int));
-            memcpy((char*)&len_b, (char*)b.key, sizeof(int));
-            //if(len_a > len_b) return true;
-            //if(len_b > len_a) return false;
-
-            RT retVal = -2;
-            char str1[len_a + 1];
-            char str2[len_b + 1];
-            str1[len_a] = '\0';
-            str2[len_b] = '\0';
-            memcpy((char*)str1, (char*)this->key + sizeof(int), len_a);
-            memcpy((char*)str2, (char*)b.key + sizeof(int), len_b);
-            retVal = strcmp(str1, str2);
-            if (retVal > 0) {
-                return true;
-            } else if(retVal == 0) {
-                if((this->rid.pageNum == INT_MAX && this->rid.slotNum == USHRT_MAX) ||
-                   (b.rid.pageNum == INT_MAX && b.rid.slotNum == USHRT_MAX)) return false;
-                return this->rid > b.rid;
-            }
-        }
-        return false;
+        return isKeyGreater(compareKeyValues(keyType, (char*)this->key, (char*)b.key), this->rid, b.rid);
     }
 
     bool operator!=(const CompositeKey& b) const {
@@ -256,21 +322,29 @@ public:
 
     /* Print overload for CompositeKye */
     friend ostream &operator<<( ostream &output, const CompositeKey &cKey ) {
-         if(cKey.keyType == TypeInt) {
+         output<<"\"";
+         if(getValueType(cKey.keyType) == TypeInt) {
              int val = 0;
              memcpy((char*)&val, (char*)cKey.key, sizeof(int));
-             output<<"\""<<val<<":[("<<cKey.rid.pageNum<<","<<cKey.rid.slotNum<<")]\"";
-         } else if(cKey.keyType == TypeReal) {
+             output<<val;
+         } else if(getValueType(cKey.keyType) == TypeReal) {
              float val = 0;
              memcpy((char*)&val, (char*)cKey.key, sizeof(float));
-             output<<"\""<<val<<":[("<<cKey.rid.pageNum<<","<<cKey.rid.slotNum<<")]\"";
+             output<<val;
          } else {
              char* str = new char[cKey.keyLen - sizeof(int)+1];
              memcpy((char*)str, (char*)(cKey.key) + sizeof(int), cKey.keyLen - sizeof(int));
              str[cKey.keyLen - sizeof(int)] = '\0';
-             output<<"\""<<str<<":[("<<cKey.rid.pageNum<<","<<cKey.rid.slotNum<<")]\"";
+             output<<str;
              delete[] str;
          }
+         if(isPostingList(cKey.rid)) {
+             int count = 0;
+             memcpy((char*)&count, cKey.getView().getPostingList(), sizeof(int));
+             output<<":["<<count<<" rids]\"";
+         } else {
+             output<<":[("<<cKey.rid.pageNum<<","<<cKey.rid.slotNum<<")]\"";
+         }
          return output;
    }
 };
@@ -327,6 +401,32 @@ public:
 
     bool checkIfUnderUtilized() const;
 
+    RTS getUsedSpace() const;
+
+    RTS getKeyDirectoryStart() const;
+
+    RTS getPrefixLength() const;
+
+    const char* getPrefix() const;
+
+    int compareKeyAt(const RTS indexType, const RTS offset, const KeyView& findKey) const;
+
+    RTS getKeySlotOffset(const RTS slot) const;
+
+    void setKeySlotOffset(const RTS slot, const RTS offset);
+
+    RTS findKeySlot(const RTS indexType, const CompositeKey& findKey) const;
+
+    RTS findKeySlot(const RTS indexType, const KeyView& findKey) const;
+
+    template<AttrType T> RTS findKeySlot(const KeyView& findKey) const;
+
+    RTS findSlotOfOffset(const RTS offset) const;
+
+    void insertKeySlot(const RTS slot, const RTS offset, const RT shift);
+
+    void removeKeySlot(const RTS slot, const RT shift);
+
     void getKeyFromOffset(const RTS indexType, RTS offset, CompositeKey& key) const;
 
     void* getWritableData() const;
@@ -347,6 +447,12 @@ public:
 
     void insertKeyAtOffset(const RTS indexType, RTS offset, CompositeKey& key);
 
+    void appendKey(const RTS indexType, CompositeKey& key);
+
+    void appendKey(const KeyView& key);
+
+    void appendPointer(const int pointer);
+
     RTS splitNode(const RTS indexType, Node& newNode, CompositeKey& keyToPushUp);
 
     RTS mergeNodes(const RTS indexType, Node& b);
@@ -428,24 +534,201 @@ public:
     virtual int removeKey(const RTS indexType, const RTS keyOffset) override;
 
     virtual void printKeys(const RTS indexType) override;
+
+    void decodeKeys(const RTS indexType, std::vector<char>& buffer, std::vector<unsigned>& offsets) const;
+
+    void buildFromKeys(const RTS indexType, const std::vector<char>& buffer,
+                       const std::vector<unsigned>& offsets, unsigned first, unsigned last);
+
+    RTS getRequiredSpace(const RTS indexType, const CompositeKey& newKey) const;
+
+    bool canMerge(const Node& b) const;
+
+    RC splitLeaf(const RTS indexType, LeafNode& newNode, CompositeKey& entry, CompositeKey& keyToPushUp,
+                 const bool appendSplit = false);
+
+    RT findValueOffset(const RTS indexType, const KeyView& findKey) const;
+};
+
+/* Page of a posting list chain, the rids are delta encoded from the start of the page */
+class PostingPage {
+private:
+    void* data;
+public:
+    PostingPage(void* data) {
+        this->data = data;
+    }
+
+    RTS getCount() const;
+
+    int getPageNum() const;
+
+    int getNext() const;
+
+    void setNext(const int next);
+
+    void getRIDs(std::vector<RID>& rids) const;
+
+    unsigned setRIDs(const std::vector<RID>& rids, unsigned first, unsigned last);
+};
+
+/* Page of the bucket directory of a hash index, the primary page of each bucket in bucket order.
+ * The pages are chained like posting pages, the number of buckets listed is in the entries field. */
+class HashDirectoryPage {
+private:
+    void* data;
+public:
+    HashDirectoryPage(void* data) {
+        this->data = data;
+    }
+
+    RTS getCount() const;
+
+    int getPageNum() const;
+
+    int getNext() const;
+
+    void setNext(const int next);
+
+    void getBuckets(std::vector<int>& buckets) const;
+
+    unsigned setBuckets(const std::vector<int>& buckets, unsigned first);
+};
+
+/* Blocked Bloom filter over 64 bit key hashes. A key sets one bit in each word of a single block,
+ * so a lookup reads one cache line and tests its words independently of each other. */
+class BloomFilter {
+private:
+    std::vector<unsigned long long> words;  // BLOOM_BLOCK_WORDS words per block
+    unsigned numBlocks;
+    unsigned numKeys;
+
+    unsigned getBlock(const unsigned long long hash) const;
+
+    static void getMask(const unsigned long long hash, unsigned long long* mask);
+
+public:
+    BloomFilter() : numBlocks(0), numKeys(0) {}
+
+    // Size the filter for the given number of keys, any previous content is dropped.
+    void init(const unsigned expectedKeys);
+
+    void clear();
+
+    // A filter without blocks is not built, it can not answer a lookup.
+    bool isEmpty() const { return numBlocks == 0; }
+
+    void add(const unsigned long long hash);
+
+    // False when the key was never added, true when it probably was.
+    bool mayContain(const unsigned long long hash) const;
+
+    // Keys added past twice the expected count raise the false positives well above the target.
+    bool isOverloaded() const;
+
+    unsigned getNumberOfKeys() const { return numKeys; }
+
+    const std::vector<unsigned long long>& getWords() const { return words; }
+
+    // Take the words of a filter read back from a file.
+    void assign(const std::vector<unsigned long long>& words, const unsigned numKeys);
+
+    // Hash of an attribute value in the record format, -0.0 and 0.0 hash alike.
+    static unsigned long long hashValue(const AttrType type, const void* value);
+};
+
+/* Page of the Bloom filter of an index, the filter words are chained over pages like posting pages.
+ * The number of words stored in a page is in the entries field. */
+class KeyFilterPage {
+private:
+    void* data;
+public:
+    KeyFilterPage(void* data) {
+        this->data = data;
+    }
+
+    RTS getCount() const;
+
+    int getPageNum() const;
+
+    int getNext() const;
+
+    void setNext(const int next);
+
+    void getWords(std::vector<unsigned long long>& words) const;
+
+    unsigned setWords(const std::vector<unsigned long long>& words, unsigned first);
+};
+
+/* Root to leaf path of a descent, level 0 is the root and the leaf is at depth - 1.
+ * Its page buffers are kept for the next descents of its owner. */
+class TreePath {
+private:
+    void* pages[MAX_TREE_HEIGHT];
+
+    TreePath(const TreePath&);              // Prevent construction by copying
+    TreePath& operator=(const TreePath&);   // Prevent assignment
+
+public:
+    int depth;
+    int pageNums[MAX_TREE_HEIGHT];
+    RTS keyOffsets[MAX_TREE_HEIGHT];        // key before the child followed in an internal node
+    int siblings[MAX_TREE_HEIGHT];          // child after the one followed, INT_MAX if it is the last
+    int prevSiblings[MAX_TREE_HEIGHT];      // child before the one followed when it is the last, else INT_MAX
+
+    TreePath();
+
+    ~TreePath();
+
+    RC descend(IXFileHandle& ixFileHandle, const RTS indexType, const CompositeKey& key,
+               std::unique_lock<std::mutex>* leafGuard = NULL);
+
+    void* startAtRoot();
+
+    void* getPage(const int level) { return pages[level]; }
+
+    int getLeaf() { return pageNums[depth - 1]; }
 };
 
 class IndexManager {
 private:
-    RC insertEntryRecursively(IXFileHandle& ixFileHandle, const RTS indexType, Node& node, CompositeKey& entry, 
-                              int& newChildEntry, CompositeKey& keyToPushUp);
+    RC insertEntryOnPath(IXFileHandle& ixFileHandle, const RTS indexType, TreePath& path, CompositeKey& entry);
 
     void depthFirstTraversal(IXFileHandle &ixFileHandle, const RTS indexType, Node& node) const;
 
-    RC deleteEntryRecursively(IXFileHandle& ixFileHandle, const RTS indexType, Node& node,
-                              CompositeKey& deleteKey, Node& parent, int parentSibling, 
-                              int parentPrevSibling, int parentKeyOffset, int& oldChildPointer);
+    RC deleteEntryFromLevel(IXFileHandle& ixFileHandle, const RTS indexType, TreePath& path,
+                            const int level, CompositeKey& deleteKey, int& oldNodePointer);
+
+    RC addToPostingList(IXFileHandle& ixFileHandle, const RTS indexType, LeafNode& leaf, CompositeKey& entry);
+
+    bool insertIntoRightmostLeaf(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& entry);
+
+    bool insertIntoLeaf(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& entry);
+
+    bool deleteFromLeaf(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& deleteKey);
+
+    RC insertIntoTree(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& entry);
+
+    RC deleteFromTree(IXFileHandle& ixFileHandle, const RTS indexType, CompositeKey& deleteKey);
+
+    bool isEntryInTree(IXFileHandle& ixFileHandle, const RTS indexType, const CompositeKey& entry);
+
+    RC mergeDeltaBuffer(IXFileHandle& ixFileHandle);
 public:
     static IndexManager &instance();
 
     // Create an index file.
     RC createFile(const std::string &fileName);
 
+    // Create an index file which keeps the rids of duplicate keys in posting lists.
+    RC createFile(const std::string &fileName, const bool postingLists);
+
+    // Create an index file whose entries carry INCLUDE columns after the key.
+    RC createFile(const std::string &fileName, const bool postingLists, const bool includePayload);
+
+    // Create an index file of the given kind, a hash index only answers equality scans in one bucket.
+    RC createFile(const std::string &fileName, const IndexKind indexKind);
+
     // Delete an index file.
     RC destroyFile(const std::string &fileName);
 
@@ -473,6 +756,33 @@ public:
     // Print the B+ tree in pre-order (in a JSON record format)
     void printBtree(IXFileHandle &ixFileHandle, const Attribute &attribute) const;
 
+    // Rewrite the B+ tree into contiguous full nodes, the file keeps only the pages in use.
+    RC compactFile(IXFileHandle &ixFileHandle, const Attribute &attribute,
+                   const float fillFactor = BULK_LOAD_FILL_FACTOR);
+
+    // Encode the columns of a multi-column key into one VarChar key, ordered column by column.
+    int encodeCompositeKey(const std::vector<Attribute> &keyAttrs, const void *tuple, void *key,
+                           const bool prefixEnd = false) const;
+
+    // VarChar attribute under which a multi-column key is indexed.
+    Attribute getCompositeKeyAttribute(const std::vector<Attribute> &keyAttrs) const;
+
+    // Copy of the Bloom filter of the keys in the index, built by a scan of the entries on the first
+    // call and then kept up to date by the inserts and saved in the file.
+    RC getKeyFilter(IXFileHandle &ixFileHandle, const Attribute &attribute, BloomFilter &filter);
+
+    // Number of levels of the B+ tree and of pages on its leaf level, a hash index has one level of buckets.
+    RC getTreeShape(IXFileHandle &ixFileHandle, const Attribute &attribute, int &height, int &leafPages);
+
+    // Keep the inserts and deletes of a BTree in memory and merge them into the tree in key order once
+    // capacity of them are held, when the file is closed or on flushDeltaBuffer(). Scans read both.
+    // A capacity of 0 merges the held changes and turns the buffer off.
+    RC setDeltaBuffer(IXFileHandle &ixFileHandle, const Attribute &attribute,
+                      const unsigned capacity = DELTA_BUFFER_ENTRIES);
+
+    // Merge the changes held by the delta buffer of an index into its BTree.
+    RC flushDeltaBuffer(IXFileHandle &ixFileHandle);
+
 protected:
     IndexManager() = default;                                                   // Prevent construction
     ~IndexManager() = default;                                                  // Prevent unwanted destruction
@@ -486,15 +796,39 @@ private:
     IXFileHandle* ixFileHandle;
     CompositeKey lowCKey;
     CompositeKey highCKey;
+    CompositeKey nextCKey;
     RTS indexType;
     int lastPageNum;
-    int lastRet;
+    unsigned version;                       // version of the BTree when lastPageNum was found
+    int dataPage;                           // leaf held in data, -1 if none
+    RTS nextSlot;                           // slot of the next entry in that leaf
     void* data;
-
-    RC treeSearch(const RTS indexType, Node& node, const CompositeKey& lowKey);
+    std::vector<RID> postingRids;           // posting list of the last key returned
+    unsigned postingPos;
+    TreePath path;
+    int hashBucket;                         // buckets read by a scan of a hash index, -1 on a BTree
+    bool hashProbe;                         // equality scan of a hash index, reads the bucket of its key only
+    std::vector<CompositeKey> bucketEntries;// matching entries of the last bucket read
+    unsigned bucketPos;
+    CompositeKey startCKey;                 // low key of the scan, then the last entry returned
+    bool started;                           // an entry was returned, startCKey holds it
+    CompositeKey treeCKey;                  // next entry of the BTree, returned after the delta entries before it
+    bool treePending;
+    bool treeDone;
+    bool merging;                           // the scan reads the delta buffer too, set once one was seen
 
     RC searchNode(const RTS indexType, const CompositeKey& lowKey);
 
+    RC getNextTreeEntry(RID &rid, void *key);
+
+    RC getNextMergedEntry(RID &rid, void *key);
+
+    void setLowKeyAfter(const CompositeKey& entry);
+
+    void restartTreeScan();
+
+    RC getNextHashEntry(RID &rid, void *key);
+
     void initComparisonKeys(const void* lowKey, const void* highKey,
                             bool lowKeyInclusive, bool highKeyInclusive);
 
@@ -519,18 +853,96 @@ public:
     RC close();
 };
 
+/* Builds a B+ tree bottom up from unsorted <key, rid> entries */
+class IX_BulkLoader {
+private:
+    IXFileHandle* ixFileHandle;
+    RTS indexType;
+    float fillFactor;
+    unsigned bufferSize;
+    std::vector<char> entries;              // entries buffered in memory, back to back
+    std::vector<unsigned> entryOffsets;
+    std::vector<std::string> runFiles;      // sorted runs spilled to disk
+    std::vector<char> leafEntries;          // entries of the leaf being filled
+    std::vector<unsigned> leafOffsets;
+    int leafKeySpace;                       // space of the above entries without prefix compression
+    void* leafData;
+    std::vector<int> children;              // nodes of the level being built
+    std::vector<CompositeKey> separators;   // separator after each of the above nodes
+    int lastLeaf;
+    CompositeKey groupKey;                  // key whose rids are gathered into a posting list
+    std::vector<RID> groupRids;
+
+    RC spillRun();
+
+    void sortEntries();
+
+    RC mergeRuns();
+
+    RC addSortedEntry(const KeyView& entry);
+
+    RC flushGroup();
+
+    RC addToLeaf(const KeyView& entry);
+
+    RC flushLeaf(const KeyView* nextEntry);
+
+    RC buildInternalLevel(std::vector<int>& levelChildren, std::vector<CompositeKey>& levelSeparators);
+
+public:
+    IX_BulkLoader();
+
+    ~IX_BulkLoader();
+
+    RC initialize(IXFileHandle& ixFileHandle, const Attribute& attribute,
+                  const float fillFactor = BULK_LOAD_FILL_FACTOR,
+                  const unsigned bufferSize = BULK_LOAD_BUFFER_SIZE);
+
+    // Add an entry, the entries can come in any order
+    RC addEntry(const void* key, const RID& rid);
+
+    // Sort the entries and write the tree
+    RC finish();
+};
+
 class IXFileHandle : public FileHandle {
 private:
     // variables to keep counter for each operation
     void* hiddenData;
-    unsigned ixReadPageCounter;
-    unsigned ixWritePageCounter;
-    unsigned ixAppendPageCounter;
+    std::atomic<unsigned> ixReadPageCounter;
+    std::atomic<unsigned> ixWritePageCounter;
+    std::atomic<unsigned> ixAppendPageCounter;
+    std::atomic<unsigned> ixDiskReadPageCounter;
     int numPages;
     int root;
     RTS rootType;
+    int postingLists;
+    int includePayload;
+    std::atomic<int> rightmostLeaf;
+    std::vector<int> freePages;
+    int indexKind;
+    int hashLevel;                          // round of splits of a hash index, HASH_INITIAL_BUCKETS << hashLevel buckets
+    int hashNext;                           // next bucket to split in the round
+    std::vector<int> hashBuckets;           // primary page of each bucket
+    std::vector<int> hashDirectoryPages;    // pages keeping the above list in the file
+    BloomFilter keyFilter;                  // filter of the keys in the index, empty until it is loaded
+    int keyFilterHead;                      // first page of the filter in the file, INT_MAX if none
+    unsigned keyFilterKeys;                 // keys added to the filter in the file, 0 if it is out of date
+    std::vector<int> keyFilterPages;        // pages of the filter chain once it was read
+    bool keyFilterChanged;
+    bool keyFilterBuilding;                 // getKeyFilter() is reading the entries
+    std::vector<unsigned long long> pendingKeyHashes; // keys inserted meanwhile
+    std::mutex keyFilterLatch;              // inserts sharing the tree latch add their keys one at a time
+    std::map<CompositeKey, int> deltaEntries;   // changes not merged into the BTree, inserts count up, a delete is -1
+    unsigned deltaCapacity;                 // changes held before a merge, 0 without a delta buffer
+    RTS deltaIndexType;
     std::fstream file;
-    bool changed;
+    std::atomic<unsigned> version;
+    SharedLatch latch;
+    TreePath path;                          // descents of the inserts and deletes holding the latch alone
+    std::mutex leafLatches[LEAF_LATCHES];   // leaves changed in place by inserts and deletes sharing the latch
+    std::recursive_mutex ioLatch;           // page writes, reads missing the buffer and the file stream
+    BufferManager& bm;
 
     virtual RC createHiddenPage(const std::string& fileName);
 
@@ -538,6 +950,24 @@ private:
 
     virtual RC updateCounterInHiddenPage();
 
+    RC writePostingPages(const std::vector<RID>& rids, int& head, int& tail);
+
+    RC insertIntoPostingPages(int head, int& tail, const RID& rid);
+
+    RC deleteFromPostingPages(int& head, int& tail, const RID& rid);
+
+    int appendBucketPage(void* data);
+
+    RC splitBucket(const RTS indexType);
+
+    RC readHashDirectory(const int head);
+
+    RC writeHashDirectory();
+
+    RC loadKeyFilter(const bool readFilter);
+
+    RC writeKeyFilter();
+
 public:
     std::string fileName;
 
@@ -561,20 +991,97 @@ public:
     virtual int getNumberOfPages() override;
     //Override
     RC initPageDirectory(void* data, RT type);
+    // Like initPageDirectory(), the page takes the number of a free page if there is one
+    RC allocatePage(void* data, RT type);
+
+    void freePage(const int pageNum);
+
+    int getNumberOfFreePages() { return freePages.size(); }
 
     int getRoot();
 
     RTS getNodeType(void* data);
 
     void setRoot(const int newRoot);
-    // To detect if the BTree has changed, used only to optimize disk I/Os in scan
-    bool isChanged() { return changed; }
+    // Posting lists are chosen when the index is created
+    bool hasPostingLists() { return postingLists != 0; }
+
+    void setPostingLists(const bool postingLists) { this->postingLists = postingLists; }
+
+    RC readPostingList(const KeyView& entry, std::vector<RID>& rids);
+
+    RC buildPostingList(CompositeKey& entry, const std::vector<RID>& rids);
+
+    RC addToPostingList(CompositeKey& entry, const RID& rid);
+
+    RC removeFromPostingList(CompositeKey& entry, const RID& rid);
+    // Entries carrying INCLUDE columns are chosen when the index is created
+    bool hasIncludePayload() { return includePayload != 0; }
+
+    void setIncludePayload(const bool includePayload) { this->includePayload = includePayload; }
+
+    RTS getIndexType(const Attribute& attribute);
+    // Hash indexes are chosen when the index is created
+    bool isHashIndex() { return indexKind == HASH_INDEX; }
+
+    IndexKind getIndexKind() { return (IndexKind)indexKind; }
+
+    RC createHashBuckets();
+
+    int getHashBucket(const RTS indexType, const KeyView& key);
+
+    int getNumberOfBuckets() { return hashBuckets.size(); }
+    // Key filters are built by IndexManager::getKeyFilter(), the calls below hold the latch alone
+    bool hasKeyFilter();
+
+    const BloomFilter& getKeyFilter() { return keyFilter; }
+
+    void addToKeyFilter(const unsigned long long hash);
+
+    bool startKeyFilter();
+
+    void finishKeyFilter(const std::vector<unsigned long long>& hashes, const bool built);
+
+    int getNumberOfKeyFilterPages() { return keyFilterPages.size(); }
+    // Delta buffers are set by IndexManager::setDeltaBuffer(), their entries change under the latch alone
+    bool hasDeltaBuffer() { return deltaCapacity != 0; }
+
+    void setDeltaBuffer(const unsigned capacity, const RTS indexType);
+
+    bool isDeltaBufferFull() { return deltaEntries.size() >= deltaCapacity; }
+
+    RTS getDeltaIndexType() { return deltaIndexType; }
+
+    std::map<CompositeKey, int>& getDeltaEntries() { return deltaEntries; }
+
+    unsigned getNumberOfDeltaEntries() { return deltaEntries.size(); }
+
+    bool getNextDeltaEntry(const CompositeKey& key, const bool inclusive, CompositeKey& entry, int& change);
+
+    RC insertIntoBucket(const RTS indexType, CompositeKey& entry);
+
+    RC deleteFromBucket(const RTS indexType, const CompositeKey& entry);
+
+    RC readBucket(const RTS indexType, const int bucket, const CompositeKey& lowKey, const CompositeKey& highKey,
+                  std::vector<CompositeKey>& entries);
+    // Last leaf of the BTree, INT_MAX if not known. Kept by the inserts, forgotten by the deletes
+    int getRightmostLeaf() { return rightmostLeaf; }
+
+    void setRightmostLeaf(const int rightmostLeaf) { this->rightmostLeaf = rightmostLeaf; }
+    // Bumped on each change of the BTree, a scan searches the tree again when it moved on
+    unsigned getVersion() { return version; }
 
-    void resetChanged() { changed = false;}
+    void setChanged() { version++; }
+    // Shared by the scans and by the inserts and deletes changing a single leaf, held alone by the others
+    SharedLatch& getLatch() { return latch; }
+    // Latch of a leaf changed while the tree latch is shared, taken before the leaf is read
+    std::mutex& getLeafLatch(const int pageNum) { return leafLatches[pageNum % LEAF_LATCHES]; }
 
-    void setChanged() { changed = true;}
+    TreePath& getPath() { return path; }
     // Put the current counter values of associated PF FileHandles into variables
     virtual RC collectCounterValues(unsigned &readPageCount, unsigned &writePageCount, unsigned &appendPageCount) override;
+    // Number of page reads which missed the buffer and went to the disk since the file was opened
+    unsigned getDiskReadPageCount() { return ixDiskReadPageCounter; }
 };
 
 #endif
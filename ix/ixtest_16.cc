@@ -0,0 +1,144 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+// Counts the entries of a range scan and checks that they come out in key order.
+int countScanEntries(IXFileHandle &ixFileHandle, const Attribute &attribute, const int *lowKey,
+                     const int *highKey, bool lowKeyInclusive, bool highKeyInclusive, bool &ordered) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, lowKey, highKey, lowKeyInclusive, highKeyInclusive,
+                              ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid;
+    int key = 0, prevKey = INT_MIN;
+    int count = 0;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key < prevKey || rid.pageNum != key) ordered = false;
+        prevKey = key;
+        count++;
+    }
+    ix_ScanIterator.close();
+    return count;
+}
+
+int testCase_16(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Insert entries with duplicate keys in random order
+    // 2. Delete every third entry
+    // 3. Range scans with every combination of inclusive bounds **
+    // 4. Delete an entry which is not present
+    // 5. An index file without the format marker is not opened
+    std::cout << std::endl << "***** In IX Test Case 16 *****" << std::endl;
+
+    RID rid;
+    IXFileHandle ixFileHandle;
+    const int numKeys = 2000;
+    const int numDuplicates = 5;
+    std::vector<std::pair<int, int> > entries;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    for (int i = 0; i < numKeys; i++) {
+        for (int j = 0; j < numDuplicates; j++) {
+            entries.push_back(std::make_pair(i, j));
+        }
+    }
+    srand(16);
+    for (int i = entries.size() - 1; i > 0; i--) {
+        std::swap(entries[i], entries[rand() % (i + 1)]);
+    }
+
+    // The rid of an entry is (key, duplicate number).
+    for (unsigned i = 0; i < entries.size(); i++) {
+        rid.pageNum = entries[i].first;
+        rid.slotNum = entries[i].second;
+        rc = indexManager.insertEntry(ixFileHandle, attribute, &entries[i].first, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+
+    std::vector<int> remaining(numKeys, numDuplicates);
+    for (unsigned i = 0; i < entries.size(); i += 3) {
+        rid.pageNum = entries[i].first;
+        rid.slotNum = entries[i].second;
+        rc = indexManager.deleteEntry(ixFileHandle, attribute, &entries[i].first, rid);
+        assert(rc == success && "indexManager::deleteEntry() should not fail.");
+        remaining[entries[i].first]--;
+    }
+
+    rid.pageNum = entries[0].first;
+    rid.slotNum = entries[0].second;
+    rc = indexManager.deleteEntry(ixFileHandle, attribute, &entries[0].first, rid);
+    bool failed = rc == success;
+
+    int ranges[][2] = {{0, numKeys - 1}, {17, 17}, {100, 1500}, {1999, 1999}, {-5, 3}, {1998, 5000}};
+    for (unsigned r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        for (int inclusive = 0; inclusive < 4; inclusive++) {
+            bool lowKeyInclusive = inclusive & 1;
+            bool highKeyInclusive = inclusive & 2;
+            int expected = 0;
+            for (int key = 0; key < numKeys; key++) {
+                bool aboveLow = lowKeyInclusive ? key >= ranges[r][0] : key > ranges[r][0];
+                bool belowHigh = highKeyInclusive ? key <= ranges[r][1] : key < ranges[r][1];
+                if (aboveLow && belowHigh) expected += remaining[key];
+            }
+
+            bool ordered = true;
+            int count = countScanEntries(ixFileHandle, attribute, &ranges[r][0], &ranges[r][1],
+                                         lowKeyInclusive, highKeyInclusive, ordered);
+            if (count != expected || !ordered) {
+                std::cout << "Range [" << ranges[r][0] << ", " << ranges[r][1] << "] inclusive " << inclusive
+                          << " returned " << count << " entries, expected " << expected << std::endl;
+                failed = true;
+            }
+        }
+    }
+
+    // Full scan.
+    bool ordered = true;
+    int count = countScanEntries(ixFileHandle, attribute, NULL, NULL, true, true, ordered);
+    if (count != numKeys * numDuplicates - (int) ((entries.size() + 2) / 3) || !ordered) {
+        failed = true;
+    }
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+
+    // The format marker is cleared as in a file written before the key slot directory, the file is not opened.
+    std::fstream file(indexFileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    int marker = 0;
+    file.seekp(PAGE_SIZE - sizeof(int));
+    file.write((char *) &marker, sizeof(int));
+    file.close();
+    if (indexManager.openFile(indexFileName, ixFileHandle) == success) {
+        std::cout << "An index file without the format marker was opened." << std::endl;
+        failed = true;
+        indexManager.closeFile(ixFileHandle);
+    }
+
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+
+    if (testCase_16(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 16 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 16 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,100 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+// Key i is "key" followed by a NUL byte and the letter 'a' + i % 26, keys 26 and up are only "key" and a NUL.
+int prepareNulKey(const int i, char *key) {
+    int length = i < 26 ? 5 : 4;
+    memcpy(key, &length, sizeof(int));
+    memcpy(key + sizeof(int), "key", 3);
+    key[sizeof(int) + 3] = '\0';
+    if (i < 26) key[sizeof(int) + 4] = (char) ('a' + i);
+    return length;
+}
+
+int testCase_17(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Insert VarChar keys which differ only after an embedded NUL byte
+    // 2. Exact match scans on every key **
+    // 3. Full scan returns the keys in bytewise order
+    std::cout << std::endl << "***** In IX Test Case 17 *****" << std::endl;
+
+    RID rid;
+    IXFileHandle ixFileHandle;
+    IX_ScanIterator ix_ScanIterator;
+    char key[100];
+    char returnedKey[100];
+    const int numKeys = 27;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    // Insert in reverse order.
+    for (int i = numKeys - 1; i >= 0; i--) {
+        prepareNulKey(i, key);
+        rid.pageNum = i;
+        rid.slotNum = i;
+        rc = indexManager.insertEntry(ixFileHandle, attribute, key, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+
+    bool failed = false;
+    for (int i = 0; i < numKeys; i++) {
+        prepareNulKey(i, key);
+        rc = indexManager.scan(ixFileHandle, attribute, key, key, true, true, ix_ScanIterator);
+        assert(rc == success && "indexManager::scan() should not fail.");
+
+        int count = 0;
+        while (ix_ScanIterator.getNextEntry(rid, returnedKey) == success) {
+            if (rid.pageNum != i) failed = true;
+            count++;
+        }
+        ix_ScanIterator.close();
+        if (count != 1) {
+            std::cout << "Exact match on key " << i << " returned " << count << " entries." << std::endl;
+            failed = true;
+        }
+    }
+
+    // The shorter key sorts first, the others by the byte after the NUL.
+    rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+    int expected = numKeys - 1;
+    while (ix_ScanIterator.getNextEntry(rid, returnedKey) == success) {
+        int length = prepareNulKey(expected, key);
+        if (rid.pageNum != expected || memcmp(key, returnedKey, sizeof(int) + length) != 0) {
+            failed = true;
+        }
+        expected = (expected + 1) % numKeys;
+    }
+    ix_ScanIterator.close();
+    if (expected != numKeys - 1) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "name_idx";
+    Attribute attrName;
+    attrName.length = 20;
+    attrName.name = "name";
+    attrName.type = TypeVarChar;
+
+    remove("name_idx");
+
+    if (testCase_17(indexFileName, attrName) == success) {
+        std::cout << "***** IX Test Case 17 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 17 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,110 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int KEY_LENGTH = 100;
+
+// 100 byte VarChar key starting with the zero padded number i, so that the keys share no long prefix.
+void prepareLongKey(const int i, char *key) {
+    int length = KEY_LENGTH;
+    memcpy(key, &length, sizeof(int));
+    memset(key + sizeof(int), 'k', KEY_LENGTH);
+    sprintf(key + sizeof(int), "%06d", i);
+    key[sizeof(int) + 6] = 'k';
+}
+
+// Looks up a key and returns the number of pages read from the disk.
+unsigned pointLookup(IXFileHandle &ixFileHandle, const Attribute &attribute, const int i, bool &found) {
+    char key[KEY_LENGTH + sizeof(int) + 1];
+    char returnedKey[KEY_LENGTH + sizeof(int) + 1];
+    RID rid;
+    IX_ScanIterator ix_ScanIterator;
+    prepareLongKey(i, key);
+
+    unsigned diskReadsBefore = ixFileHandle.getDiskReadPageCount();
+    RC rc = indexManager.scan(ixFileHandle, attribute, key, key, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+    found = ix_ScanIterator.getNextEntry(rid, returnedKey) == success && rid.pageNum == i;
+    ix_ScanIterator.close();
+    return ixFileHandle.getDiskReadPageCount() - diskReadsBefore;
+}
+
+int testCase_18(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Insert enough long keys for a 3 level B+ tree
+    // 2. Point lookups read the root and internal nodes from the buffer pool **
+    // 3. Read the tree back after the cached pages are written at close
+    std::cout << std::endl << "***** In IX Test Case 18 *****" << std::endl;
+
+    RID rid;
+    IXFileHandle ixFileHandle;
+    char key[KEY_LENGTH + sizeof(int) + 1];
+    const int numKeys = 20000;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    for (int i = 0; i < numKeys; i++) {
+        int k = (i * 7919) % numKeys;
+        prepareLongKey(k, key);
+        rid.pageNum = k;
+        rid.slotNum = 0;
+        rc = indexManager.insertEntry(ixFileHandle, attribute, key, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    // The first lookup reads the root, an internal node and a leaf from the disk.
+    bool failed = false, found = false;
+    unsigned diskReads = pointLookup(ixFileHandle, attribute, 0, found);
+    std::cout << "Disk reads of the first lookup: " << diskReads << std::endl;
+    if (diskReads != 3 || !found) failed = true;
+
+    for (int i = 1; i < numKeys; i += 37) {
+        pointLookup(ixFileHandle, attribute, i, found);
+        if (!found) failed = true;
+    }
+
+    // Once the upper levels are cached a lookup reads at most its leaf.
+    unsigned maxDiskReads = 0;
+    for (int i = 0; i < numKeys; i += 13) {
+        diskReads = pointLookup(ixFileHandle, attribute, i, found);
+        if (diskReads > maxDiskReads) maxDiskReads = diskReads;
+        if (!found) failed = true;
+    }
+    std::cout << "Maximum disk reads of a lookup: " << maxDiskReads << std::endl;
+    if (maxDiskReads > 1) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "long_idx";
+    Attribute attrLong;
+    attrLong.length = KEY_LENGTH;
+    attrLong.name = "long";
+    attrLong.type = TypeVarChar;
+
+    remove("long_idx");
+
+    if (testCase_18(indexFileName, attrLong) == success) {
+        std::cout << "***** IX Test Case 18 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 18 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,162 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+// Scans the whole index, checks the order and returns the number of entries.
+int countOrderedEntries(IXFileHandle &ixFileHandle, const Attribute &attribute, bool &ordered) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid, prevRid;
+    int key = 0, prevKey = INT_MIN;
+    int count = 0;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key < prevKey || (key == prevKey && !(rid > prevRid)) || rid.pageNum != key) ordered = false;
+        prevKey = key;
+        prevRid = rid;
+        count++;
+    }
+    ix_ScanIterator.close();
+    return count;
+}
+
+// Bulk loads the shuffled entries and returns the number of pages of the index.
+int bulkLoad(const std::string &indexFileName, const Attribute &attribute,
+             const std::vector<std::pair<int, int> > &entries, const float fillFactor, IXFileHandle &ixFileHandle) {
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    // A small buffer spills several sorted runs.
+    IX_BulkLoader bulkLoader;
+    rc = bulkLoader.initialize(ixFileHandle, attribute, fillFactor, 16 * PAGE_SIZE);
+    assert(rc == success && "IX_BulkLoader::initialize() should not fail.");
+
+    RID rid;
+    for (unsigned i = 0; i < entries.size(); i++) {
+        rid.pageNum = entries[i].first;
+        rid.slotNum = entries[i].second;
+        rc = bulkLoader.addEntry(&entries[i].first, rid);
+        assert(rc == success && "IX_BulkLoader::addEntry() should not fail.");
+    }
+    rc = bulkLoader.finish();
+    assert(rc == success && "IX_BulkLoader::finish() should not fail.");
+    return ixFileHandle.getNumberOfPages();
+}
+
+int testCase_19(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Bulk load shuffled entries with duplicate keys through an external sort
+    // 2. Full and range scans of the bulk loaded tree **
+    // 3. Insert and delete entries after the bulk load
+    // 4. A lower fill factor leaves more pages, a bulk load into a non empty index fails
+    std::cout << std::endl << "***** In IX Test Case 19 *****" << std::endl;
+
+    RID rid;
+    IXFileHandle ixFileHandle;
+    IX_ScanIterator ix_ScanIterator;
+    const int numKeys = 10000;
+    const int numDuplicates = 3;
+    std::vector<std::pair<int, int> > entries;
+
+    for (int i = 0; i < numKeys; i++) {
+        for (int j = 0; j < numDuplicates; j++) {
+            entries.push_back(std::make_pair(i, j));
+        }
+    }
+    srand(19);
+    for (int i = entries.size() - 1; i > 0; i--) {
+        std::swap(entries[i], entries[rand() % (i + 1)]);
+    }
+
+    RC rc;
+    int fullPages = bulkLoad(indexFileName, attribute, entries, 1.0, ixFileHandle);
+    bool failed = false, ordered = true;
+    if (countOrderedEntries(ixFileHandle, attribute, ordered) != numKeys * numDuplicates || !ordered) {
+        std::cout << "Full scan after the bulk load failed." << std::endl;
+        failed = true;
+    }
+
+    IX_BulkLoader bulkLoader;
+    if (bulkLoader.initialize(ixFileHandle, attribute) != fail) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    int halfPages = bulkLoad(indexFileName, attribute, entries, 0.5, ixFileHandle);
+    std::cout << "Pages at fill factor 1.0: " << fullPages << ", at 0.5: " << halfPages << std::endl;
+    if (halfPages < fullPages * 3 / 2) failed = true;
+
+    // Reopen so that the tree is read back from the disk.
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    int low = 2500, high = 2599;
+    rc = indexManager.scan(ixFileHandle, attribute, &low, &high, true, false, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+    int key = 0, count = 0;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key < low || key >= high) failed = true;
+        count++;
+    }
+    ix_ScanIterator.close();
+    if (count != (high - low) * numDuplicates) failed = true;
+
+    // New keys above and between the loaded ones, then delete every duplicate 0.
+    for (int i = 0; i < numKeys; i += 2) {
+        int newKey = i + numKeys;
+        rid.pageNum = newKey;
+        rid.slotNum = 0;
+        rc = indexManager.insertEntry(ixFileHandle, attribute, &newKey, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+        rid.pageNum = i;
+        rid.slotNum = numDuplicates;
+        rc = indexManager.insertEntry(ixFileHandle, attribute, &i, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+    for (int i = 0; i < numKeys; i++) {
+        rid.pageNum = i;
+        rid.slotNum = 0;
+        rc = indexManager.deleteEntry(ixFileHandle, attribute, &i, rid);
+        assert(rc == success && "indexManager::deleteEntry() should not fail.");
+    }
+
+    ordered = true;
+    count = countOrderedEntries(ixFileHandle, attribute, ordered);
+    if (count != numKeys * (numDuplicates - 1) + numKeys || !ordered) {
+        std::cout << "Full scan after the updates returned " << count << " entries." << std::endl;
+        failed = true;
+    }
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+
+    if (testCase_19(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 19 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 19 failed. *****" << std::endl;
+        return fail;
+    }
+}
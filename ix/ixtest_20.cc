@@ -0,0 +1,147 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const char *URL_PREFIX = "https://www.example.com/catalog/products/category/electronics/item?id=";
+
+// Key i is the common url prefix followed by the zero padded number i.
+int prepareUrlKey(const int i, char *key) {
+    int length = sprintf(key + sizeof(int), "%s%06d", URL_PREFIX, i);
+    memcpy(key, &length, sizeof(int));
+    return length;
+}
+
+// Scans [lowKey, highKey] and checks that the keys come back whole and in order.
+int countUrlEntries(IXFileHandle &ixFileHandle, const Attribute &attribute, const int lowKey, const int highKey,
+                    const std::vector<bool> &present, bool &correct) {
+    char low[PAGE_SIZE], high[PAGE_SIZE], key[PAGE_SIZE], returnedKey[PAGE_SIZE];
+    prepareUrlKey(lowKey, low);
+    prepareUrlKey(highKey, high);
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, low, high, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid;
+    int count = 0, expected = lowKey;
+    while (ix_ScanIterator.getNextEntry(rid, returnedKey) == success) {
+        while (expected <= highKey && !present[expected]) expected++;
+        int length = prepareUrlKey(expected, key);
+        if (rid.pageNum != expected || memcmp(key, returnedKey, sizeof(int) + length) != 0) {
+            correct = false;
+        }
+        expected++;
+        count++;
+    }
+    ix_ScanIterator.close();
+    return count;
+}
+
+int testCase_20(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Insert keys sharing a long prefix in random order
+    // 2. The leaves store the prefix once, the index takes fewer pages than the full keys **
+    // 3. A key without the prefix shortens the prefix of its leaf
+    // 4. Scans return whole keys after deletes merge the leaves
+    std::cout << std::endl << "***** In IX Test Case 20 *****" << std::endl;
+
+    RID rid;
+    IXFileHandle ixFileHandle;
+    char key[PAGE_SIZE];
+    const int numKeys = 5000;
+    std::vector<int> order;
+    std::vector<bool> present(numKeys, true);
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    for (int i = 0; i < numKeys; i++) {
+        order.push_back(i);
+    }
+    srand(20);
+    for (int i = numKeys - 1; i > 0; i--) {
+        std::swap(order[i], order[rand() % (i + 1)]);
+    }
+
+    int keyLength = 0;
+    for (int i = 0; i < numKeys; i++) {
+        keyLength = prepareUrlKey(order[i], key);
+        rid.pageNum = order[i];
+        rid.slotNum = 0;
+        rc = indexManager.insertEntry(ixFileHandle, attribute, key, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+
+    // Leaf entries of the full keys alone would take this many pages.
+    int uncompressedPages = numKeys * (keyLength + 2 * sizeof(int) + 2 * sizeof(short)) / PAGE_SIZE;
+    std::cout << "Index pages: " << ixFileHandle.getNumberOfPages() << ", pages of the full keys: "
+              << uncompressedPages << std::endl;
+    bool failed = ixFileHandle.getNumberOfPages() >= uncompressedPages / 2;
+
+    bool correct = true;
+    if (countUrlEntries(ixFileHandle, attribute, 0, numKeys - 1, present, correct) != numKeys || !correct) {
+        std::cout << "Full scan failed." << std::endl;
+        failed = true;
+    }
+
+    // "a" sorts before every url, its leaf loses the prefix.
+    int shortLength = 1;
+    memcpy(key, &shortLength, sizeof(int));
+    key[sizeof(int)] = 'a';
+    rid.pageNum = numKeys;
+    rc = indexManager.insertEntry(ixFileHandle, attribute, key, rid);
+    assert(rc == success && "indexManager::insertEntry() should not fail.");
+
+    for (int i = 0; i < numKeys; i++) {
+        if (i % 4 == 0) continue;
+        prepareUrlKey(i, key);
+        rid.pageNum = i;
+        rc = indexManager.deleteEntry(ixFileHandle, attribute, key, rid);
+        assert(rc == success && "indexManager::deleteEntry() should not fail.");
+        present[i] = false;
+    }
+
+    correct = true;
+    if (countUrlEntries(ixFileHandle, attribute, 1000, 3999, present, correct) != 750 || !correct) {
+        std::cout << "Range scan after the deletes failed." << std::endl;
+        failed = true;
+    }
+
+    IX_ScanIterator ix_ScanIterator;
+    rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+    int count = 0;
+    while (ix_ScanIterator.getNextEntry(rid, key) == success) {
+        if (count == 0 && rid.pageNum != numKeys) failed = true;
+        count++;
+    }
+    ix_ScanIterator.close();
+    if (count != numKeys / 4 + 1) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "url_idx";
+    Attribute attrUrl;
+    attrUrl.length = 200;
+    attrUrl.name = "url";
+    attrUrl.type = TypeVarChar;
+
+    remove("url_idx");
+
+    if (testCase_20(indexFileName, attrUrl) == success) {
+        std::cout << "***** IX Test Case 20 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 20 failed. *****" << std::endl;
+        return fail;
+    }
+}
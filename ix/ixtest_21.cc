@@ -0,0 +1,224 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 300;
+const int bigKey = -1;          // key whose posting list spans several posting pages
+const int bigKeyDuplicates = 5000;
+
+// Keys 0-9 have 1000 rids, keys 10-99 have 5 and the others one, the big key has 5000.
+int getDuplicates(const int key) {
+    if (key == bigKey) return bigKeyDuplicates;
+    if (key < 10) return 1000;
+    if (key < 100) return 5;
+    return 1;
+}
+
+// The j-th rid of a key, the rids of the big key are far apart.
+RID getRid(const int key, const int j) {
+    RID rid;
+    rid.pageNum = key == bigKey ? j * 1000 : j;
+    rid.slotNum = key == bigKey ? 7 : key;
+    return rid;
+}
+
+// Scans a range, checks the rids of each key come out in order and returns the number of entries.
+int countRange(IXFileHandle &ixFileHandle, const Attribute &attribute, const int *lowKey, const int *highKey,
+               bool lowKeyInclusive, bool highKeyInclusive, bool &ordered) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, lowKey, highKey, lowKeyInclusive, highKeyInclusive,
+                              ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid, prevRid;
+    int key = 0, prevKey = INT_MIN;
+    int count = 0;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key < prevKey || (key == prevKey && !(rid > prevRid))) ordered = false;
+        if (key != bigKey && rid.slotNum != key) ordered = false;
+        prevKey = key;
+        prevRid = rid;
+        count++;
+    }
+    ix_ScanIterator.close();
+    return count;
+}
+
+// Inserts the shuffled entries into a new index and returns the number of pages.
+int buildIndex(const std::string &indexFileName, const Attribute &attribute, const bool postingLists,
+               const std::vector<std::pair<int, int> > &entries, IXFileHandle &ixFileHandle) {
+    RC rc = indexManager.createFile(indexFileName, postingLists);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    for (unsigned i = 0; i < entries.size(); i++) {
+        RID rid = getRid(entries[i].first, entries[i].second);
+        rc = indexManager.insertEntry(ixFileHandle, attribute, &entries[i].first, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+    return ixFileHandle.getNumberOfPages();
+}
+
+int testCase_21(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Insert shuffled entries of a skewed key into an index with posting lists
+    // 2. The index takes less than half the pages of one without posting lists
+    // 3. Equality and range scans return every rid in order **
+    // 4. Delete half of the rids, duplicate inserts and missing deletes fail
+    // 5. Bulk load an index with posting lists
+    std::cout << std::endl << "***** In IX Test Case 21 *****" << std::endl;
+
+    IXFileHandle ixFileHandle;
+    std::vector<std::pair<int, int> > entries;
+    std::vector<int> remaining(numKeys, 0);
+    int total = 0;
+    for (int key = bigKey; key < numKeys; key++) {
+        for (int j = 0; j < getDuplicates(key); j++) {
+            entries.push_back(std::make_pair(key, j));
+        }
+        total += getDuplicates(key);
+    }
+    srand(21);
+    for (int i = entries.size() - 1; i > 0; i--) {
+        std::swap(entries[i], entries[rand() % (i + 1)]);
+    }
+
+    const std::string plainFileName = indexFileName + "_plain";
+    IXFileHandle plainFileHandle;
+    int plainPages = buildIndex(plainFileName, attribute, false, entries, plainFileHandle);
+    int postingPages = buildIndex(indexFileName, attribute, true, entries, ixFileHandle);
+    std::cout << "Pages without posting lists: " << plainPages << ", with posting lists: " << postingPages
+              << std::endl;
+    bool failed = postingPages * 2 > plainPages;
+
+    RC rc = indexManager.closeFile(plainFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(plainFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    // The posting list format is kept in the file.
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    bool ordered = true;
+    for (int key = bigKey; key < numKeys; key += 7) {
+        if (countRange(ixFileHandle, attribute, &key, &key, true, true, ordered) != getDuplicates(key)) {
+            std::cout << "Equality scan on key " << key << " failed." << std::endl;
+            failed = true;
+        }
+    }
+    int low = 5, high = 50;
+    int expected = 4 * 1000 + 40 * 5;
+    if (countRange(ixFileHandle, attribute, &low, &high, false, false, ordered) != expected) failed = true;
+    if (countRange(ixFileHandle, attribute, NULL, NULL, true, true, ordered) != total) failed = true;
+
+    // An entry can not be inserted twice.
+    RID rid = getRid(3, 10);
+    int key = 3;
+    if (indexManager.insertEntry(ixFileHandle, attribute, &key, rid) == success) failed = true;
+
+    // Delete every other entry, keys with an odd number of rids keep one more.
+    int deleted = 0;
+    for (unsigned i = 0; i < entries.size(); i++) {
+        if (entries[i].second % 2 != 0) continue;
+        rid = getRid(entries[i].first, entries[i].second);
+        rc = indexManager.deleteEntry(ixFileHandle, attribute, &entries[i].first, rid);
+        assert(rc == success && "indexManager::deleteEntry() should not fail.");
+        deleted++;
+    }
+    rid = getRid(bigKey, 0);
+    key = bigKey;
+    if (indexManager.deleteEntry(ixFileHandle, attribute, &key, rid) == success) failed = true;
+
+    for (key = bigKey; key < numKeys; key++) {
+        int count = countRange(ixFileHandle, attribute, &key, &key, true, true, ordered);
+        if (count != getDuplicates(key) / 2) {
+            std::cout << "Key " << key << " has " << count << " rids after the deletes." << std::endl;
+            failed = true;
+        }
+    }
+    if (countRange(ixFileHandle, attribute, NULL, NULL, true, true, ordered) != total - deleted) failed = true;
+
+    // Key 10 is left with two rids, deleting one turns its posting list back into an entry.
+    key = 10;
+    rid = getRid(key, 1);
+    rc = indexManager.deleteEntry(ixFileHandle, attribute, &key, rid);
+    assert(rc == success && "indexManager::deleteEntry() should not fail.");
+    rid = getRid(key, 1);
+    if (indexManager.deleteEntry(ixFileHandle, attribute, &key, rid) == success) failed = true;
+    if (countRange(ixFileHandle, attribute, &key, &key, true, true, ordered) != 1) failed = true;
+    if (!ordered) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    // Bulk load the same entries.
+    rc = indexManager.createFile(indexFileName, true);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    IX_BulkLoader bulkLoader;
+    rc = bulkLoader.initialize(ixFileHandle, attribute, 1.0, 16 * PAGE_SIZE);
+    assert(rc == success && "IX_BulkLoader::initialize() should not fail.");
+    for (unsigned i = 0; i < entries.size(); i++) {
+        rid = getRid(entries[i].first, entries[i].second);
+        rc = bulkLoader.addEntry(&entries[i].first, rid);
+        assert(rc == success && "IX_BulkLoader::addEntry() should not fail.");
+    }
+    rc = bulkLoader.finish();
+    assert(rc == success && "IX_BulkLoader::finish() should not fail.");
+    std::cout << "Pages after the bulk load: " << ixFileHandle.getNumberOfPages() << std::endl;
+
+    ordered = true;
+    if (countRange(ixFileHandle, attribute, NULL, NULL, true, true, ordered) != total || !ordered) {
+        std::cout << "Full scan after the bulk load failed." << std::endl;
+        failed = true;
+    }
+    for (key = bigKey; key < numKeys; key += 11) {
+        if (countRange(ixFileHandle, attribute, &key, &key, true, true, ordered) != getDuplicates(key)) {
+            failed = true;
+        }
+    }
+
+    // Insert after the bulk load, the rid goes into the existing posting list.
+    key = 0;
+    rid.pageNum = 5000;
+    rid.slotNum = 0;
+    rc = indexManager.insertEntry(ixFileHandle, attribute, &key, rid);
+    assert(rc == success && "indexManager::insertEntry() should not fail.");
+    if (countRange(ixFileHandle, attribute, &key, &key, true, true, ordered) != getDuplicates(key) + 1) {
+        failed = true;
+    }
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+    remove("age_idx_plain");
+
+    if (testCase_21(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 21 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 21 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,113 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+int testCase_22(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Insert enough keys for a few hundred leaves
+    // 2. A full scan reads each leaf once, the first one again after the search from the root **
+    // 3. Deleting the returned entry and inserting ahead of the scan keeps the cursor in place
+    std::cout << std::endl << "***** In IX Test Case 22 *****" << std::endl;
+
+    RID rid;
+    IXFileHandle ixFileHandle;
+    IX_ScanIterator ix_ScanIterator;
+    const int numKeys = 50000;
+    int key = 0;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    // Even keys only, the odd keys are inserted during the scan.
+    for (int i = 0; i < numKeys; i++) {
+        key = ((i * 7919) % numKeys) * 2;
+        rid.pageNum = key;
+        rid.slotNum = key % 100;
+        rc = indexManager.insertEntry(ixFileHandle, attribute, &key, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+    int numPages = ixFileHandle.getNumberOfPages();
+
+    unsigned readPageCountBefore = 0, readPageCount = 0, writePageCount = 0, appendPageCount = 0;
+    rc = ixFileHandle.collectCounterValues(readPageCountBefore, writePageCount, appendPageCount);
+    assert(rc == success && "indexManager::collectCounterValues() should not fail.");
+
+    rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    bool failed = false;
+    int count = 0, expected = 0;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key != expected || rid.pageNum != key) failed = true;
+        expected += 2;
+        count++;
+    }
+    ix_ScanIterator.close();
+
+    rc = ixFileHandle.collectCounterValues(readPageCount, writePageCount, appendPageCount);
+    assert(rc == success && "indexManager::collectCounterValues() should not fail.");
+    std::cout << "Pages: " << numPages << ", page reads of the full scan: " << readPageCount - readPageCountBefore
+              << std::endl;
+    if (count != numKeys || readPageCount - readPageCountBefore > (unsigned) numPages + 1) failed = true;
+
+    // Delete each returned entry and insert the next odd key, which the scan must return next.
+    rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    count = 0;
+    expected = 0;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key != expected || rid.pageNum != key) failed = true;
+        rc = indexManager.deleteEntry(ixFileHandle, attribute, &key, rid);
+        assert(rc == success && "indexManager::deleteEntry() should not fail.");
+
+        if (key % 2 == 0 && key < 2 * numKeys) {
+            int oddKey = key + 1;
+            rid.pageNum = oddKey;
+            rid.slotNum = oddKey % 100;
+            rc = indexManager.insertEntry(ixFileHandle, attribute, &oddKey, rid);
+            assert(rc == success && "indexManager::insertEntry() should not fail.");
+        }
+        expected++;
+        count++;
+    }
+    ix_ScanIterator.close();
+    if (count != 2 * numKeys) {
+        std::cout << "Scan with deletes and inserts returned " << count << " entries." << std::endl;
+        failed = true;
+    }
+
+    // Nothing is left.
+    rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+    if (ix_ScanIterator.getNextEntry(rid, &key) != IX_EOF) failed = true;
+    ix_ScanIterator.close();
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+
+    if (testCase_22(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 22 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 22 failed. *****" << std::endl;
+        return fail;
+    }
+}
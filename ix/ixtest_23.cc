@@ -0,0 +1,171 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 20000;
+
+// Writes [VarChar key][RTS n][int i][VarChar of i % 30 'x'] and returns its length.
+int prepareEntry(const int i, void *buf) {
+    char name[16];
+    int len = sprintf(name, "name%05d", (i * 7919) % numKeys);
+    int offset = 0;
+    memcpy((char *) buf + offset, &len, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buf + offset, name, len);
+    offset += len;
+
+    int fillLen = i % 30;
+    RTS payloadLen = 2 * sizeof(int) + fillLen;
+    memcpy((char *) buf + offset, &payloadLen, sizeof(RTS));
+    offset += sizeof(RTS);
+    memcpy((char *) buf + offset, &i, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buf + offset, &fillLen, sizeof(int));
+    offset += sizeof(int);
+    memset((char *) buf + offset, 'x', fillLen);
+    return offset + fillLen;
+}
+
+RID getRid(const int i) {
+    RID rid;
+    rid.pageNum = i / 100;
+    rid.slotNum = i % 100;
+    return rid;
+}
+
+// Scans the index and checks each entry against the one inserted with its rid.
+int countEntries(IXFileHandle &ixFileHandle, const Attribute &attribute, bool &valid) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid;
+    char key[PAGE_SIZE], expected[PAGE_SIZE];
+    std::string prevName;
+    int count = 0;
+    while (ix_ScanIterator.getNextEntry(rid, key) == success) {
+        int i = rid.pageNum * 100 + rid.slotNum;
+        int len = prepareEntry(i, expected);
+        if (memcmp(key, expected, len) != 0) valid = false;
+
+        int nameLen = 0;
+        memcpy(&nameLen, key, sizeof(int));
+        std::string name(key + sizeof(int), nameLen);
+        if (name < prevName) valid = false;
+        prevName = name;
+        count++;
+    }
+    ix_ScanIterator.close();
+    return count;
+}
+
+int testCase_23(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Insert VarChar keys followed by INCLUDE columns of different lengths
+    // 2. The scan returns each key with its INCLUDE columns **
+    // 3. Delete with the key value only, reopen the file and scan again
+    // 4. Bulk load the same entries
+    std::cout << std::endl << "***** In IX Test Case 23 *****" << std::endl;
+
+    IXFileHandle ixFileHandle;
+    char entry[PAGE_SIZE];
+
+    // INCLUDE columns can not be combined with posting lists
+    RC rc = indexManager.createFile(indexFileName, true, true);
+    assert(rc != success && "indexManager::createFile() should fail.");
+
+    rc = indexManager.createFile(indexFileName, false, true);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    for (int i = 0; i < numKeys; i++) {
+        prepareEntry(i, entry);
+        rc = indexManager.insertEntry(ixFileHandle, attribute, entry, getRid(i));
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+    std::cout << "Pages after the inserts: " << ixFileHandle.getNumberOfPages() << std::endl;
+
+    bool valid = true;
+    bool failed = countEntries(ixFileHandle, attribute, valid) != numKeys;
+
+    // Delete every third entry, the INCLUDE columns after the key are not needed.
+    int deleted = 0;
+    for (int i = 0; i < numKeys; i += 3) {
+        char name[16];
+        int len = sprintf(name, "name%05d", (i * 7919) % numKeys);
+        memcpy(entry, &len, sizeof(int));
+        memcpy(entry + sizeof(int), name, len);
+        rc = indexManager.deleteEntry(ixFileHandle, attribute, entry, getRid(i));
+        assert(rc == success && "indexManager::deleteEntry() should not fail.");
+        deleted++;
+    }
+
+    // The INCLUDE columns are kept in the file.
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    if (countEntries(ixFileHandle, attribute, valid) != numKeys - deleted) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    // Bulk load the same entries through sorted runs.
+    rc = indexManager.createFile(indexFileName, false, true);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    IX_BulkLoader bulkLoader;
+    rc = bulkLoader.initialize(ixFileHandle, attribute, 1.0, 16 * PAGE_SIZE);
+    assert(rc == success && "IX_BulkLoader::initialize() should not fail.");
+    for (int i = 0; i < numKeys; i++) {
+        prepareEntry(i, entry);
+        rc = bulkLoader.addEntry(entry, getRid(i));
+        assert(rc == success && "IX_BulkLoader::addEntry() should not fail.");
+    }
+    rc = bulkLoader.finish();
+    assert(rc == success && "IX_BulkLoader::finish() should not fail.");
+    std::cout << "Pages after the bulk load: " << ixFileHandle.getNumberOfPages() << std::endl;
+    if (countEntries(ixFileHandle, attribute, valid) != numKeys) failed = true;
+
+    // Inserts after the bulk load split the full leaves.
+    for (int i = numKeys; i < numKeys + 500; i++) {
+        prepareEntry(i, entry);
+        rc = indexManager.insertEntry(ixFileHandle, attribute, entry, getRid(i));
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+    if (countEntries(ixFileHandle, attribute, valid) != numKeys + 500) failed = true;
+    if (!valid) {
+        std::cout << "The scan returned wrong INCLUDE columns or keys out of order." << std::endl;
+        failed = true;
+    }
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "name_idx";
+    Attribute attrName;
+    attrName.length = 16;
+    attrName.name = "name";
+    attrName.type = TypeVarChar;
+
+    remove("name_idx");
+
+    if (testCase_23(indexFileName, attrName) == success) {
+        std::cout << "***** IX Test Case 23 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 23 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,157 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 100000;
+
+RID getRid(const int key) {
+    RID rid;
+    rid.pageNum = key / 100;
+    rid.slotNum = key % 100;
+    return rid;
+}
+
+unsigned getReadPageCount(IXFileHandle &ixFileHandle) {
+    unsigned readPageCount = 0, writePageCount = 0, appendPageCount = 0;
+    RC rc = ixFileHandle.collectCounterValues(readPageCount, writePageCount, appendPageCount);
+    assert(rc == success && "indexManager::collectCounterValues() should not fail.");
+    return readPageCount;
+}
+
+// Inserts the keys [first, last) in increasing order and returns the page reads per insert.
+double insertAscending(IXFileHandle &ixFileHandle, const Attribute &attribute, int first, int last) {
+    unsigned readPageCountBefore = getReadPageCount(ixFileHandle);
+    for (int key = first; key < last; key++) {
+        RC rc = indexManager.insertEntry(ixFileHandle, attribute, &key, getRid(key));
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+    return (double) (getReadPageCount(ixFileHandle) - readPageCountBefore) / (last - first);
+}
+
+// Checks that the scan returns the expected keys in order.
+bool checkKeys(IXFileHandle &ixFileHandle, const Attribute &attribute, const std::vector<int> &expected) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid;
+    int key = 0;
+    unsigned count = 0;
+    bool valid = true;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (count >= expected.size() || key != expected[count] || rid.pageNum != getRid(key).pageNum) valid = false;
+        count++;
+    }
+    ix_ScanIterator.close();
+    return valid && count == expected.size();
+}
+
+int testCase_24(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Ascending inserts go to the last leaf without a descent from the root **
+    // 2. The last leaf splits 90/10, the index is about as small as a bulk loaded one **
+    // 3. Keys out of order, deletes and a reopen of the file between the ascending inserts
+    std::cout << std::endl << "***** In IX Test Case 24 *****" << std::endl;
+
+    IXFileHandle ixFileHandle;
+    bool failed = false;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    double readsPerInsert = insertAscending(ixFileHandle, attribute, 0, numKeys);
+    int insertPages = ixFileHandle.getNumberOfPages();
+
+    std::vector<int> expected;
+    for (int key = 0; key < numKeys; key++) expected.push_back(key);
+    if (!checkKeys(ixFileHandle, attribute, expected)) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    // Same keys bulk loaded with 90% full leaves.
+    rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    IX_BulkLoader bulkLoader;
+    rc = bulkLoader.initialize(ixFileHandle, attribute, 0.9);
+    assert(rc == success && "IX_BulkLoader::initialize() should not fail.");
+    for (int key = 0; key < numKeys; key++) {
+        rc = bulkLoader.addEntry(&key, getRid(key));
+        assert(rc == success && "IX_BulkLoader::addEntry() should not fail.");
+    }
+    rc = bulkLoader.finish();
+    assert(rc == success && "IX_BulkLoader::finish() should not fail.");
+    int bulkLoadPages = ixFileHandle.getNumberOfPages();
+
+    std::cout << "Page reads per ascending insert: " << readsPerInsert << ", pages: " << insertPages
+              << ", bulk loaded pages: " << bulkLoadPages << std::endl;
+    if (readsPerInsert > 1.1) {
+        std::cout << "The ascending inserts descended from the root." << std::endl;
+        failed = true;
+    }
+    if (insertPages > bulkLoadPages * 11 / 10) {
+        std::cout << "The ascending inserts left the leaves half empty." << std::endl;
+        failed = true;
+    }
+
+    // Keys after the bulk load, with some out of order ones and deletes in between.
+    readsPerInsert = insertAscending(ixFileHandle, attribute, numKeys, numKeys + 1000);
+    for (int key = numKeys; key < numKeys + 1000; key++) expected.push_back(key);
+    for (int key = 1; key < numKeys; key += 1000) {
+        rc = indexManager.deleteEntry(ixFileHandle, attribute, &key, getRid(key));
+        assert(rc == success && "indexManager::deleteEntry() should not fail.");
+        expected.erase(std::find(expected.begin(), expected.end(), key));
+    }
+    for (int key = numKeys + 1500; key > numKeys + 1000; key -= 2) {
+        rc = indexManager.insertEntry(ixFileHandle, attribute, &key, getRid(key));
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+        expected.push_back(key);
+    }
+    insertAscending(ixFileHandle, attribute, numKeys + 1501, numKeys + 2000);
+    for (int key = numKeys + 1501; key < numKeys + 2000; key++) expected.push_back(key);
+    std::sort(expected.begin(), expected.end());
+    if (!checkKeys(ixFileHandle, attribute, expected)) failed = true;
+
+    // The last leaf is kept across a reopen.
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    double readsAfterReopen = insertAscending(ixFileHandle, attribute, numKeys + 2000, numKeys + 3000);
+    for (int key = numKeys + 2000; key < numKeys + 3000; key++) expected.push_back(key);
+    if (!checkKeys(ixFileHandle, attribute, expected)) failed = true;
+    std::cout << "Page reads per ascending insert after the bulk load: " << readsPerInsert
+              << ", after a reopen: " << readsAfterReopen << std::endl;
+    if (readsAfterReopen > 1.1) failed = true;
+    if (failed) std::cout << "The scan returned wrong keys or the inserts descended from the root." << std::endl;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+
+    if (testCase_24(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 24 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 24 failed. *****" << std::endl;
+        return fail;
+    }
+}
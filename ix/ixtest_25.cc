@@ -0,0 +1,147 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 50000;
+
+RID getRid(const int key) {
+    RID rid;
+    rid.pageNum = key / 100;
+    rid.slotNum = key % 100;
+    return rid;
+}
+
+// Inserts or deletes the keys of [0, numKeys) for which keep() is false, in a shuffled order.
+void updateKeys(IXFileHandle &ixFileHandle, const Attribute &attribute, bool insert, bool (*keep)(int)) {
+    for (int i = 0; i < numKeys; i++) {
+        int key = (int) (((long long) i * 7919) % numKeys);
+        if (keep(key)) continue;
+        RC rc = insert ? indexManager.insertEntry(ixFileHandle, attribute, &key, getRid(key))
+                       : indexManager.deleteEntry(ixFileHandle, attribute, &key, getRid(key));
+        assert(rc == success && "indexManager::insertEntry() / deleteEntry() should not fail.");
+    }
+}
+
+bool keepNone(int) { return false; }
+
+bool keepAll(int) { return true; }
+
+bool keepTenth(int key) { return key % 10 == 0; }
+
+// Checks that the scan returns the keys of [0, numKeys) for which keep() is true, in order.
+bool checkKeys(IXFileHandle &ixFileHandle, const Attribute &attribute, bool (*keep)(int)) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid;
+    int key = 0, expected = 0;
+    bool valid = true;
+    while (expected < numKeys && !keep(expected)) expected++;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key != expected || rid.pageNum != getRid(key).pageNum || rid.slotNum != getRid(key).slotNum) {
+            valid = false;
+        }
+        expected++;
+        while (expected < numKeys && !keep(expected)) expected++;
+    }
+    ix_ScanIterator.close();
+    return valid && expected == numKeys;
+}
+
+int testCase_25(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Pages emptied by merges go to the free list of the header page **
+    // 2. Splits take their pages from the free list, the file does not grow on re-inserts **
+    // 3. The free list is kept across a reopen of the file
+    // 4. compactFile() shrinks the file, the scan returns the same entries **
+    std::cout << std::endl << "***** In IX Test Case 25 *****" << std::endl;
+
+    IXFileHandle ixFileHandle;
+    bool failed = false;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    updateKeys(ixFileHandle, attribute, true, keepNone);
+    int insertPages = ixFileHandle.getNumberOfPages();
+    if (!checkKeys(ixFileHandle, attribute, keepAll)) failed = true;
+
+    updateKeys(ixFileHandle, attribute, false, keepTenth);
+    int freePages = ixFileHandle.getNumberOfFreePages();
+    if (!checkKeys(ixFileHandle, attribute, keepTenth)) failed = true;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    if (ixFileHandle.getNumberOfFreePages() != freePages) {
+        std::cout << "The free list was not kept across a reopen." << std::endl;
+        failed = true;
+    }
+
+    updateKeys(ixFileHandle, attribute, true, keepTenth);
+    int reinsertPages = ixFileHandle.getNumberOfPages();
+    if (!checkKeys(ixFileHandle, attribute, keepAll)) failed = true;
+
+    std::cout << "Pages after the inserts: " << insertPages << ", freed by the deletes: " << freePages
+              << ", after the re-inserts: " << reinsertPages << std::endl;
+    if (freePages < insertPages / 2) {
+        std::cout << "The deletes did not free the merged pages." << std::endl;
+        failed = true;
+    }
+    if (reinsertPages > insertPages * 11 / 10) {
+        std::cout << "The re-inserts did not reuse the free pages." << std::endl;
+        failed = true;
+    }
+
+    // The lazy deletes leave underfull leaves, the compaction rewrites them full.
+    updateKeys(ixFileHandle, attribute, false, keepTenth);
+    int deletePages = ixFileHandle.getNumberOfPages();
+    rc = indexManager.compactFile(ixFileHandle, attribute);
+    assert(rc == success && "indexManager::compactFile() should not fail.");
+    int compactPages = ixFileHandle.getNumberOfPages();
+    if (!checkKeys(ixFileHandle, attribute, keepTenth)) failed = true;
+
+    std::cout << "Pages before the compaction: " << deletePages << ", after: " << compactPages << std::endl;
+    if (compactPages * 5 > deletePages || ixFileHandle.getNumberOfFreePages() != 0) {
+        std::cout << "The compaction did not shrink the file." << std::endl;
+        failed = true;
+    }
+
+    // The compacted file takes inserts again and is the one found after a reopen.
+    updateKeys(ixFileHandle, attribute, true, keepTenth);
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    if (!checkKeys(ixFileHandle, attribute, keepAll)) failed = true;
+    if (failed) std::cout << "The scan returned wrong entries or the pages were not reclaimed." << std::endl;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+    remove("age_idx.compact");
+
+    if (testCase_25(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 25 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 25 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,166 @@
+#include <thread>
+#include <atomic>
+
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 40000;
+const int numThreads = 4;
+
+RID getRid(const int key) {
+    RID rid;
+    rid.pageNum = key / 100;
+    rid.slotNum = key % 100;
+    return rid;
+}
+
+bool isAnyKey(const int key) { return true; }
+
+bool isOddKey(const int key) { return key % 2 == 1; }
+
+bool isEvenKey(const int key) { return key % 2 == 0; }
+
+bool isHalfEvenKey(const int key) { return key % 4 == 2; }
+
+bool isKeptKey(const int key) { return key % 4 != 2; }
+
+// Inserts or deletes the keys of [0, numKeys) taken by the filter, a thread takes every numThreads-th one
+// of a shuffled order.
+void updateKeys(IXFileHandle *ixFileHandle, const Attribute *attribute, bool insert, bool (*selected)(int),
+                int thread, std::atomic<int> *failures) {
+    for (int i = thread; i < numKeys; i += numThreads) {
+        int key = (int) (((long long) i * 7919) % numKeys);
+        if (!selected(key)) continue;
+        RC rc = insert ? indexManager.insertEntry(*ixFileHandle, *attribute, &key, getRid(key))
+                       : indexManager.deleteEntry(*ixFileHandle, *attribute, &key, getRid(key));
+        if (rc != success) (*failures)++;
+    }
+}
+
+// Scans the index until the writers are done, the keys of each scan must be increasing with their own rid.
+void scanKeys(IXFileHandle *ixFileHandle, const Attribute *attribute, std::atomic<bool> *done,
+              std::atomic<int> *failures, std::atomic<int> *scans) {
+    while (!*done) {
+        IX_ScanIterator ix_ScanIterator;
+        if (indexManager.scan(*ixFileHandle, *attribute, NULL, NULL, true, true, ix_ScanIterator) != success) {
+            (*failures)++;
+            return;
+        }
+        RID rid;
+        int key = 0, prev = -1;
+        while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+            if (key <= prev || rid.pageNum != getRid(key).pageNum || rid.slotNum != getRid(key).slotNum) {
+                (*failures)++;
+            }
+            prev = key;
+        }
+        ix_ScanIterator.close();
+        (*scans)++;
+    }
+}
+
+// Runs the inserts and the deletes of the keys taken by their filters, NULL for none, on numThreads threads
+// each while as many threads scan the index.
+int runConcurrently(IXFileHandle &ixFileHandle, const Attribute &attribute, bool (*inserted)(int),
+                    bool (*deleted)(int)) {
+    std::atomic<int> failures(0), scans(0);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> writers, readers;
+    for (int t = 0; t < numThreads; t++) {
+        readers.push_back(std::thread(scanKeys, &ixFileHandle, &attribute, &done, &failures, &scans));
+    }
+    for (int t = 0; t < numThreads; t++) {
+        if (inserted != NULL) {
+            writers.push_back(std::thread(updateKeys, &ixFileHandle, &attribute, true, inserted, t, &failures));
+        }
+        if (deleted != NULL) {
+            writers.push_back(std::thread(updateKeys, &ixFileHandle, &attribute, false, deleted, t, &failures));
+        }
+    }
+    for (auto &writer : writers) writer.join();
+    done = true;
+    for (auto &reader : readers) reader.join();
+
+    std::cout << (inserted == NULL ? "Deletes" : deleted == NULL ? "Inserts" : "Inserts and deletes")
+              << " done with " << scans << " concurrent scans, " << failures << " failures" << std::endl;
+    return failures;
+}
+
+// Checks that a scan returns the keys of [0, numKeys) taken by the filter.
+bool checkKeys(IXFileHandle &ixFileHandle, const Attribute &attribute, bool (*kept)(int)) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    RID rid;
+    int key = 0, expected = 0;
+    bool valid = true;
+    while (!kept(expected)) expected++;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        if (key != expected || rid.pageNum != getRid(key).pageNum) valid = false;
+        for (expected++; expected < numKeys && !kept(expected); expected++);
+    }
+    ix_ScanIterator.close();
+    return valid && expected == numKeys;
+}
+
+int testCase_26(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. insertEntry() on several threads while other threads scan the index **
+    // 2. deleteEntry() on several threads while other threads scan the index **
+    // 3. Inserts and deletes of the same leaves on several threads at once **
+    // 4. The scans return increasing keys with their own rids, the index has the expected keys after
+    std::cout << std::endl << "***** In IX Test Case 26 *****" << std::endl;
+
+    IXFileHandle ixFileHandle;
+    bool failed = false;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    if (runConcurrently(ixFileHandle, attribute, isAnyKey, NULL) != 0) failed = true;
+    if (!checkKeys(ixFileHandle, attribute, isAnyKey)) {
+        std::cout << "The concurrent inserts lost or duplicated entries." << std::endl;
+        failed = true;
+    }
+
+    if (runConcurrently(ixFileHandle, attribute, NULL, isOddKey) != 0) failed = true;
+    if (!checkKeys(ixFileHandle, attribute, isEvenKey)) {
+        std::cout << "The concurrent deletes left wrong entries." << std::endl;
+        failed = true;
+    }
+
+    // the odd keys come back while half of the even ones go, in the same leaves
+    if (runConcurrently(ixFileHandle, attribute, isOddKey, isHalfEvenKey) != 0) failed = true;
+    if (!checkKeys(ixFileHandle, attribute, isKeptKey)) {
+        std::cout << "The concurrent inserts and deletes left wrong entries." << std::endl;
+        failed = true;
+    }
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return failed ? fail : success;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+
+    if (testCase_26(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 26 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 26 failed. *****" << std::endl;
+        return fail;
+    }
+}
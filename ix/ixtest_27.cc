@@ -0,0 +1,165 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 5000;
+const int numDuplicates = 4;
+const int numEntries = numKeys * numDuplicates;
+
+// Entry i has the key i % numKeys, so each key has numDuplicates rids.
+RID getRid(const int i) {
+    RID rid;
+    rid.pageNum = i / 100;
+    rid.slotNum = i % 100;
+    return rid;
+}
+
+// Inserts or deletes the entries of [0, numEntries) which are odd when onlyOdd is set, in a shuffled order.
+void updateEntries(IXFileHandle &ixFileHandle, const Attribute &attribute, bool insert, bool onlyOdd) {
+    for (int j = 0; j < numEntries; j++) {
+        int i = (int) (((long long) j * 7919) % numEntries);
+        if (onlyOdd && i % 2 == 0) continue;
+        int key = i % numKeys;
+        RC rc = insert ? indexManager.insertEntry(ixFileHandle, attribute, &key, getRid(i))
+                       : indexManager.deleteEntry(ixFileHandle, attribute, &key, getRid(i));
+        assert(rc == success && "indexManager::insertEntry() / deleteEntry() should not fail.");
+    }
+}
+
+// Checks that an equality scan of each key returns its rids, only the even entries if onlyEven is set.
+// Returns the pages read per probe.
+float checkProbes(IXFileHandle &ixFileHandle, const Attribute &attribute, bool onlyEven, bool &valid) {
+    unsigned readBefore, readAfter, writeCount, appendCount;
+    ixFileHandle.collectCounterValues(readBefore, writeCount, appendCount);
+    for (int key = 0; key < numKeys; key++) {
+        IX_ScanIterator ix_ScanIterator;
+        RC rc = indexManager.scan(ixFileHandle, attribute, &key, &key, true, true, ix_ScanIterator);
+        assert(rc == success && "indexManager::scan() should not fail.");
+
+        std::vector<int> found;
+        RID rid;
+        int returnedKey = 0;
+        while (ix_ScanIterator.getNextEntry(rid, &returnedKey) == success) {
+            if (returnedKey != key) valid = false;
+            found.push_back(rid.pageNum * 100 + rid.slotNum);
+        }
+        ix_ScanIterator.close();
+
+        std::sort(found.begin(), found.end());
+        std::vector<int> expected;
+        for (int i = key; i < numEntries; i += numKeys) {
+            if (!onlyEven || i % 2 == 0) expected.push_back(i);
+        }
+        if (found != expected) valid = false;
+    }
+    ixFileHandle.collectCounterValues(readAfter, writeCount, appendCount);
+    return (float) (readAfter - readBefore) / numKeys;
+}
+
+// Checks that a scan without bounds returns every entry once, in any order.
+bool checkFullScan(IXFileHandle &ixFileHandle, const Attribute &attribute, bool onlyEven) {
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    std::vector<int> found;
+    RID rid;
+    int key = 0;
+    bool valid = true;
+    while (ix_ScanIterator.getNextEntry(rid, &key) == success) {
+        int i = rid.pageNum * 100 + rid.slotNum;
+        if (key != i % numKeys) valid = false;
+        found.push_back(i);
+    }
+    ix_ScanIterator.close();
+
+    std::sort(found.begin(), found.end());
+    for (int i = 0, n = 0; i < numEntries; i++) {
+        if (onlyEven && i % 2 != 0) continue;
+        if (n >= (int) found.size() || found[n++] != i) valid = false;
+    }
+    return valid && (int) found.size() == (onlyEven ? numEntries / 2 : numEntries);
+}
+
+int testCase_27(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. createFile() of a hash index, insertEntry() with duplicate keys splits the buckets **
+    // 2. An equality scan reads the bucket of its key only **
+    // 3. A scan without bounds returns every entry
+    // 4. deleteEntry() frees the emptied overflow pages, a missing entry is not deleted
+    // 5. The buckets are kept across a reopen of the file **
+    std::cout << std::endl << "***** In IX Test Case 27 *****" << std::endl;
+
+    IXFileHandle ixFileHandle;
+    bool valid = true;
+
+    RC rc = indexManager.createFile(indexFileName, HASH_INDEX);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    updateEntries(ixFileHandle, attribute, true, false);
+    int buckets = ixFileHandle.getNumberOfBuckets();
+    float probePages = checkProbes(ixFileHandle, attribute, false, valid);
+    if (!checkFullScan(ixFileHandle, attribute, false)) valid = false;
+    std::cout << "Buckets after the inserts: " << buckets << ", pages read per probe: " << probePages << std::endl;
+    if (buckets <= HASH_INITIAL_BUCKETS || probePages > 2) {
+        std::cout << "The buckets were not split or a probe read more than its bucket." << std::endl;
+        valid = false;
+    }
+    if (indexManager.compactFile(ixFileHandle, attribute) == success) {
+        std::cout << "compactFile() should fail on a hash index." << std::endl;
+        valid = false;
+    }
+
+    updateEntries(ixFileHandle, attribute, false, true);
+    int key = 1;
+    if (indexManager.deleteEntry(ixFileHandle, attribute, &key, getRid(1)) == success) {
+        std::cout << "deleteEntry() of a deleted entry should fail." << std::endl;
+        valid = false;
+    }
+    checkProbes(ixFileHandle, attribute, true, valid);
+    if (!checkFullScan(ixFileHandle, attribute, true)) valid = false;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    if (ixFileHandle.getNumberOfBuckets() != buckets) {
+        std::cout << "The buckets were not kept across a reopen." << std::endl;
+        valid = false;
+    }
+    checkProbes(ixFileHandle, attribute, true, valid);
+
+    // The deleted entries fit into the pages freed by the deletes.
+    int pages = ixFileHandle.getNumberOfPages();
+    updateEntries(ixFileHandle, attribute, true, true);
+    checkProbes(ixFileHandle, attribute, false, valid);
+    std::cout << "Pages before the re-inserts: " << pages << ", after: " << ixFileHandle.getNumberOfPages()
+              << std::endl;
+    if (!valid) std::cout << "A scan returned wrong entries." << std::endl;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return valid ? success : fail;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+
+    if (testCase_27(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 27 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 27 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,144 @@
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 20000;
+
+// Inserts the entries of the keys in [first, last) which are even, one rid per key.
+void insertEvenKeys(IXFileHandle &ixFileHandle, const Attribute &attribute, const int first, const int last) {
+    for (int key = first; key < last; key += 2) {
+        RID rid;
+        rid.pageNum = key / 100;
+        rid.slotNum = key % 100;
+        RC rc = indexManager.insertEntry(ixFileHandle, attribute, &key, rid);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+}
+
+// Checks that no even key of [0, last) is ruled out, returns the fraction of odd keys let through.
+float checkKeyFilter(const BloomFilter &filter, const int last, bool &valid) {
+    int falsePositives = 0;
+    for (int key = 0; key < last; key++) {
+        bool found = filter.mayContain(BloomFilter::hashValue(TypeInt, &key));
+        if (key % 2 == 0 && !found) valid = false;
+        if (key % 2 != 0 && found) falsePositives++;
+    }
+    return (float) falsePositives / (last / 2);
+}
+
+// Pages read by getKeyFilter().
+unsigned getKeyFilter(IXFileHandle &ixFileHandle, const Attribute &attribute, BloomFilter &filter) {
+    unsigned readBefore, readAfter, writeCount, appendCount;
+    ixFileHandle.collectCounterValues(readBefore, writeCount, appendCount);
+    RC rc = indexManager.getKeyFilter(ixFileHandle, attribute, filter);
+    assert(rc == success && "indexManager::getKeyFilter() should not fail.");
+    ixFileHandle.collectCounterValues(readAfter, writeCount, appendCount);
+    return readAfter - readBefore;
+}
+
+int testCase_28(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. getKeyFilter() builds a Bloom filter of the keys without false negatives **
+    // 2. The filter is kept up to date by the inserts and saved in the index file **
+    // 3. Inserts on a file whose filter was not read mark it out of date, it is built again
+    // 4. A filter which outgrew its size is dropped and its pages are freed
+    std::cout << std::endl << "***** In IX Test Case 28 *****" << std::endl;
+
+    IXFileHandle ixFileHandle;
+    BloomFilter filter;
+    bool valid = true;
+
+    // -0.0 and 0.0 are the same key
+    float zero = 0, negativeZero = -zero;
+    if (BloomFilter::hashValue(TypeReal, &zero) != BloomFilter::hashValue(TypeReal, &negativeZero)) {
+        std::cout << "-0.0 and 0.0 should hash alike." << std::endl;
+        valid = false;
+    }
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    insertEvenKeys(ixFileHandle, attribute, 0, numKeys);
+    int pages = ixFileHandle.getNumberOfPages();
+    unsigned buildReads = getKeyFilter(ixFileHandle, attribute, filter);
+    float falsePositives = checkKeyFilter(filter, numKeys, valid);
+    std::cout << "Index pages: " << pages << ", pages read by the build: " << buildReads
+              << ", false positives: " << falsePositives * 100 << "%" << std::endl;
+    if (falsePositives > 0.03) valid = false;
+
+    // Keys inserted after the build are added to the filter of the handle.
+    insertEvenKeys(ixFileHandle, attribute, numKeys, numKeys + 2000);
+    if (getKeyFilter(ixFileHandle, attribute, filter) != 0) valid = false;
+    checkKeyFilter(filter, numKeys + 2000, valid);
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    // The filter is read back from its pages instead of the entries.
+    unsigned loadReads = getKeyFilter(ixFileHandle, attribute, filter);
+    checkKeyFilter(filter, numKeys + 2000, valid);
+    std::cout << "Key filter pages: " << ixFileHandle.getNumberOfKeyFilterPages()
+              << ", pages read to load it: " << loadReads << std::endl;
+    if (ixFileHandle.getNumberOfKeyFilterPages() == 0 || loadReads != (unsigned) ixFileHandle.getNumberOfKeyFilterPages()) {
+        valid = false;
+    }
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    // An insert without the filter loaded leaves it out of date, the next call builds it again.
+    unsigned readBefore, readAfter, writeCount, appendCount;
+    ixFileHandle.collectCounterValues(readBefore, writeCount, appendCount);
+    insertEvenKeys(ixFileHandle, attribute, numKeys + 2000, numKeys + 2002);
+    ixFileHandle.collectCounterValues(readAfter, writeCount, appendCount);
+    if (readAfter - readBefore > 4) valid = false;
+    pages = ixFileHandle.getNumberOfPages();
+    if (getKeyFilter(ixFileHandle, attribute, filter) < (unsigned) pages / 2) valid = false;
+    checkKeyFilter(filter, numKeys + 2002, valid);
+    if (ixFileHandle.getNumberOfPages() != pages) valid = false;
+
+    // Three times the keys the filter was sized for, it is dropped and freed at the close.
+    insertEvenKeys(ixFileHandle, attribute, numKeys + 2002, 4 * numKeys);
+    int freeBefore = ixFileHandle.getNumberOfFreePages();
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    std::cout << "Free pages after the filter was dropped: " << ixFileHandle.getNumberOfFreePages() << std::endl;
+    if (ixFileHandle.getNumberOfFreePages() <= freeBefore) valid = false;
+    getKeyFilter(ixFileHandle, attribute, filter);
+    falsePositives = checkKeyFilter(filter, 4 * numKeys, valid);
+    if (falsePositives > 0.03) valid = false;
+
+    if (!valid) std::cout << "The key filter missed a key or was not kept." << std::endl;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return valid ? success : fail;
+}
+
+int main() {
+    const std::string indexFileName = "age_idx";
+    Attribute attrAge;
+    attrAge.length = 4;
+    attrAge.name = "age";
+    attrAge.type = TypeInt;
+
+    remove("age_idx");
+
+    if (testCase_28(indexFileName, attrAge) == success) {
+        std::cout << "***** IX Test Case 28 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 28 failed. *****" << std::endl;
+        return fail;
+    }
+}
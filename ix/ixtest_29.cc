@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <random>
+#include <set>
+
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numKeys = 40000;
+const int keyLength = 50;
+
+// VarChar key of an id, the ids sort as the keys.
+void prepareDeltaKey(const int id, void *key) {
+    char text[keyLength + 1];
+    snprintf(text, sizeof(text), "key_%08d", id);
+    std::string value(text);
+    value.resize(keyLength, 'x');
+    int length = keyLength;
+    memcpy((char *) key, &length, sizeof(int));
+    memcpy((char *) key + sizeof(int), value.c_str(), length);
+}
+
+RID getDeltaRid(const int id) {
+    RID rid;
+    rid.pageNum = id;
+    rid.slotNum = id % 100;
+    return rid;
+}
+
+RC insertDeltaKey(IXFileHandle &ixFileHandle, const Attribute &attribute, const int id) {
+    char key[PAGE_SIZE];
+    prepareDeltaKey(id, key);
+    return indexManager.insertEntry(ixFileHandle, attribute, key, getDeltaRid(id));
+}
+
+RC deleteDeltaKey(IXFileHandle &ixFileHandle, const Attribute &attribute, const int id) {
+    char key[PAGE_SIZE];
+    prepareDeltaKey(id, key);
+    return indexManager.deleteEntry(ixFileHandle, attribute, key, getDeltaRid(id));
+}
+
+// Inserts the ids in the given order, returns the pages read from the disk until the changes are in the tree.
+unsigned insertShuffled(const std::string &indexFileName, const Attribute &attribute, const std::vector<int> &ids,
+                        const bool deltaBuffer) {
+    IXFileHandle ixFileHandle;
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    if (deltaBuffer) {
+        rc = indexManager.setDeltaBuffer(ixFileHandle, attribute);
+        assert(rc == success && "indexManager::setDeltaBuffer() should not fail.");
+    }
+    for (int id : ids) {
+        rc = insertDeltaKey(ixFileHandle, attribute, id);
+        assert(rc == success && "indexManager::insertEntry() should not fail.");
+    }
+    rc = indexManager.flushDeltaBuffer(ixFileHandle);
+    assert(rc == success && "indexManager::flushDeltaBuffer() should not fail.");
+    unsigned reads = ixFileHandle.getDiskReadPageCount();
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    return reads;
+}
+
+// Scans the ids of [low, high) and checks them against the expected ones. A flush is done midway if asked.
+bool checkDeltaScan(IXFileHandle &ixFileHandle, const Attribute &attribute, const std::set<int> &expected,
+                    const int low, const int high, const bool flushMidway) {
+    char lowKey[PAGE_SIZE], highKey[PAGE_SIZE], key[PAGE_SIZE], value[PAGE_SIZE];
+    prepareDeltaKey(low, lowKey);
+    prepareDeltaKey(high, highKey);
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, lowKey, highKey, true, false, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    auto itr = expected.lower_bound(low), end = expected.lower_bound(high);
+    unsigned count = 0, total = std::distance(itr, end);
+    bool valid = true;
+    RID rid;
+    while (ix_ScanIterator.getNextEntry(rid, key) == success) {
+        if (itr == end) {
+            valid = false;
+            break;
+        }
+        prepareDeltaKey(*itr, value);
+        if (memcmp(key, value, sizeof(int) + keyLength) != 0 || rid.pageNum != *itr) {
+            std::cout << "Expected id " << *itr << ", got rid " << rid.pageNum << std::endl;
+            valid = false;
+            break;
+        }
+        ++itr;
+        if (++count == total / 2 && flushMidway) {
+            rc = indexManager.flushDeltaBuffer(ixFileHandle);
+            assert(rc == success && "indexManager::flushDeltaBuffer() should not fail.");
+        }
+    }
+    ix_ScanIterator.close();
+    if (itr != end) valid = false;
+    if (!valid) std::cout << "Wrong scan of [" << low << ", " << high << ") after " << count << " entries" << std::endl;
+    return valid;
+}
+
+int testCase_29(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Inserts held by a delta buffer read fewer pages from the disk than inserts into the tree **
+    // 2. Scans merge the changes held with the entries of the tree, deletes included **
+    // 3. A merge during a scan neither loses nor repeats an entry
+    // 4. The changes held are merged at the close and kept in the file
+    std::cout << std::endl << "***** In IX Test Case 29 *****" << std::endl;
+
+    std::vector<int> ids;
+    for (int id = 0; id < numKeys; id++) ids.push_back(2 * id);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(29));
+
+    unsigned treeReads = insertShuffled(indexFileName, attribute, ids, false);
+    RC rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+    unsigned deltaReads = insertShuffled(indexFileName, attribute, ids, true);
+    std::cout << "Pages read from the disk by " << numKeys << " random inserts: " << treeReads
+              << ", with a delta buffer: " << deltaReads << std::endl;
+    bool valid = deltaReads < treeReads / 2;
+
+    IXFileHandle ixFileHandle;
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    std::set<int> expected(ids.begin(), ids.end());
+    valid = checkDeltaScan(ixFileHandle, attribute, expected, 0, 2 * numKeys, false) && valid;
+
+    rc = indexManager.setDeltaBuffer(ixFileHandle, attribute);
+    assert(rc == success && "indexManager::setDeltaBuffer() should not fail.");
+
+    // Odd ids are held, every third even id of the tree is deleted and so is every fifth held id.
+    for (int id = 1; id < 2000; id += 2) {
+        if (insertDeltaKey(ixFileHandle, attribute, id) != success) valid = false;
+        expected.insert(id);
+    }
+    for (int id = 0; id < 2000; id += 6) {
+        if (deleteDeltaKey(ixFileHandle, attribute, id) != success) valid = false;
+        expected.erase(id);
+    }
+    for (int id = 1; id < 2000; id += 10) {
+        if (deleteDeltaKey(ixFileHandle, attribute, id) != success) valid = false;
+        expected.erase(id);
+    }
+    // Missing entries and entries deleted twice are not found.
+    if (deleteDeltaKey(ixFileHandle, attribute, 1) == success || deleteDeltaKey(ixFileHandle, attribute, 6) == success ||
+        deleteDeltaKey(ixFileHandle, attribute, 2 * numKeys + 1) == success) {
+        valid = false;
+    }
+    // A tree entry deleted and inserted again is back.
+    if (deleteDeltaKey(ixFileHandle, attribute, 14) != success || insertDeltaKey(ixFileHandle, attribute, 14) != success) {
+        valid = false;
+    }
+    expected.insert(14);
+    std::cout << "Changes held by the delta buffer: " << ixFileHandle.getNumberOfDeltaEntries() << std::endl;
+    if (ixFileHandle.getNumberOfDeltaEntries() == 0) valid = false;
+
+    valid = checkDeltaScan(ixFileHandle, attribute, expected, 0, 2 * numKeys, false) && valid;
+    valid = checkDeltaScan(ixFileHandle, attribute, expected, 101, 347, false) && valid;
+    valid = checkDeltaScan(ixFileHandle, attribute, expected, 0, 2000, true) && valid;
+    if (ixFileHandle.getNumberOfDeltaEntries() != 0) valid = false;
+    valid = checkDeltaScan(ixFileHandle, attribute, expected, 0, 2 * numKeys, false) && valid;
+
+    // Held changes reach the file at the close.
+    for (int id = 2001; id < 3000; id += 2) {
+        if (insertDeltaKey(ixFileHandle, attribute, id) != success) valid = false;
+        expected.insert(id);
+    }
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+    if (ixFileHandle.hasDeltaBuffer()) valid = false;
+    valid = checkDeltaScan(ixFileHandle, attribute, expected, 0, 2 * numKeys, false) && valid;
+
+    if (!valid) std::cout << "The delta buffer lost a change or read as many pages." << std::endl;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return valid ? success : fail;
+}
+
+int main() {
+    const std::string indexFileName = "name_idx";
+    Attribute attrName;
+    attrName.length = keyLength;
+    attrName.name = "name";
+    attrName.type = TypeVarChar;
+
+    remove("name_idx");
+
+    if (testCase_29(indexFileName, attrName) == success) {
+        std::cout << "***** IX Test Case 29 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 29 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -0,0 +1,147 @@
+#include <random>
+#include <set>
+
+#include "ix.h"
+#include "ix_test_util.h"
+
+const int numIds = 3000;
+const int idsPerKey = 3;
+const int numSteps = 40000;
+const int maxKeyLength = 1000;
+
+// VarChar key of an id, shared by idsPerKey ids. The ids sort as the keys and a key is 850 to 949 bytes long.
+int prepareLongKey(const int id, void *key) {
+    int keyNum = id / idsPerKey;
+    char text[16];
+    snprintf(text, sizeof(text), "key_%08d", keyNum);
+    std::string value(text);
+    value.resize(850 + keyNum % 100, (char) ('a' + keyNum % 26));
+    int length = value.size();
+    memcpy((char *) key, &length, sizeof(int));
+    memcpy((char *) key + sizeof(int), value.c_str(), length);
+    return sizeof(int) + length;
+}
+
+RID getLongKeyRid(const int id) {
+    RID rid;
+    rid.pageNum = id;
+    rid.slotNum = id % 50;
+    return rid;
+}
+
+// Scans the whole index and checks it against the expected ids.
+bool checkLongKeyScan(IXFileHandle &ixFileHandle, const Attribute &attribute, const std::set<int> &expected) {
+    char key[PAGE_SIZE], value[PAGE_SIZE];
+    IX_ScanIterator ix_ScanIterator;
+    RC rc = indexManager.scan(ixFileHandle, attribute, NULL, NULL, true, true, ix_ScanIterator);
+    assert(rc == success && "indexManager::scan() should not fail.");
+
+    auto itr = expected.begin();
+    bool valid = true;
+    RID rid;
+    while (ix_ScanIterator.getNextEntry(rid, key) == success) {
+        if (itr == expected.end()) {
+            valid = false;
+            break;
+        }
+        int size = prepareLongKey(*itr, value);
+        if (memcmp(key, value, size) != 0 || rid.pageNum != *itr) {
+            std::cout << "Expected id " << *itr << ", got rid " << rid.pageNum << std::endl;
+            valid = false;
+            break;
+        }
+        ++itr;
+    }
+    ix_ScanIterator.close();
+    if (itr != expected.end()) valid = false;
+    return valid;
+}
+
+int testCase_30(const std::string &indexFileName, const Attribute &attribute) {
+    // Functions tested
+    // 1. Random inserts and deletes of keys of about 900 bytes, a node holds a few of them **
+    // 2. Internal nodes left with a single child by merges stay valid **
+    // 3. Freed pages are reused by later splits
+    // 4. Every live entry is found and deleted, no deleted one is found
+    std::cout << std::endl << "***** In IX Test Case 30 *****" << std::endl;
+
+    RC rc = indexManager.createFile(indexFileName);
+    assert(rc == success && "indexManager::createFile() should not fail.");
+    IXFileHandle ixFileHandle;
+    rc = indexManager.openFile(indexFileName, ixFileHandle);
+    assert(rc == success && "indexManager::openFile() should not fail.");
+
+    std::mt19937 generator(30);
+    std::uniform_int_distribution<int> anyId(0, numIds - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::set<int> expected;
+    char key[PAGE_SIZE];
+    bool valid = true;
+
+    // Inserts outnumber the deletes for 2000 steps, then the other way round.
+    for (int step = 0; step < numSteps && valid; step++) {
+        int id = anyId(generator);
+        bool insert = percent(generator) < ((step / 2000) % 2 == 0 ? 65 : 35);
+        prepareLongKey(id, key);
+        if (insert && expected.count(id) == 0) {
+            rc = indexManager.insertEntry(ixFileHandle, attribute, key, getLongKeyRid(id));
+            if (rc != success) {
+                std::cout << "Insert of id " << id << " failed at step " << step << std::endl;
+                valid = false;
+            }
+            expected.insert(id);
+        } else if (!insert) {
+            rc = indexManager.deleteEntry(ixFileHandle, attribute, key, getLongKeyRid(id));
+            if ((rc == success) != (expected.count(id) == 1)) {
+                std::cout << "Delete of id " << id << " returned " << rc << " at step " << step << std::endl;
+                valid = false;
+            }
+            expected.erase(id);
+        }
+        if ((step + 1) % 4000 == 0) {
+            valid = valid && checkLongKeyScan(ixFileHandle, attribute, expected);
+            std::cout << "Step " << step + 1 << ": " << expected.size() << " entries, "
+                      << ixFileHandle.getNumberOfPages() << " pages" << std::endl;
+        }
+    }
+
+    // Every entry left is deleted.
+    for (auto itr = expected.begin(); itr != expected.end() && valid; ++itr) {
+        prepareLongKey(*itr, key);
+        if (indexManager.deleteEntry(ixFileHandle, attribute, key, getLongKeyRid(*itr)) != success) {
+            std::cout << "Delete of id " << *itr << " failed" << std::endl;
+            valid = false;
+        }
+    }
+    if (valid) {
+        expected.clear();
+        valid = checkLongKeyScan(ixFileHandle, attribute, expected);
+    }
+
+    if (!valid) std::cout << "The index lost or corrupted an entry with a long key." << std::endl;
+
+    rc = indexManager.closeFile(ixFileHandle);
+    assert(rc == success && "indexManager::closeFile() should not fail.");
+    rc = indexManager.destroyFile(indexFileName);
+    assert(rc == success && "indexManager::destroyFile() should not fail.");
+
+    return valid ? success : fail;
+}
+
+int main() {
+    const std::string indexFileName = "name_idx";
+    Attribute attrName;
+    attrName.length = maxKeyLength;
+    attrName.name = "name";
+    attrName.type = TypeVarChar;
+
+    remove("name_idx");
+
+    if (testCase_30(indexFileName, attrName) == success) {
+        std::cout << "***** IX Test Case 30 finished. The result will be examined. *****" << std::endl;
+        return success;
+    } else {
+        std::cout << "***** [FAIL] IX Test Case 30 failed. *****" << std::endl;
+        return fail;
+    }
+}
@@ -446,7 +446,9 @@ Filter::Filter(Iterator *input, const Condition &condition) {
                                              this->filterAttributes,
                                              this->lhsColPos);
 
-    this->lhsAttrVal = malloc(PAGE_SIZE);
+    // VarChars in overflow pages can make a value larger than a page
+    int tupleSize = std::max((int)PAGE_SIZE, getMaxRecordSize(this->filterAttributes));
+    this->lhsAttrVal = malloc(tupleSize);
     this->dataType = this->filterAttributes[this->lhsColPos].type;
 
     if(this->filterCondition.bRhsIsAttr) {
@@ -454,7 +456,7 @@ Filter::Filter(Iterator *input, const Condition &condition) {
                                                  this->filterAttributes,
                                                  this->rhsColPos);
 
-        this->rhsAttrVal = malloc(PAGE_SIZE);
+        this->rhsAttrVal = malloc(tupleSize);
     } else {
         this->rhsColPos = INT_MAX;
     }
@@ -495,7 +497,7 @@ void Filter::getAttributes(std::vector<Attribute>& attrs) const {
 Project::Project(Iterator *input, const std::vector<std::string> &attrNames) {
     this->projectIterator = input;
     input->getAttributes(this->projectAttributes);
-    this->projectData = malloc(PAGE_SIZE);
+    this->projectData = malloc(std::max((int)PAGE_SIZE, getMaxRecordSize(this->projectAttributes)));
     for(int i = 0; i < (int)attrNames.size(); i++) {
         int colPos = 0;
         QueryEngineUtils::getPositionOfAttribute(attrNames[i], this->projectAttributes, colPos);
@@ -550,11 +552,12 @@ Aggregate::Aggregate(Iterator* input, const Attribute &aggAttr, AggregateOp op)
     input->getAttributes(this->aggrAttributes);
     this->aggrOp = op;
     this->aggrAttribute = aggAttr;
-    this->aggrData = malloc(PAGE_SIZE);
+    this->aggrData = malloc(std::max((int)PAGE_SIZE, getMaxRecordSize(this->aggrAttributes)));
     this->aggrColData = malloc(sizeof(int));
     this->aggrType = aggAttr.type;
     this->endFlag = false;
     this->isGroupBy = false;
+    this->groupData = NULL;
     QueryEngineUtils::getPositionOfAttribute(aggAttr.name, this->aggrAttributes, this->aggrColPos);
     aggrStat[0] = FLT_MAX;
     aggrStat[1] = FLT_MIN;
@@ -571,11 +574,12 @@ Aggregate::Aggregate(Iterator* input, const Attribute &aggAttr, const Attribute
     this->aggrAttribute = aggAttr;
     this->groupAttr = groupAttr;
     this->isGroupBy = true;
-    this->aggrData = malloc(PAGE_SIZE);
+    int tupleSize = std::max((int)PAGE_SIZE, getMaxRecordSize(this->aggrAttributes));
+    this->aggrData = malloc(tupleSize);
     this->aggrColData = malloc(sizeof(int));
     this->aggrType = aggAttr.type;
     this->groupType = groupAttr.type;
-    this->groupData = malloc(PAGE_SIZE);
+    this->groupData = malloc(tupleSize);
     this->aggrDone = false; 
     this->endFlag = false;
     QueryEngineUtils::getPositionOfAttribute(aggAttr.name, this->aggrAttributes, this->aggrColPos);
@@ -779,23 +783,26 @@ BNLJoin::BNLJoin(Iterator* leftIn, TableScan* rightIn,
         QueryEngineUtils::getPositionOfAttribute(condition.rhsAttr, this->rAttributes, this->rColPos);
 
     this->joinDataType = this->lAttributes[this->lColPos].type;
-    this->blockSize = numPages*PAGE_SIZE;
+    this->lTupleSize = std::max((int)PAGE_SIZE, getMaxRecordSize(this->lAttributes));
+    int rTupleSize = std::max((int)PAGE_SIZE, getMaxRecordSize(this->rAttributes));
+    // the block holds at least one left tuple
+    this->blockSize = std::max((int)(numPages*PAGE_SIZE), this->lTupleSize);
     this->block = malloc(this->blockSize);
-    this->lTuple = malloc(PAGE_SIZE);
-    this->rTuple = malloc(PAGE_SIZE);
-    this->rColData = malloc(PAGE_SIZE);
+    this->lTuple = malloc(this->lTupleSize);
+    this->rTuple = malloc(rTupleSize);
+    this->rColData = malloc(rTupleSize);
     this->lastTupleIndex = -1;
     this->lastTupleNum = 0;
-    this->lastRemTuple = malloc(PAGE_SIZE);
+    this->lastRemTuple = malloc(this->lTupleSize);
     this->lastRemTupleSize = 0;
 
 
     createHashTable( this->joinDataType);
 
+    this->LEOF = false;
     this->numTuples = loadDataIntoBlock();
     this->isUsingPrev = false;
     this->isRNull = 0;
-    this->LEOF = false;
 
 }
 
@@ -831,20 +838,21 @@ void BNLJoin::deleteHashTable(int type) {
 }
 
 int BNLJoin::loadDataIntoBlock() {
-    void* data = malloc(PAGE_SIZE);
-    void* lColData = malloc(PAGE_SIZE);
+    void* data = malloc(this->lTupleSize);
+    void* lColData = malloc(this->lTupleSize);
     int offset = 0;
     int numTuples = 0;
     bool noEnd = true;
 
-    if(this->lastRemTupleSize != -1) {
-        memcpy((char*)this->lastRemTuple, (char*)block + offset, this->lastRemTupleSize);
-        offset += this->lastRemTupleSize;
-        this->lastRemTupleSize = -1;
-        numTuples++;
+    /* the tuple that did not fit into the previous block starts this one */
+    bool hasRemTuple = this->lastRemTupleSize > 0;
+    if(hasRemTuple) {
+        memcpy((char*)data, (char*)this->lastRemTuple, this->lastRemTupleSize);
+        this->lastRemTupleSize = 0;
     }
 
-    while(this->lIterator->getNextTuple(data) != QE_EOF) {
+    while(hasRemTuple || this->lIterator->getNextTuple(data) != QE_EOF) {
+        hasRemTuple = false;
         int tupleSize = QueryEngineUtils::getTupleSize(data, this->lAttributes);
         int isLNull = QueryEngineUtils::getColumnData(data, this->lColPos,
                                                       this->lAttributes, lColData);
@@ -877,52 +885,51 @@ int BNLJoin::loadDataIntoBlock() {
 }
 
 RC BNLJoin::getNextTuple(void* data) {
-    while(this->isUsingPrev || this->rIterator->getNextTuple(this->rTuple) != QE_EOF) {
-        if(!this->isUsingPrev) { 
-            this->isRNull = QueryEngineUtils::getColumnData(this->rTuple, this->rColPos,
-                                                          this->rAttributes, this->rColData);
-        }
-        if(this->isRNull == -1) continue;
+    while(true) {
+        while(this->isUsingPrev || this->rIterator->getNextTuple(this->rTuple) != QE_EOF) {
+            if(!this->isUsingPrev) { 
+                this->isRNull = QueryEngineUtils::getColumnData(this->rTuple, this->rColPos,
+                                                              this->rAttributes, this->rColData);
+            }
+            if(this->isRNull == -1) continue;
 
-        if(this->lastTupleIndex == -1 || this->lastTupleIndex == (int)this->tupleOffsets.size()) {
-            this->tupleOffsets.clear();
-            this->tupleOffsets = QueryEngineUtils::getTupleOffsetFromHashTable(this->hashMap,
-                                                                               this->rColData,
-                                                                               isRNull,
-                                                                               this->joinDataType);
+            if(this->lastTupleIndex == -1 || this->lastTupleIndex == (int)this->tupleOffsets.size()) {
+                this->tupleOffsets.clear();
+                this->tupleOffsets = QueryEngineUtils::getTupleOffsetFromHashTable(this->hashMap,
+                                                                                   this->rColData,
+                                                                                   isRNull,
+                                                                                   this->joinDataType);
 
-            this->lastTupleIndex = 0;
-        }
+                this->lastTupleIndex = 0;
+            }
 
-        if(this->tupleOffsets.size() == 0) continue;
+            if(this->tupleOffsets.size() == 0) continue;
 
-        QueryEngineUtils::getTupleFromBlock(this->block, tupleOffsets[this->lastTupleIndex],
-                                            this->lAttributes, this->lTuple);
-        this->lastTupleIndex++;
-        QueryEngineUtils::concatTuples(this->lTuple, this->lAttributes,
-                                       this->rTuple, this->rAttributes, data);
+            QueryEngineUtils::getTupleFromBlock(this->block, tupleOffsets[this->lastTupleIndex],
+                                                this->lAttributes, this->lTuple);
+            this->lastTupleIndex++;
+            QueryEngineUtils::concatTuples(this->lTuple, this->lAttributes,
+                                           this->rTuple, this->rAttributes, data);
 
-        if(this->lastTupleIndex == (int)this->tupleOffsets.size()) {
-            this->isUsingPrev = false;
-        } else {
-            this->isUsingPrev = true;
+            if(this->lastTupleIndex == (int)this->tupleOffsets.size()) {
+                this->isUsingPrev = false;
+            } else {
+                this->isUsingPrev = true;
+            }
+            return 0;
         }
-        return 0;
-    }
 
-    if(!this->LEOF) {
-        if(this->lastTupleNum > this->numTuples) {
-            QueryEngineUtils::eraseHashTableData(hashMap, this->joinDataType);
-            this->numTuples = loadDataIntoBlock();
-            this->lastTupleIndex = -1;
-            this->lastTupleNum = 0;
-            this->rIterator->setIterator();
-            this->isUsingPrev = false;
-        }
-    }
-    
+        if(this->LEOF) return QE_EOF;
 
-    return QE_EOF;
+        /* the right input is done with this block, join it again with the next one */
+        QueryEngineUtils::eraseHashTableData(hashMap, this->joinDataType);
+        this->numTuples = loadDataIntoBlock();
+        this->tupleOffsets.clear();
+        this->lastTupleIndex = -1;
+        this->lastTupleNum = 0;
+        this->rIterator->setIterator();
+        this->isUsingPrev = false;
+    }
 }
 
 void BNLJoin::getAttributes(std::vector<Attribute>& attrs) const {
@@ -945,13 +952,18 @@ INLJoin::INLJoin(Iterator* leftIn, IndexScan* rightIn, const Condition& conditio
         QueryEngineUtils::getPositionOfAttribute(condition.rhsAttr, this->rAttributes, this->rColPos);
 
     this->joinDataType = this->lAttributes[this->lColPos].type;
-    this->lTuple = malloc(PAGE_SIZE);
-    this->rTuple = malloc(PAGE_SIZE);
-    this->lColData = malloc(PAGE_SIZE);
-    this->rColData = malloc(PAGE_SIZE);
+    int lTupleSize = std::max((int)PAGE_SIZE, getMaxRecordSize(this->lAttributes));
+    int rTupleSize = std::max((int)PAGE_SIZE, getMaxRecordSize(this->rAttributes));
+    this->lTuple = malloc(lTupleSize);
+    this->rTuple = malloc(rTupleSize);
+    this->lColData = malloc(lTupleSize);
+    this->rColData = malloc(rTupleSize);
 
     this->usingPrevTuple = false;
     this->isLNull = 0;
+    // a composite index is probed on its leading column, its filter holds whole keys
+    this->useKeyFilter = rightIn->keyAttrNames.empty() && rightIn->getKeyFilter(this->keyFilter) == 0;
+    this->skippedProbes = 0;
 }
 
 RC INLJoin::getNextTuple(void* data) {
@@ -960,6 +972,12 @@ RC INLJoin::getNextTuple(void* data) {
         if(!this->usingPrevTuple) {
             this->isLNull = QueryEngineUtils::getColumnData(this->lTuple, this->lColPos,
                                                             this->lAttributes, this->lColData);
+            if(this->isLNull == -1) continue;
+            if(this->useKeyFilter &&
+               !this->keyFilter.mayContain(BloomFilter::hashValue((AttrType)this->joinDataType, this->lColData))) {
+                this->skippedProbes++;
+                continue;
+            }
             this->rIterator->setIterator(this->lColData, this->lColData, true, true);
 
         }
@@ -1015,9 +1033,12 @@ GHJoin::GHJoin(Iterator* leftIn, Iterator* rightIn,
                                                  this->rColPos);
 
     this->joinDataType = this->lAttributes[this->lColPos].type;
-    this->lTuple = malloc(PAGE_SIZE);
-    this->rTuple = malloc(PAGE_SIZE);
-    this->rColData = malloc(PAGE_SIZE);
+    // the partitioning reads the tuples of both inputs into lTuple
+    this->tupleSize = std::max((int)PAGE_SIZE, std::max(getMaxRecordSize(this->lAttributes),
+                                                        getMaxRecordSize(this->rAttributes)));
+    this->lTuple = malloc(this->tupleSize);
+    this->rTuple = malloc(this->tupleSize);
+    this->rColData = malloc(this->tupleSize);
 
     this->isUsingPrevT = false;
     this->isUsingPrev = false;
@@ -1040,8 +1061,15 @@ GHJoin::GHJoin(Iterator* leftIn, Iterator* rightIn,
     joinCounter = QueryEngineUtils::getJoinCounter();
     createIntermediatePartitions(numPartitions);
 
-    populatePartition(this->lIterator, this->lFileHandles, this->lColPos, this->lAttributes);
-    populatePartition(this->rIterator, this->rFileHandles, this->rColPos, this->rAttributes);
+    // the keys of R fill a Bloom filter which drops the tuples of S without a match
+    std::vector<unsigned long long> buildKeys;
+    populatePartition(this->lIterator, this->lFileHandles, this->lColPos, this->lAttributes, &buildKeys);
+    this->keyFilter.init(buildKeys.size());
+    for(unsigned long long hash : buildKeys) {
+        this->keyFilter.add(hash);
+    }
+    this->droppedTuples = 0;
+    populatePartition(this->rIterator, this->rFileHandles, this->rColPos, this->rAttributes, NULL);
     createHashTable( this->joinDataType);
 
     this->joinComplete = false;
@@ -1059,13 +1087,22 @@ void GHJoin::createIntermediatePartitions(unsigned numPartitions) {
     return;
 }
 
-/* uses hashfuncion to populate partition */
-void GHJoin::populatePartition(Iterator* itr, FileHandle* fileHandles, int colPos, std::vector<Attribute>& attrs) {
+/* uses hashfuncion to populate partition, the hashes of the build keys are collected
+ * into buildKeys, without it the tuples whose key is not in the key filter are dropped */
+void GHJoin::populatePartition(Iterator* itr, FileHandle* fileHandles, int colPos, std::vector<Attribute>& attrs,
+                               std::vector<unsigned long long>* buildKeys) {
     while(itr->getNextTuple(this->lTuple) != QE_EOF) {
        int isNull = QueryEngineUtils::getColumnData(this->lTuple, colPos,
                                                     attrs, this->rColData);
 
        if(isNull == -1) continue;
+       unsigned long long hash = BloomFilter::hashValue((AttrType)this->joinDataType, this->rColData);
+       if(buildKeys != NULL) {
+           buildKeys->push_back(hash);
+       } else if(!this->keyFilter.mayContain(hash)) {
+           this->droppedTuples++;
+           continue;
+       }
        int partition = QueryEngineUtils::getPartitionToInsert(this->rColData, this->joinDataType,
                                                               isNull, this->numPartitions);
        RID dummyRID;
@@ -1089,8 +1126,8 @@ RC GHJoin::loadFileIntoMemory(FileHandle& fileHandle, void* block) {
     rbfm.scan(fileHandle, this->lAttributes, "", NO_OP,
               NULL, this->lAttrNames, this->rbfmSI);
 
-    void* record = malloc(PAGE_SIZE);
-    void* lColData = malloc(PAGE_SIZE);
+    void* record = malloc(this->tupleSize);
+    void* lColData = malloc(this->tupleSize);
     int offset = 0;
     int numRecords = 0;
     RID dummyRID;
@@ -171,7 +171,24 @@ public:
     char key[PAGE_SIZE]{};
     RID rid{};
 
-    IndexScan(RelationManager &rm, const std::string &tableName, const std::string &attrName, const char *alias = NULL)
+    // Batched fetch: up to batchSize rids are collected from the index and their tuples are read
+    // with readTuples(), which visits the heap pages in page order, each of them once per batch.
+    unsigned batchSize;
+    std::vector<RID> batchRids;
+    char *batchTuples;
+    int tupleSize;
+    unsigned batchPos;
+
+    // Index-only scan: the tuples hold the key and INCLUDE columns of the index and are built
+    // from the index entries, the heap file is not read.
+    std::vector<Attribute> indexAttrs;
+    bool indexOnly;
+
+    // Columns of a composite index, empty for an index on attrName.
+    std::vector<std::string> keyAttrNames;
+
+    IndexScan(RelationManager &rm, const std::string &tableName, const std::string &attrName, const char *alias = NULL,
+              const unsigned batchSize = 0)
             : rm(rm) {
         // Set members
         this->tableName = tableName;
@@ -185,19 +202,95 @@ public:
         iter = new RM_IndexScanIterator();
         rm.indexScan(tableName, attrName, NULL, NULL, true, true, *iter);
 
+        this->batchSize = batchSize;
+        this->tupleSize = getMaxRecordSize(attrs);
+        this->batchTuples = batchSize == 0 ? NULL : (char *) malloc((size_t) batchSize * tupleSize);
+        this->batchPos = 0;
+        rm.getIndexAttributes(tableName, attrName, indexAttrs);
+        this->indexOnly = false;
+
+        // Set alias
+        if (alias) this->tableName = alias;
+    };
+
+    // Scan over a composite index, attrName is its leading column.
+    IndexScan(RelationManager &rm, const std::string &tableName, const std::vector<std::string> &keyAttrNames,
+              const char *alias = NULL, const unsigned batchSize = 0)
+            : rm(rm) {
+        // Set members
+        this->tableName = tableName;
+        this->attrName = keyAttrNames[0];
+        this->keyAttrNames = keyAttrNames;
+
+        // Get Attributes from RM
+        rm.getAttributes(tableName, attrs);
+
+        // Call rm compositeIndexScan to get iterator
+        iter = new RM_IndexScanIterator();
+        rm.compositeIndexScan(tableName, keyAttrNames, NULL, NULL, 0, true, true, *iter);
+
+        this->batchSize = batchSize;
+        this->tupleSize = getMaxRecordSize(attrs);
+        this->batchTuples = batchSize == 0 ? NULL : (char *) malloc((size_t) batchSize * tupleSize);
+        this->batchPos = 0;
+        this->indexOnly = false;
+
         // Set alias
         if (alias) this->tableName = alias;
     };
 
-    // Start a new iterator given the new key range
+    // Start a new iterator given the new key range, on a composite index the keys are values
+    // of the leading column.
     void setIterator(void *lowKey, void *highKey, bool lowKeyInclusive, bool highKeyInclusive) {
+        setIterator(lowKey, highKey, 1, lowKeyInclusive, highKeyInclusive);
+    };
+
+    // Start a new iterator given the values of the first prefixColumns columns of a composite index.
+    void setIterator(void *lowKey, void *highKey, unsigned prefixColumns, bool lowKeyInclusive,
+                     bool highKeyInclusive) {
         iter->close();
         delete iter;
         iter = new RM_IndexScanIterator();
-        rm.indexScan(tableName, attrName, lowKey, highKey, lowKeyInclusive, highKeyInclusive, *iter);
+        if (keyAttrNames.empty()) {
+            rm.indexScan(tableName, attrName, lowKey, highKey, lowKeyInclusive, highKeyInclusive, *iter);
+        } else {
+            rm.compositeIndexScan(tableName, keyAttrNames, lowKey, highKey, prefixColumns,
+                                  lowKeyInclusive, highKeyInclusive, *iter);
+        }
+        batchRids.clear();
+        batchPos = 0;
+    };
+
+    // Switches to an index-only scan if the index covers every given column, names may be
+    // qualified with the table name. Returns false and keeps reading the heap otherwise.
+    bool useIndexOnly(const std::vector<std::string> &attrNames) {
+        for (const std::string &attrName : attrNames) {
+            std::string name = attrName.substr(attrName.find('.') + 1);
+            bool covered = false;
+            for (const Attribute &attr : indexAttrs) {
+                if (attr.name == name) covered = true;
+            }
+            if (!covered) return false;
+        }
+        indexOnly = !indexAttrs.empty();
+        return indexOnly;
+    };
+
+    // Bloom filter of the keys of the index, an equality scan of a key ruled out by it finds nothing.
+    RC getKeyFilter(BloomFilter &filter) {
+        return iter->getKeyFilter(filter);
     };
 
     RC getNextTuple(void *data) override {
+        if (indexOnly) {
+            int rc = iter->getNextEntry(rid, key);
+            if (rc == 0) {
+                rc = rm.getTupleFromIndexEntry(indexAttrs, key, data);
+            }
+            return rc;
+        }
+        if (batchSize != 0) return getNextBatchedTuple(data);
+
         int rc = iter->getNextEntry(rid, key);
         if (rc == 0) {
             rc = rm.readTuple(tableName.c_str(), rid, data);
@@ -205,9 +298,30 @@ public:
         return rc;
     };
 
+    // Tuples are still returned in index order, only the heap reads of a batch are sorted.
+    RC getNextBatchedTuple(void *data) {
+        if (batchPos == batchRids.size()) {
+            batchRids.clear();
+            batchPos = 0;
+            while (batchRids.size() < batchSize && iter->getNextEntry(rid, key) == 0) {
+                batchRids.push_back(rid);
+            }
+            if (batchRids.empty()) return QE_EOF;
+            if (rm.readTuples(tableName, batchRids, batchTuples, tupleSize) == -1) {
+                batchRids.clear();
+                return -1;
+            }
+        }
+
+        char *tuple = batchTuples + (size_t) batchPos * tupleSize;
+        memcpy(data, tuple, QueryEngineUtils::getTupleSize(tuple, attrs));
+        rid = batchRids[batchPos++];
+        return 0;
+    };
+
     void getAttributes(std::vector<Attribute> &attributes) const override {
         attributes.clear();
-        attributes = this->attrs;
+        attributes = indexOnly ? this->indexAttrs : this->attrs;
 
 
         // For attribute in std::vector<Attribute>, name it as rel.attr
@@ -222,6 +336,7 @@ public:
     ~IndexScan() override {
         iter->close();
         delete iter;
+        if (batchTuples != NULL) free(batchTuples);
     };
 };
 
@@ -288,6 +403,7 @@ private:
     void* lTuple = NULL;
     void* rTuple = NULL;
     void* rColData = NULL;
+    int lTupleSize;                 // largest left tuple, VarChars may be in overflow pages
     int blockSize;
     void* block = NULL;
     int lastTupleIndex;
@@ -339,6 +455,9 @@ private:
     void* rColData = NULL;
     bool usingPrevTuple;
     int isLNull;
+    BloomFilter keyFilter;          // keys of the index of S, outer keys ruled out by it are not probed
+    bool useKeyFilter;
+    unsigned skippedProbes;
 
 public:
     INLJoin(Iterator *leftIn,           // Iterator of input R
@@ -357,6 +476,9 @@ public:
 
     // For attribute in std::vector<Attribute>, name it as rel.attr
     void getAttributes(std::vector<Attribute> &attrs) const override;
+
+    // Outer tuples whose key was ruled out by the key filter without scanning the index
+    unsigned getSkippedProbes() const { return skippedProbes; }
 };
 
 // Optional for everyone. 10 extra-credit points
@@ -375,6 +497,7 @@ private:
     void* lTuple = NULL;
     void* rTuple = NULL;
     void* rColData = NULL;
+    int tupleSize;                  // largest tuple of either input, VarChars may be in overflow pages
     bool isUsingPrevT;
     bool isUsingPrev;
     int isRNull;
@@ -389,6 +512,8 @@ private:
     RBFM_ScanIterator rbfmSI;
     FileHandle* lFileHandles;
     FileHandle* rFileHandles;
+    BloomFilter keyFilter;          // join keys of R, tuples of S ruled out by it are not partitioned
+    unsigned droppedTuples;
 
     int joinCounter;
     bool joinComplete;
@@ -398,7 +523,7 @@ private:
     void deleteHashTable(const int type);
     void createIntermediatePartitions(unsigned numPartitions);
     void populatePartition(Iterator* itr, FileHandle* fileHandles, int colPos,
-                           std::vector<Attribute>& attrs);
+                           std::vector<Attribute>& attrs, std::vector<unsigned long long>* buildKeys);
     void deleteIntermediatePartitions();
 
     // Grace hash join operator
@@ -415,6 +540,9 @@ public:
 
     // For attribute in std::vector<Attribute>, name it as rel.attr
     void getAttributes(std::vector<Attribute> &attrs) const override;
+
+    // Tuples of S dropped before partitioning since no tuple of R has their key
+    unsigned getDroppedTuples() const { return droppedTuples; }
 };
 
 class Aggregate : public Iterator {
@@ -0,0 +1,124 @@
+#include "qe_test_util.h"
+
+const std::string shuffledTableName = "largeshuffled";
+const int shuffledTupleCount = 20000;
+
+// B is a permutation of [0, shuffledTupleCount), so the index order jumps between heap pages.
+int createShuffledTable() {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "A";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    attr.name = "B";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    attr.name = "C";
+    attr.type = TypeReal;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    RC rc = rm.createTable(shuffledTableName, attrs);
+    if (rc != success) return rc;
+
+    void *buf = malloc(bufSize);
+    unsigned char nullsIndicator = 0;
+    RID rid;
+    for (int i = 0; i < shuffledTupleCount && rc == success; i++) {
+        int b = (int) (((long long) i * 7919) % shuffledTupleCount);
+        prepareLeftTuple(attrs.size(), &nullsIndicator, i, b, (float) b + 0.5f, buf);
+        rc = rm.insertTuple(shuffledTableName, buf, rid);
+    }
+    free(buf);
+    if (rc != success) return rc;
+
+    return rm.createIndex(shuffledTableName, "B");
+}
+
+// Scans B in [low, high] and returns the number of heap page reads, the tuples are appended to values.
+unsigned scanRange(IndexScan *scan, int low, int high, std::vector<int> &values, bool &valid) {
+    unsigned readPageCountBefore = 0, readPageCount = 0, writePageCount = 0, appendPageCount = 0;
+    scan->setIterator(&low, &high, true, true);
+    rm.fileHandle.collectCounterValues(readPageCountBefore, writePageCount, appendPageCount);
+
+    void *data = malloc(bufSize);
+    while (scan->getNextTuple(data) != QE_EOF) {
+        int a = *(int *) ((char *) data + 1);
+        int b = *(int *) ((char *) data + 1 + sizeof(int));
+        float c = *(float *) ((char *) data + 1 + 2 * sizeof(int));
+        if (b != (int) (((long long) a * 7919) % shuffledTupleCount) || c != (float) b + 0.5f) valid = false;
+        values.push_back(b);
+    }
+    free(data);
+
+    rm.fileHandle.collectCounterValues(readPageCount, writePageCount, appendPageCount);
+    return readPageCount - readPageCountBefore;
+}
+
+RC testCase_17() {
+    // Functions tested
+    // 1. IndexScan fetching its tuples in batches sorted by heap page
+    // 2. Same tuples in the same order as the single tuple IndexScan **
+    // 3. Fewer heap page reads for a range with thousands of matches
+    std::cerr << std::endl << "***** In QE Test Case 17 *****" << std::endl;
+
+    RC rc = success;
+    auto *plainScan = new IndexScan(rm, shuffledTableName, "B");
+    auto *batchedScan = new IndexScan(rm, shuffledTableName, "B", NULL, 1024);
+
+    const int low = 1000, high = 8999;
+    std::vector<int> plainValues, batchedValues;
+    bool valid = true;
+    unsigned plainReads = scanRange(plainScan, low, high, plainValues, valid);
+    unsigned batchedReads = scanRange(batchedScan, low, high, batchedValues, valid);
+    std::cerr << "Heap page reads, single tuple: " << plainReads << ", batched: " << batchedReads << std::endl;
+
+    if (!valid || plainValues != batchedValues || (int) batchedValues.size() != high - low + 1) {
+        std::cerr << "***** The batched index scan returned wrong tuples. *****" << std::endl;
+        rc = fail;
+    }
+    for (unsigned i = 0; i < batchedValues.size(); i++) {
+        if (batchedValues[i] != low + (int) i) rc = fail;
+    }
+    if (batchedReads * 4 > plainReads) {
+        std::cerr << "***** The batched index scan did not save heap page reads. *****" << std::endl;
+        rc = fail;
+    }
+
+    // A range smaller than a batch, then one ending exactly on a batch boundary.
+    batchedValues.clear();
+    scanRange(batchedScan, 5, 9, batchedValues, valid);
+    if (batchedValues.size() != 5) rc = fail;
+    batchedValues.clear();
+    scanRange(batchedScan, 0, 2047, batchedValues, valid);
+    if (batchedValues.size() != 2048 || !valid) rc = fail;
+
+    delete plainScan;
+    delete batchedScan;
+    return rc;
+}
+
+int main() {
+    // Tables created: largeshuffled
+    // Indexes created: largeshuffled.B
+    rm.deleteTable(shuffledTableName);
+    if (createShuffledTable() != success) {
+        std::cerr << "***** createShuffledTable() failed." << std::endl;
+        std::cerr << "***** [FAIL] QE Test Case 17 failed. *****" << std::endl;
+        return fail;
+    }
+
+    RC rc = testCase_17();
+    rm.deleteTable(shuffledTableName);
+    if (rc != success) {
+        std::cerr << "***** [FAIL] QE Test Case 17 failed. *****" << std::endl;
+        return fail;
+    } else {
+        std::cerr << "***** QE Test Case 17 finished. The result will be examined. *****" << std::endl;
+        return success;
+    }
+}
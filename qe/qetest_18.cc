@@ -0,0 +1,191 @@
+#include "qe_test_util.h"
+
+const std::string coveredTableName = "largecovered";
+const int coveredTupleCount = 10000;
+RID lastRid;
+
+// C is NULL for every tenth tuple, the first half is inserted before the index is created.
+RC insertCoveredTuples(const std::vector<Attribute> &attrs, int first, int last) {
+    void *buf = malloc(bufSize);
+    RC rc = success;
+    for (int i = first; i < last && rc == success; i++) {
+        unsigned char nullsIndicator = i % 10 == 0 ? 0x20 : 0;
+        int b = (int) (((long long) i * 7919) % coveredTupleCount);
+        prepareLeftTuple(attrs.size(), &nullsIndicator, i, b, (float) b / 4, buf);
+        rc = rm.insertTuple(coveredTableName, buf, lastRid);
+    }
+    free(buf);
+    return rc;
+}
+
+int createCoveredTable() {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "A";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    attr.name = "B";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    attr.name = "C";
+    attr.type = TypeReal;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    RC rc = rm.createTable(coveredTableName, attrs);
+    if (rc != success) return rc;
+
+    rc = insertCoveredTuples(attrs, 0, coveredTupleCount / 2);
+    if (rc != success) return rc;
+
+    // An INCLUDE column must be another column of the table.
+    if (rm.createIndex(coveredTableName, "B", std::vector<std::string>(1, "B")) == success) return fail;
+    if (rm.createIndex(coveredTableName, "B", std::vector<std::string>(1, "D")) == success) return fail;
+
+    rc = rm.createIndex(coveredTableName, "B", std::vector<std::string>(1, "C"));
+    if (rc != success) return rc;
+
+    return insertCoveredTuples(attrs, coveredTupleCount / 2, coveredTupleCount);
+}
+
+unsigned getHeapReadCount() {
+    unsigned readPageCount = 0, writePageCount = 0, appendPageCount = 0;
+    rm.fileHandle.collectCounterValues(readPageCount, writePageCount, appendPageCount);
+    return readPageCount;
+}
+
+// SELECT B, C FROM largecovered WHERE B >= low AND C < 1000, in index order.
+void runProjection(IndexScan *scan, int low, std::vector<std::pair<int, float> > &rows) {
+    scan->setIterator(&low, NULL, true, true);
+
+    Condition cond;
+    cond.lhsAttr = coveredTableName + ".C";
+    cond.op = LT_OP;
+    cond.bRhsIsAttr = false;
+    float value = 1000;
+    cond.rhsValue.type = TypeReal;
+    cond.rhsValue.data = &value;
+    auto *filter = new Filter(scan, cond);
+
+    std::vector<std::string> attrNames;
+    attrNames.push_back(coveredTableName + ".B");
+    attrNames.push_back(coveredTableName + ".C");
+    auto *project = new Project(filter, attrNames);
+
+    void *data = malloc(bufSize);
+    while (project->getNextTuple(data) != QE_EOF) {
+        int b = *(int *) ((char *) data + 1);
+        float c = *(float *) ((char *) data + 1 + sizeof(int));
+        rows.push_back(std::make_pair(b, c));
+    }
+    free(data);
+    delete project;
+    delete filter;
+}
+
+// SELECT SUM(C) FROM largecovered, NULL values are skipped.
+float runSum(IndexScan *scan) {
+    scan->setIterator(NULL, NULL, true, true);
+
+    Attribute aggAttr;
+    aggAttr.name = coveredTableName + ".C";
+    aggAttr.type = TypeReal;
+    aggAttr.length = 4;
+    auto *agg = new Aggregate(scan, aggAttr, SUM);
+
+    float sum = -1;
+    void *data = malloc(bufSize);
+    if (agg->getNextTuple(data) != QE_EOF) {
+        sum = *(float *) ((char *) data + 1);
+    }
+    free(data);
+    delete agg;
+    return sum;
+}
+
+RC testCase_18() {
+    // Functions tested
+    // 1. Covering index with an INCLUDE column, built from the heap and maintained by insertTuple
+    // 2. IndexScan + Filter + Project answered from the index alone **
+    // 3. IndexScan + Aggregate answered from the index alone **
+    // 4. The plans return the same rows as the ones reading the heap
+    std::cerr << std::endl << "***** In QE Test Case 18 *****" << std::endl;
+
+    RC rc = success;
+    auto *heapScan = new IndexScan(rm, coveredTableName, "B");
+    auto *coveredScan = new IndexScan(rm, coveredTableName, "B");
+
+    // A is not covered by the index.
+    std::vector<std::string> referenced;
+    referenced.push_back(coveredTableName + ".A");
+    referenced.push_back(coveredTableName + ".B");
+    if (coveredScan->useIndexOnly(referenced)) rc = fail;
+    referenced.erase(referenced.begin());
+    referenced.push_back("C");
+    if (!coveredScan->useIndexOnly(referenced)) rc = fail;
+
+    std::vector<std::pair<int, float> > heapRows, coveredRows;
+    runProjection(heapScan, 2000, heapRows);
+
+    // The heap file handle of the relation manager points to the table from here on.
+    void *data = malloc(bufSize);
+    rm.readTuple(coveredTableName, lastRid, data);
+    free(data);
+    unsigned readsBefore = getHeapReadCount();
+    runProjection(coveredScan, 2000, coveredRows);
+    float coveredSum = runSum(coveredScan);
+    unsigned coveredReads = getHeapReadCount() - readsBefore;
+    float heapSum = runSum(heapScan);
+
+    std::cerr << "Rows: " << coveredRows.size() << ", sum: " << coveredSum << ", heap page reads: " << coveredReads
+              << std::endl;
+    // B = 2000..3999 with C = B / 4 < 1000, less the NULL values of C
+    if (coveredRows != heapRows || coveredRows.size() != 1800) {
+        std::cerr << "***** The index-only plan returned wrong tuples. *****" << std::endl;
+        rc = fail;
+    }
+    for (unsigned i = 1; i < coveredRows.size(); i++) {
+        if (coveredRows[i].first <= coveredRows[i - 1].first) rc = fail;
+        if (coveredRows[i].second != (float) coveredRows[i].first / 4) rc = fail;
+    }
+    if (coveredSum != heapSum) {
+        std::cerr << "***** The index-only aggregate returned " << coveredSum << " instead of " << heapSum
+                  << ". *****" << std::endl;
+        rc = fail;
+    }
+    if (coveredReads != 0) {
+        std::cerr << "***** The index-only plans read the heap file. *****" << std::endl;
+        rc = fail;
+    }
+
+    delete heapScan;
+    delete coveredScan;
+    return rc;
+}
+
+int main() {
+    // Tables created: largecovered
+    // Indexes created: largecovered.B INCLUDE (C)
+    rm.destroyIndex(coveredTableName, "B");
+    rm.deleteTable(coveredTableName);
+    if (createCoveredTable() != success) {
+        std::cerr << "***** createCoveredTable() failed." << std::endl;
+        std::cerr << "***** [FAIL] QE Test Case 18 failed. *****" << std::endl;
+        return fail;
+    }
+
+    RC rc = testCase_18();
+    rm.destroyIndex(coveredTableName, "B");
+    rm.deleteTable(coveredTableName);
+    if (rc != success) {
+        std::cerr << "***** [FAIL] QE Test Case 18 failed. *****" << std::endl;
+        return fail;
+    } else {
+        std::cerr << "***** QE Test Case 18 finished. The result will be examined. *****" << std::endl;
+        return success;
+    }
+}
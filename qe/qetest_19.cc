@@ -0,0 +1,310 @@
+#include "qe_test_util.h"
+
+const std::string compositeTableName = "largecomposite";
+const std::string keysTableName = "largecompositekeys";
+const int compositeTupleCount = 6000;
+const int groupCount = 50;
+
+std::vector<std::string> getKeyAttrNames() {
+    std::vector<std::string> keyAttrNames;
+    keyAttrNames.push_back("name");
+    keyAttrNames.push_back("score");
+    return keyAttrNames;
+}
+
+std::string getGroupName(int group) {
+    char name[16];
+    sprintf(name, "grp%02d", group);
+    return name;
+}
+
+// Writes [name][score] with name = grpNN for i % groupCount, score is NULL for every 97th tuple.
+void prepareCompositeTuple(int i, void *buf, std::string &name, int &score, bool &isNull) {
+    name = getGroupName(i % groupCount);
+    score = (int) (((long long) i * 7919) % compositeTupleCount) - compositeTupleCount / 2;
+    isNull = i % 97 == 0;
+
+    unsigned char nullsIndicator = isNull ? 0x40 : 0;
+    int offset = 0;
+    memcpy((char *) buf + offset, &nullsIndicator, 1);
+    offset += 1;
+    int len = name.size();
+    memcpy((char *) buf + offset, &len, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buf + offset, name.c_str(), len);
+    offset += len;
+    if (!isNull) memcpy((char *) buf + offset, &score, sizeof(int));
+}
+
+RC insertCompositeTuples(int first, int last) {
+    void *buf = malloc(bufSize);
+    std::string name;
+    int score;
+    bool isNull;
+    RID rid;
+    RC rc = success;
+    for (int i = first; i < last && rc == success; i++) {
+        prepareCompositeTuple(i, buf, name, score, isNull);
+        rc = rm.insertTuple(compositeTableName, buf, rid);
+    }
+    free(buf);
+    return rc;
+}
+
+int createCompositeTables() {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "name";
+    attr.type = TypeVarChar;
+    attr.length = 30;
+    attrs.push_back(attr);
+
+    attr.name = "score";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    RC rc = rm.createTable(compositeTableName, attrs);
+    if (rc != success) return rc;
+
+    // The first half is bulk loaded when the index is created, the rest goes through insertTuple.
+    rc = insertCompositeTuples(0, compositeTupleCount / 2);
+    if (rc != success) return rc;
+
+    std::vector<std::string> keyAttrNames = getKeyAttrNames();
+    std::vector<std::string> badAttrNames(2, "name");
+    if (rm.createCompositeIndex(compositeTableName, badAttrNames) == success) return fail;
+    badAttrNames[1] = "weight";
+    if (rm.createCompositeIndex(compositeTableName, badAttrNames) == success) return fail;
+
+    rc = rm.createCompositeIndex(compositeTableName, keyAttrNames);
+    if (rc != success) return rc;
+
+    rc = insertCompositeTuples(compositeTupleCount / 2, compositeTupleCount);
+    if (rc != success) return rc;
+
+    // Outer table of the join, grp99 has no match.
+    attrs.pop_back();
+    rc = rm.createTable(keysTableName, attrs);
+    if (rc != success) return rc;
+
+    void *buf = malloc(bufSize);
+    RID rid;
+    const int groups[] = {3, 41, 99, 17};
+    for (int group : groups) {
+        std::string name = getGroupName(group);
+        int len = name.size();
+        memset(buf, 0, 1);
+        memcpy((char *) buf + 1, &len, sizeof(int));
+        memcpy((char *) buf + 1 + sizeof(int), name.c_str(), len);
+        rc = rm.insertTuple(keysTableName, buf, rid);
+        if (rc != success) break;
+    }
+    free(buf);
+    return rc;
+}
+
+// Reads [name][score] of a tuple, the score of a NULL is INT_MIN so that it sorts first.
+std::pair<std::string, int> readCompositeKey(const void *data) {
+    unsigned char nullsIndicator = *(unsigned char *) data;
+    int len = 0;
+    memcpy(&len, (char *) data + 1, sizeof(int));
+    std::string name((char *) data + 1 + sizeof(int), len);
+    int score = INT_MIN;
+    if (!(nullsIndicator & 0x40)) memcpy(&score, (char *) data + 1 + sizeof(int) + len, sizeof(int));
+    return std::make_pair(name, score);
+}
+
+// Runs a prefix scan through the relation manager and returns the keys of the tuples in index order.
+void scanComposite(const void *lowKey, const void *highKey, unsigned prefixColumns, bool lowKeyInclusive,
+                   bool highKeyInclusive, std::vector<std::pair<std::string, int> > &keys) {
+    RM_IndexScanIterator rmisi;
+    RC rc = rm.compositeIndexScan(compositeTableName, getKeyAttrNames(), lowKey, highKey, prefixColumns,
+                                  lowKeyInclusive, highKeyInclusive, rmisi);
+    assert(rc == success && "RelationManager::compositeIndexScan() should not fail.");
+
+    RID rid;
+    char key[PAGE_SIZE];
+    void *data = malloc(bufSize);
+    while (rmisi.getNextEntry(rid, key) == success) {
+        rc = rm.readTuple(compositeTableName, rid, data);
+        assert(rc == success && "RelationManager::readTuple() should not fail.");
+        keys.push_back(readCompositeKey(data));
+    }
+    free(data);
+    rmisi.close();
+}
+
+// Same rows computed from the generator, sorted.
+void expectedKeys(bool (*match)(const std::string &, int), std::vector<std::pair<std::string, int> > &keys) {
+    std::string name;
+    int score;
+    bool isNull;
+    void *buf = malloc(bufSize);
+    for (int i = 0; i < compositeTupleCount; i++) {
+        prepareCompositeTuple(i, buf, name, score, isNull);
+        if (isNull) score = INT_MIN;
+        if (match(name, score)) keys.push_back(std::make_pair(name, score));
+    }
+    free(buf);
+    std::sort(keys.begin(), keys.end());
+}
+
+bool matchAll(const std::string &, int) { return true; }
+
+bool matchGroup7(const std::string &name, int) { return name == "grp07"; }
+
+bool matchGroup7Range(const std::string &name, int score) {
+    return name == "grp07" && score >= -500 && score < 500;
+}
+
+bool matchGroup8To9(const std::string &name, int) { return name == "grp08" || name == "grp09"; }
+
+// Writes the VarChar value of a bound and returns its length.
+int prepareNameBound(const std::string &name, void *buf) {
+    int len = name.size();
+    memcpy(buf, &len, sizeof(int));
+    memcpy((char *) buf + sizeof(int), name.c_str(), len);
+    return sizeof(int) + len;
+}
+
+RC checkScan(const std::string &what, const void *lowKey, const void *highKey, unsigned prefixColumns,
+             bool lowKeyInclusive, bool highKeyInclusive, bool (*match)(const std::string &, int)) {
+    std::vector<std::pair<std::string, int> > keys, expected;
+    scanComposite(lowKey, highKey, prefixColumns, lowKeyInclusive, highKeyInclusive, keys);
+    expectedKeys(match, expected);
+    std::cerr << what << ": " << keys.size() << " tuples" << std::endl;
+    if (keys != expected) {
+        std::cerr << "***** " << what << " returned " << keys.size() << " tuples instead of " << expected.size()
+                  << " or out of order. *****" << std::endl;
+        return fail;
+    }
+    return success;
+}
+
+RC testCase_19() {
+    // Functions tested
+    // 1. Composite index on (VarChar, Int), built from the heap and maintained by insertTuple
+    // 2. Full scan ordered by name, then score, NULL first **
+    // 3. Equality and range on the leading column, equality and range on both columns **
+    // 4. IndexScan over the composite index and INLJoin on its leading column
+    // 5. -0.0 and 0.0 have the same encoded key
+    std::cerr << std::endl << "***** In QE Test Case 19 *****" << std::endl;
+
+    RC rc = success;
+    char low[PAGE_SIZE], high[PAGE_SIZE];
+
+    if (checkScan("Full scan", NULL, NULL, 0, true, true, matchAll) != success) rc = fail;
+
+    // -0.0 and 0.0 are the same Real key
+    std::vector<Attribute> realAttrs(1);
+    realAttrs[0].name = "real";
+    realAttrs[0].type = TypeReal;
+    realAttrs[0].length = 4;
+    float zero = 0, negativeZero = -zero;
+    char zeroTuple[1 + sizeof(float)] = {0}, negativeZeroTuple[1 + sizeof(float)] = {0};
+    memcpy(zeroTuple + 1, &zero, sizeof(float));
+    memcpy(negativeZeroTuple + 1, &negativeZero, sizeof(float));
+    int zeroLength = im.encodeCompositeKey(realAttrs, zeroTuple, low);
+    if (im.encodeCompositeKey(realAttrs, negativeZeroTuple, high) != zeroLength || memcmp(low, high, zeroLength) != 0) {
+        std::cerr << "***** -0.0 and 0.0 are encoded differently. *****" << std::endl;
+        rc = fail;
+    }
+
+    prepareNameBound("grp07", low);
+    if (checkScan("name = grp07", low, low, 1, true, true, matchGroup7) != success) rc = fail;
+
+    int lowLen = prepareNameBound("grp07", low), highLen = prepareNameBound("grp07", high);
+    int lowScore = -500, highScore = 500;
+    memcpy(low + lowLen, &lowScore, sizeof(int));
+    memcpy(high + highLen, &highScore, sizeof(int));
+    if (checkScan("name = grp07 and -500 <= score < 500", low, high, 2, true, false, matchGroup7Range) != success)
+        rc = fail;
+
+    prepareNameBound("grp07", low);
+    prepareNameBound("grp09", high);
+    if (checkScan("grp07 < name <= grp09", low, high, 1, false, true, matchGroup8To9) != success) rc = fail;
+
+    // IndexScan with a bound on both columns.
+    auto *scan = new IndexScan(rm, compositeTableName, getKeyAttrNames());
+    lowLen = prepareNameBound("grp07", low);
+    highLen = prepareNameBound("grp07", high);
+    memcpy(low + lowLen, &lowScore, sizeof(int));
+    memcpy(high + highLen, &highScore, sizeof(int));
+    scan->setIterator(low, high, 2, true, false);
+    std::vector<std::pair<std::string, int> > keys, expected;
+    void *data = malloc(bufSize);
+    while (scan->getNextTuple(data) != QE_EOF) keys.push_back(readCompositeKey(data));
+    expectedKeys(matchGroup7Range, expected);
+    if (keys != expected) {
+        std::cerr << "***** IndexScan returned wrong tuples. *****" << std::endl;
+        rc = fail;
+    }
+
+    // SELECT * FROM largecompositekeys, largecomposite WHERE largecompositekeys.name = largecomposite.name
+    auto *keysScan = new TableScan(rm, keysTableName);
+    Condition cond;
+    cond.lhsAttr = keysTableName + ".name";
+    cond.op = EQ_OP;
+    cond.bRhsIsAttr = true;
+    cond.rhsAttr = compositeTableName + ".name";
+    auto *join = new INLJoin(keysScan, scan, cond);
+
+    int joined = 0;
+    std::pair<std::string, int> prev;
+    while (join->getNextTuple(data) == success) {
+        int len = 0;
+        memcpy(&len, (char *) data + 1, sizeof(int));
+        std::string outerName((char *) data + 1 + sizeof(int), len);
+        // the right tuple follows the outer name, its score is the third column
+        std::pair<std::string, int> key;
+        int offset = 1 + sizeof(int) + len;
+        memcpy(&len, (char *) data + offset, sizeof(int));
+        key.first = std::string((char *) data + offset + sizeof(int), len);
+        key.second = INT_MIN;
+        offset += sizeof(int) + len;
+        if (!(*(unsigned char *) data & 0x20)) memcpy(&key.second, (char *) data + offset, sizeof(int));
+        if (key.first != outerName || (joined % (compositeTupleCount / groupCount) != 0 && key < prev)) rc = fail;
+        prev = key;
+        joined++;
+    }
+    std::cerr << "Joined tuples: " << joined << std::endl;
+    if (joined != 3 * compositeTupleCount / groupCount) {
+        std::cerr << "***** INLJoin returned " << joined << " tuples. *****" << std::endl;
+        rc = fail;
+    }
+
+    free(data);
+    delete join;
+    delete keysScan;
+    delete scan;
+    return rc;
+}
+
+void cleanUp() {
+    rm.destroyCompositeIndex(compositeTableName, getKeyAttrNames());
+    rm.deleteTable(compositeTableName);
+    rm.deleteTable(keysTableName);
+}
+
+int main() {
+    // Tables created: largecomposite, largecompositekeys
+    // Indexes created: largecomposite.(name, score)
+    cleanUp();
+    if (createCompositeTables() != success) {
+        std::cerr << "***** createCompositeTables() failed." << std::endl;
+        std::cerr << "***** [FAIL] QE Test Case 19 failed. *****" << std::endl;
+        cleanUp();
+        return fail;
+    }
+
+    RC rc = testCase_19();
+    cleanUp();
+    if (rc != success) {
+        std::cerr << "***** [FAIL] QE Test Case 19 failed. *****" << std::endl;
+        return fail;
+    } else {
+        std::cerr << "***** QE Test Case 19 finished. The result will be examined. *****" << std::endl;
+        return success;
+    }
+}
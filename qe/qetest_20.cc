@@ -0,0 +1,163 @@
+#include "qe_test_util.h"
+
+const std::string hashTableName = "largehash";
+const std::string keysTableName = "largehashkeys";
+const int hashTupleCount = 4000;
+const int hashKeyCount = 500;
+
+// Writes [k][v] with k = i % hashKeyCount and v = i.
+void prepareHashTuple(int i, void *buf) {
+    int k = i % hashKeyCount;
+    memset(buf, 0, 1);
+    memcpy((char *) buf + 1, &k, sizeof(int));
+    memcpy((char *) buf + 1 + sizeof(int), &i, sizeof(int));
+}
+
+RC insertHashTuples(int first, int last) {
+    void *buf = malloc(bufSize);
+    RID rid;
+    RC rc = success;
+    for (int i = first; i < last && rc == success; i++) {
+        prepareHashTuple(i, buf);
+        rc = rm.insertTuple(hashTableName, buf, rid);
+    }
+    free(buf);
+    return rc;
+}
+
+int createHashTables() {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "k";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    attr.name = "v";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    RC rc = rm.createTable(hashTableName, attrs);
+    if (rc != success) return rc;
+
+    // The first half is inserted when the index is created, the rest goes through insertTuple.
+    rc = insertHashTuples(0, hashTupleCount / 2);
+    if (rc != success) return rc;
+
+    std::vector<std::string> includeAttrs(1, "v");
+    if (rm.createIndex(hashTableName, "k", includeAttrs, BULK_LOAD_FILL_FACTOR, HASH_INDEX) == success) return fail;
+
+    rc = rm.createIndex(hashTableName, "k", HASH_INDEX);
+    if (rc != success) return rc;
+
+    rc = insertHashTuples(hashTupleCount / 2, hashTupleCount);
+    if (rc != success) return rc;
+
+    // Outer table of the join, the key hashKeyCount has no match.
+    attrs.pop_back();
+    rc = rm.createTable(keysTableName, attrs);
+    if (rc != success) return rc;
+
+    void *buf = malloc(bufSize);
+    RID rid;
+    const int keys[] = {7, hashKeyCount - 1, hashKeyCount, 123};
+    for (int k : keys) {
+        memset(buf, 0, 1);
+        memcpy((char *) buf + 1, &k, sizeof(int));
+        rc = rm.insertTuple(keysTableName, buf, rid);
+        if (rc != success) break;
+    }
+    free(buf);
+    return rc;
+}
+
+RC testCase_20() {
+    // Functions tested
+    // 1. Hash index created by createIndex(), filled from the heap and maintained by insertTuple
+    // 2. IndexScan with an equality returns the tuples of its key **
+    // 3. INLJoin probing the hash index **
+    std::cerr << std::endl << "***** In QE Test Case 20 *****" << std::endl;
+
+    RC rc = success;
+    void *data = malloc(bufSize);
+    auto *scan = new IndexScan(rm, hashTableName, "k");
+
+    // SELECT * FROM largehash WHERE k = 42
+    int key = 42;
+    scan->setIterator(&key, &key, true, true);
+    std::vector<int> values;
+    while (scan->getNextTuple(data) != QE_EOF) {
+        int k = 0, v = 0;
+        memcpy(&k, (char *) data + 1, sizeof(int));
+        memcpy(&v, (char *) data + 1 + sizeof(int), sizeof(int));
+        if (k != key) rc = fail;
+        values.push_back(v);
+    }
+    std::sort(values.begin(), values.end());
+    std::vector<int> expected;
+    for (int i = key; i < hashTupleCount; i += hashKeyCount) expected.push_back(i);
+    std::cerr << "k = 42: " << values.size() << " tuples" << std::endl;
+    if (values != expected) {
+        std::cerr << "***** IndexScan returned wrong tuples. *****" << std::endl;
+        rc = fail;
+    }
+
+    // SELECT * FROM largehashkeys, largehash WHERE largehashkeys.k = largehash.k
+    auto *keysScan = new TableScan(rm, keysTableName);
+    Condition cond;
+    cond.lhsAttr = keysTableName + ".k";
+    cond.op = EQ_OP;
+    cond.bRhsIsAttr = true;
+    cond.rhsAttr = hashTableName + ".k";
+    auto *join = new INLJoin(keysScan, scan, cond);
+
+    int joined = 0;
+    while (join->getNextTuple(data) == success) {
+        int outerKey = 0, k = 0, v = 0;
+        memcpy(&outerKey, (char *) data + 1, sizeof(int));
+        memcpy(&k, (char *) data + 1 + sizeof(int), sizeof(int));
+        memcpy(&v, (char *) data + 1 + 2 * sizeof(int), sizeof(int));
+        if (k != outerKey || v % hashKeyCount != k) rc = fail;
+        joined++;
+    }
+    std::cerr << "Joined tuples: " << joined << std::endl;
+    if (joined != 3 * hashTupleCount / hashKeyCount) {
+        std::cerr << "***** INLJoin returned " << joined << " tuples. *****" << std::endl;
+        rc = fail;
+    }
+
+    free(data);
+    delete join;
+    delete keysScan;
+    delete scan;
+    return rc;
+}
+
+void cleanUp() {
+    rm.destroyIndex(hashTableName, "k");
+    rm.deleteTable(hashTableName);
+    rm.deleteTable(keysTableName);
+}
+
+int main() {
+    // Tables created: largehash, largehashkeys
+    // Indexes created: largehash.k (hash)
+    cleanUp();
+    if (createHashTables() != success) {
+        std::cerr << "***** createHashTables() failed." << std::endl;
+        std::cerr << "***** [FAIL] QE Test Case 20 failed. *****" << std::endl;
+        cleanUp();
+        return fail;
+    }
+
+    RC rc = testCase_20();
+    cleanUp();
+    if (rc != success) {
+        std::cerr << "***** [FAIL] QE Test Case 20 failed. *****" << std::endl;
+        return fail;
+    } else {
+        std::cerr << "***** QE Test Case 20 finished. The result will be examined. *****" << std::endl;
+        return success;
+    }
+}
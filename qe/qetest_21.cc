@@ -0,0 +1,185 @@
+#include "qe_test_util.h"
+
+const std::string outerTableName = "filterouter";
+const std::string innerTableName = "filterinner";
+const int outerTupleCount = 3000;
+const int innerTupleCount = 1000;
+
+// Writes [k][v], NULL k when nullKey is set.
+void prepareKeyTuple(int k, int v, bool nullKey, void *buf) {
+    unsigned char nullsIndicator = nullKey ? 0x80 : 0;
+    memcpy(buf, &nullsIndicator, 1);
+    int offset = 1;
+    if (!nullKey) {
+        memcpy((char *) buf + offset, &k, sizeof(int));
+        offset += sizeof(int);
+    }
+    memcpy((char *) buf + offset, &v, sizeof(int));
+}
+
+// Inserts the inner tuples of [first, last), tuple i has the key 3 * i.
+RC insertInnerTuples(int first, int last) {
+    void *buf = malloc(bufSize);
+    RID rid;
+    RC rc = success;
+    for (int i = first; i < last && rc == success; i++) {
+        prepareKeyTuple(3 * i, i, false, buf);
+        rc = rm.insertTuple(innerTableName, buf, rid);
+    }
+    free(buf);
+    return rc;
+}
+
+int createKeyTables() {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "k";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    attr.name = "v";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    RC rc = rm.createTable(outerTableName, attrs);
+    if (rc != success) return rc;
+    rc = rm.createTable(innerTableName, attrs);
+    if (rc != success) return rc;
+
+    // Every outer key up to outerTupleCount, a tenth of the tuples have a NULL key.
+    void *buf = malloc(bufSize);
+    RID rid;
+    for (int i = 0; i < outerTupleCount && rc == success; i++) {
+        prepareKeyTuple(i, i, i % 10 == 5, buf);
+        rc = rm.insertTuple(outerTableName, buf, rid);
+    }
+    free(buf);
+    if (rc != success) return rc;
+
+    // Half of the inner keys, the others are inserted once the index keeps its key filter.
+    rc = insertInnerTuples(0, innerTupleCount / 2);
+    if (rc != success) return rc;
+    return rm.createIndex(innerTableName, "k");
+}
+
+// Number of outer keys in [0, last) matching an inner key 3 * i for i < innerCount.
+int getExpectedMatches(int last, int innerCount) {
+    int matches = 0;
+    for (int k = 0; k < last; k++) {
+        if (k % 10 != 5 && k % 3 == 0 && k / 3 < innerCount) matches++;
+    }
+    return matches;
+}
+
+// Counts the joined tuples, checks that the keys of both sides are equal. The outer side is at outerFirst.
+int countJoined(Iterator *join, bool outerFirst, RC &rc) {
+    void *data = malloc(bufSize);
+    int joined = 0;
+    while (join->getNextTuple(data) == success) {
+        int outerKey = 0, outerValue = 0, innerKey = 0, innerValue = 0;
+        char *outer = (char *) data + 1 + (outerFirst ? 0 : 2 * sizeof(int));
+        char *inner = (char *) data + 1 + (outerFirst ? 2 * sizeof(int) : 0);
+        memcpy(&outerKey, outer, sizeof(int));
+        memcpy(&outerValue, outer + sizeof(int), sizeof(int));
+        memcpy(&innerKey, inner, sizeof(int));
+        memcpy(&innerValue, inner + sizeof(int), sizeof(int));
+        if (outerKey != innerKey || outerValue != outerKey || innerKey != 3 * innerValue) rc = fail;
+        joined++;
+    }
+    free(data);
+    return joined;
+}
+
+RC testCase_21() {
+    // Functions tested
+    // 1. INLJoin does not probe the index for outer keys ruled out by its key filter **
+    // 2. GHJoin drops the probe tuples ruled out by the filter of the build keys **
+    // 3. Tuples inserted after the filter was kept in the index are still joined
+    std::cerr << std::endl << "***** In QE Test Case 21 *****" << std::endl;
+
+    RC rc = success;
+    Condition cond;
+    cond.lhsAttr = outerTableName + ".k";
+    cond.op = EQ_OP;
+    cond.bRhsIsAttr = true;
+    cond.rhsAttr = innerTableName + ".k";
+
+    // SELECT * FROM filterouter, filterinner WHERE filterouter.k = filterinner.k
+    auto *outerScan = new TableScan(rm, outerTableName);
+    auto *innerScan = new IndexScan(rm, innerTableName, "k");
+    auto *inlJoin = new INLJoin(outerScan, innerScan, cond);
+    int joined = countJoined(inlJoin, true, rc);
+    int misses = outerTupleCount * 9 / 10 - joined;
+    std::cerr << "INLJoin: " << joined << " tuples, " << inlJoin->getSkippedProbes() << " of "
+              << misses << " probes without a match skipped" << std::endl;
+    if (joined != getExpectedMatches(outerTupleCount, innerTupleCount / 2) ||
+        inlJoin->getSkippedProbes() < (unsigned) misses * 95 / 100) {
+        rc = fail;
+    }
+    delete inlJoin;
+    delete innerScan;
+    delete outerScan;
+
+    // SELECT * FROM filterinner, filterouter WHERE filterinner.k = filterouter.k, the inner side is built
+    Condition ghCond = cond;
+    ghCond.lhsAttr = innerTableName + ".k";
+    ghCond.rhsAttr = outerTableName + ".k";
+    auto *innerTableScan = new TableScan(rm, innerTableName);
+    outerScan = new TableScan(rm, outerTableName);
+    auto *ghJoin = new GHJoin(innerTableScan, outerScan, ghCond, 5);
+    joined = countJoined(ghJoin, false, rc);
+    std::cerr << "GHJoin: " << joined << " tuples, " << ghJoin->getDroppedTuples() << " of "
+              << misses << " probe tuples without a match dropped" << std::endl;
+    if (joined != getExpectedMatches(outerTupleCount, innerTupleCount / 2) ||
+        ghJoin->getDroppedTuples() < (unsigned) misses * 95 / 100) {
+        rc = fail;
+    }
+    delete ghJoin;
+    delete outerScan;
+    delete innerTableScan;
+
+    // The inserts reach the keys of the filter kept by the index.
+    if (insertInnerTuples(innerTupleCount / 2, innerTupleCount) != success) rc = fail;
+    outerScan = new TableScan(rm, outerTableName);
+    innerScan = new IndexScan(rm, innerTableName, "k");
+    inlJoin = new INLJoin(outerScan, innerScan, cond);
+    joined = countJoined(inlJoin, true, rc);
+    std::cerr << "INLJoin after the inserts: " << joined << " tuples" << std::endl;
+    if (joined != getExpectedMatches(outerTupleCount, innerTupleCount)) rc = fail;
+    delete inlJoin;
+    delete innerScan;
+    delete outerScan;
+
+    if (rc != success) std::cerr << "***** A join returned wrong tuples or probed every key. *****" << std::endl;
+    return rc;
+}
+
+void cleanUp() {
+    rm.destroyIndex(innerTableName, "k");
+    rm.deleteTable(innerTableName);
+    rm.deleteTable(outerTableName);
+}
+
+int main() {
+    // Tables created: filterouter, filterinner
+    // Indexes created: filterinner.k
+    cleanUp();
+    if (createKeyTables() != success) {
+        std::cerr << "***** createKeyTables() failed." << std::endl;
+        std::cerr << "***** [FAIL] QE Test Case 21 failed. *****" << std::endl;
+        cleanUp();
+        return fail;
+    }
+
+    RC rc = testCase_21();
+    cleanUp();
+    if (rc != success) {
+        std::cerr << "***** [FAIL] QE Test Case 21 failed. *****" << std::endl;
+        return fail;
+    } else {
+        std::cerr << "***** QE Test Case 21 finished. The result will be examined. *****" << std::endl;
+        return success;
+    }
+}
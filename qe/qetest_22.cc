@@ -0,0 +1,229 @@
+#include "qe_test_util.h"
+
+const std::string leftTableName = "overflowleft";
+const std::string rightTableName = "overflowright";
+const int overflowTupleCount = 5;
+const int overflowTextLength = 10000;
+const unsigned overflowBufSize = 4 * overflowTextLength;
+
+// Length of the text of row i, two of them go to overflow pages.
+int getTextLength(int i, bool left) {
+    const int leftLengths[overflowTupleCount] = {10, 9000, 300, 5000, 20};
+    const int rightLengths[overflowTupleCount] = {9000, 40, 4500, 7, 300};
+    return left ? leftLengths[i] : rightLengths[i];
+}
+
+std::string getText(int i, bool left) {
+    return std::string(getTextLength(i, left), (char) ((left ? 'a' : 'A') + i));
+}
+
+// Writes [id][text], returns the size of the tuple.
+int prepareOverflowTuple(int id, const std::string &text, void *buf) {
+    unsigned char nullsIndicator = 0;
+    memcpy(buf, &nullsIndicator, 1);
+    int offset = 1;
+    memcpy((char *) buf + offset, &id, sizeof(int));
+    offset += sizeof(int);
+    int length = text.size();
+    memcpy((char *) buf + offset, &length, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buf + offset, text.c_str(), length);
+    return offset + length;
+}
+
+// Reads [id][text] at offset, returns the offset after it.
+int readOverflowTuple(const void *buf, int offset, int &id, std::string &text) {
+    memcpy(&id, (char *) buf + offset, sizeof(int));
+    offset += sizeof(int);
+    int length = 0;
+    memcpy(&length, (char *) buf + offset, sizeof(int));
+    offset += sizeof(int);
+    text.assign((char *) buf + offset, length);
+    return offset + length;
+}
+
+int createOverflowTables() {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "id";
+    attr.type = TypeInt;
+    attr.length = 4;
+    attrs.push_back(attr);
+
+    attr.name = "text";
+    attr.type = TypeVarChar;
+    attr.length = overflowTextLength;
+    attrs.push_back(attr);
+
+    RC rc = rm.createTable(leftTableName, attrs);
+    if (rc != success) return rc;
+    rc = rm.createTable(rightTableName, attrs);
+    if (rc != success) return rc;
+
+    void *buf = malloc(overflowBufSize);
+    RID rid;
+    for (int i = 0; i < overflowTupleCount && rc == success; i++) {
+        prepareOverflowTuple(i, getText(i, true), buf);
+        rc = rm.insertTuple(leftTableName, buf, rid);
+        if (rc != success) break;
+        prepareOverflowTuple(i, getText(i, false), buf);
+        rc = rm.insertTuple(rightTableName, buf, rid);
+    }
+    free(buf);
+    if (rc != success) return rc;
+    return rm.createIndex(rightTableName, "id");
+}
+
+// Checks the joined tuples of leftTableName and rightTableName on id, every id is joined once.
+RC checkJoined(Iterator *join, const std::string &name) {
+    void *data = malloc(overflowBufSize);
+    bool seen[overflowTupleCount] = {false};
+    RC rc = success;
+    int joined = 0;
+    while (join->getNextTuple(data) == success) {
+        int leftId = 0, rightId = 0;
+        std::string leftText, rightText;
+        int offset = readOverflowTuple(data, 1, leftId, leftText);
+        readOverflowTuple(data, offset, rightId, rightText);
+        if (leftId != rightId || leftId < 0 || leftId >= overflowTupleCount || seen[leftId] ||
+            leftText != getText(leftId, true) || rightText != getText(rightId, false)) {
+            std::cerr << name << " returned a wrong tuple for id " << leftId << std::endl;
+            rc = fail;
+            break;
+        }
+        seen[leftId] = true;
+        joined++;
+    }
+    free(data);
+    std::cerr << name << ": " << joined << " tuples" << std::endl;
+    return rc == success && joined == overflowTupleCount ? success : fail;
+}
+
+RC testCase_22() {
+    // Functions tested
+    // 1. Project and Filter over a table with VarChars kept in overflow pages **
+    // 2. BNLJoin, INLJoin and GHJoin of such tables **
+    // 3. Aggregate over such a table
+    std::cerr << std::endl << "***** In QE Test Case 22 *****" << std::endl;
+
+    RC rc = success;
+    void *data = malloc(overflowBufSize);
+
+    // SELECT overflowleft.text, overflowleft.id FROM overflowleft
+    auto *leftScan = new TableScan(rm, leftTableName);
+    std::vector<std::string> attrNames;
+    attrNames.push_back(leftTableName + ".text");
+    attrNames.push_back(leftTableName + ".id");
+    auto *project = new Project(leftScan, attrNames);
+    int projected = 0;
+    while (project->getNextTuple(data) == success) {
+        int length = 0, id = 0;
+        memcpy(&length, (char *) data + 1, sizeof(int));
+        memcpy(&id, (char *) data + 1 + sizeof(int) + length, sizeof(int));
+        if (id < 0 || id >= overflowTupleCount || std::string((char *) data + 1 + sizeof(int), length) != getText(id, true)) {
+            rc = fail;
+        }
+        projected++;
+    }
+    if (projected != overflowTupleCount) rc = fail;
+    delete project;
+    delete leftScan;
+
+    // SELECT * FROM overflowleft WHERE overflowleft.id = 1
+    int filterId = 1;
+    Condition filterCond;
+    filterCond.lhsAttr = leftTableName + ".id";
+    filterCond.op = EQ_OP;
+    filterCond.bRhsIsAttr = false;
+    filterCond.rhsValue.type = TypeInt;
+    filterCond.rhsValue.data = &filterId;
+    leftScan = new TableScan(rm, leftTableName);
+    auto *filter = new Filter(leftScan, filterCond);
+    int filtered = 0;
+    while (filter->getNextTuple(data) == success) {
+        int id = 0;
+        std::string text;
+        readOverflowTuple(data, 1, id, text);
+        if (id != filterId || text != getText(filterId, true)) rc = fail;
+        filtered++;
+    }
+    if (filtered != 1) rc = fail;
+    delete filter;
+    delete leftScan;
+
+    // SELECT MAX(overflowleft.id) FROM overflowleft
+    leftScan = new TableScan(rm, leftTableName);
+    Attribute aggAttr;
+    aggAttr.name = leftTableName + ".id";
+    aggAttr.type = TypeInt;
+    aggAttr.length = 4;
+    auto *aggregate = new Aggregate(leftScan, aggAttr, MAX);
+    float maxId = -1;
+    if (aggregate->getNextTuple(data) == success) memcpy(&maxId, (char *) data + 1, sizeof(float));
+    if (maxId != overflowTupleCount - 1) rc = fail;
+    delete aggregate;
+    delete leftScan;
+    free(data);
+
+    // SELECT * FROM overflowleft, overflowright WHERE overflowleft.id = overflowright.id
+    Condition cond;
+    cond.lhsAttr = leftTableName + ".id";
+    cond.op = EQ_OP;
+    cond.bRhsIsAttr = true;
+    cond.rhsAttr = rightTableName + ".id";
+
+    leftScan = new TableScan(rm, leftTableName);
+    auto *rightScan = new TableScan(rm, rightTableName);
+    auto *bnlJoin = new BNLJoin(leftScan, rightScan, cond, 1);
+    if (checkJoined(bnlJoin, "BNLJoin") != success) rc = fail;
+    delete bnlJoin;
+    delete rightScan;
+    delete leftScan;
+
+    leftScan = new TableScan(rm, leftTableName);
+    auto *rightIndexScan = new IndexScan(rm, rightTableName, "id");
+    auto *inlJoin = new INLJoin(leftScan, rightIndexScan, cond);
+    if (checkJoined(inlJoin, "INLJoin") != success) rc = fail;
+    delete inlJoin;
+    delete rightIndexScan;
+    delete leftScan;
+
+    leftScan = new TableScan(rm, leftTableName);
+    rightScan = new TableScan(rm, rightTableName);
+    auto *ghJoin = new GHJoin(leftScan, rightScan, cond, 3);
+    if (checkJoined(ghJoin, "GHJoin") != success) rc = fail;
+    delete ghJoin;
+    delete rightScan;
+    delete leftScan;
+
+    if (rc != success) std::cerr << "***** An operator lost or cut a VarChar kept in overflow pages. *****" << std::endl;
+    return rc;
+}
+
+void cleanUp() {
+    rm.destroyIndex(rightTableName, "id");
+    rm.deleteTable(rightTableName);
+    rm.deleteTable(leftTableName);
+}
+
+int main() {
+    // Tables created: overflowleft, overflowright
+    // Indexes created: overflowright.id
+    cleanUp();
+    if (createOverflowTables() != success) {
+        std::cerr << "***** createOverflowTables() failed." << std::endl;
+        std::cerr << "***** [FAIL] QE Test Case 22 failed. *****" << std::endl;
+        cleanUp();
+        return fail;
+    }
+
+    RC rc = testCase_22();
+    cleanUp();
+    if (rc != success) {
+        std::cerr << "***** [FAIL] QE Test Case 22 failed. *****" << std::endl;
+        return fail;
+    } else {
+        std::cerr << "***** QE Test Case 22 finished. The result will be examined. *****" << std::endl;
+        return success;
+    }
+}
@@ -1,5 +1,60 @@
 #include "pfm.h"
 
+// Guards the cache, index files are read by several threads at once. Lookups share it,
+// the calls changing the cache hold it alone and write pages back through the unlatched helpers.
+static SharedLatch bufferLatch;
+
+/**
+ * lockShared() - take the latch along with other readers.
+ *
+ * Return : void, returns once no writer holds or waits for the latch.
+*/
+void SharedLatch::lockShared() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while(this->writer || this->waitingWriters > 0) {
+        this->released.wait(lock);
+    }
+    this->readers++;
+}
+
+/**
+ * unlockShared() - release the latch taken by lockShared().
+ *
+ * Return : void.
+*/
+void SharedLatch::unlockShared() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if(--this->readers == 0) {
+        this->released.notify_all();
+    }
+}
+
+/**
+ * lock() - take the latch alone.
+ *
+ * Return : void, returns once the readers and the writer holding the latch released it.
+*/
+void SharedLatch::lock() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->waitingWriters++;
+    while(this->writer || this->readers > 0) {
+        this->released.wait(lock);
+    }
+    this->waitingWriters--;
+    this->writer = true;
+}
+
+/**
+ * unlock() - release the latch taken by lock().
+ *
+ * Return : void.
+*/
+void SharedLatch::unlock() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->writer = false;
+    this->released.notify_all();
+}
+
 // Buffer manager singleton.
 BufferManager &BufferManager::instance() {
     static BufferManager _buf_manager = BufferManager();
@@ -21,53 +76,140 @@ BufferManager &BufferManager::operator=(const BufferManager &) = default;
  * Return : 0 on success, -1 page not in cache.
 */
 RC BufferManager::pageInBuffer(const std::string& fileName, const int pageNum, void *data) {
-    if(buffer.find(fileName) != buffer.end()) {
-        if(buffer[fileName].find(pageNum) != buffer[fileName].end()) {
-            memcpy((char*)data, (char*)(buffer[fileName][pageNum]).pageData, PAGE_SIZE);
+    SharedLatchGuard guard(bufferLatch);
+    auto file = buffer.find(fileName);
+    if(file != buffer.end()) {
+        auto page = file->second.find(pageNum);
+        if(page != file->second.end()) {
+            memcpy((char*)data, (char*)page->second.pageData, PAGE_SIZE);
             return 0;
         }
     }
     return -1;
 }
 
+/**
+ * registerFile() - give a file its own page budget in the cache.
+ * @argument1 : name of the file.
+ * @argument2 : number of header pages before page 0 of the file.
+ * @argument3 : maximum number of pages of the file kept in the cache.
+ *
+ * Pages of the other files share MAX_FILES_FOR_CACHE file slots of MAX_CACHE_PAGE_PER_FILE pages.
+ * Return : void.
+*/
+void BufferManager::registerFile(const std::string& fileName, const int hiddenPages, const int maxPages) {
+    std::lock_guard<SharedLatch> guard(bufferLatch);
+    registeredFiles[fileName].hiddenPages = hiddenPages;
+    registeredFiles[fileName].maxPages = maxPages;
+}
+
+/**
+ * dropFile() - discard the cached pages of a file without writing them back.
+ * @argument1 : name of the file, used when the file is destroyed.
+ *
+ * Return : void.
+*/
+void BufferManager::dropFile(const std::string& fileName) {
+    std::lock_guard<SharedLatch> guard(bufferLatch);
+    buffer.erase(fileName);
+    registeredFiles.erase(fileName);
+}
+
+/**
+ * getHiddenPages() - number of header pages before page 0 of a file.
+ * @argument1 : name of the file.
+ *
+ * Return : number of header pages.
+*/
+int BufferManager::getHiddenPages(const std::string& fileName) {
+    auto itr = registeredFiles.find(fileName);
+    if(itr == registeredFiles.end()) return MAX_HIDDEN_PAGES;
+    return itr->second.hiddenPages;
+}
+
+/**
+ * evictPage() - evict one page of a file from the cache, unpinned pages go first.
+ * @argument1 : name of the file.
+ *
+ * Return : 0 on success, -1 if no page of the file is cached.
+*/
+RC BufferManager::evictPage(const std::string& fileName) {
+    auto file = buffer.find(fileName);
+    if(file == buffer.end() || file->second.empty()) return -1;
+
+    auto victim = file->second.begin();
+    for(auto itr = file->second.begin(); itr != file->second.end(); itr++) {
+        if(!itr->second.pinned) {
+            victim = itr;
+            break;
+        }
+    }
+    writePageToDisk(fileName, victim->first, victim->second.pageData, victim->second.dirtyBit);
+    file->second.erase(victim);
+    return 0;
+}
+
+/**
+ * evictSharedFile() - evict all the cached pages of a file using the shared file slots.
+ *
+ * Return : 0 on success, -1 if no such file is cached.
+*/
+RC BufferManager::evictSharedFile() {
+    for(auto itr = buffer.begin(); itr != buffer.end(); itr++) {
+        if(registeredFiles.find(itr->first) == registeredFiles.end()) {
+            std::string fileName = itr->first;
+            return writeBackFile(fileName);
+        }
+    }
+    return -1;
+}
+
 /**
  * storeInBuffer() - stores a page into cache.
  * @argument1 : name of the file whose page is being cached.
  * @argument2 : page number to be cached.
  * @argument3 : page data which to be written to cache.
+ * @argument4 : 1 if the page differs from the page on disk.
+ * @argument5 : true to keep the page cached while the file has unpinned pages.
  *
  * Return : 0 on success.
 */
-RC BufferManager::storeInBuffer( const std::string& fileName, const int pageNum, const void *data) {
-    if(buffer.find(fileName) != buffer.end() && buffer[fileName].find(pageNum) != buffer[fileName].end()) {
-        memcpy((char*)(buffer[fileName][pageNum]).pageData, (char*)data, PAGE_SIZE);
-        (buffer[fileName][pageNum]).dirtyBit = 1;
+RC BufferManager::storeInBuffer(const std::string& fileName, const int pageNum, const void *data,
+                                const int dirtyBit, const bool pinned) {
+    std::lock_guard<SharedLatch> guard(bufferLatch);
+    auto file = buffer.find(fileName);
+    if(file != buffer.end() && file->second.find(pageNum) != file->second.end()) {
+        CacheInfo& page = file->second[pageNum];
+        memcpy((char*)page.pageData, (char*)data, PAGE_SIZE);
+        page.dirtyBit = 1;
+        page.pinned = pinned;
+        return 0;
+    }
 
-    } else if(buffer.find(fileName) != buffer.end()) {
-        if(buffer[fileName].size() == MAX_CACHE_PAGE_PER_FILE) {
-            writeBackPageToFile(fileName, buffer[fileName].begin()->first, buffer[fileName].begin()->second.pageData, 
-                                (buffer.begin()->second).begin()->second.dirtyBit);
-            buffer.erase(fileName);
+    auto registered = registeredFiles.find(fileName);
+    if(registered != registeredFiles.end()) {
+        if(file != buffer.end() && (int)file->second.size() >= registered->second.maxPages) {
+            evictPage(fileName);
+        }
+    } else if(file != buffer.end()) {
+        if(file->second.size() >= (unsigned)MAX_CACHE_PAGE_PER_FILE) {
+            evictPage(fileName);
         }
-        (buffer[fileName][pageNum]).pageData = malloc(PAGE_SIZE);
-        memcpy((char*)(buffer[fileName][pageNum]).pageData, (char*)data, PAGE_SIZE);
-        (buffer[fileName][pageNum]).dirtyBit = 0;
-
-    } else if (buffer.size() == MAX_FILES_FOR_CACHE) {
-        writeBackPageToFile(buffer.begin()->first, (buffer.begin()->second).begin()->first, 
-                            (buffer.begin()->second).begin()->second.pageData, 
-                            (buffer.begin()->second).begin()->second.dirtyBit);
-
-        buffer.erase(buffer.begin());
-        (buffer[fileName][pageNum]).pageData = malloc(PAGE_SIZE);
-        memcpy((char*)(buffer[fileName][pageNum]).pageData, (char*)data, PAGE_SIZE);
-        (buffer[fileName][pageNum]).dirtyBit = 0;
-
     } else {
-        (buffer[fileName][pageNum]).pageData = malloc(PAGE_SIZE);
-        memcpy((char*)(buffer[fileName][pageNum]).pageData, (char*)data, PAGE_SIZE);
-        (buffer[fileName][pageNum]).dirtyBit = 0;
+        int sharedFiles = 0;
+        for(auto itr = buffer.begin(); itr != buffer.end(); itr++) {
+            if(registeredFiles.find(itr->first) == registeredFiles.end()) sharedFiles++;
+        }
+        if(sharedFiles >= MAX_FILES_FOR_CACHE) {
+            evictSharedFile();
+        }
     }
+
+    CacheInfo& page = buffer[fileName][pageNum];
+    page.pageData = malloc(PAGE_SIZE);
+    memcpy((char*)page.pageData, (char*)data, PAGE_SIZE);
+    page.dirtyBit = dirtyBit;
+    page.pinned = pinned;
     return 0;
 }
 
@@ -76,16 +218,15 @@ RC BufferManager::storeInBuffer( const std::string& fileName, const int pageNum,
  * @argument1 : name of the file whose cached page is to be written to disk.
  * @argument2 : page number to be written.
  * @argument3 : page data which is to be written to disk.
- * @argument4 : provison for dirtyBit currently not being used.
+ * @argument4 : dirtyBit, clean pages are not written.
  *
  * Return : 0 on success.
 */
 RC BufferManager::writeBackPageToFile(const std::string& fileName, const int pageNum,
                                       const void* data, int dirtyBit) {
-    std::fstream file(fileName);
-    file.seekp((pageNum + MAX_HIDDEN_PAGES)*PAGE_SIZE);
-    file.write((char*)data, PAGE_SIZE);
-    return 0;
+    if(dirtyBit == 0) return 0;
+    std::lock_guard<SharedLatch> guard(bufferLatch);
+    return writePageToDisk(fileName, pageNum, data, dirtyBit);
 }
 
 /**
@@ -95,12 +236,41 @@ RC BufferManager::writeBackPageToFile(const std::string& fileName, const int pag
  * Return : 0 on success.
 */
 RC BufferManager::writeBackFullBufferToFile(const std::string &fileName) {
-    
-    if(buffer.find(fileName) != buffer.end()) {
-        for(auto itr =  buffer[fileName].begin(); itr != buffer[fileName].end(); itr++) {
-            writeBackPageToFile(fileName, (itr)->first, (itr)->second.pageData, (itr)->second.dirtyBit);
+    std::lock_guard<SharedLatch> guard(bufferLatch);
+    return writeBackFile(fileName);
+}
+
+/**
+ * writePageToDisk() - writeBackPageToFile() for a caller holding the cache latch.
+ * @argument1 : name of the file.
+ * @argument2 : page number to be written.
+ * @argument3 : page data which is to be written to disk.
+ * @argument4 : dirtyBit, clean pages are not written.
+ *
+ * Return : 0 on success.
+*/
+RC BufferManager::writePageToDisk(const std::string& fileName, const int pageNum,
+                                  const void* data, int dirtyBit) {
+    if(dirtyBit == 0) return 0;
+    std::fstream file(fileName);
+    file.seekp((pageNum + getHiddenPages(fileName))*PAGE_SIZE);
+    file.write((char*)data, PAGE_SIZE);
+    return 0;
+}
+
+/**
+ * writeBackFile() - writeBackFullBufferToFile() for a caller holding the cache latch.
+ * @argument1 : name of the file.
+ *
+ * Return : 0 on success.
+*/
+RC BufferManager::writeBackFile(const std::string &fileName) {
+    auto file = buffer.find(fileName);
+    if(file != buffer.end()) {
+        for(auto itr = file->second.begin(); itr != file->second.end(); itr++) {
+            writePageToDisk(fileName, itr->first, itr->second.pageData, itr->second.dirtyBit);
         }
-        buffer.erase(buffer.find(fileName));
+        buffer.erase(file);
     }
     return 0;
 }
@@ -142,6 +312,8 @@ RC PagedFileManager::createFile(const std::string &fileName) {
     }
 
     newFile.close();
+    // zone maps left by an earlier file of the same name.
+    remove((fileName + ZONE_MAP_SUFFIX).c_str());
     return 0;
 }
 
@@ -155,6 +327,27 @@ RC PagedFileManager::destroyFile(const std::string &fileName) {
     if(remove(fileName.c_str()) != 0) {
         return -1;
     }
+    BufferManager::instance().dropFile(fileName);
+    remove((fileName + ZONE_MAP_SUFFIX).c_str());
+
+    return 0;
+}
+
+/**
+ * renameFile() - renames a closed file on the disk, its zone maps go with it.
+ * @argument1 : name of the file.
+ * @argument2 : new name of the file, a closed file of that name is replaced in one step.
+ *
+ * Return : 0 on success, -1 on failure, both files are then left as they were.
+*/
+RC PagedFileManager::renameFile(const std::string &fileName, const std::string &newFileName) {
+    if(rename(fileName.c_str(), newFileName.c_str()) != 0) {
+        return -1;
+    }
+    BufferManager::instance().dropFile(fileName);
+    BufferManager::instance().dropFile(newFileName);
+    remove((newFileName + ZONE_MAP_SUFFIX).c_str());
+    rename((fileName + ZONE_MAP_SUFFIX).c_str(), (newFileName + ZONE_MAP_SUFFIX).c_str());
 
     return 0;
 }
@@ -196,6 +389,8 @@ FileHandle::FileHandle() : bm(BufferManager::instance()) {
     writePageCounter = 0;
     appendPageCounter = 0;
     numPages = 0;
+    zoneMapsChanged = false;
+    fixedWidthRecords = false;
 }
 
 FileHandle::~FileHandle() {}
@@ -205,7 +400,7 @@ FileHandle::~FileHandle() {}
  * @argument1 : Name of the file to be opened.
  * 
  * Opens a file, if the file is opened for the first time creates the hidden page,
- * reads the performance counter for the file from hidden/header page.
+ * reads the performance counter for the file from hidden/header page and the zone maps.
  *
  * Return : none.
 */
@@ -214,6 +409,7 @@ void FileHandle::openFile(const std::string& fileName) {
     if (this->isEmpty()) this->createHiddenPage(fileName);
     this->readCounterFromHiddenPage();
     this->setFileName(fileName);
+    this->readZoneMaps();
 }
 
 /**
@@ -226,6 +422,7 @@ void FileHandle::openFile(const std::string& fileName) {
  * Return : none.
 */
 void FileHandle::closeRoutine() {
+    this->writeZoneMaps();
     this->updateCounterInHiddenPage();
     this->bm.writeBackFullBufferToFile(fileName);
     this->file.close();
@@ -264,6 +461,9 @@ RC FileHandle::createHiddenPage(const std::string& fileName) {
     counter = 1;
     memcpy((char*)data + 2*sizeof(int), (char*)&counter, sizeof(int));
     memcpy((char*)data + 3*sizeof(int), (char*)&pageNum, sizeof(int));
+    // records of the new file use the fixed width format
+    int marker = FIXED_WIDTH_MARKER;
+    memcpy((char*)data + OFFSET_FOR_FS_TABLE*sizeof(int) + MAX_FS_TABLE_PAGES*2*sizeof(RT), (char*)&marker, sizeof(int));
 
     newFile.write((char*)data, MAX_HIDDEN_PAGES*PAGE_SIZE);
     newFile.close();
@@ -320,7 +520,7 @@ RC FileHandle::writePage(PageNum pageNum, const void *data) {
     updateFreeSpaceForPage(pageNum, data);
     writePageCounter++;
     pageNum += MAX_HIDDEN_PAGES;
-    if(bm.storeInBuffer(fileName, pageNum - MAX_HIDDEN_PAGES, data) == 0) return 0;
+    if(bm.storeInBuffer(fileName, pageNum - MAX_HIDDEN_PAGES, data, 1) == 0) return 0;
    /* file.seekp(pageNum*PAGE_SIZE, std::ios_base::beg);
     file.write((char*)data, PAGE_SIZE); */
 
@@ -374,11 +574,13 @@ RC FileHandle::appendPage(const void *data) {
  * @argument1 : page number for which the free space is to be updated.
  * @argument2 : buffer containing data for the above page number.
  * 
- * Updates the freespace for the given page number into the header page. 
+ * Updates the freespace for the given page number into the header page. Pages past MAX_FS_TABLE_PAGES
+ * have no slot, findFreePage() reads them from the disk.
  *
  * Return : 0 on success, -1 on failure.
 */
 RC FileHandle::updateFreeSpaceForPage(int pageNum, const void* data) {
+    if(pageNum >= MAX_FS_TABLE_PAGES) return 0;
     RT dirSlot, recSlot;
     memcpy((char*)&dirSlot, (char*)data + PAGE_SIZE - sizeof(RT), sizeof(RT));
     memcpy((char*)&recSlot, (char*)data + PAGE_SIZE - 2*sizeof(RT), sizeof(RT));
@@ -449,6 +651,9 @@ RC FileHandle::readCounterFromHiddenPage(){
     memcpy((char*)&writePageCounter, (char*)counters + sizeof(int), sizeof(int));
     memcpy((char*)&appendPageCounter, (char*)counters + 2*sizeof(int), sizeof(int));
     memcpy((char*)&numPages, (char*)counters + 3*sizeof(int), sizeof(int));
+    int marker = 0;
+    memcpy((char*)&marker, (char*)hiddenData + MAX_FS_TABLE_PAGES*2*sizeof(RT), sizeof(int));
+    fixedWidthRecords = marker == FIXED_WIDTH_MARKER;
     readPageCounter++;
 
     free(counters);
@@ -492,6 +697,174 @@ RT FileHandle::getTotalSlotsInPage(const void* data) {
     return totalSlots;
 }
 
+/**
+ * isOverflowPage() - checks from the header page if a page only holds overflow data.
+ * @argument1 : page number.
+ *
+ * Lets the scans skip overflow pages without reading them. Pages whose free space slot does not fit
+ * in the header pages are reported as regular pages.
+ *
+ * Return : true if overflow page, false otherwise.
+*/
+bool FileHandle::isOverflowPage(int pageNum) {
+    if(pageNum >= MAX_FS_TABLE_PAGES) return false;
+
+    RT freeSlots = 0;
+    memcpy((char*)&freeSlots, (char*)hiddenData + (2*pageNum + 1)*sizeof(RT), sizeof(RT));
+    return freeSlots == OVERFLOW_PAGE;
+}
+
+/**
+ * readZoneMaps() - loads the zone maps of the file upon file open.
+ *
+ * The zone map file starts with the number of pages of the file when it was written, it is ignored
+ * if the file has changed size since then (e.g it was written by an older build or replaced).
+ * Layout : [numPages][columns] then for each column [name length][name][pages][pages * PageZone].
+ *
+ * Return : 0 on success, -1 if the file has no usable zone maps.
+*/
+RC FileHandle::readZoneMaps() {
+    zoneMaps.clear();
+    zoneMapsChanged = false;
+    std::ifstream zoneFile((fileName + ZONE_MAP_SUFFIX).c_str(), std::ios::binary);
+    if(!zoneFile.good()) return -1;
+
+    int pages = 0, columns = 0;
+    zoneFile.read((char*)&pages, sizeof(int));
+    zoneFile.read((char*)&columns, sizeof(int));
+    if(!zoneFile.good() || pages != (int)numPages) return -1;
+
+    for(int i = 0; i < columns; i++) {
+        int nameLength = 0, zones = 0;
+        zoneFile.read((char*)&nameLength, sizeof(int));
+        if(!zoneFile.good() || nameLength < 0 || nameLength > PAGE_SIZE) break;
+        std::string column(nameLength, '\0');
+        zoneFile.read(&column[0], nameLength);
+        zoneFile.read((char*)&zones, sizeof(int));
+        if(!zoneFile.good() || zones < 0 || zones > pages) break;
+        std::vector<PageZone> columnZones(zones);
+        zoneFile.read((char*)columnZones.data(), zones*sizeof(PageZone));
+        if(!zoneFile.good()) break;
+        zoneMaps[column] = columnZones;
+    }
+    if(!zoneFile.good()) {
+        zoneMaps.clear();
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * writeZoneMaps() - writes back the zone maps of the file before file close.
+ *
+ * Nothing is written if they have not changed since the file was opened.
+ *
+ * Return : 0 on success.
+*/
+RC FileHandle::writeZoneMaps() {
+    if(zoneMapsChanged && !zoneMaps.empty()) {
+        std::ofstream zoneFile((fileName + ZONE_MAP_SUFFIX).c_str(), std::ios::binary | std::ios::trunc);
+        int pages = numPages, columns = zoneMaps.size();
+        zoneFile.write((char*)&pages, sizeof(int));
+        zoneFile.write((char*)&columns, sizeof(int));
+        for(auto& column : zoneMaps) {
+            int nameLength = column.first.size(), zones = column.second.size();
+            zoneFile.write((char*)&nameLength, sizeof(int));
+            zoneFile.write(column.first.data(), nameLength);
+            zoneFile.write((char*)&zones, sizeof(int));
+            zoneFile.write((char*)column.second.data(), zones*sizeof(PageZone));
+        }
+    }
+    zoneMaps.clear();
+    zoneMapsChanged = false;
+    return 0;
+}
+
+/**
+ * markZoneMapsChanged() - called before the zone maps of the file are changed.
+ *
+ * The zone map file on the disk is removed until the file is closed, so that it is never read
+ * back after the pages of the file changed without it.
+ *
+ * Return : void.
+*/
+void FileHandle::markZoneMapsChanged() {
+    if(zoneMapsChanged) return;
+    remove((fileName + ZONE_MAP_SUFFIX).c_str());
+    zoneMapsChanged = true;
+}
+
+/**
+ * addZoneColumn() - keeps a zone map for a TypeInt or TypeReal column of the file.
+ * @argument1 : name of the column.
+ *
+ * The existing pages of the file are not known for the column until they are emptied.
+ *
+ * Return : void.
+*/
+void FileHandle::addZoneColumn(const std::string& column) {
+    if(zoneMaps.find(column) != zoneMaps.end()) return;
+    markZoneMapsChanged();
+    zoneMaps[column];
+}
+
+/**
+ * widenZone() - widens the zone of a page so that it contains a value of a record stored in it.
+ * @argument1 : page number.
+ * @argument2 : name of the column, see addZoneColumn().
+ * @argument3 : value of the column in the record.
+ *
+ * Return : void.
+*/
+void FileHandle::widenZone(int pageNum, const std::string& column, const double value) {
+    auto itr = zoneMaps.find(column);
+    if(itr == zoneMaps.end() || pageNum >= (int)itr->second.size()) return;
+
+    PageZone& zone = itr->second[pageNum];
+    if(value >= zone.minValue && value <= zone.maxValue) return;
+    markZoneMapsChanged();
+    if(value < zone.minValue) zone.minValue = value;
+    if(value > zone.maxValue) zone.maxValue = value;
+}
+
+/**
+ * clearZones() - empties the zones of a page, used when a page has no record left or is appended.
+ * @argument1 : page number.
+ *
+ * Return : void.
+*/
+void FileHandle::clearZones(int pageNum) {
+    for(auto& column : zoneMaps) {
+        if(pageNum >= (int)column.second.size()) {
+            markZoneMapsChanged();
+            column.second.resize(pageNum + 1);
+        }
+        PageZone& zone = column.second[pageNum];
+        if(zone.minValue == HUGE_VAL && zone.maxValue == -HUGE_VAL) continue;
+        markZoneMapsChanged();
+        zone.minValue = HUGE_VAL;
+        zone.maxValue = -HUGE_VAL;
+    }
+}
+
+/**
+ * getZone() - smallest and largest value of a column over the records of a page.
+ * @argument1 : page number.
+ * @argument2 : name of the column.
+ * @argument3 : smallest value (out parameter).
+ * @argument4 : largest value (out parameter), smaller than the smallest one if the page has no record.
+ *
+ * Return : true if known, false if any value may be stored in the page.
+*/
+bool FileHandle::getZone(int pageNum, const std::string& column, double& minValue, double& maxValue) {
+    auto itr = zoneMaps.find(column);
+    if(itr == zoneMaps.end() || pageNum >= (int)itr->second.size()) return false;
+
+    minValue = itr->second[pageNum].minValue;
+    maxValue = itr->second[pageNum].maxValue;
+    return minValue != -HUGE_VAL || maxValue != HUGE_VAL;
+}
+
 /**
  * findFreePage() - returns first free page with atleast the requiredSpace to insert data.
  * @argument1 : minuimum amount of free space required.
@@ -7,6 +7,9 @@
 #include <iostream>
 #include <math.h>
 #include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
 
 using namespace std;
 
@@ -17,24 +20,48 @@ typedef short RT;
 const RT PAGE_SIZE = 4096;
 const RT MAX_HIDDEN_PAGES  = 6;
 const RT OFFSET_FOR_FS_TABLE  = 4; //ONLY A MULTIPLIER WITH SIZEOF(INT)
+// Pages whose free space is kept in the header pages, the header bytes past their slots hold the format marker.
+const int MAX_FS_TABLE_PAGES = MAX_HIDDEN_PAGES*PAGE_SIZE/(2*sizeof(RT)) - OFFSET_FOR_FS_TABLE*sizeof(int);
+// Format marker of the files storing Int/Real only records in the fixed width format (see isFixedWidthDescriptor()),
+// files without it keep the field offset table in every record.
+const int FIXED_WIDTH_MARKER = 0x57584946;
 
 const RT MAX_CACHE_PAGE_PER_FILE = 1;
 const RT MAX_FILES_FOR_CACHE = 1;
 const RT SLOT_SIZE  = 4;
 const RT DELETED = 30000;
 const RT UPDATED = 30001;
+const RT OVERFLOW_PAGE = -1; // free slot count of a page holding overflow data, it has no records.
+
+// Zone maps of a file are kept next to it in fileName + ZONE_MAP_SUFFIX, see FileHandle::readZoneMaps().
+const std::string ZONE_MAP_SUFFIX = ".zone";
 
 class FileHandle;
 
+// Smallest and largest value of a TypeInt or TypeReal column over the records of a page. A page
+// without records has minValue > maxValue, a page whose records are not known has (-HUGE_VAL, HUGE_VAL).
+class PageZone {
+public:
+    double minValue;
+    double maxValue;
+
+    PageZone() {
+        minValue = -HUGE_VAL;
+        maxValue = HUGE_VAL;
+    }
+};
+
 class CacheInfo {
 public:
     void* pageData;
     int dirtyBit;
+    bool pinned;
     std::string  fileName;
 
     CacheInfo () {
         pageData = NULL;
         dirtyBit = 0;
+        pinned = false;
     }
 
     ~CacheInfo() {
@@ -45,14 +72,64 @@ public:
      }
 } ;
 
+// Cache layout of a file which keeps its own pages in the buffer instead of sharing the file slots.
+class FileCacheInfo {
+public:
+    int hiddenPages;
+    int maxPages;
+};
+
+/* Reader/writer latch: readers share it, a writer holds it alone. Waiting writers keep
+ * new readers out so that a stream of readers can not starve them. */
+class SharedLatch {
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    int readers;
+    int waitingWriters;
+    bool writer;
+
+public:
+    SharedLatch() : readers(0), waitingWriters(0), writer(false) {}
+
+    void lockShared();
+
+    void unlockShared();
+
+    void lock();
+
+    void unlock();
+};
+
+// Holds a SharedLatch in shared mode for a scope, std::lock_guard holds it alone.
+class SharedLatchGuard {
+private:
+    SharedLatch& latch;
+
+public:
+    SharedLatchGuard(SharedLatch& latch) : latch(latch) { latch.lockShared(); }
+
+    ~SharedLatchGuard() { latch.unlockShared(); }
+};
+
 class BufferManager {
 private:
     std::unordered_map<std::string, std::unordered_map<int, CacheInfo>> buffer;
+    std::unordered_map<std::string, FileCacheInfo> registeredFiles;
+
+    int getHiddenPages(const std::string& fileName);
+    RC evictPage(const std::string& fileName);
+    RC evictSharedFile();
+    RC writePageToDisk(const std::string& fileName, const int pageNum, const void* data, int dirtyBit);
+    RC writeBackFile(const std::string& fileName);
 public:
     static BufferManager &instance();
 
+    void registerFile(const std::string& fileName, const int hiddenPages, const int maxPages);
+    void dropFile(const std::string& fileName);
     RC pageInBuffer(const std::string& fileName, const int pageNum, void* data);
-    RC storeInBuffer(const std::string& fileName, const int pageNum, const void* data);
+    RC storeInBuffer(const std::string& fileName, const int pageNum, const void* data,
+                     const int dirtyBit = 0, const bool pinned = false);
     RC writeBackPageToFile(const std::string& fileName, const int pageNum, const void* data, int dirtyBit);
     RC writeBackFullBufferToFile(const std::string& fileName);
 
@@ -72,6 +149,7 @@ public:
 
     RC createFile(const std::string &fileName);                         // Create a new file
     RC destroyFile(const std::string &fileName);                        // Destroy a file
+    RC renameFile(const std::string &fileName, const std::string &newFileName); // Rename a closed file
     RC openFile(const std::string &fileName, FileHandle &fileHandle);   // Open a file
     RC closeFile(FileHandle &fileHandle);                               // Close a file
 protected:
@@ -93,6 +171,10 @@ private:
     int numHiddenPages;
     void* hiddenData;
     BufferManager& bm;
+    // min/max of every zone map column, indexed by page number. Pages past the end are not known.
+    std::unordered_map<std::string, std::vector<PageZone>> zoneMaps;
+    bool zoneMapsChanged;
+    bool fixedWidthRecords;
 
     int getHiddenPagesToLoad(int& pageToStartLoadingFrom);
     RC writeBackPage(int pageNum, const void* data);
@@ -100,6 +182,9 @@ private:
     virtual RC createHiddenPage(const std::string& fileName);
     virtual RC updateCounterInHiddenPage();
     virtual RC readCounterFromHiddenPage();
+    RC readZoneMaps();
+    RC writeZoneMaps();
+    void markZoneMapsChanged();
 public:
     std::string fileName;
 
@@ -123,6 +208,15 @@ public:
     RC updateFreeSpaceForPage(int pageNum, const void* data);
     int findFreePage(RT requiredSpace);
     RT getTotalSlotsInPage(const void* data);
+    bool isOverflowPage(int pageNum);
+    // Set when the file was created with the fixed width record format, read from the header pages.
+    bool hasFixedWidthRecords() { return fixedWidthRecords; }
+
+    // Zone maps, maintained by the record based file manager.
+    void addZoneColumn(const std::string& column);
+    void widenZone(int pageNum, const std::string& column, const double value);
+    void clearZones(int pageNum);
+    bool getZone(int pageNum, const std::string& column, double& minValue, double& maxValue);
     void setFileName(const std::string& name) { fileName = name; }
 };
 
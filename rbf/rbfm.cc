@@ -1,4 +1,5 @@
 #include "rbfm.h"
+#include <algorithm>
 #include "../rm/rm.h"
 
 /**
@@ -21,6 +22,7 @@ RC RBFM_ScanIterator::initializeScanIterator(FileHandle &fileHandle, const std::
     for(auto itr : recordDescriptor) {
         if(itr.name == conditionAttribute) {
             this->type = itr.type;
+            this->length = itr.length;
             if(value == NULL) this->compValue = NULL;
             else if(itr.type == TypeReal) {
                 (this->compValue) = malloc(sizeof(float));
@@ -30,8 +32,8 @@ RC RBFM_ScanIterator::initializeScanIterator(FileHandle &fileHandle, const std::
                 memcpy((char*)(this->compValue), (char*)value, sizeof(int));
             } else {
                 int length = 0;
-                (this->compValue) = malloc(sizeof(int) + length);
                 memcpy((char*)&length, (char*)value, sizeof(int));
+                (this->compValue) = malloc(sizeof(int) + length);
                 memcpy((char*)(this->compValue), (char*)value, sizeof(int) + length);
             }
             break;
@@ -69,7 +71,8 @@ RID RBFM_ScanIterator::getNextValidRID (RID currentRID, void* data) {
     int totalPages = this->fileHandle->getNumberOfPages();
     for(int i = currentRID.pageNum ; i < totalPages; i++) {
         nextRID.pageNum = i;
-        if(this->fileHandle->readPage(nextRID.pageNum, data) == -1) {
+        if(this->fileHandle->isOverflowPage(i) || zoneExcludesPage(i) ||
+           this->fileHandle->readPage(nextRID.pageNum, data) == -1) {
             continue;
         }
         RT totalSlots = this->fileHandle->getTotalSlotsInPage(data);
@@ -85,6 +88,41 @@ RID RBFM_ScanIterator::getNextValidRID (RID currentRID, void* data) {
     return nextRID;
 }
 
+/**
+ * zoneExcludesPage() - checks the zone map of a page against the iterator condition.
+ * @argument1 : page number.
+ *
+ * Range and equality conditions on a TypeInt or TypeReal attribute can skip every page whose
+ * smallest and largest value rule out a match, without reading it. NULLs never match such a condition.
+ *
+ * Return : true if no record of the page can match.
+*/
+bool RBFM_ScanIterator::zoneExcludesPage(const int pageNum) {
+    if(this->compValue == NULL || this->compOp == NO_OP || this->compOp == NE_OP || this->type == TypeVarChar) {
+        return false;
+    }
+
+    double minValue = 0, maxValue = 0;
+    if(!this->fileHandle->getZone(pageNum, this->conditionAttribute, minValue, maxValue)) return false;
+
+    double value = 0;
+    if(this->type == TypeInt) {
+        int intValue = 0;
+        memcpy((char*)&intValue, (char*)this->compValue, sizeof(int));
+        value = intValue;
+    } else {
+        float realValue = 0;
+        memcpy((char*)&realValue, (char*)this->compValue, sizeof(float));
+        value = realValue;
+    }
+
+    if(this->compOp == EQ_OP) return !(minValue <= value && value <= maxValue);
+    if(this->compOp == LT_OP) return !(minValue < value);
+    if(this->compOp == LE_OP) return !(minValue <= value);
+    if(this->compOp == GT_OP) return !(maxValue > value);
+    return !(maxValue >= value);
+}
+
 /**
  * recordComparison() - Compares record based on the iterator condition.
  * @argument1 : RID of the record.
@@ -117,7 +155,7 @@ bool RBFM_ScanIterator::recordComparison(const RID& rid, void* pageData) {
         }
         retVal =  compareTypeInt(attributeValue, this->compValue, compOp);
     } else {
-        attributeValue = malloc(PAGE_SIZE);
+        attributeValue = malloc(sizeof(int) + std::max((int)PAGE_SIZE, (int)this->length));
         if(RecordBasedFileManager::instance().readAttributeOptimized(*(this->fileHandle), this->recordDescriptor, rid,
                                                          this->conditionAttribute, attributeValue, pageData) == NULL_POINT) {
             free(attributeValue);
@@ -188,6 +226,17 @@ RC RecordBasedFileManager::destroyFile(const std::string &fileName) {
     return PagedFileManager::instance().destroyFile(fileName);
 }
 
+/**
+ * renameFile() - renames a given closed file
+ * @argument1 : Name of the file
+ * @argument2 : New name of the file, a closed file of that name is replaced
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::renameFile(const std::string &fileName, const std::string &newFileName) {
+    return PagedFileManager::instance().renameFile(fileName, newFileName);
+}
+
 /**
  * openFile() - opens a given file
  * @argument1 : Name of the file
@@ -225,7 +274,11 @@ RC RecordBasedFileManager::insertRecord(FileHandle &fileHandle, const std::vecto
     if(recordDescriptor.size() == 0) return -1;
     int currentPage = fileHandle.getNumberOfPages() - 1;
     RT formattedDataSize = 0;
-    void* formattedData = formatDataForStoring(recordDescriptor, data, formattedDataSize);
+    void* rowData = storeOverflowFields(fileHandle, recordDescriptor, data);
+    void* formattedData = formatDataForStoring(recordDescriptor, usesFixedWidthFormat(fileHandle, recordDescriptor),
+                                               rowData != NULL ? rowData : data, formattedDataSize);
+    free(rowData);
+    addZoneColumns(fileHandle, recordDescriptor);
     void* pageData = malloc(PAGE_SIZE);
     int retVal = fileHandle.readPage(currentPage, pageData);
     //Check wether the current Page has free space for the given record.
@@ -233,6 +286,7 @@ RC RecordBasedFileManager::insertRecord(FileHandle &fileHandle, const std::vecto
         RT offset = fileHandle.hasEnoughSpace(pageData, formattedDataSize);
         if(offset != -1) {
             storeDataInFile(fileHandle, currentPage, offset, formattedData, formattedDataSize, rid, pageData);
+            widenZones(fileHandle, recordDescriptor, data, rid.pageNum);
             free(formattedData);
             free(pageData);
             return 0;
@@ -244,6 +298,7 @@ RC RecordBasedFileManager::insertRecord(FileHandle &fileHandle, const std::vecto
         fileHandle.readPage(freePage, pageData);
         RT offset = fileHandle.hasEnoughSpace(pageData, formattedDataSize);
         storeDataInFile(fileHandle, freePage, offset, formattedData, formattedDataSize, rid, pageData);
+        widenZones(fileHandle, recordDescriptor, data, rid.pageNum);
         free(formattedData);
         free(pageData);
         return 0;
@@ -253,12 +308,58 @@ RC RecordBasedFileManager::insertRecord(FileHandle &fileHandle, const std::vecto
     int newPage = fileHandle.getNumberOfPages();
     fileHandle.initPageDirectory(pageData);
     storeDataInFile(fileHandle, newPage, 0, formattedData, formattedDataSize, rid, pageData);
+    widenZones(fileHandle, recordDescriptor, data, rid.pageNum);
     free(pageData);
     free(formattedData);
     
     return 0;
 }
 
+/**
+ * appendRecord() - inserts a given record in the last page of the file.
+ * @argument1 : Filehandle of the file.
+ * @argument2 : record descriptor.
+ * @argument3 : record data to be inserted
+ * @argument4 : return RID of the inserted record by reference.
+ *
+ * Unlike insertRecord() free space in earlier pages is never reused, so records
+ * appended one after the other keep their relative order in the file. Used to load
+ * packed files (see RelationManager::vacuumTable()).
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::appendRecord(FileHandle &fileHandle, const std::vector<Attribute> &recordDescriptor,
+                                        const void *data, RID &rid) {
+
+    if(recordDescriptor.size() == 0) return -1;
+    int currentPage = fileHandle.getNumberOfPages() - 1;
+    RT formattedDataSize = 0;
+    void* rowData = storeOverflowFields(fileHandle, recordDescriptor, data);
+    void* formattedData = formatDataForStoring(recordDescriptor, usesFixedWidthFormat(fileHandle, recordDescriptor),
+                                               rowData != NULL ? rowData : data, formattedDataSize);
+    free(rowData);
+    addZoneColumns(fileHandle, recordDescriptor);
+    void* pageData = malloc(PAGE_SIZE);
+    if (fileHandle.readPage(currentPage, pageData) != -1) {
+        RT offset = fileHandle.hasEnoughSpace(pageData, formattedDataSize);
+        if(offset != -1) {
+            storeDataInFile(fileHandle, currentPage, offset, formattedData, formattedDataSize, rid, pageData);
+            widenZones(fileHandle, recordDescriptor, data, rid.pageNum);
+            free(formattedData);
+            free(pageData);
+            return 0;
+        }
+    }
+
+    int newPage = fileHandle.getNumberOfPages();
+    fileHandle.initPageDirectory(pageData);
+    storeDataInFile(fileHandle, newPage, 0, formattedData, formattedDataSize, rid, pageData);
+    widenZones(fileHandle, recordDescriptor, data, rid.pageNum);
+    free(pageData);
+    free(formattedData);
+    return 0;
+}
+
 /**
  * readRecord() - reads a given record
  * @argument1 : Filehandle of the file.
@@ -286,9 +387,10 @@ RC RecordBasedFileManager::readRecord(FileHandle &fileHandle, const std::vector<
         return -1;
     }
     // If the record has benn previously updated, read the page where the record has been stored after updation.
-    formatDataForReading(offset, formattedDataSize, recordDescriptor, pageData, data);
+    formatDataForReading(offset, formattedDataSize, recordDescriptor, usesFixedWidthFormat(fileHandle, recordDescriptor),
+                         pageData, data);
     free(pageData);
-    return 0;
+    return readOverflowFields(fileHandle, recordDescriptor, data);
 }
 
 /**
@@ -313,7 +415,19 @@ RC RecordBasedFileManager::deleteRecord(FileHandle &fileHandle, const std::vecto
 
     offset = getOffsetAndSizeFromRID(fileHandle, rid, formattedDataSize, final_rid, update_flag, initOffset, pageData);
     //record has already been deleted
-    if(offset == -1) return -1;
+    if(offset == DELETED) {
+        free(pageData);
+        free(oldData);
+        return -1;
+    }
+
+    std::vector<PageNum> overflowPages;
+    getOverflowPagesInRecord(getStoredDescriptor(fileHandle.fileName, recordDescriptor,
+                                                 getVersionOfRecordWithPage(pageData, final_rid)),
+                             (char*)pageData + offset, overflowPages);
+    for(auto pageNum : overflowPages) {
+        freeOverflowChain(fileHandle, pageNum);
+    }
     //record has been updated, need to delete from the page where it is actually stored. we should also delete 
     //the place holder rid's value from the original page.
     if(update_flag == UPDATED) {
@@ -323,6 +437,7 @@ RC RecordBasedFileManager::deleteRecord(FileHandle &fileHandle, const std::vecto
         moveRecordsByOffset(startOffset, moveOffset, LEFT, rid.slotNum, DELETED, 0 , 0, oldData);
         incrementFreeSlotsInPage(oldData);
         fileHandle.writePage(rid.pageNum, oldData);
+        clearZonesIfEmpty(fileHandle, rid.pageNum, oldData);
 
         //deleting from the page where updated record actually sits.
         startOffset = offset + formattedDataSize;
@@ -330,6 +445,7 @@ RC RecordBasedFileManager::deleteRecord(FileHandle &fileHandle, const std::vecto
         moveRecordsByOffset(startOffset, moveOffset, LEFT, final_rid.slotNum, DELETED, 0, 0, pageData);
         incrementFreeSlotsInPage(pageData);
         fileHandle.writePage(final_rid.pageNum, pageData);
+        clearZonesIfEmpty(fileHandle, final_rid.pageNum, pageData);
 
         free(oldData);
         free(pageData);
@@ -343,6 +459,7 @@ RC RecordBasedFileManager::deleteRecord(FileHandle &fileHandle, const std::vecto
     //Mark the slot for given record as deleted, hence can be used later.
     incrementFreeSlotsInPage(pageData);
     fileHandle.writePage(final_rid.pageNum, pageData);
+    clearZonesIfEmpty(fileHandle, final_rid.pageNum, pageData);
 
     free(oldData);
     free(pageData);
@@ -415,7 +532,13 @@ RC RecordBasedFileManager::updateRecord(FileHandle &fileHandle, const std::vecto
     if(recordDescriptor.size() == 0) return -1;
 
     RT newDataSize = 0;
-    void* newData = formatDataForStoring(recordDescriptor, data, newDataSize);
+    void* rowData = storeOverflowFields(fileHandle, recordDescriptor, data);
+    void* newData = formatDataForStoring(recordDescriptor, usesFixedWidthFormat(fileHandle, recordDescriptor),
+                                         rowData != NULL ? rowData : data, newDataSize);
+    free(rowData);
+    addZoneColumns(fileHandle, recordDescriptor);
+    std::vector<PageNum> newOverflowPages;
+    getOverflowPagesInRecord(recordDescriptor, newData, newOverflowPages);
 
     // Get the original record size.
     RT formattedDataSize = 0, update_flag = 0, initOffset = 0, offset = 0;
@@ -428,11 +551,20 @@ RC RecordBasedFileManager::updateRecord(FileHandle &fileHandle, const std::vecto
     offset = getOffsetAndSizeFromRID(fileHandle, rid, formattedDataSize, finalRid, update_flag, initOffset, pageData);
     //case 1 : record is already deleted
     if(offset == DELETED) {
+        for(auto pageNum : newOverflowPages) {
+            freeOverflowChain(fileHandle, pageNum);
+        }
         free(newData);
         free(pageData);
         free(oldData);
         return -1;
     }
+
+    // chains still referenced by the new record (rows rewritten by migrateRecords()) are kept.
+    std::vector<PageNum> oldOverflowPages;
+    getOverflowPagesInRecord(getStoredDescriptor(fileHandle.fileName, recordDescriptor,
+                                                 getVersionOfRecordWithPage(pageData, finalRid)),
+                             (char*)pageData + offset, oldOverflowPages);
     // get the latest table schmea
     RT latestVersion = (RT)(getLatestTableVersion(fileHandle.fileName));
     // if the new record leght is less than equal to previous one, we can use the same page
@@ -443,6 +575,7 @@ RC RecordBasedFileManager::updateRecord(FileHandle &fileHandle, const std::vecto
         moveRecordsByOffset(startOffset, moveOffset, LEFT, finalRid.slotNum, offset, newDataSize, 0, pageData);
         updateVersionOfRecord(pageData, finalRid, latestVersion);
         fileHandle.writePage(finalRid.pageNum, pageData);
+        widenZones(fileHandle, recordDescriptor, data, finalRid.pageNum);
     } else {
         // if record is bigger, check if current page has enough space, if not move to new page and place a tombstone
         int recEndOffset = fileHandle.hasEnoughSpace(pageData, newDataSize - formattedDataSize, UPDATED);
@@ -453,12 +586,14 @@ RC RecordBasedFileManager::updateRecord(FileHandle &fileHandle, const std::vecto
             memcpy((char*)pageData + offset, (char*)newData, newDataSize);
             updateVersionOfRecord(pageData, finalRid, latestVersion);
             fileHandle.writePage(finalRid.pageNum, pageData);
+            widenZones(fileHandle, recordDescriptor, data, finalRid.pageNum);
         } else {
             if(update_flag != UPDATED) {
                 //case 3.b page cant hold the new record, find a page with enough space.
                 // Also, delete the out dated record
                 RID newRid;
                 insertUpdatedRecord(fileHandle, recordDescriptor, newData, newDataSize, newRid, latestVersion);
+                widenZones(fileHandle, recordDescriptor, data, newRid.pageNum);
                 int pageNum = newRid.pageNum;
                 RT slotNum = newRid.slotNum;
                 memcpy((char*)pageData + offset, (char*)&pageNum, sizeof(int));
@@ -473,6 +608,7 @@ RC RecordBasedFileManager::updateRecord(FileHandle &fileHandle, const std::vecto
                 RID newRid;
                 //insert the record in a new page and get the new RID, update tombstone with the new RID.
                 insertUpdatedRecord(fileHandle, recordDescriptor, newData, newDataSize, newRid, latestVersion);
+                widenZones(fileHandle, recordDescriptor, data, newRid.pageNum);
                 int pageNum = newRid.pageNum;
                 RT slotNum = newRid.slotNum;
                 memcpy((char*)oldData + initOffset, (char*)&pageNum, sizeof(int));
@@ -486,10 +622,17 @@ RC RecordBasedFileManager::updateRecord(FileHandle &fileHandle, const std::vecto
                 moveRecordsByOffset(startOffset, moveOffset, LEFT, finalRid.slotNum, DELETED, formattedDataSize, 0, pageData);
                 incrementFreeSlotsInPage(pageData);
                 fileHandle.writePage(finalRid.pageNum, pageData);
+                clearZonesIfEmpty(fileHandle, finalRid.pageNum, pageData);
             }
         }
     }
 
+    for(auto pageNum : oldOverflowPages) {
+        if(std::find(newOverflowPages.begin(), newOverflowPages.end(), pageNum) == newOverflowPages.end()) {
+            freeOverflowChain(fileHandle, pageNum);
+        }
+    }
+
     free(newData);   
     free(pageData);
     free(oldData);
@@ -532,6 +675,16 @@ RC RecordBasedFileManager::readAttribute(FileHandle &fileHandle, const std::vect
 
     RT version = getVersionOfRecordWithPage(pageData, final_rid);
     RT latestVersion = (RT)getLatestTableVersion(fileHandle.fileName);
+    const std::vector<Attribute>& storedDescriptor = getStoredDescriptor(fileHandle.fileName, recordDescriptor, version);
+    if(usesFixedWidthFormat(fileHandle, storedDescriptor)) {
+        RC rc = readFixedWidthField(storedDescriptor, (char*)pageData + offset, attributeName, (char*)data + 1);
+        free(pageData);
+        if(rc == -1 && version == latestVersion) return -1;
+        char nullInfo = rc == 0 ? 0 : (1 << (CHAR_BIT - 1));
+        memcpy((char*)data, &nullInfo, 1);
+        return 0;
+    }
+
     // for the case when record is of an outdated schema, need to conform to latest schema.
     if(version != latestVersion) {
         std::vector<Attribute> recordDesc = getAttributesForVersion(fileHandle.fileName, version);
@@ -575,7 +728,12 @@ RC RecordBasedFileManager::readAttribute(FileHandle &fileHandle, const std::vect
                 if(prevLen == NULL_POINT) prevLen = recordDesc.size()*sizeof(RT);
                 memcpy((char*)&length, (char*)pageData + offset + prevLen, sizeof(int));
             }
-            memcpy((char*)data + nullBytes, (char*)pageData + offset + attributeOffset - length - sizeof(int), length + sizeof(int));
+            int fieldSize = getVarCharFieldSize(length);
+            memcpy((char*)data + nullBytes, (char*)pageData + offset + attributeOffset - fieldSize, fieldSize);
+            if(readOverflowValue(fileHandle, (char*)data + nullBytes) == -1) {
+                free(pageData);
+                return -1;
+            }
         }
 
         memcpy((char*)data, (char*)nullInfo, nullBytes);
@@ -618,7 +776,7 @@ RC RecordBasedFileManager::readAttribute(FileHandle &fileHandle, const std::vect
     } else {
         int length = 0;
         if(i == 0)
-            memcpy((char*)&length, (char*)pageData + offset + recordDescriptor.size()*sizeof(RT), sizeof(RT));
+            memcpy((char*)&length, (char*)pageData + offset + recordDescriptor.size()*sizeof(RT), sizeof(int));
         else {
             RT prevLen = -1;
             for(int j = i - 1; j >= 0; j--) {
@@ -630,7 +788,12 @@ RC RecordBasedFileManager::readAttribute(FileHandle &fileHandle, const std::vect
             if(prevLen == NULL_POINT) prevLen = recordDescriptor.size()*sizeof(RT);
             memcpy((char*)&length, (char*)pageData + offset + prevLen, sizeof(int));
         }
-        memcpy((char*)data + nullBytes, (char*)pageData + offset + attributeOffset - length - sizeof(int), length + sizeof(int));
+        int fieldSize = getVarCharFieldSize(length);
+        memcpy((char*)data + nullBytes, (char*)pageData + offset + attributeOffset - fieldSize, fieldSize);
+        if(readOverflowValue(fileHandle, (char*)data + nullBytes) == -1) {
+            free(pageData);
+            return -1;
+        }
     }
 
     memcpy((char*)data, (char*)nullInfo, nullBytes);
@@ -639,6 +802,209 @@ RC RecordBasedFileManager::readAttribute(FileHandle &fileHandle, const std::vect
     return 0;
 }
 
+/**
+ * readRecordWithLatestSchema() - Reads a table record in the latest schema of the table.
+ * @argument1 : filehandle of the table.
+ * @argument2 : RID of the record.
+ * @argument3 : buffer containing the record (out parameter).
+ * @argument4 : false to leave the VarChars stored in overflow pages as pointers (record kept as stored).
+ *
+ * The version is taken from the slot of the page already in hand, so a record is read with a single
+ * page fetch (two if it has been forwarded), plus the overflow pages of its large VarChars. Rows of
+ * older versions are translated through the cached projection of their version, see getVersionProjection().
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::readRecordWithLatestSchema(FileHandle &fileHandle, const RID &rid, void *data,
+                                                      const bool readOverflow) {
+    char pageData[PAGE_SIZE];
+    if(fileHandle.readPage(rid.pageNum, pageData) == -1) return -1;
+
+    RID final_rid = rid;
+    RT update_flag = 0, formattedDataSize = 0, initOffset = 0;
+    RT offset = getOffsetAndSizeFromRID(fileHandle, rid, formattedDataSize, final_rid, update_flag, initOffset, pageData);
+    if(offset == DELETED) return -1;
+
+    RT version = getVersionOfRecordWithPage(pageData, final_rid);
+    const VersionProjection& projection = getVersionProjection(fileHandle.fileName, version);
+    if(projection.latestDescriptor.size() == 0) return -1;
+
+    formatDataWithProjection(offset, projection, usesFixedWidthFormat(fileHandle, projection.storedDescriptor),
+                             pageData, data);
+    if(!readOverflow) return 0;
+    return readOverflowFields(fileHandle, projection.latestDescriptor, data);
+}
+
+/**
+ * readRecordsWithLatestSchema() - Reads a batch of table records in the latest schema of the table.
+ * @argument1 : filehandle of the table.
+ * @argument2 : RIDs of the records, in any order.
+ * @argument3 : buffer of rids.size() slots of recordSize bytes, record i goes to slot i (out parameter).
+ * @argument4 : size of a slot, at least getMaxRecordSize() of the latest descriptor.
+ *
+ * The records are read in page order so that each page of the batch is fetched once for all the
+ * records it holds, forwarded records and large VarChars cost their own page reads.
+ *
+ * Return : 0 on success, -1 if any of the records could not be read.
+*/
+RC RecordBasedFileManager::readRecordsWithLatestSchema(FileHandle &fileHandle, const std::vector<RID> &rids,
+                                                       void *data, const int recordSize) {
+    std::vector<unsigned> order(rids.size());
+    for(unsigned i = 0; i < rids.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&rids](const unsigned a, const unsigned b) {
+        return rids[b] > rids[a];
+    });
+
+    char pageData[PAGE_SIZE];
+    int pageInBuffer = -1;
+    for(unsigned i = 0; i < order.size(); i++) {
+        const RID& rid = rids[order[i]];
+        if(pageInBuffer != (int)rid.pageNum) {
+            if(fileHandle.readPage(rid.pageNum, pageData) == -1) return -1;
+            pageInBuffer = rid.pageNum;
+        }
+
+        RID final_rid = rid;
+        RT update_flag = 0, formattedDataSize = 0, initOffset = 0;
+        RT offset = getOffsetAndSizeFromRID(fileHandle, rid, formattedDataSize, final_rid, update_flag, initOffset, pageData);
+        // a forwarded record replaced the page in the buffer
+        if(final_rid.pageNum != rid.pageNum) pageInBuffer = final_rid.pageNum;
+        if(offset == DELETED) return -1;
+
+        RT version = getVersionOfRecordWithPage(pageData, final_rid);
+        const VersionProjection& projection = getVersionProjection(fileHandle.fileName, version);
+        if(projection.latestDescriptor.size() == 0) return -1;
+
+        void* record = (char*)data + (size_t)order[i]*recordSize;
+        formatDataWithProjection(offset, projection, usesFixedWidthFormat(fileHandle, projection.storedDescriptor),
+                                 pageData, record);
+        if(readOverflowFields(fileHandle, projection.latestDescriptor, record) == -1) return -1;
+    }
+    return 0;
+}
+
+/**
+ * readAttributeWithLatestSchema() - Reads a specific attribute of a table record in the latest schema.
+ * @argument1 : filehandle of the table.
+ * @argument2 : RID of the record.
+ * @argument3 : attribute name to be projected
+ * @argument4 : buffer containing the null byte and the attribute (out parameter).
+ *
+ * Columns added after the record was written are returned as NULL.
+ *
+ * Return : 0 on success, -1 on failure or if the attribute is not in the latest schema.
+*/
+RC RecordBasedFileManager::readAttributeWithLatestSchema(FileHandle &fileHandle, const RID &rid,
+                                                         const std::string &attributeName, void *data) {
+    char pageData[PAGE_SIZE];
+    if(fileHandle.readPage(rid.pageNum, pageData) == -1) return -1;
+
+    RID final_rid = rid;
+    RT update_flag = 0, formattedDataSize = 0, initOffset = 0;
+    RT offset = getOffsetAndSizeFromRID(fileHandle, rid, formattedDataSize, final_rid, update_flag, initOffset, pageData);
+    if(offset == DELETED) return -1;
+
+    RT version = getVersionOfRecordWithPage(pageData, final_rid);
+    const VersionProjection& projection = getVersionProjection(fileHandle.fileName, version);
+
+    int storedPos = -1;
+    RT i = 0;
+    for(i = 0; i < (RT)projection.latestDescriptor.size(); i++) {
+        if(projection.latestDescriptor[i].name == attributeName) {
+            storedPos = projection.latestToStored[i];
+            break;
+        }
+    }
+
+    // No attribute with the given name.
+    if(i == (RT)projection.latestDescriptor.size()) return -1;
+
+    char nullInfo = 0;
+    if(storedPos != -1) {
+        RT fieldCount = projection.storedDescriptor.size();
+        RT start[fieldCount], end[fieldCount];
+        getFieldBoundsInRecord(pageData, offset, projection.storedDescriptor,
+                               usesFixedWidthFormat(fileHandle, projection.storedDescriptor), start, end);
+        if(end[storedPos] != NULL_POINT) {
+            memcpy((char*)data + 1, pageData + offset + start[storedPos], end[storedPos] - start[storedPos]);
+            if(projection.latestDescriptor[i].type == TypeVarChar &&
+               readOverflowValue(fileHandle, (char*)data + 1) == -1) return -1;
+        } else {
+            storedPos = -1;
+        }
+    }
+
+    if(storedPos == -1) nullInfo |= (1 << (CHAR_BIT - 1));
+    memcpy((char*)data, &nullInfo, 1);
+    return 0;
+}
+
+/**
+ * migrateRecords() - Rewrites records of older schema versions in the latest version.
+ * @argument1 : filehandle of the table.
+ * @argument2 : last slot examined, (0, 0) to start from the beginning of the file (in/out parameter).
+ * @argument3 : maximum number of slots to examine.
+ * @argument4 : number of records rewritten (out parameter).
+ * @argument5 : number of old records left as they are (out parameter).
+ *
+ * A record is only rewritten if it still fits in its page, so RIDs and forwarding pointers are never
+ * changed, and large VarChars keep their overflow pages. Records that would have to move are left to
+ * RelationManager::vacuumTable(). The cursor is moved past the last page once the whole file has been examined.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::migrateRecords(FileHandle &fileHandle, RID &cursor, const unsigned batchSize,
+                                          unsigned &migrated, unsigned &skipped) {
+    migrated = 0;
+    skipped = 0;
+    RT latestVersion = (RT)getLatestTableVersion(fileHandle.fileName);
+    std::vector<Attribute> recordDescriptor = getVersionProjection(fileHandle.fileName, latestVersion).latestDescriptor;
+    if(recordDescriptor.size() == 0) return -1;
+
+    char pageData[PAGE_SIZE];
+    void* data = malloc(PAGE_SIZE);
+    int totalPages = fileHandle.getNumberOfPages();
+    unsigned examined = 0;
+
+    while(cursor.pageNum < totalPages && examined < batchSize) {
+        if(fileHandle.isOverflowPage(cursor.pageNum)) {
+            cursor.pageNum++;
+            cursor.slotNum = 0;
+            continue;
+        }
+        if(fileHandle.readPage(cursor.pageNum, pageData) == -1) break;
+        RT totalSlots = fileHandle.getTotalSlotsInPage(pageData);
+
+        while(cursor.slotNum < totalSlots && examined < batchSize) {
+            cursor.slotNum++;
+            examined++;
+            if(!isValidRID(cursor, pageData) || getVersionOfRecordWithPage(pageData, cursor) == latestVersion) continue;
+
+            RT oldSize = 0;
+            memcpy((char*)&oldSize, pageData + PAGE_SIZE - cursor.slotNum*SLOT_SIZE*sizeof(RT) - sizeof(RT), sizeof(RT));
+            readRecordWithLatestSchema(fileHandle, cursor, data, false);
+            RT newSize = getDataSizeWithoutNullBytes(recordDescriptor, usesFixedWidthFormat(fileHandle, recordDescriptor),
+                                                     data);
+            if(newSize > oldSize && fileHandle.hasEnoughSpace(pageData, newSize - oldSize, UPDATED) == -1) {
+                skipped++;
+                continue;
+            }
+
+            updateRecord(fileHandle, recordDescriptor, data, cursor);
+            fileHandle.readPage(cursor.pageNum, pageData);
+            migrated++;
+        }
+
+        if(cursor.slotNum >= totalSlots) {
+            cursor.pageNum++;
+            cursor.slotNum = 0;
+        }
+    }
+
+    free(data);
+    return 0;
+}
+
 /**
  * readAttributeOptimized() - Reads a specific attribute from the record.
  * @argument1 : filehandle of the file.
@@ -664,6 +1030,13 @@ RC RecordBasedFileManager::readAttributeOptimized(FileHandle &fileHandle, const
     RT version = getVersionOfRecordWithPage(pageData, final_rid);
     RT latestVersion = (RT)getLatestTableVersion(fileHandle.fileName);
 
+    const std::vector<Attribute>& storedDescriptor = getStoredDescriptor(fileHandle.fileName, recordDescriptor, version);
+    if(usesFixedWidthFormat(fileHandle, storedDescriptor)) {
+        RC rc = readFixedWidthField(storedDescriptor, (char*)pageData + offset, attributeName, data);
+        if(rc == -1 && version != latestVersion) return NULL_POINT;
+        return rc;
+    }
+
     if(version != latestVersion) {
         RT attributeOffset = 0;
         int attributeType = INVAL_TYPE;
@@ -707,7 +1080,9 @@ RC RecordBasedFileManager::readAttributeOptimized(FileHandle &fileHandle, const
                 if(prevLen == NULL_POINT) prevLen = recordDesc.size()*sizeof(RT);
                 memcpy((char*)&length, (char*)pageData + offset + prevLen, sizeof(int));
             }
-            memcpy((char*)data, (char*)pageData + offset + attributeOffset - length - sizeof(int), length + sizeof(int));
+            int fieldSize = getVarCharFieldSize(length);
+            memcpy((char*)data, (char*)pageData + offset + attributeOffset - fieldSize, fieldSize);
+            if(readOverflowValue(fileHandle, data) == -1) return -1;
         }
         return 0;
     }
@@ -750,7 +1125,9 @@ RC RecordBasedFileManager::readAttributeOptimized(FileHandle &fileHandle, const
             if(prevLen == NULL_POINT) prevLen = recordDescriptor.size()*sizeof(RT);
             memcpy((char*)&length, (char*)pageData + offset + prevLen, sizeof(int));
         }
-        memcpy((char*)data, (char*)pageData + offset + attributeOffset - length - sizeof(int), length + sizeof(int));
+        int fieldSize = getVarCharFieldSize(length);
+        memcpy((char*)data, (char*)pageData + offset + attributeOffset - fieldSize, fieldSize);
+        if(readOverflowValue(fileHandle, data) == -1) return -1;
     }
 
     return 0;
@@ -782,6 +1159,23 @@ RC RecordBasedFileManager::readAttributes(FileHandle &fileHandle, const std::vec
     if(offset == DELETED) {
         return -1;
     }
+
+    const std::vector<Attribute>& storedDescriptor = getStoredDescriptor(fileHandle.fileName, recordDescriptor,
+                                                                         getVersionOfRecordWithPage(pageData, final_rid));
+    if(usesFixedWidthFormat(fileHandle, storedDescriptor)) {
+        RT nullBytes = ceil((double)attributeNames.size()/CHAR_BIT);
+        memset((char*)data, 0, nullBytes);
+        RT dataOffset = nullBytes;
+        for(int j = 0; j < (int)attributeNames.size(); j++) {
+            if(readFixedWidthField(storedDescriptor, (char*)pageData + offset, attributeNames[j], (char*)data + dataOffset) == 0) {
+                dataOffset += sizeof(int);
+            } else {
+                *((char*)data + j/CHAR_BIT) |= (1 << (CHAR_BIT - 1 - j%CHAR_BIT));
+            }
+        }
+        return 0;
+    }
+
     if(!isSystemFile(fileHandle.fileName)) {
         RT version = getVersionOfRecordWithPage(pageData, final_rid);
         RT latestVersion = (RT)getLatestTableVersion(fileHandle.fileName);
@@ -792,6 +1186,7 @@ RC RecordBasedFileManager::readAttributes(FileHandle &fileHandle, const std::vec
             char nullBitField[nullBytes];
             memset(nullBitField, 0, nullBytes);
             RT dataOffset = nullBytes;
+            bool hasOverflow = false;
             std::unordered_set<std::string> s;
             for(RT i = 0 ; i < (RT)attributeNames.size(); i++) {
                 s.insert(attributeNames[i]);
@@ -826,8 +1221,10 @@ RC RecordBasedFileManager::readAttributes(FileHandle &fileHandle, const std::vec
                             if(prevLen == NULL_POINT) prevLen = sizeWoInval*sizeof(RT);
                             memcpy((char*)&length, (char*)pageData + offset + prevLen, sizeof(int));
                         }
-                        memcpy((char*)data + dataOffset, (char*)pageData + offset + attributeOffset - length - sizeof(int), length + sizeof(int));
-                        dataOffset += length + sizeof(int);
+                        int fieldSize = getVarCharFieldSize(length);
+                        memcpy((char*)data + dataOffset, (char*)pageData + offset + attributeOffset - fieldSize, fieldSize);
+                        dataOffset += fieldSize;
+                        if(length < 0) hasOverflow = true;
                     }
                     s.erase(attributeNames[j]);
                     j++;
@@ -841,6 +1238,7 @@ RC RecordBasedFileManager::readAttributes(FileHandle &fileHandle, const std::vec
                 nullBitField[j/CHAR_BIT] |= (1 << (CHAR_BIT - 1 - j%CHAR_BIT));
              }
             memcpy((char*)data, (char*)nullBitField, nullBytes);
+            if(hasOverflow) return readOverflowAttributes(fileHandle, recordDescriptor, attributeNames, data);
             return 0;
         }
     }
@@ -851,6 +1249,7 @@ RC RecordBasedFileManager::readAttributes(FileHandle &fileHandle, const std::vec
     char nullBitField[nullBytes];
     memset(nullBitField, 0, nullBytes);
     RT dataOffset = nullBytes;
+    bool hasOverflow = false;
     std::vector<Attribute> recordDescriptorActual = recordDescriptor;
     recordDescriptorActual.erase(std::remove_if(recordDescriptorActual.begin(), recordDescriptorActual.end(),
                        [](Attribute& a) { return a.valid ==  INVALID; }), recordDescriptorActual.end());
@@ -889,8 +1288,10 @@ RC RecordBasedFileManager::readAttributes(FileHandle &fileHandle, const std::vec
                     if(prevLen == NULL_POINT) prevLen = recordDescriptorActual.size()*sizeof(RT);
                     memcpy((char*)&length, (char*)pageData + offset + prevLen, sizeof(int));
                 }
-                memcpy((char*)data + dataOffset, (char*)pageData + offset + attributeOffset - length - sizeof(int), length + sizeof(int));
-                dataOffset += length + sizeof(int);
+                int fieldSize = getVarCharFieldSize(length);
+                memcpy((char*)data + dataOffset, (char*)pageData + offset + attributeOffset - fieldSize, fieldSize);
+                dataOffset += fieldSize;
+                if(length < 0) hasOverflow = true;
             }
             s.erase(attributeNames[j]);
             j++;
@@ -901,6 +1302,7 @@ RC RecordBasedFileManager::readAttributes(FileHandle &fileHandle, const std::vec
     }
 
     memcpy((char*)data, (char*)nullBitField, nullBytes);
+    if(hasOverflow) return readOverflowAttributes(fileHandle, recordDescriptor, attributeNames, data);
     return 0;
 }
 
@@ -966,6 +1368,332 @@ RC RecordBasedFileManager::insertUpdatedRecord(FileHandle& fileHandle,
     return 0;
 }
 
+/************************* RBFM Zone map APIs ******************************************/
+
+/**
+ * addZoneColumns() - keeps a zone map for every TypeInt and TypeReal attribute of a record descriptor.
+ * @argument1 : filehandle of the file.
+ * @argument2 : record descriptor.
+ *
+ * Called before a record is stored, so that a page appended for it starts with empty zones.
+ *
+ * Return : void.
+*/
+void RecordBasedFileManager::addZoneColumns(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor) {
+    for(auto& attr : recordDescriptor) {
+        if(attr.valid == VALID && attr.type != TypeVarChar) fileHandle.addZoneColumn(attr.name);
+    }
+}
+
+/**
+ * widenZones() - widens the zones of a page with the values of a record stored in it.
+ * @argument1 : filehandle of the file.
+ * @argument2 : record descriptor.
+ * @argument3 : record data, in the format of insertRecord().
+ * @argument4 : page where the record is stored.
+ *
+ * Return : void.
+*/
+void RecordBasedFileManager::widenZones(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor,
+                                        const void* data, const PageNum pageNum) {
+    RT nullBytes = ceil((double)recordDescriptor.size()/CHAR_BIT);
+    int dataOffset = nullBytes;
+    for(int i = 0; i < (int)recordDescriptor.size(); i++) {
+        if(*((char*)data + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) continue;
+
+        if(recordDescriptor[i].type == TypeVarChar) {
+            int length = 0;
+            memcpy((char*)&length, (char*)data + dataOffset, sizeof(int));
+            dataOffset += sizeof(int) + length;
+            continue;
+        }
+        if(recordDescriptor[i].valid == VALID) {
+            double value = 0;
+            if(recordDescriptor[i].type == TypeInt) {
+                int intValue = 0;
+                memcpy((char*)&intValue, (char*)data + dataOffset, sizeof(int));
+                value = intValue;
+            } else {
+                float realValue = 0;
+                memcpy((char*)&realValue, (char*)data + dataOffset, sizeof(float));
+                value = realValue;
+            }
+            fileHandle.widenZone(pageNum, recordDescriptor[i].name, value);
+        }
+        dataOffset += sizeof(int);
+    }
+}
+
+/**
+ * clearZonesIfEmpty() - empties the zones of a page once its last record is deleted.
+ * @argument1 : filehandle of the file.
+ * @argument2 : page number.
+ * @argument3 : buffer containing data of the page.
+ *
+ * Zones only grow while a page has records, so they may be wider than the records left in it.
+ *
+ * Return : void.
+*/
+void RecordBasedFileManager::clearZonesIfEmpty(FileHandle& fileHandle, const PageNum pageNum, void* pageData) {
+    RT dirSlotPointer = 0, recordSlotPointer = 0;
+    getDirAndRecPointers(dirSlotPointer, recordSlotPointer, pageData);
+    if(recordSlotPointer == 0) fileHandle.clearZones(pageNum);
+}
+
+/************************* RBFM Overflow page APIs ******************************************/
+
+/**
+ * storeOverflowFields() - moves the large VarChars of a record to overflow pages.
+ * @argument1 : filehandle of the file.
+ * @argument2 : record descriptor.
+ * @argument3 : record data, in the format of insertRecord().
+ *
+ * Every VarChar longer than OVERFLOW_THRESHOLD is written to its own chain of overflow pages and
+ * replaced in the record by its negated length followed by the first page of the chain.
+ *
+ * Return : new record data to be freed by the caller, NULL if the record has no large VarChar.
+*/
+void* RecordBasedFileManager::storeOverflowFields(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor,
+                                                  const void* data) {
+    RT nullBytes = ceil((double)recordDescriptor.size()/CHAR_BIT);
+    int recordSize = nullBytes;
+    bool hasLargeField = false;
+    for(int i = 0; i < (int)recordDescriptor.size(); i++) {
+        if(*((char*)data + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) continue;
+        if(recordDescriptor[i].type != TypeVarChar) {
+            recordSize += sizeof(int);
+            continue;
+        }
+        int length = 0;
+        memcpy((char*)&length, (char*)data + recordSize, sizeof(int));
+        if(length > OVERFLOW_THRESHOLD) hasLargeField = true;
+        recordSize += getVarCharFieldSize(length);
+    }
+
+    if(!hasLargeField) return NULL;
+
+    void* rowData = malloc(recordSize);
+    memcpy((char*)rowData, (char*)data, nullBytes);
+    int dataOffset = nullBytes, rowOffset = nullBytes;
+    for(int i = 0; i < (int)recordDescriptor.size(); i++) {
+        if(*((char*)data + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) continue;
+        int fieldSize = sizeof(int);
+        if(recordDescriptor[i].type == TypeVarChar) {
+            int length = 0;
+            memcpy((char*)&length, (char*)data + dataOffset, sizeof(int));
+            fieldSize = getVarCharFieldSize(length);
+            if(length > OVERFLOW_THRESHOLD) {
+                PageNum pageNum = writeOverflowChain(fileHandle, (char*)data + dataOffset + sizeof(int), length);
+                int storedLength = -length;
+                memcpy((char*)rowData + rowOffset, (char*)&storedLength, sizeof(int));
+                memcpy((char*)rowData + rowOffset + sizeof(int), (char*)&pageNum, sizeof(int));
+                dataOffset += fieldSize;
+                rowOffset += 2*sizeof(int);
+                continue;
+            }
+        }
+        memcpy((char*)rowData + rowOffset, (char*)data + dataOffset, fieldSize);
+        dataOffset += fieldSize;
+        rowOffset += fieldSize;
+    }
+
+    return rowData;
+}
+
+/**
+ * writeOverflowChain() - appends a chain of overflow pages holding a value.
+ * @argument1 : filehandle of the file.
+ * @argument2 : value to be stored.
+ * @argument3 : length of the value in bytes.
+ *
+ * Overflow pages have no slot and no free space, so neither the scans nor the inserts use them.
+ *
+ * Return : first page of the chain.
+*/
+PageNum RecordBasedFileManager::writeOverflowChain(FileHandle& fileHandle, const void* value, const int length) {
+    char pageData[PAGE_SIZE];
+    PageNum firstPage = fileHandle.getNumberOfPages();
+    RT dirSlotPointer = PAGE_SIZE - 3*sizeof(RT);
+    RT freeSlots = OVERFLOW_PAGE;
+    int written = 0;
+    while(written < length) {
+        PageNum pageNum = fileHandle.getNumberOfPages();
+        RT chunkSize = std::min(length - written, (int)OVERFLOW_CHUNK_SIZE);
+        PageNum nextPage = written + chunkSize < length ? pageNum + 1 : OVERFLOW_CHAIN_END;
+
+        memset(pageData, 0, PAGE_SIZE);
+        memcpy(pageData, (char*)&nextPage, sizeof(int));
+        memcpy(pageData + sizeof(int), (char*)&chunkSize, sizeof(RT));
+        memcpy(pageData + sizeof(int) + sizeof(RT), (char*)value + written, chunkSize);
+        memcpy(pageData + PAGE_SIZE - sizeof(RT), (char*)&dirSlotPointer, sizeof(RT));
+        memcpy(pageData + PAGE_SIZE - 2*sizeof(RT), (char*)&dirSlotPointer, sizeof(RT));
+        memcpy(pageData + PAGE_SIZE - 3*sizeof(RT), (char*)&freeSlots, sizeof(RT));
+
+        fileHandle.appendPage(pageData);
+        fileHandle.updateFreeSpaceForPage(pageNum, pageData);
+        written += chunkSize;
+    }
+    return firstPage;
+}
+
+/**
+ * readOverflowChain() - reads a value stored in a chain of overflow pages.
+ * @argument1 : filehandle of the file.
+ * @argument2 : first page of the chain.
+ * @argument3 : length of the value in bytes.
+ * @argument4 : buffer receiving the value (out parameter).
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::readOverflowChain(FileHandle& fileHandle, PageNum pageNum, const int length, void* value) {
+    char pageData[PAGE_SIZE];
+    int read = 0;
+    while(pageNum != OVERFLOW_CHAIN_END && read < length) {
+        if(fileHandle.readPage(pageNum, pageData) == -1) return -1;
+        RT chunkSize = 0;
+        memcpy((char*)&chunkSize, pageData + sizeof(int), sizeof(RT));
+        memcpy((char*)value + read, pageData + sizeof(int) + sizeof(RT), chunkSize);
+        read += chunkSize;
+        memcpy((char*)&pageNum, pageData, sizeof(int));
+    }
+    return read == length ? 0 : -1;
+}
+
+/**
+ * freeOverflowChain() - releases the pages of an overflow chain.
+ * @argument1 : filehandle of the file.
+ * @argument2 : first page of the chain.
+ *
+ * The pages become empty record pages, reused by later inserts.
+ *
+ * Return : void.
+*/
+void RecordBasedFileManager::freeOverflowChain(FileHandle& fileHandle, PageNum pageNum) {
+    char pageData[PAGE_SIZE];
+    while(pageNum != OVERFLOW_CHAIN_END) {
+        if(fileHandle.readPage(pageNum, pageData) == -1) return;
+        PageNum nextPage = OVERFLOW_CHAIN_END;
+        memcpy((char*)&nextPage, pageData, sizeof(int));
+        memset(pageData, 0, PAGE_SIZE);
+        fileHandle.initPageDirectory(pageData);
+        fileHandle.writePage(pageNum, pageData);
+        pageNum = nextPage;
+    }
+}
+
+/**
+ * readOverflowValue() - replaces an overflow pointer by the value it points to.
+ * @argument1 : filehandle of the file.
+ * @argument2 : VarChar field, the buffer must be large enough for the value (in/out parameter).
+ *
+ * Fields stored in the record are left as they are.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::readOverflowValue(FileHandle& fileHandle, void* field) {
+    int length = 0;
+    memcpy((char*)&length, (char*)field, sizeof(int));
+    if(length >= 0) return 0;
+
+    PageNum pageNum = 0;
+    memcpy((char*)&pageNum, (char*)field + sizeof(int), sizeof(int));
+    length = -length;
+    memcpy((char*)field, (char*)&length, sizeof(int));
+    return readOverflowChain(fileHandle, pageNum, length, (char*)field + sizeof(int));
+}
+
+/**
+ * readOverflowFields() - reads the large VarChars of a record from their overflow pages.
+ * @argument1 : filehandle of the file.
+ * @argument2 : descriptor of the fields in the record.
+ * @argument3 : record, in the format of readRecord(), with overflow pointers (in/out parameter).
+ *
+ * Fields behind an overflow value are shifted to make room for it, the buffer must be large enough
+ * for the whole record.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::readOverflowFields(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor,
+                                              void* data) {
+    RT nullBytes = ceil((double)recordDescriptor.size()/CHAR_BIT);
+    int recordSize = nullBytes;
+    bool hasOverflow = false;
+    for(int i = 0; i < (int)recordDescriptor.size(); i++) {
+        if(*((char*)data + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) continue;
+        if(recordDescriptor[i].type != TypeVarChar) {
+            recordSize += sizeof(int);
+            continue;
+        }
+        int length = 0;
+        memcpy((char*)&length, (char*)data + recordSize, sizeof(int));
+        if(length < 0) hasOverflow = true;
+        recordSize += getVarCharFieldSize(length);
+    }
+
+    if(!hasOverflow) return 0;
+
+    int dataOffset = nullBytes;
+    for(int i = 0; i < (int)recordDescriptor.size(); i++) {
+        if(*((char*)data + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) continue;
+        if(recordDescriptor[i].type != TypeVarChar) {
+            dataOffset += sizeof(int);
+            continue;
+        }
+        int length = 0;
+        memcpy((char*)&length, (char*)data + dataOffset, sizeof(int));
+        if(length < 0) {
+            int pointerEnd = dataOffset + 2*sizeof(int);
+            memmove((char*)data + dataOffset + sizeof(int) - length, (char*)data + pointerEnd, recordSize - pointerEnd);
+            recordSize += -length - sizeof(int);
+            if(readOverflowValue(fileHandle, (char*)data + dataOffset) == -1) return -1;
+            length = -length;
+        }
+        dataOffset += sizeof(int) + length;
+    }
+    return 0;
+}
+
+/**
+ * readOverflowAttributes() - reads the large VarChars of projected attributes from their overflow pages.
+ * @argument1 : filehandle of the file.
+ * @argument2 : record descriptor.
+ * @argument3 : names of the projected attributes.
+ * @argument4 : projected attributes, in the format of readAttributes() (in/out parameter).
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RecordBasedFileManager::readOverflowAttributes(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor,
+                                                  const std::vector<std::string>& attributeNames, void* data) {
+    std::vector<Attribute> projectedDescriptor;
+    for(auto name : attributeNames) {
+        for(auto attr : recordDescriptor) {
+            if(attr.name == name) {
+                projectedDescriptor.push_back(attr);
+                break;
+            }
+        }
+    }
+    if(projectedDescriptor.size() != attributeNames.size()) return -1;
+    return readOverflowFields(fileHandle, projectedDescriptor, data);
+}
+
+/**
+ * getStoredDescriptor() - descriptor of the fields physically stored in a record.
+ * @argument1 : name of the file.
+ * @argument2 : record descriptor given by the caller.
+ * @argument3 : version of the record.
+ *
+ * Rows of a table are stored with the valid columns of their version, other files with the given descriptor.
+ *
+ * Return : vector of attribute.
+*/
+const std::vector<Attribute>& RecordBasedFileManager::getStoredDescriptor(const std::string& fileName,
+                                                                          const std::vector<Attribute>& recordDescriptor,
+                                                                          const RT version) {
+    if(isSystemFile(fileName) || columnsMap.find(fileName) == columnsMap.end()) return recordDescriptor;
+    return getVersionProjection(fileName, version).storedDescriptor;
+}
+
 /************************* RBFM Version control APIs *******************************************
 
 /**
@@ -1060,6 +1788,46 @@ vector<Attribute> RecordBasedFileManager::getAttributesForVersion(const std::str
     return columnsMap[tableName][version].recordDescriptor;
 }
 
+/**
+ * getVersionProjection() - get the cached translation of a version (or schema) to the latest version.
+ * @argument1 : name of the table.
+ * @argument2 : version (or schema) number the record was written with.
+ *
+ * Rows are stored with the valid columns of their version. Dropped columns keep their position in
+ * later versions and added columns are appended, so a column is matched by its position. The projection
+ * is rebuilt only when the latest version of the table changes.
+ *
+ * Return : projection for the version, with empty descriptors if the table is unknown.
+*/
+const VersionProjection& RecordBasedFileManager::getVersionProjection(const std::string& tableName, const int version) {
+    int latestVersion = getLatestTableVersion(tableName);
+    VersionProjection& projection = projectionCache[tableName][version];
+    if(projection.latestVersion == latestVersion) return projection;
+
+    std::vector<Attribute> recordDesc = getAttributesForVersion(tableName, version);
+    std::vector<Attribute> recordDescLatest = getAttributesForVersion(tableName, latestVersion);
+
+    projection.latestVersion = latestVersion;
+    projection.storedDescriptor.clear();
+    projection.latestDescriptor.clear();
+    projection.latestToStored.clear();
+
+    std::vector<int> storedPos(recordDesc.size(), -1);
+    for(int i = 0; i < (int)recordDesc.size(); i++) {
+        if(recordDesc[i].valid == INVALID) continue;
+        storedPos[i] = projection.storedDescriptor.size();
+        projection.storedDescriptor.push_back(recordDesc[i]);
+    }
+
+    for(int i = 0; i < (int)recordDescLatest.size(); i++) {
+        if(recordDescLatest[i].valid == INVALID) continue;
+        projection.latestDescriptor.push_back(recordDescLatest[i]);
+        projection.latestToStored.push_back(i < (int)storedPos.size() ? storedPos[i] : -1);
+    }
+
+    return projection;
+}
+
 /**
  * isSystemFile() - check if is a system file.
  * @argument1 : filename to be looked
@@ -1075,14 +1843,21 @@ bool RecordBasedFileManager::isSystemFile(const std::string& fileName) {
 /**
  * getDataSizeWithoutNullBytes() - get the size of the data without the null bytes.
  * @argument1 : record descriptor
- * @argument2 : data
+ * @argument2 : true if the record is stored in the fixed width format, see usesFixedWidthFormat().
+ * @argument3 : data
  * 
- * Enforces the minimum record size ( = MIN_RECORD_SIZE).
+ * Enforces the minimum record size ( = MIN_RECORD_SIZE). Fixed width records keep their null bytes
+ * and the space of their null fields.
  *
  * Return : 0.
 */
-RT getDataSizeWithoutNullBytes(const std::vector<Attribute>& recordDesc, const void* data) {
+RT getDataSizeWithoutNullBytes(const std::vector<Attribute>& recordDesc, const bool fixedWidth, const void* data) {
     RT nullBytes = ceil((double)recordDesc.size()/CHAR_BIT);
+    if(fixedWidth) {
+        RT size = nullBytes + recordDesc.size()*sizeof(int);
+        return MIN_RECORD_SIZE > size ? MIN_RECORD_SIZE : size;
+    }
+
     char nullField[nullBytes];
     memset(nullField, 0 , nullBytes);
     memcpy(nullField, (char*)data, nullBytes);
@@ -1097,7 +1872,7 @@ RT getDataSizeWithoutNullBytes(const std::vector<Attribute>& recordDesc, const v
             else {
                 int varcharlen = 0;
                 memcpy(&varcharlen,(char*)data + recordSize, sizeof(int));
-                recordSize += sizeof(int) + (RT)varcharlen;
+                recordSize += (RT)getVarCharFieldSize(varcharlen);
             }
         }
     }
@@ -1170,6 +1945,155 @@ RT getOffsetAndSizeFromRID(FileHandle& fileHandle, const RID& rid, RT& formatted
     return offset;
 }
 
+/**
+ * getFieldBoundsInRecord() - start and end offsets of every field of a stored record.
+ * @argument1 : page data where the record is stored.
+ * @argument2 : offset of the record in the page.
+ * @argument3 : descriptor of the fields stored in the record.
+ * @argument4 : true if the record is stored in the fixed width format, see usesFixedWidthFormat().
+ * @argument5 : start offset of each field relative to the record (out parameter).
+ * @argument6 : end offset of each field relative to the record, NULL_POINT for null fields (out parameter).
+ *
+ * Return : void.
+*/
+void getFieldBoundsInRecord(const void* pageData, RT offset, const std::vector<Attribute>& storedDesc,
+                            const bool fixedWidth, RT* start, RT* end) {
+    RT fieldCount = storedDesc.size();
+    if(fixedWidth) {
+        for(RT i = 0; i < fieldCount; i++) {
+            start[i] = getFixedWidthFieldOffset(storedDesc, i);
+            end[i] = start[i] + sizeof(int);
+            if(*((char*)pageData + offset + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) end[i] = NULL_POINT;
+        }
+        return;
+    }
+
+    RT prevEnd = fieldCount*sizeof(RT);
+    for(RT i = 0; i < fieldCount; i++) {
+        memcpy((char*)&end[i], (char*)pageData + offset + i*sizeof(RT), sizeof(RT));
+        start[i] = prevEnd;
+        if(end[i] != NULL_POINT) prevEnd = end[i];
+    }
+}
+
+/**
+ * isFixedWidthDescriptor() - checks if the records of a descriptor use the fixed width format.
+ * @argument1 : descriptor of the fields stored in the record.
+ *
+ * Records made only of TypeInt and TypeReal fields are stored as their null bytes followed by every
+ * field, null fields included. Field i always sits at the same offset, so there is no offset table
+ * and fields are read without walking the record. Only files created with the format store them
+ * so, see usesFixedWidthFormat().
+ *
+ * Return : true if fixed width, false otherwise.
+*/
+bool isFixedWidthDescriptor(const std::vector<Attribute>& recordDesc) {
+    if(recordDesc.size() == 0) return false;
+    for(auto& attr : recordDesc) {
+        if(attr.type == TypeVarChar) return false;
+    }
+    return true;
+}
+
+/**
+ * usesFixedWidthFormat() - checks if the records of a descriptor are stored in the fixed width format in a file.
+ * @argument1 : filehandle of the file.
+ * @argument2 : descriptor of the fields stored in the record.
+ *
+ * The header pages of the files created with the format carry FIXED_WIDTH_MARKER. Files written
+ * before it keep the field offset table in every record, whatever the types of the fields.
+ *
+ * Return : true if fixed width, false otherwise.
+*/
+bool usesFixedWidthFormat(FileHandle& fileHandle, const std::vector<Attribute>& storedDesc) {
+    return fileHandle.hasFixedWidthRecords() && isFixedWidthDescriptor(storedDesc);
+}
+
+/**
+ * getFixedWidthFieldOffset() - offset of a field in a fixed width record.
+ * @argument1 : descriptor of the fields stored in the record.
+ * @argument2 : position of the field in the descriptor.
+ *
+ * Return : offset relative to the record.
+*/
+RT getFixedWidthFieldOffset(const std::vector<Attribute>& recordDesc, const int fieldNum) {
+    RT nullBytes = ceil((double)recordDesc.size()/CHAR_BIT);
+    return nullBytes + fieldNum*sizeof(int);
+}
+
+/**
+ * readFixedWidthField() - reads a field of a fixed width record.
+ * @argument1 : descriptor of the fields stored in the record.
+ * @argument2 : record.
+ * @argument3 : name of the field.
+ * @argument4 : buffer receiving the value (out parameter).
+ *
+ * Return : 0 on success, NULL_POINT if the field is null, -1 if the record has no such field.
+*/
+RC readFixedWidthField(const std::vector<Attribute>& storedDesc, const void* record,
+                       const std::string& attributeName, void* data) {
+    for(int i = 0; i < (int)storedDesc.size(); i++) {
+        if(storedDesc[i].name != attributeName) continue;
+        if(*((char*)record + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) return NULL_POINT;
+        memcpy((char*)data, (char*)record + getFixedWidthFieldOffset(storedDesc, i), sizeof(int));
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * getVarCharFieldSize() - size of a VarChar field in a record.
+ * @argument1 : length stored in front of the field, negated for values in overflow pages.
+ *
+ * Return : length and characters, or length and first overflow page.
+*/
+int getVarCharFieldSize(const int storedLength) {
+    if(storedLength < 0) return 2*sizeof(int);
+    return sizeof(int) + storedLength;
+}
+
+/**
+ * getMaxRecordSize() - largest record of a descriptor, in the format of readRecord().
+ * @argument1 : record descriptor.
+ *
+ * Used to size the buffers of reads that may return values stored in overflow pages.
+ *
+ * Return : size in bytes.
+*/
+int getMaxRecordSize(const std::vector<Attribute>& recordDesc) {
+    int size = ceil((double)recordDesc.size()/CHAR_BIT);
+    for(auto attr : recordDesc) {
+        size += sizeof(int);
+        if(attr.type == TypeVarChar) size += attr.length;
+    }
+    return size;
+}
+
+/**
+ * getOverflowPagesInRecord() - first pages of the overflow chains referenced by a stored record.
+ * @argument1 : descriptor of the fields stored in the record.
+ * @argument2 : record, with its field offset table.
+ * @argument3 : first page of every chain (out parameter).
+ *
+ * Return : void.
+*/
+void getOverflowPagesInRecord(const std::vector<Attribute>& storedDesc, const void* record, std::vector<PageNum>& pages) {
+    // no VarChar, no overflow chain
+    if(isFixedWidthDescriptor(storedDesc)) return;
+    RT fieldCount = storedDesc.size();
+    RT start[fieldCount], end[fieldCount];
+    getFieldBoundsInRecord(record, 0, storedDesc, false, start, end);
+    for(RT i = 0; i < fieldCount; i++) {
+        if(storedDesc[i].type != TypeVarChar || end[i] == NULL_POINT) continue;
+        int length = 0;
+        memcpy((char*)&length, (char*)record + start[i], sizeof(int));
+        if(length >= 0) continue;
+        PageNum pageNum = 0;
+        memcpy((char*)&pageNum, (char*)record + start[i] + sizeof(int), sizeof(int));
+        pages.push_back(pageNum);
+    }
+}
+
 /**
  * addEntryToPageDirectory() - adds a new entry to the page, can use an existing slot
  * @argument1 : pagenum where the entry is to be added. 
@@ -1328,21 +2252,36 @@ RC moveRecordsByOffset(RT startOffset, RT moveOffset, RT direction,
 /**
  * formatDataForReading() - formats the data for inserting into file (adds field offset in front).
  * @argument1 : record descriptor.
- * @argument2 : buffer containing the data to be formatted.
- * @argument3 : passed by ref. the size of the returned formatted data.
+ * @argument2 : true to store the record in the fixed width format, see usesFixedWidthFormat().
+ * @argument3 : buffer containing the data to be formatted.
+ * @argument4 : passed by ref. the size of the returned formatted data.
  *
  *
- * Used to input data ( or insert operation).
+ * Used to input data ( or insert operation). Fixed width records keep their null bytes instead of
+ * the offset table, see isFixedWidthDescriptor().
  *
  * Return : buffer which will contain the record after formatting.
 */
-void* formatDataForStoring(const std::vector<Attribute>& recordDesc, const void* data, RT& formattedDataSize) {
+void* formatDataForStoring(const std::vector<Attribute>& recordDesc, const bool fixedWidth, const void* data,
+                           RT& formattedDataSize) {
     //stores the end of each field in the offset table
-    RT size = getDataSizeWithoutNullBytes(recordDesc, data);
+    RT size = getDataSizeWithoutNullBytes(recordDesc, fixedWidth, data);
     formattedDataSize = size;
     void* formattedData = malloc(formattedDataSize);
     memset(formattedData, 0, formattedDataSize);
     RT nullBytes = ceil((double)recordDesc.size()/CHAR_BIT);
+
+    if(fixedWidth) {
+        memcpy((char*)formattedData, (char*)data, nullBytes);
+        RT dataOffset = nullBytes;
+        for(int i = 0; i < (int)recordDesc.size(); i++) {
+            if(*((char*)data + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) continue;
+            memcpy((char*)formattedData + getFixedWidthFieldOffset(recordDesc, i), (char*)data + dataOffset, sizeof(int));
+            dataOffset += sizeof(int);
+        }
+        return formattedData;
+    }
+
     char nullfield[nullBytes];
     memset(nullfield, 0, nullBytes);
     memcpy(nullfield, (char*)data, nullBytes);
@@ -1370,9 +2309,10 @@ void* formatDataForStoring(const std::vector<Attribute>& recordDesc, const void*
             } else {
                 int varcharlen = 0;
                 memcpy(&varcharlen,(char*)data + recordSize, sizeof(int));
-                memcpy((char*)formattedData + totaloffset , (char*)data + recordSize, varcharlen + sizeof(int));
-                totaloffset += sizeof(int) + varcharlen;
-                recordSize += sizeof(int) + varcharlen;
+                RT fieldSize = (RT)getVarCharFieldSize(varcharlen);
+                memcpy((char*)formattedData + totaloffset , (char*)data + recordSize, fieldSize);
+                totaloffset += fieldSize;
+                recordSize += fieldSize;
                 memcpy((char*)formattedData + i*sizeof(RT), &totaloffset, sizeof(RT));
             }
         }
@@ -1386,19 +2326,32 @@ void* formatDataForStoring(const std::vector<Attribute>& recordDesc, const void*
  * @argument1 : offset at which the data is stored.
  * @argument2 : formatted data size.
  * @argument3 : record descriptor.
- * @argument4 : buffer containing the page data in which the record is stored.
- * @argument5 : buffer which will contain the record after formatting for reading.
+ * @argument4 : true if the record is stored in the fixed width format, see usesFixedWidthFormat().
+ * @argument5 : buffer containing the page data in which the record is stored.
+ * @argument6 : buffer which will contain the record after formatting for reading.
  *
  *
  * Used to read operation, field offset table is removed and null bytes are added in front.
+ * Null fields of fixed width records are skipped.
  *
- * Return : @argument 5
+ * Return : @argument 6
 */
 void formatDataForReading(RT offset, RT formattedDataSize,
-                          const std::vector<Attribute>& recordDescriptor,
+                          const std::vector<Attribute>& recordDescriptor, const bool fixedWidth,
                           void* pageData, void* data) {
 
     RT nullBytes = ceil((double)recordDescriptor.size()/CHAR_BIT);
+    if(fixedWidth) {
+        memcpy((char*)data, (char*)pageData + offset, nullBytes);
+        RT dataOffset = nullBytes;
+        for(int i = 0; i < (int)recordDescriptor.size(); i++) {
+            if(*((char*)data + i/CHAR_BIT) & (1 << (CHAR_BIT - 1 - i%CHAR_BIT))) continue;
+            memcpy((char*)data + dataOffset, (char*)pageData + offset + getFixedWidthFieldOffset(recordDescriptor, i), sizeof(int));
+            dataOffset += sizeof(int);
+        }
+        return;
+    }
+
     void* attrOffsets = malloc(recordDescriptor.size()*sizeof(RT));
     //special case when record size was less than the minimum required record size
     if(formattedDataSize == MIN_RECORD_SIZE) {
@@ -1429,6 +2382,39 @@ void formatDataForReading(RT offset, RT formattedDataSize,
     return;
 }
 
+/**
+ * formatDataWithProjection() - formats a stored record in the latest schema of its table.
+ * @argument1 : offset at which the record is stored.
+ * @argument2 : projection of the version the record was written with.
+ * @argument3 : true if the record is stored in the fixed width format, see usesFixedWidthFormat().
+ * @argument4 : buffer containing the page data in which the record is stored.
+ * @argument5 : buffer which will contain the record after formatting for reading.
+ *
+ * Fields are copied straight from the page, columns missing from the stored version are set to NULL.
+ *
+ * Return : @argument 5
+*/
+void formatDataWithProjection(RT offset, const VersionProjection& projection, const bool fixedWidth,
+                              const void* pageData, void* data) {
+    RT fieldCount = projection.storedDescriptor.size();
+    RT start[fieldCount], end[fieldCount];
+    getFieldBoundsInRecord(pageData, offset, projection.storedDescriptor, fixedWidth, start, end);
+
+    RT latestCount = projection.latestToStored.size();
+    RT nullBytes = ceil((double)latestCount/CHAR_BIT);
+    memset((char*)data, 0, nullBytes);
+    RT dataOffset = nullBytes;
+    for(RT j = 0; j < latestCount; j++) {
+        int pos = projection.latestToStored[j];
+        if(pos == -1 || end[pos] == NULL_POINT) {
+            *((char*)data + j/CHAR_BIT) |= (1 << (CHAR_BIT - 1 - j%CHAR_BIT));
+            continue;
+        }
+        memcpy((char*)data + dataOffset, (char*)pageData + offset + start[pos], end[pos] - start[pos]);
+        dataOffset += end[pos] - start[pos];
+    }
+}
+
 /**
  * generateNullBitField() - given a record descriptor and formatted data generate the null bytes.
  * @argument1 : record descriptor.
@@ -1485,6 +2471,7 @@ void storeDataInFile(FileHandle& fileHandle,
     if(freePage == fileHandle.getNumberOfPages()) {
         fileHandle.appendPage(pageData);
         fileHandle.updateFreeSpaceForPage(freePage, pageData);
+        fileHandle.clearZones(freePage);
         return;
     }
     fileHandle.writePage(freePage, pageData);
@@ -19,6 +19,16 @@ const int INVAL_TYPE = -1;
 const int VALID = -15;
 const int INVALID = -16;
 
+// VarChars longer than OVERFLOW_THRESHOLD bytes are stored in a chain of overflow pages, the record only
+// keeps the negated length and the first page of the chain. An overflow page starts with the next page
+// of the chain (OVERFLOW_CHAIN_END for the last one) and the number of bytes it holds.
+const int OVERFLOW_THRESHOLD = 1024;
+const int OVERFLOW_CHAIN_END = -1;
+const RT OVERFLOW_CHUNK_SIZE = PAGE_SIZE - 4*sizeof(RT) - sizeof(int);
+
+// Records made only of TypeInt and TypeReal fields use a fixed width format in the files created with it,
+// see usesFixedWidthFormat().
+
 // Record ID
 struct RID {
     int pageNum;    // page number
@@ -76,6 +86,18 @@ struct TablesTableInfo {
     }
 };
 
+// Precomputed translation of rows stored with an older schema version into the latest schema.
+struct VersionProjection {
+    int latestVersion;                          // latest version this projection was built against.
+    std::vector<Attribute> storedDescriptor;    // columns physically stored in rows of the version.
+    std::vector<Attribute> latestDescriptor;    // valid columns of the latest version.
+    std::vector<int> latestToStored;            // position in storedDescriptor of each latest column, -1 if absent.
+
+    VersionProjection() {
+        latestVersion = -1;
+    }
+};
+
 // Comparison Operator (NOT needed for part 1 of the project)
 typedef enum {
     EQ_OP = 0, // no condition// =
@@ -106,7 +128,7 @@ typedef enum {
 //Utility functions
 
 // Record information retreival helpers
-RT getDataSizeWithoutNullBytes(const std::vector<Attribute>& recordDesc, const void* data);
+RT getDataSizeWithoutNullBytes(const std::vector<Attribute>& recordDesc, const bool fixedWidth, const void* data);
 
 void getDirAndRecPointers(RT& dirSlotPointer, RT& recordSlotPointer, void* pageData);
 
@@ -115,6 +137,24 @@ RT getOffsetAndSizeFromRID(FileHandle& fileHandle, const RID& rid, RT& formatted
 
 RT getFreeSlotInPage(const RT dirSlotPointer, const void* pageData, bool& existingSlot);
 
+int getVarCharFieldSize(const int storedLength);
+
+int getMaxRecordSize(const std::vector<Attribute>& recordDesc);
+
+void getOverflowPagesInRecord(const std::vector<Attribute>& storedDesc, const void* record, std::vector<PageNum>& pages);
+
+void getFieldBoundsInRecord(const void* pageData, RT offset, const std::vector<Attribute>& storedDesc,
+                            const bool fixedWidth, RT* start, RT* end);
+
+bool isFixedWidthDescriptor(const std::vector<Attribute>& recordDesc);
+
+bool usesFixedWidthFormat(FileHandle& fileHandle, const std::vector<Attribute>& storedDesc);
+
+RT getFixedWidthFieldOffset(const std::vector<Attribute>& recordDesc, const int fieldNum);
+
+RC readFixedWidthField(const std::vector<Attribute>& storedDesc, const void* record,
+                       const std::string& attributeName, void* data);
+
 bool isValidRID(const RID& nextRID, const void* data);
 
 //Page directory handlers
@@ -131,12 +171,16 @@ RC updatePageDirectoryByOffset(RT startOffset, RT moveOffset, RT dirSlotPointer,
 RC moveRecordsByOffset(RT startOffset, RT moveOffset, RT direction, RT slotNum, RT offset, RT recordSize,
                        RT update_flag, void* pageData);
 
-void* formatDataForStoring(const std::vector<Attribute>& recordDesc, const void* data, RT& formattedDataSize);
+void* formatDataForStoring(const std::vector<Attribute>& recordDesc, const bool fixedWidth, const void* data,
+                           RT& formattedDataSize);
 
 void formatDataForReading(RT offset, RT formattedDataSize,
-                          const std::vector<Attribute>& recordDescriptor,
+                          const std::vector<Attribute>& recordDescriptor, const bool fixedWidth,
                           void* pageData, void* data); 
 
+void formatDataWithProjection(RT offset, const VersionProjection& projection, const bool fixedWidth,
+                              const void* pageData, void* data);
+
 void* generateNullBitField (const std::vector<Attribute>& recordDesc, const void* data);
 
 void storeDataInFile(FileHandle& fileHandle, PageNum freePage, RT offset, 
@@ -162,6 +206,7 @@ private:
     void* compValue;
     CompOp compOp;
     AttrType type;
+    AttrLength length;
     RID currentRID;
     std::vector<Attribute> recordDescriptor;
     std::vector<std::string> attributeNames;
@@ -181,6 +226,7 @@ public:
 
     RID getNextValidRID(RID currentRID, void* data);
     bool recordComparison(const RID& rid, void* data);
+    bool zoneExcludesPage(const int pageNum);
 
     // Never keep the results in the memory. When getNextRecord() is called,
     // a satisfying record needs to be fetched from the file.
@@ -194,9 +240,37 @@ class RecordBasedFileManager {
 private:
     RC insertUpdatedRecord(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor,
                            const void* newData, const RT recordSize, RID& newRid, const int version);
+
+    // Overflow pages for large VarChars.
+    void* storeOverflowFields(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor, const void* data);
+
+    PageNum writeOverflowChain(FileHandle& fileHandle, const void* value, const int length);
+
+    RC readOverflowChain(FileHandle& fileHandle, PageNum pageNum, const int length, void* value);
+
+    void freeOverflowChain(FileHandle& fileHandle, PageNum pageNum);
+
+    RC readOverflowValue(FileHandle& fileHandle, void* field);
+
+    RC readOverflowFields(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor, void* data);
+
+    RC readOverflowAttributes(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor,
+                              const std::vector<std::string>& attributeNames, void* data);
+
+    const std::vector<Attribute>& getStoredDescriptor(const std::string& fileName,
+                                                      const std::vector<Attribute>& recordDescriptor, const RT version);
+
+    // Zone maps (per page min/max of the TypeInt and TypeReal columns) kept in the file handle.
+    void addZoneColumns(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor);
+
+    void widenZones(FileHandle& fileHandle, const std::vector<Attribute>& recordDescriptor, const void* data,
+                    const PageNum pageNum);
+
+    void clearZonesIfEmpty(FileHandle& fileHandle, const PageNum pageNum, void* pageData);
 public:
     std::unordered_map<std::string, std::unordered_map<int, ColumnTableInfo>> columnsMap;
     std::unordered_map<std::string, TablesTableInfo> tableMap;
+    std::unordered_map<std::string, std::unordered_map<int, VersionProjection>> projectionCache;
 
     static RecordBasedFileManager &instance();                          // Access to the _rbf_manager instance
 
@@ -204,6 +278,8 @@ public:
 
     RC destroyFile(const std::string &fileName);                        // Destroy a record-based file
 
+    RC renameFile(const std::string &fileName, const std::string &newFileName); // Rename a closed record-based file
+
     RC openFile(const std::string &fileName, FileHandle &fileHandle);   // Open a record-based file
 
     RC closeFile(FileHandle &fileHandle);                               // Close a record-based file
@@ -227,6 +303,10 @@ public:
     RC insertRecord(FileHandle &fileHandle, const std::vector<Attribute> &recordDescriptor, 
                     const void *data, RID &rid);
 
+    // Insert a record into the last page of a file, never reusing free space of earlier pages.
+    RC appendRecord(FileHandle &fileHandle, const std::vector<Attribute> &recordDescriptor,
+                    const void *data, RID &rid);
+
     // Read a record identified by the given rid.
     RC readRecord(FileHandle &fileHandle, const std::vector<Attribute> &recordDescriptor, 
                   const RID &rid, void *data);
@@ -261,6 +341,20 @@ public:
     RC readAttributes(FileHandle &fileHandle, const std::vector<Attribute> &recordDescriptor, const RID &rid,
                       const std::vector<std::string> &attributeNames, void *data, void* pageData);
 
+    // Single page fetch reads of a table record, rows of older versions are returned in the latest schema.
+    RC readRecordWithLatestSchema(FileHandle &fileHandle, const RID &rid, void *data, const bool readOverflow = true);
+
+    // Reads a batch of records fetching each of their pages once, record i goes to data + i*recordSize.
+    RC readRecordsWithLatestSchema(FileHandle &fileHandle, const std::vector<RID> &rids, void *data,
+                                   const int recordSize);
+
+    RC readAttributeWithLatestSchema(FileHandle &fileHandle, const RID &rid,
+                                     const std::string &attributeName, void *data);
+
+    // Rewrites a batch of records of older versions in the latest version, in place.
+    RC migrateRecords(FileHandle &fileHandle, RID &cursor, const unsigned batchSize,
+                      unsigned &migrated, unsigned &skipped);
+
     // Scan returns an iterator to allow the caller to go through the results one by one.
     RC scan(FileHandle &fileHandle,
             const std::vector<Attribute> &recordDescriptor,
@@ -281,6 +375,8 @@ public:
 
     vector<Attribute> getAttributesForVersion(const std::string& tableName, const int version);
 
+    const VersionProjection& getVersionProjection(const std::string& tableName, const int version);
+
     RC getLatestTableVersion(const std::string& tableName);
 
     bool isSystemFile(const std::string& fileName);
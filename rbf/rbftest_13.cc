@@ -0,0 +1,206 @@
+#include "pfm.h"
+#include "rbfm.h"
+#include "test_util.h"
+
+const int MAX_DOC_LENGTH = 20000;
+
+void createOverflowRecordDescriptor(std::vector<Attribute> &recordDescriptor) {
+    Attribute attr;
+    attr.name = "Id";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    recordDescriptor.push_back(attr);
+
+    attr.name = "Doc";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength) MAX_DOC_LENGTH;
+    recordDescriptor.push_back(attr);
+
+    attr.name = "Note";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength) 100;
+    recordDescriptor.push_back(attr);
+}
+
+// Record (Id, Doc, Note), a negative docLength makes Doc NULL.
+int prepareOverflowRecord(const int id, const int docLength, const std::string &note, void *buffer) {
+    int offset = 1;
+    unsigned char nullsIndicator = docLength < 0 ? (1 << 6) : 0;
+    memcpy((char *) buffer, &nullsIndicator, 1);
+    memcpy((char *) buffer + offset, &id, sizeof(int));
+    offset += sizeof(int);
+    if (docLength >= 0) {
+        memcpy((char *) buffer + offset, &docLength, sizeof(int));
+        offset += sizeof(int);
+        for (int i = 0; i < docLength; i++) {
+            *((char *) buffer + offset + i) = (char) ('a' + (id + i) % 26);
+        }
+        offset += docLength;
+    }
+    int noteLength = note.size();
+    memcpy((char *) buffer + offset, &noteLength, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buffer + offset, note.c_str(), noteLength);
+    offset += noteLength;
+    return offset;
+}
+
+unsigned countPageReads(RecordBasedFileManager &rbfm, FileHandle &fileHandle,
+                        const std::vector<Attribute> &recordDescriptor,
+                        const std::vector<std::string> &attributeNames, void *returnedData, int &count) {
+    unsigned readBefore = 0, readAfter = 0, writeCount = 0, appendCount = 0;
+    fileHandle.collectCounterValues(readBefore, writeCount, appendCount);
+
+    RBFM_ScanIterator rbfmsi;
+    RC rc = rbfm.scan(fileHandle, recordDescriptor, "", NO_OP, NULL, attributeNames, rbfmsi);
+    assert(rc == success && "Scanning the file should not fail.");
+
+    RID rid;
+    count = 0;
+    while (rbfmsi.getNextRecord(rid, returnedData) != RBFM_EOF) {
+        count++;
+    }
+    rbfmsi.close();
+
+    fileHandle.collectCounterValues(readAfter, writeCount, appendCount);
+    return readAfter - readBefore;
+}
+
+int RBFTest_13(RecordBasedFileManager &rbfm) {
+    // Functions tested
+    // 1. Insert records with VarChars larger than a page
+    // 2. Read records and attributes stored in overflow pages
+    // 3. Scan without reading the overflow pages of non projected attributes
+    // 4. Update and delete records with overflow pages
+    std::cout << std::endl << "***** In RBF Test Case 13 *****" << std::endl;
+
+    RC rc;
+    std::string fileName = "test13";
+
+    rc = rbfm.createFile(fileName);
+    assert(rc == success && "Creating the file should not fail.");
+
+    FileHandle fileHandle;
+    rc = rbfm.openFile(fileName, fileHandle);
+    assert(rc == success && "Opening the file should not fail.");
+
+    std::vector<Attribute> recordDescriptor;
+    createOverflowRecordDescriptor(recordDescriptor);
+
+    int bufferSize = getMaxRecordSize(recordDescriptor);
+    void *record = malloc(bufferSize);
+    void *returnedData = malloc(bufferSize);
+    int numRecords = 20;
+    int overflowPages = 0;
+    std::vector<RID> rids;
+    RID rid;
+
+    // Every third record is small enough to stay in its page, record 10 has a NULL Doc.
+    for (int i = 0; i < numRecords; i++) {
+        int docLength = i % 3 == 0 ? 100 + i : 1500 + i * 900;
+        if (i == 10) docLength = -1;
+        if (docLength > OVERFLOW_THRESHOLD) {
+            overflowPages += (docLength + OVERFLOW_CHUNK_SIZE - 1) / OVERFLOW_CHUNK_SIZE;
+        }
+        prepareOverflowRecord(i, docLength, "note", record);
+        rc = rbfm.insertRecord(fileHandle, recordDescriptor, record, rid);
+        assert(rc == success && "Inserting a record should not fail.");
+        rids.push_back(rid);
+    }
+
+    bool failed = false;
+    for (int i = 0; i < numRecords; i++) {
+        int docLength = i % 3 == 0 ? 100 + i : 1500 + i * 900;
+        if (i == 10) docLength = -1;
+        int recordSize = prepareOverflowRecord(i, docLength, "note", record);
+        rc = rbfm.readRecord(fileHandle, recordDescriptor, rids[i], returnedData);
+        assert(rc == success && "Reading a record should not fail.");
+        if (memcmp(record, returnedData, recordSize) != 0) {
+            std::cout << "Record " << i << " does not match." << std::endl;
+            failed = true;
+        }
+    }
+
+    // Read a single large attribute.
+    int docLength = 1500 + 5 * 900;
+    prepareOverflowRecord(5, docLength, "note", record);
+    rc = rbfm.readAttribute(fileHandle, recordDescriptor, rids[5], "Doc", returnedData);
+    assert(rc == success && "Reading an attribute should not fail.");
+    if (*(unsigned char *) returnedData != 0 ||
+        memcmp((char *) record + 1 + sizeof(int), (char *) returnedData + 1, sizeof(int) + docLength) != 0) {
+        std::cout << "Attribute Doc of record 5 does not match." << std::endl;
+        failed = true;
+    }
+
+    // A scan reads the overflow pages only when Doc is projected.
+    std::vector<std::string> idOnly, idAndDoc;
+    idOnly.push_back("Id");
+    idAndDoc.push_back("Id");
+    idAndDoc.push_back("Doc");
+    int count = 0, countWithDoc = 0;
+    unsigned readsWithoutDoc = countPageReads(rbfm, fileHandle, recordDescriptor, idOnly, returnedData, count);
+    unsigned readsWithDoc = countPageReads(rbfm, fileHandle, recordDescriptor, idAndDoc, returnedData, countWithDoc);
+    std::cout << "Page reads of the scan without Doc: " << readsWithoutDoc << ", with Doc: " << readsWithDoc
+              << ", overflow pages: " << overflowPages << std::endl;
+    if (count != numRecords || countWithDoc != numRecords || readsWithDoc - readsWithoutDoc != (unsigned) overflowPages) {
+        failed = true;
+    }
+
+    // Shrink a large record, grow a small one and delete a large one.
+    int recordSize = prepareOverflowRecord(4, 10, "shrunk", record);
+    rc = rbfm.updateRecord(fileHandle, recordDescriptor, record, rids[4]);
+    assert(rc == success && "Updating a record should not fail.");
+    rc = rbfm.readRecord(fileHandle, recordDescriptor, rids[4], returnedData);
+    assert(rc == success && "Reading a record should not fail.");
+    if (memcmp(record, returnedData, recordSize) != 0) failed = true;
+
+    recordSize = prepareOverflowRecord(3, MAX_DOC_LENGTH, "grown", record);
+    rc = rbfm.updateRecord(fileHandle, recordDescriptor, record, rids[3]);
+    assert(rc == success && "Updating a record should not fail.");
+    rc = rbfm.readRecord(fileHandle, recordDescriptor, rids[3], returnedData);
+    assert(rc == success && "Reading a record should not fail.");
+    if (memcmp(record, returnedData, recordSize) != 0) failed = true;
+
+    rc = rbfm.deleteRecord(fileHandle, recordDescriptor, rids[7]);
+    assert(rc == success && "Deleting a record should not fail.");
+    rc = rbfm.readRecord(fileHandle, recordDescriptor, rids[7], returnedData);
+    assert(rc != success && "Reading a deleted record should fail.");
+
+    // The freed overflow pages hold records again.
+    int numPages = fileHandle.getNumberOfPages();
+    for (int i = 0; i < 200; i++) {
+        prepareOverflowRecord(numRecords + i, 10, "reuse", record);
+        rc = rbfm.insertRecord(fileHandle, recordDescriptor, record, rid);
+        assert(rc == success && "Inserting a record should not fail.");
+    }
+    if (fileHandle.getNumberOfPages() != numPages) {
+        std::cout << "Freed overflow pages were not reused." << std::endl;
+        failed = true;
+    }
+
+    rc = rbfm.closeFile(fileHandle);
+    assert(rc == success && "Closing the file should not fail.");
+
+    rc = rbfm.destroyFile(fileName);
+    assert(rc == success && "Destroying the file should not fail.");
+
+    free(record);
+    free(returnedData);
+
+    if (failed) {
+        std::cout << "[FAIL] Test Case 13 Failed!" << std::endl << std::endl;
+        return -1;
+    }
+
+    std::cout << "RBF Test Case 13 Finished! The result will be examined." << std::endl << std::endl;
+    return 0;
+}
+
+int main() {
+    // To test the functionality of the record-based file manager
+    RecordBasedFileManager &rbfm = RecordBasedFileManager::instance();
+
+    remove("test13");
+
+    return RBFTest_13(rbfm);
+}
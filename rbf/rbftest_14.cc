@@ -0,0 +1,187 @@
+#include "pfm.h"
+#include "rbfm.h"
+#include "test_util.h"
+
+void createFixedWidthRecordDescriptor(std::vector<Attribute> &recordDescriptor) {
+    Attribute attr;
+    attr.name = "Id";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    recordDescriptor.push_back(attr);
+
+    attr.name = "Score";
+    attr.type = TypeReal;
+    attr.length = (AttrLength) 4;
+    recordDescriptor.push_back(attr);
+
+    attr.name = "Rank";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    recordDescriptor.push_back(attr);
+}
+
+// Record (Id, Score, Rank), Score is NULL for every seventh record.
+int prepareFixedWidthRecord(const int id, void *buffer) {
+    int offset = 1;
+    unsigned char nullsIndicator = id % 7 == 0 ? (1 << 6) : 0;
+    memcpy((char *) buffer, &nullsIndicator, 1);
+    memcpy((char *) buffer + offset, &id, sizeof(int));
+    offset += sizeof(int);
+    if (id % 7 != 0) {
+        float score = id * 0.5f;
+        memcpy((char *) buffer + offset, &score, sizeof(float));
+        offset += sizeof(float);
+    }
+    int rank = 1000 - id;
+    memcpy((char *) buffer + offset, &rank, sizeof(int));
+    offset += sizeof(int);
+    return offset;
+}
+
+int RBFTest_14(RecordBasedFileManager &rbfm) {
+    // Functions tested
+    // 1. Insert and read records of an all Int/Real descriptor (fixed width format)
+    // 2. Read attributes and scan with a condition
+    // 3. Update a record
+    // 4. A file created before the format keeps the field offset table in its Int/Real records
+    std::cout << std::endl << "***** In RBF Test Case 14 *****" << std::endl;
+
+    RC rc;
+    std::string fileName = "test14";
+
+    rc = rbfm.createFile(fileName);
+    assert(rc == success && "Creating the file should not fail.");
+
+    FileHandle fileHandle;
+    rc = rbfm.openFile(fileName, fileHandle);
+    assert(rc == success && "Opening the file should not fail.");
+
+    std::vector<Attribute> recordDescriptor;
+    createFixedWidthRecordDescriptor(recordDescriptor);
+    assert(isFixedWidthDescriptor(recordDescriptor) && "An all Int/Real descriptor should be fixed width.");
+    assert(fileHandle.hasFixedWidthRecords() && "A new file should have the fixed width format.");
+
+    void *record = malloc(100);
+    void *returnedData = malloc(100);
+    std::vector<RID> rids;
+    RID rid;
+
+    // 13 bytes per record and 8 bytes per slot, so a page holds 194 records.
+    int numRecords = 194;
+    for (int i = 0; i < numRecords; i++) {
+        prepareFixedWidthRecord(i, record);
+        rc = rbfm.insertRecord(fileHandle, recordDescriptor, record, rid);
+        assert(rc == success && "Inserting a record should not fail.");
+        rids.push_back(rid);
+    }
+
+    bool failed = fileHandle.getNumberOfPages() != 1;
+    for (int i = 0; i < numRecords; i++) {
+        int recordSize = prepareFixedWidthRecord(i, record);
+        rc = rbfm.readRecord(fileHandle, recordDescriptor, rids[i], returnedData);
+        assert(rc == success && "Reading a record should not fail.");
+        if (memcmp(record, returnedData, recordSize) != 0) failed = true;
+    }
+
+    // Fields after a NULL field keep their offset.
+    rc = rbfm.readAttribute(fileHandle, recordDescriptor, rids[14], "Rank", returnedData);
+    assert(rc == success && "Reading an attribute should not fail.");
+    if (*(unsigned char *) returnedData != 0 || *(int *) ((char *) returnedData + 1) != 1000 - 14) failed = true;
+
+    rc = rbfm.readAttribute(fileHandle, recordDescriptor, rids[14], "Score", returnedData);
+    assert(rc == success && "Reading an attribute should not fail.");
+    if (*(unsigned char *) returnedData != 0x80) failed = true;
+
+    // Scan for Score > 90 projecting (Rank, Id).
+    float threshold = 90;
+    std::vector<std::string> attributeNames;
+    attributeNames.push_back("Rank");
+    attributeNames.push_back("Id");
+    RBFM_ScanIterator rbfmsi;
+    rc = rbfm.scan(fileHandle, recordDescriptor, "Score", GT_OP, &threshold, attributeNames, rbfmsi);
+    assert(rc == success && "Scanning the file should not fail.");
+
+    int count = 0;
+    while (rbfmsi.getNextRecord(rid, returnedData) != RBFM_EOF) {
+        int rank = *(int *) ((char *) returnedData + 1);
+        int id = *(int *) ((char *) returnedData + 5);
+        if (*(unsigned char *) returnedData != 0 || rank != 1000 - id || id <= 180 || id % 7 == 0) failed = true;
+        count++;
+    }
+    rbfmsi.close();
+    if (count != 11) failed = true;
+
+    // Update a record whose Score was NULL.
+    int recordSize = prepareFixedWidthRecord(15, record);
+    rc = rbfm.updateRecord(fileHandle, recordDescriptor, record, rids[21]);
+    assert(rc == success && "Updating a record should not fail.");
+    rc = rbfm.readRecord(fileHandle, recordDescriptor, rids[21], returnedData);
+    assert(rc == success && "Reading a record should not fail.");
+    if (memcmp(record, returnedData, recordSize) != 0) failed = true;
+
+    rc = rbfm.closeFile(fileHandle);
+    assert(rc == success && "Closing the file should not fail.");
+
+    rc = rbfm.destroyFile(fileName);
+    assert(rc == success && "Destroying the file should not fail.");
+
+    // The format marker is cleared as in a file written before it.
+    rc = rbfm.createFile(fileName);
+    assert(rc == success && "Creating the file should not fail.");
+    rc = rbfm.openFile(fileName, fileHandle);
+    assert(rc == success && "Opening the file should not fail.");
+    rc = rbfm.closeFile(fileHandle);
+    assert(rc == success && "Closing the file should not fail.");
+    std::fstream file(fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    int marker = 0;
+    file.seekp(OFFSET_FOR_FS_TABLE * sizeof(int) + MAX_FS_TABLE_PAGES * 2 * sizeof(RT));
+    file.write((char *) &marker, sizeof(int));
+    file.close();
+
+    rc = rbfm.openFile(fileName, fileHandle);
+    assert(rc == success && "Opening the file should not fail.");
+    if (fileHandle.hasFixedWidthRecords()) failed = true;
+    rids.clear();
+    for (int i = 0; i < numRecords; i++) {
+        prepareFixedWidthRecord(i, record);
+        rc = rbfm.insertRecord(fileHandle, recordDescriptor, record, rid);
+        assert(rc == success && "Inserting a record should not fail.");
+        rids.push_back(rid);
+    }
+    // 18 bytes per record with the offset table, the records do not fit in one page.
+    if (fileHandle.getNumberOfPages() == 1) failed = true;
+    for (int i = 0; i < numRecords; i++) {
+        int recordSize = prepareFixedWidthRecord(i, record);
+        rc = rbfm.readRecord(fileHandle, recordDescriptor, rids[i], returnedData);
+        assert(rc == success && "Reading a record should not fail.");
+        if (memcmp(record, returnedData, recordSize) != 0) failed = true;
+    }
+    rc = rbfm.readAttribute(fileHandle, recordDescriptor, rids[14], "Rank", returnedData);
+    assert(rc == success && "Reading an attribute should not fail.");
+    if (*(unsigned char *) returnedData != 0 || *(int *) ((char *) returnedData + 1) != 1000 - 14) failed = true;
+
+    rc = rbfm.closeFile(fileHandle);
+    assert(rc == success && "Closing the file should not fail.");
+    rc = rbfm.destroyFile(fileName);
+    assert(rc == success && "Destroying the file should not fail.");
+
+    free(record);
+    free(returnedData);
+
+    if (failed) {
+        std::cout << "[FAIL] Test Case 14 Failed!" << std::endl << std::endl;
+        return -1;
+    }
+
+    std::cout << "RBF Test Case 14 Finished! The result will be examined." << std::endl << std::endl;
+    return 0;
+}
+
+int main() {
+    // To test the functionality of the record-based file manager
+    RecordBasedFileManager &rbfm = RecordBasedFileManager::instance();
+
+    remove("test14");
+
+    return RBFTest_14(rbfm);
+}
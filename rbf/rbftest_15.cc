@@ -0,0 +1,201 @@
+#include <algorithm>
+#include "pfm.h"
+#include "rbfm.h"
+#include "test_util.h"
+
+void createZoneRecordDescriptor(std::vector<Attribute> &recordDescriptor) {
+    Attribute attr;
+    attr.name = "Ts";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    recordDescriptor.push_back(attr);
+
+    attr.name = "Temp";
+    attr.type = TypeReal;
+    attr.length = (AttrLength) 4;
+    recordDescriptor.push_back(attr);
+
+    attr.name = "Sensor";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength) 40;
+    recordDescriptor.push_back(attr);
+}
+
+// Record (Ts, Temp, Sensor), Temp is NULL for every eleventh record.
+void prepareZoneRecord(const int ts, const int sensorLength, void *buffer) {
+    int offset = 1;
+    unsigned char nullsIndicator = ts % 11 == 0 ? (1 << 6) : 0;
+    memcpy((char *) buffer, &nullsIndicator, 1);
+    memcpy((char *) buffer + offset, &ts, sizeof(int));
+    offset += sizeof(int);
+    if (ts % 11 != 0) {
+        float temp = ts * 0.25f;
+        memcpy((char *) buffer + offset, &temp, sizeof(float));
+        offset += sizeof(float);
+    }
+    memcpy((char *) buffer + offset, &sensorLength, sizeof(int));
+    offset += sizeof(int);
+    memset((char *) buffer + offset, 'a' + ts % 26, sensorLength);
+}
+
+// Returns the sorted Ts of the records matching a condition on Ts or Temp.
+std::vector<int> scanTs(RecordBasedFileManager &rbfm, FileHandle &fileHandle,
+                        const std::vector<Attribute> &recordDescriptor, const std::string &attribute,
+                        const CompOp compOp, const void *value, unsigned &pagesRead) {
+    std::vector<std::string> attributeNames(1, "Ts");
+    RBFM_ScanIterator rbfmsi;
+    unsigned readBefore, readAfter, writeCount, appendCount;
+    fileHandle.collectCounterValues(readBefore, writeCount, appendCount);
+    RC rc = rbfm.scan(fileHandle, recordDescriptor, attribute, compOp, value, attributeNames, rbfmsi);
+    assert(rc == success && "Scanning the file should not fail.");
+
+    std::vector<int> result;
+    RID rid;
+    char returnedData[100];
+    while (rbfmsi.getNextRecord(rid, returnedData) != RBFM_EOF) {
+        result.push_back(*(int *) (returnedData + 1));
+    }
+    rbfmsi.close();
+    fileHandle.collectCounterValues(readAfter, writeCount, appendCount);
+    // getNextRecord() reads the page of the previous record again, only the other reads are counted.
+    pagesRead = readAfter - readBefore - result.size();
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Checks a scan on Ts against the records expected in the file, returns the pages it read.
+unsigned checkTsScan(RecordBasedFileManager &rbfm, FileHandle &fileHandle,
+                     const std::vector<Attribute> &recordDescriptor, const std::vector<int> &stored,
+                     const CompOp compOp, const int value, bool &failed) {
+    unsigned pagesRead = 0;
+    std::vector<int> result = scanTs(rbfm, fileHandle, recordDescriptor, "Ts", compOp, &value, pagesRead);
+    std::vector<int> expected;
+    for (int ts : stored) {
+        if ((compOp == EQ_OP && ts == value) || (compOp == LT_OP && ts < value) ||
+            (compOp == LE_OP && ts <= value) || (compOp == GT_OP && ts > value) ||
+            (compOp == GE_OP && ts >= value)) {
+            expected.push_back(ts);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    if (result != expected) {
+        std::cout << "Scan of Ts " << compOp << " " << value << " returned " << result.size()
+                  << " records instead of " << expected.size() << std::endl;
+        failed = true;
+    }
+    return pagesRead;
+}
+
+int RBFTest_15(RecordBasedFileManager &rbfm) {
+    // Functions tested
+    // 1. Scans with a range condition on an Int/Real attribute skip the pages outside of it **
+    // 2. Zones follow deletes, inserts into emptied pages and updates moving records **
+    // 3. Zones are kept across a reopen of the file **
+    std::cout << std::endl << "***** In RBF Test Case 15 *****" << std::endl;
+
+    RC rc;
+    std::string fileName = "test15";
+
+    rc = rbfm.createFile(fileName);
+    assert(rc == success && "Creating the file should not fail.");
+
+    FileHandle fileHandle;
+    rc = rbfm.openFile(fileName, fileHandle);
+    assert(rc == success && "Opening the file should not fail.");
+
+    std::vector<Attribute> recordDescriptor;
+    createZoneRecordDescriptor(recordDescriptor);
+
+    void *record = malloc(100);
+    std::vector<RID> rids;
+    std::vector<int> stored;
+    RID rid;
+    bool failed = false;
+
+    // Records arrive in the order of their timestamp.
+    int numRecords = 3000;
+    for (int ts = 0; ts < numRecords; ts++) {
+        prepareZoneRecord(ts, 8, record);
+        rc = rbfm.insertRecord(fileHandle, recordDescriptor, record, rid);
+        assert(rc == success && "Inserting a record should not fail.");
+        rids.push_back(rid);
+        stored.push_back(ts);
+    }
+    int pages = fileHandle.getNumberOfPages();
+
+    unsigned pagesRead = checkTsScan(rbfm, fileHandle, recordDescriptor, stored, GE_OP, 2900, failed);
+    std::cout << "Pages: " << pages << ", pages read by Ts >= 2900: " << pagesRead << std::endl;
+    if ((int) pagesRead > 2) failed = true;
+    if ((int) checkTsScan(rbfm, fileHandle, recordDescriptor, stored, EQ_OP, 1500, failed) > 1) failed = true;
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, LT_OP, 100, failed);
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, LE_OP, -1, failed);
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, GT_OP, numRecords - 1, failed);
+
+    // Temp < 10 matches Ts < 40, NULLs excluded.
+    float temp = 10;
+    std::vector<int> result = scanTs(rbfm, fileHandle, recordDescriptor, "Temp", LT_OP, &temp, pagesRead);
+    if (result.size() != 36 || result.back() != 39 || (int) pagesRead > 1) failed = true;
+
+    // Empty the first pages, new records reuse them.
+    for (int ts = 0; ts < 500; ts++) {
+        rc = rbfm.deleteRecord(fileHandle, recordDescriptor, rids[ts]);
+        assert(rc == success && "Deleting a record should not fail.");
+    }
+    stored.erase(stored.begin(), stored.begin() + 500);
+    for (int ts = 5000; ts < 5100; ts++) {
+        prepareZoneRecord(ts, 8, record);
+        rc = rbfm.insertRecord(fileHandle, recordDescriptor, record, rid);
+        assert(rc == success && "Inserting a record should not fail.");
+        stored.push_back(ts);
+    }
+    if (fileHandle.getNumberOfPages() != pages) failed = true;
+    pagesRead = checkTsScan(rbfm, fileHandle, recordDescriptor, stored, GE_OP, 5000, failed);
+    std::cout << "Pages read by Ts >= 5000 after the deletes: " << pagesRead << std::endl;
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, LT_OP, 600, failed);
+
+    // Longer records do not fit in their page and are moved.
+    for (int ts = 1000; ts < 1200; ts++) {
+        prepareZoneRecord(ts + 8000, 30, record);
+        rc = rbfm.updateRecord(fileHandle, recordDescriptor, record, rids[ts]);
+        assert(rc == success && "Updating a record should not fail.");
+        *std::find(stored.begin(), stored.end(), ts) = ts + 8000;
+    }
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, GE_OP, 9000, failed);
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, EQ_OP, 1100, failed);
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, GT_OP, 2500, failed);
+
+    rc = rbfm.closeFile(fileHandle);
+    assert(rc == success && "Closing the file should not fail.");
+    rc = rbfm.openFile(fileName, fileHandle);
+    assert(rc == success && "Opening the file should not fail.");
+
+    pagesRead = checkTsScan(rbfm, fileHandle, recordDescriptor, stored, GE_OP, 2900, failed);
+    std::cout << "Pages read by Ts >= 2900 after a reopen: " << pagesRead << std::endl;
+    if ((int) pagesRead > pages / 2) failed = true;
+    checkTsScan(rbfm, fileHandle, recordDescriptor, stored, LE_OP, 1199, failed);
+
+    rc = rbfm.closeFile(fileHandle);
+    assert(rc == success && "Closing the file should not fail.");
+
+    rc = rbfm.destroyFile(fileName);
+    assert(rc == success && "Destroying the file should not fail.");
+
+    free(record);
+
+    if (failed) {
+        std::cout << "[FAIL] Test Case 15 Failed!" << std::endl << std::endl;
+        return -1;
+    }
+
+    std::cout << "RBF Test Case 15 Finished! The result will be examined." << std::endl << std::endl;
+    return 0;
+}
+
+int main() {
+    // To test the functionality of the record-based file manager
+    RecordBasedFileManager &rbfm = RecordBasedFileManager::instance();
+
+    remove("test15");
+
+    return RBFTest_15(rbfm);
+}
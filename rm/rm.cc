@@ -1,4 +1,58 @@
 #include "rm.h"
+#include <random>
+
+// Columns of the Statistics table, see initializeStatisticsAttribute().
+enum {
+    STATS_TABLE_NAME = 0, STATS_OBJECT_NAME, STATS_KIND, STATS_ROW_COUNT, STATS_PAGES, STATS_NULL_FRACTION,
+    STATS_DISTINCT_COUNT, STATS_MIN_VALUE, STATS_MAX_VALUE, STATS_HISTOGRAM, STATS_INDEX_HEIGHT, STATS_LEAF_PAGES
+};
+
+/**
+ * getTupleFields() - locate the fields of a tuple.
+ * @argument1 : columns of the tuple.
+ * @argument2 : tuple in the format of RelationManager::insertTuple().
+ * @argument3 : start of each field, NULL for a NULL field (out parameter).
+ *
+ * Return : void.
+*/
+static void getTupleFields(const std::vector<Attribute>& attrs, const void* data, std::vector<const char*>& fields) {
+    int nullBytes = ceil((double)attrs.size()/CHAR_BIT);
+    const char* field = (const char*)data + nullBytes;
+    fields.assign(attrs.size(), NULL);
+    for(unsigned i = 0; i < attrs.size(); i++) {
+        if(((const unsigned char*)data)[i / CHAR_BIT] & (1 << (CHAR_BIT - 1 - i % CHAR_BIT))) continue;
+        fields[i] = field;
+        int len = 0;
+        if(attrs[i].type == TypeVarChar) memcpy(&len, field, sizeof(int));
+        field += sizeof(int) + len;
+    }
+}
+
+/**
+ * getIndexTuple() - take the columns of an index out of a tuple of the table.
+ * @argument1 : index of the table.
+ * @argument2 : fields of the tuple, see getTupleFields().
+ * @argument3 : tuple of the columns of the index, in the insertTuple() format (out parameter).
+ *
+ * Return : length of the tuple of the index.
+*/
+static int getIndexTuple(const TableIndex& index, const std::vector<const char*>& fields, char* tuple) {
+    int nullBytes = ceil((double)index.indexAttrs.size()/CHAR_BIT);
+    memset(tuple, 0, nullBytes);
+    int offset = nullBytes;
+    for(unsigned i = 0; i < index.indexAttrs.size(); i++) {
+        const char* field = fields[index.positions[i]];
+        if(field == NULL) {
+            tuple[i / CHAR_BIT] |= (1 << (CHAR_BIT - 1 - i % CHAR_BIT));
+            continue;
+        }
+        int len = 0;
+        if(index.indexAttrs[i].type == TypeVarChar) memcpy(&len, field, sizeof(int));
+        memcpy(tuple + offset, field, sizeof(int) + len);
+        offset += sizeof(int) + len;
+    }
+    return offset;
+}
 
 /**
  * initializeScanIterator() - initializes the table iterator.
@@ -61,15 +115,44 @@ RC RM_IndexScanIterator::initializeScanIterator(const string &tableName,
                                                 bool highKeyInclusive) {
 
     std::string indexFileName = tableName + "_" + attributeName + ".idx";
-    if(ixm.openFile(indexFileName, this->ixFileHandle) == -1) {
+    vector<Attribute> attrs;
+    if(RelationManager::instance().getAttributes(indexFileName, attrs) == -1) {
         return -1;
     }
 
-    vector<Attribute> attrs;
-    RelationManager::instance().getAttributes(indexFileName, attrs);
+    return initializeScanIterator(indexFileName, attrs[0], lowKey, highKey, lowKeyInclusive, highKeyInclusive);
+}
+
+/**
+ * initializeScanIterator() - initializes the iterator over an index file.
+ * @argument1 : name of the index file.
+ * @argument2 : attribute under which the keys are indexed.
+ * @argument3 : low bound in comparison
+ * @argument4 : upper bound in comparison
+ * @argument5 : flag to decide if the range include lowKey or not.
+ * @argument6 : flag to decide if the range include highKey or not.
+
+ * Return : 0 on success, -1 on failure.
+*/
+RC RM_IndexScanIterator::initializeScanIterator(const string &indexFileName,
+                                                const Attribute &attribute,
+                                                const void *lowKey,
+                                                const void *highKey,
+                                                bool lowKeyInclusive,
+                                                bool highKeyInclusive) {
+    // a scan started again without a close
+    close();
+    // the scan reads the handle the writes to the table go through, changes it holds included
+    this->ixFileHandle = RelationManager::instance().acquireIndexFileHandle(indexFileName);
+    if(this->ixFileHandle == NULL) {
+        return -1;
+    }
+    this->indexFileName = indexFileName;
+    this->attribute = attribute;
 
-    if(ixm.scan(this->ixFileHandle, attrs[0], lowKey, highKey,
+    if(ixm.scan(*this->ixFileHandle, attribute, lowKey, highKey,
                 lowKeyInclusive, highKeyInclusive, this->ixsi) == -1) {
+        close();
         return -1;
     }
 
@@ -87,6 +170,33 @@ RC RM_IndexScanIterator::getNextEntry(RID& rid, void* data) {
     return this->ixsi.getNextEntry(rid, data);
 }
 
+/**
+ * getKeyFilter() - get the Bloom filter of the keys of the scanned index.
+ * @argument1 : filter (out parameter).
+ *
+ * The filter is built on the first call and kept in the index file.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RM_IndexScanIterator::getKeyFilter(BloomFilter& filter) {
+    if(this->ixFileHandle == NULL) return -1;
+    return this->ixm.getKeyFilter(*this->ixFileHandle, this->attribute, filter);
+}
+
+/**
+ * close() - close the scan and release the index file, which can then be destroyed or rebuilt.
+ *
+ * Return : 0 on success.
+*/
+RC RM_IndexScanIterator::close() {
+    this->ixsi.close();
+    if(this->ixFileHandle != NULL) {
+        RelationManager::instance().releaseIndexFileHandle(this->indexFileName);
+        this->ixFileHandle = NULL;
+    }
+    return 0;
+}
+
 // RM Singleton
 RelationManager &RelationManager::instance() {
     static RelationManager _relation_manager = RelationManager();
@@ -95,6 +205,8 @@ RelationManager &RelationManager::instance() {
 
 //C'tor RM
 RelationManager::RelationManager() : rbfm(RecordBasedFileManager::instance()) {
+    backgroundMigrationBatch = 0;
+    initializeStatisticsAttribute(this->statisticsAttributes);
     if (isCatalogInitialized()) {
         // order of initializaitons matter here
         initializeTableAttribute(this->tableAttributes);
@@ -110,6 +222,7 @@ RelationManager::RelationManager() : rbfm(RecordBasedFileManager::instance()) {
 
 //D'tor RM
 RelationManager::~RelationManager() {
+    closeIndexFiles();
     rbfm.closeFile(this->tableFileHandle);
     rbfm.closeFile(this->columnFileHandle);
     if(this->currFile != "") {
@@ -156,14 +269,25 @@ RC RelationManager::createCatalog() {
  * Return : 0 on success, -1 on file end
 */
 RC RelationManager::deleteCatalog() {
+    // open index scans read the index files
+    if(!this->indexScans.empty()) return -1;
     if(rbfm.destroyFile(TABLES_FILE) == -1 || rbfm.destroyFile(COLUMNS_FILE) == -1) {
         return -1;
     }
+    // only there once a table was analyzed.
+    if(currFile == STATISTICS_FILE) {
+        currFile = "";
+        rbfm.closeFile(this->fileHandle);
+    }
+    rbfm.destroyFile(STATISTICS_FILE);
+    closeIndexFiles();
+    this->deltaBufferIndexes.clear();
 
     tableMap.clear();
     columnsMap.clear();
     rbfm.tableMap.clear();
     rbfm.columnsMap.clear();
+    rbfm.projectionCache.clear();
     return 0;
 }
 
@@ -206,6 +330,9 @@ RC RelationManager::deleteTable(const std::string &tableName) {
     if(isSystemTable(tableName) || !isTableExist(tableName)) return -1;
 
     deleteTableEntryFromCatalog(tableName);
+    schemaMigrations.erase(tableName);
+    tableIndexes.erase(tableName);
+    deleteStatistics(tableName);
 
     if(currFile == tableName) {
         currFile = "";
@@ -284,21 +411,8 @@ RC RelationManager::insertTuple(const std::string &tableName, const void *data,
         rbfm.insertVersionOfRecord(this->fileHandle, rid, (RT)latestVersion);
     }
 
-    IXFileHandle ixFileHandle;
-    void* key = malloc(PAGE_SIZE);
-
-    for(int i = 0 ;  i < (int)recordDescriptor.size(); i++) {
-        std::string indexName = tableName + "_" + recordDescriptor[i].name + ".idx";
-        if(this->tableMap.find(indexName) != this->tableMap.end()) {
-            IndexManager::instance().openFile(indexName, ixFileHandle);
-            this->readAttribute(tableName, rid, recordDescriptor[i].name, key);
-            IndexManager::instance().insertEntry(ixFileHandle, recordDescriptor[i], (char*)key + 1, rid);
-            IndexManager::instance().closeFile(ixFileHandle);
-        }
-
-    }
-
-    free(key);
+    updateIndexEntries(tableName, recordDescriptor, NULL, data, rid);
+    runBackgroundSchemaMigration(tableName);
     return 0;
 }
 
@@ -335,25 +449,26 @@ RC RelationManager::deleteTuple(const std::string &tableName, const RID &rid) {
 
     if(recordDescriptor.size() == 0) return -1;
 
-    if(rbfm.deleteRecord(this->fileHandle, recordDescriptorP, rid) == -1) {
-        return -1;
-    }
-
-    IXFileHandle ixFileHandle;
-    void* key = malloc(PAGE_SIZE);
-
-    for(int i = 0 ;  i < (int)recordDescriptor.size(); i++) {
-        std::string indexName = tableName + "_" + recordDescriptor[i].name + ".idx";
-        if(this->tableMap.find(indexName) != this->tableMap.end()) {
-            IndexManager::instance().openFile(indexName, ixFileHandle);
-            this->readAttribute(tableName, rid, recordDescriptor[i].name, key);
-            IndexManager::instance().insertEntry(ixFileHandle, recordDescriptor[i], (char*)key + 1, rid);
-            IndexManager::instance().closeFile(ixFileHandle);
+    // the keys of the tuple are taken from it before it is gone
+    std::vector<Attribute> latestDescriptor;
+    getAttributes(tableName, latestDescriptor);
+    void* oldData = NULL;
+    if(!getTableIndexes(tableName, latestDescriptor).empty()) {
+        oldData = malloc(std::max((int)PAGE_SIZE, getMaxRecordSize(latestDescriptor)));
+        if(this->readTuple(tableName, rid, oldData) == -1) {
+            free(oldData);
+            return -1;
         }
+    }
 
+    if(rbfm.deleteRecord(this->fileHandle, recordDescriptorP, rid) == -1) {
+        free(oldData);
+        return -1;
     }
 
-    free(key);
+    if(oldData != NULL) updateIndexEntries(tableName, latestDescriptor, oldData, NULL, rid);
+    free(oldData);
+    runBackgroundSchemaMigration(tableName);
     return 0;
 }
 
@@ -380,11 +495,24 @@ RC RelationManager::updateTuple(const std::string &tableName, const void *data,
         rbfm.openFile(tableName, this->fileHandle);
     }
 
+    void* oldData = NULL;
+    if(!getTableIndexes(tableName, recordDescriptor).empty()) {
+        oldData = malloc(std::max((int)PAGE_SIZE, getMaxRecordSize(recordDescriptor)));
+        if(this->readTuple(tableName, rid, oldData) == -1) {
+            free(oldData);
+            return -1;
+        }
+    }
+
     if(rbfm.updateRecord(this->fileHandle, recordDescriptor, data, rid) == -1)  {
+        free(oldData);
         rbfm.closeFile(this->fileHandle);
         return -1;
     }
 
+    if(oldData != NULL) updateIndexEntries(tableName, recordDescriptor, oldData, data, rid);
+    free(oldData);
+    runBackgroundSchemaMigration(tableName);
     return 0;
 }
 
@@ -397,13 +525,9 @@ RC RelationManager::updateTuple(const std::string &tableName, const void *data,
  * Return : 0 on success, -1 on file end
 */
 RC RelationManager::readTuple(const std::string &tableName, const RID &rid, void *data) {
-    // get the version number from the given rid
-    // get the recordDescriptor for the given version of the table
-    // call rbfm.readRecord(...) with above informations.
-    // should handle the case where the record format doesnt conform with the latest schema changes.
+    // the version of the record is read from its slot and the record is formatted
+    // with the latest schema while its page is in hand.
     if(!isTableExist(tableName) || isSystemTable(tableName)) return -1;
-    std::vector<Attribute> recordDescriptor;
-    std::vector<Attribute> recordDescriptorP;
     if(currFile == "") {
         rbfm.openFile(tableName, this->fileHandle);
         this->currFile = tableName;
@@ -413,28 +537,31 @@ RC RelationManager::readTuple(const std::string &tableName, const RID &rid, void
         rbfm.openFile(tableName, this->fileHandle);
     }
 
-    int version = rbfm.getVersionOfRecord(this->fileHandle, rid);
-    recordDescriptor = getAttributesForVersion(tableName, version);
-    recordDescriptorP = recordDescriptor;
-    processDescriptor(recordDescriptorP);
-
-    if(recordDescriptor.size() == 0) return -1;
-
-    if(rbfm.readRecord(this->fileHandle, recordDescriptorP, rid, data) == -1) {
-        return -1;
-    }
+    return rbfm.readRecordWithLatestSchema(this->fileHandle, rid, data);
+}
 
-    //If the read record doesnt match the latest schema, format it.
-    int latestVersion = getLatestTableVersion(tableName);
-    if (version != latestVersion) {
-        std::vector<Attribute> recordDescriptorLatest = getAttributesForVersion(tableName, latestVersion);
-        std::vector<Attribute> recordDescriptorLatestActual;
-        getAttributes(tableName, recordDescriptorLatestActual);
-        formatRecordWithLatestSchemaChange(recordDescriptor, recordDescriptorLatest,
-                                           recordDescriptorLatestActual, data);
+/**
+ * readTuples() - reads a batch of tuples, each page of the table is read once for the whole batch.
+ * @argument1 : name of the table
+ * @argument2 : rids of the tuples, in any order
+ * @argument3 : out parameter, tuple i is returned at data + i*tupleSize.
+ * @argument4 : space given to each tuple, at least getMaxRecordSize() of the table.
+ *
+ * Return : 0 on success, -1 on failure
+*/
+RC RelationManager::readTuples(const std::string &tableName, const std::vector<RID> &rids, void *data,
+                               const int tupleSize) {
+    if(!isTableExist(tableName) || isSystemTable(tableName)) return -1;
+    if(currFile == "") {
+        rbfm.openFile(tableName, this->fileHandle);
+        this->currFile = tableName;
+    } else if(currFile != tableName) {
+        rbfm.closeFile(this->fileHandle);
+        this->currFile = tableName;
+        rbfm.openFile(tableName, this->fileHandle);
     }
 
-    return 0;
+    return rbfm.readRecordsWithLatestSchema(this->fileHandle, rids, data, tupleSize);
 }
 
 /**
@@ -460,14 +587,9 @@ RC RelationManager::printTuple(const std::vector<Attribute> &attrs, const void *
 RC RelationManager::readAttribute(const std::string &tableName, const RID &rid,
                                   const std::string &attributeName,
                                   void *data) {
-    // get the version number from the given rid
-    // get the recordDescriptor for the given version of the table
-    // call rbfm.readAttribute(...) with above informations.
-    // needs to conform to new data schema.
+    // needs to conform to new data schema, see readTuple().
     if(!isTableExist(tableName) || isSystemTable(tableName)) return -1;
 
-    std::vector<Attribute> recordDescriptor;
-
     if(currFile == "") {
         rbfm.openFile(tableName, this->fileHandle);
         this->currFile = tableName;
@@ -477,17 +599,7 @@ RC RelationManager::readAttribute(const std::string &tableName, const RID &rid,
         rbfm.openFile(tableName, this->fileHandle);
     }
 
-
-    int version = rbfm.getVersionOfRecord(this->fileHandle, rid);
-    recordDescriptor = getAttributesForVersion(tableName, version);
-
-    if(recordDescriptor.size() == 0) return -1;
-
-    if(rbfm.readAttribute(this->fileHandle, recordDescriptor, rid, attributeName, data) == -1) {
-        return -1;
-    }
-
-    return 0;
+    return rbfm.readAttributeWithLatestSchema(this->fileHandle, rid, attributeName, data);
 }
 
 /**
@@ -536,6 +648,8 @@ RC RelationManager::dropAttribute(const std::string &tableName, const std::strin
     int tableID = -1;
     createAndInsertTablesData(tableName, tableID, UPDATED);
     createAndInsertColumnsData(tableName, recordDescriptor, tableID);
+    // the indexed columns moved
+    tableIndexes.erase(tableName);
     return 0;    
 }
 
@@ -554,6 +668,7 @@ RC RelationManager::addAttribute(const std::string &tableName, const Attribute &
 
     createAndInsertTablesData(tableName, tableID, UPDATED);
     createAndInsertColumnsData(tableName, recordDescriptor, tableID);
+    tableIndexes.erase(tableName);
     return 0;
 }
 
@@ -561,12 +676,50 @@ RC RelationManager::addAttribute(const std::string &tableName, const Attribute &
  * createIndex() - add a index on given column
  * @argument1 : name of the table
  * @argument2 : column which index is created
+ * @argument3 : fraction of each B+ tree node filled when the index is built,
+ *              lower values leave room for later inserts.
+ *
+ * Return : 0 on success, -1 on failure
+*/
+RC RelationManager::createIndex(const std::string &tableName, const std::string &attributeName,
+                                const float fillFactor) {
+    return createIndex(tableName, attributeName, std::vector<std::string>(), fillFactor);
+}
+
+/**
+ * createIndex() - add a index of the given kind on given column
+ * @argument1 : name of the table
+ * @argument2 : column which index is created
+ * @argument3 : BTREE_INDEX, or HASH_INDEX for an index answering only equality scans
+ *              (IndexScan::setIterator() with equal inclusive bounds, INLJoin) from one bucket.
+ *
+ * Return : 0 on success, -1 on failure
+*/
+RC RelationManager::createIndex(const std::string &tableName, const std::string &attributeName,
+                                const IndexKind indexKind) {
+    return createIndex(tableName, attributeName, std::vector<std::string>(), BULK_LOAD_FILL_FACTOR, indexKind);
+}
+
+/**
+ * createIndex() - add a covering index on given column
+ * @argument1 : name of the table
+ * @argument2 : column which index is created
+ * @argument3 : INCLUDE columns whose values are stored in the leaf entries next to the key.
+ * @argument4 : fraction of each B+ tree node filled when the index is built,
+ *              lower values leave room for later inserts.
+ * @argument5 : kind of the index, a hash index can not have INCLUDE columns.
+ *
+ * The index is registered in the catalog with the key column followed by the INCLUDE columns,
+ * so a query reading only these columns can be answered from the index alone.
  *
  * Return : 0 on success, -1 on failure
 */
-RC RelationManager::createIndex(const std::string &tableName, const std::string &attributeName) {
+RC RelationManager::createIndex(const std::string &tableName, const std::string &attributeName,
+                                const std::vector<std::string> &includeAttributes,
+                                const float fillFactor, const IndexKind indexKind) {
     // No indexes to be created on system table.
     if(isSystemTable(tableName) || !isTableExist(tableName)) return -1;
+    if(indexKind == HASH_INDEX && !includeAttributes.empty()) return -1;
 
     std::string indexFileName = tableName + "_" + attributeName + ".idx";
 
@@ -584,14 +737,26 @@ RC RelationManager::createIndex(const std::string &tableName, const std::string
     // No such attribute to create Index on.
     if(indexAttr.size() == 0) return -1;
 
-    if(IndexManager::instance().createFile(indexFileName) == -1) return -1;
+    for(auto includeName : includeAttributes) {
+        auto isIncludeAttr = [&includeName](const Attribute& attr) { return attr.name == includeName; };
+        // an INCLUDE column is a column of the table, other than the key and given once
+        if(std::find_if(indexAttr.begin(), indexAttr.end(), isIncludeAttr) != indexAttr.end()) return -1;
+        auto attr = std::find_if(attrs.begin(), attrs.end(), isIncludeAttr);
+        if(attr == attrs.end()) return -1;
+        indexAttr.push_back(*attr);
+    }
+
+    RC rc = indexKind == HASH_INDEX ? IndexManager::instance().createFile(indexFileName, HASH_INDEX)
+                                    : IndexManager::instance().createFile(indexFileName, false, indexAttr.size() > 1);
+    if(rc == -1) return -1;
 
     //create Entry into catalog.
     int table_id = -1;
     createAndInsertTablesData(indexFileName, table_id);
     createAndInsertColumnsData(indexFileName, indexAttr, table_id);
+    tableIndexes.erase(tableName);
 
-    if(populateIndexOnAttribute(tableName, indexFileName, indexAttr) == -1) return -1;
+    if(populateIndexOnAttribute(tableName, indexFileName, indexAttr, fillFactor) == -1) return -1;
     return 0;
 }
 
@@ -606,11 +771,157 @@ RC RelationManager::destroyIndex(const std::string &tableName, const std::string
     std::string indexFileName = tableName + "_" + attributeName + ".idx";
     if(isSystemTable(indexFileName) || !isTableExist(indexFileName)) return -1;
 
+    if(closeIndexFile(indexFileName) == -1) return -1;
+    deleteTableEntryFromCatalog(indexFileName);
+    this->deltaBufferIndexes.erase(indexFileName);
+
+    return IndexManager::instance().destroyFile(indexFileName);
+}
+
+/**
+ * createCompositeIndex() - add a index on several columns.
+ * @argument1 : name of the table
+ * @argument2 : columns of the key, the keys are ordered by the first column, then by the second and so on.
+ * @argument3 : fraction of each B+ tree node filled when the index is built.
+ *
+ * The columns are encoded into one VarChar key (see IndexManager::encodeCompositeKey()) and the index
+ * file is named after the columns joined by '+'. Rows with NULL columns are indexed, a NULL sorts before
+ * every value of its column.
+ *
+ * Return : 0 on success, -1 on failure
+*/
+RC RelationManager::createCompositeIndex(const std::string &tableName, const std::vector<std::string> &attributeNames,
+                                         const float fillFactor) {
+    if(isSystemTable(tableName) || !isTableExist(tableName) || attributeNames.size() < 2) return -1;
+
+    std::string indexFileName = getIndexFileName(tableName, attributeNames);
+    std::vector<Attribute> attrs, indexAttr;
+    this->getAttributes(tableName, attrs);
+
+    for(auto attrName : attributeNames) {
+        auto isKeyAttr = [&attrName](const Attribute& attr) { return attr.name == attrName; };
+        if(std::find_if(indexAttr.begin(), indexAttr.end(), isKeyAttr) != indexAttr.end()) return -1;
+        auto attr = std::find_if(attrs.begin(), attrs.end(), isKeyAttr);
+        if(attr == attrs.end()) return -1;
+        indexAttr.push_back(*attr);
+    }
+
+    if(IndexManager::instance().createFile(indexFileName) == -1) return -1;
+
+    //create Entry into catalog.
+    int table_id = -1;
+    createAndInsertTablesData(indexFileName, table_id);
+    createAndInsertColumnsData(indexFileName, indexAttr, table_id);
+    tableIndexes.erase(tableName);
+
+    if(populateIndexOnAttribute(tableName, indexFileName, indexAttr, fillFactor) == -1) return -1;
+    return 0;
+}
+
+/**
+ * destroyCompositeIndex() - delete the index on several columns.
+ * @argument1 : name of the table
+ * @argument2 : columns of the key.
+ *
+ * Return : 0 on success, -1 on failure
+*/
+RC RelationManager::destroyCompositeIndex(const std::string &tableName, const std::vector<std::string> &attributeNames) {
+    std::string indexFileName = getIndexFileName(tableName, attributeNames);
+    if(isSystemTable(indexFileName) || !isTableExist(indexFileName)) return -1;
+
+    if(closeIndexFile(indexFileName) == -1) return -1;
     deleteTableEntryFromCatalog(indexFileName);
+    this->deltaBufferIndexes.erase(indexFileName);
 
     return IndexManager::instance().destroyFile(indexFileName);
 }
 
+/**
+ * compositeIndexScan() - range scan on the leading columns of an index on several columns.
+ * @argument1 : name of the table
+ * @argument2 : columns of the key.
+ * @argument3 : low bound, values of the first prefixColumns columns one after the other, NULL for none.
+ * @argument4 : upper bound, in the same format, NULL for none.
+ * @argument5 : number of leading columns in the bounds.
+ * @argument6 : flag to decide if the range include lowKey or not.
+ * @argument7 : flag to decide if the range include highKey or not.
+ * @argument8 : ref. of rm index iteratr object
+ *
+ * A bound on the leading columns covers every key starting with them, e.g. with an index on (A, B)
+ * and prefixColumns = 1, lowKey = highKey = 5 inclusive returns the rows with A = 5 ordered by B.
+ * The keys returned by the iterator are the encoded keys.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RelationManager::compositeIndexScan(const std::string &tableName,
+                                       const std::vector<std::string> &attributeNames,
+                                       const void *lowKey,
+                                       const void *highKey,
+                                       const unsigned prefixColumns,
+                                       bool lowKeyInclusive,
+                                       bool highKeyInclusive,
+                                       RM_IndexScanIterator &rm_IndexScanIterator) {
+    std::string indexFileName = getIndexFileName(tableName, attributeNames);
+    std::vector<Attribute> indexAttrs;
+    if(this->getAttributes(indexFileName, indexAttrs) == -1) return -1;
+    if(prefixColumns > indexAttrs.size()) return -1;
+
+    std::vector<Attribute> prefixAttrs(indexAttrs.begin(), indexAttrs.begin() + prefixColumns);
+    int nullBytes = ceil((double)prefixColumns/CHAR_BIT);
+    char* tuple = (char*)malloc(PAGE_SIZE);
+    char* lowEncoded = (char*)malloc(PAGE_SIZE);
+    char* highEncoded = (char*)malloc(PAGE_SIZE);
+    memset(tuple, 0, nullBytes);
+
+    // length of the values in the bounds
+    int boundLength[2] = {0, 0};
+    const void* bounds[2] = {lowKey, highKey};
+    for(int b = 0; b < 2; b++) {
+        for(unsigned i = 0; bounds[b] != NULL && i < prefixAttrs.size(); i++) {
+            int len = sizeof(int);
+            if(prefixAttrs[i].type == TypeVarChar) {
+                memcpy(&len, (char*)bounds[b] + boundLength[b], sizeof(int));
+                len += sizeof(int);
+            }
+            boundLength[b] += len;
+        }
+    }
+
+    // a key starting with the prefix sorts after the prefix and before the prefix followed by 0xFF
+    if(lowKey != NULL) {
+        memcpy(tuple + nullBytes, lowKey, boundLength[0]);
+        IndexManager::instance().encodeCompositeKey(prefixAttrs, tuple, lowEncoded, !lowKeyInclusive);
+    }
+    if(highKey != NULL) {
+        memcpy(tuple + nullBytes, highKey, boundLength[1]);
+        IndexManager::instance().encodeCompositeKey(prefixAttrs, tuple, highEncoded, highKeyInclusive);
+    }
+    RC rc = rm_IndexScanIterator.initializeScanIterator(indexFileName,
+                                                        IndexManager::instance().getCompositeKeyAttribute(indexAttrs),
+                                                        lowKey == NULL ? NULL : lowEncoded,
+                                                        highKey == NULL ? NULL : highEncoded,
+                                                        true, highKeyInclusive);
+    free(tuple);
+    free(lowEncoded);
+    free(highEncoded);
+    return rc;
+}
+
+/**
+ * getIndexAttributes() - get the columns of the index on a column.
+ * @argument1 : name of the table
+ * @argument2 : column on which the index exists.
+ * @argument3 : key column followed by the INCLUDE columns of the index (out parameter).
+ *
+ * Return : 0 on success, -1 if there is no such index.
+*/
+RC RelationManager::getIndexAttributes(const std::string &tableName, const std::string &attributeName,
+                                       std::vector<Attribute> &attrs) {
+    std::string indexFileName = tableName + "_" + attributeName + ".idx";
+    if(isSystemTable(indexFileName)) return -1;
+    return this->getAttributes(indexFileName, attrs);
+}
+
 /**
  * indexScan() - wrapper on initializeScanIterator() for index.
  * @argument1 : name of the table
@@ -636,62 +947,432 @@ RC RelationManager::indexScan(const string &tableName,
 }
 
 /**
- * initializeTableAttribute() - defines the schmea of Tables table.
- * @argument1 : vector of column as out parameter.
+ * vacuumTable() - rewrites a table into packed pages.
+ * @argument1 : name of the table
+ * @argument2 : indexed column on which to cluster the rows, "" to keep the heap order.
+ * @argument3 : optional hook called every VACUUM_PROGRESS_INTERVAL rows.
  *
- * Return : void.
- */
-void RelationManager::initializeTableAttribute(vector<Attribute> &tableAttributes) {
-    Attribute attr;
+ * Live tuples are streamed one at a time into a scratch file, so forwarding pointers, tombstones
+ * and freed slots are dropped and every row is stored with the latest schema version. The scratch
+ * file then replaces the table file and all indexes on the table are rebuilt with the new RIDs.
+ * If the cluster index does not cover the whole heap the rows are copied in heap order instead.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RelationManager::vacuumTable(const std::string &tableName,
+                                const std::string &clusterAttribute,
+                                ProgressCallback progress) {
+    if(isSystemTable(tableName) || !isTableExist(tableName)) return -1;
 
-    attr.name = "table-id";
-    attr.type = TypeInt;
-    attr.length = (AttrLength)(sizeof(int));
-    tableAttributes.push_back(attr);
+    std::vector<Attribute> recordDescriptor;
+    getAttributes(tableName, recordDescriptor);
+    if(recordDescriptor.size() == 0) return -1;
 
-    attr.name = "table-name";
-    attr.type = TypeVarChar;
-    attr.length = (AttrLength)50;
-    tableAttributes.push_back(attr);
+    if(clusterAttribute != "" &&
+       this->tableMap.find(tableName + "_" + clusterAttribute + ".idx") == this->tableMap.end()) return -1;
 
-    attr.name = "file-name";
-    attr.type = TypeVarChar;
-    attr.length = (AttrLength)50;
-    tableAttributes.push_back(attr);
+    // the indexes are rebuilt, none may be under an open scan
+    std::vector<std::string> indexFileNames;
+    getIndexesOnTable(tableName, recordDescriptor, indexFileNames);
+    for(auto indexFileName : indexFileNames) {
+        if(this->indexScans.find(indexFileName) != this->indexScans.end()) return -1;
+    }
 
-    attr.name = "version";
-    attr.type = TypeInt;
-    attr.length = (AttrLength)(sizeof(int));
-    tableAttributes.push_back(attr);
-    return;
-}
+    if(currFile == "") {
+        rbfm.openFile(tableName, this->fileHandle);
+        this->currFile = tableName;
+    } else if(currFile != tableName) {
+        rbfm.closeFile(this->fileHandle);
+        this->currFile = tableName;
+        rbfm.openFile(tableName, this->fileHandle);
+    }
 
-/**
- * initializeTableAttribute() - defines the schema of Columns table.
- * @argument1 : vector of column as out parameter.
- *
- * Return : void.
- */
-void RelationManager::initializeColumnAttribute(vector<Attribute> &columnAttributes) {
-    Attribute attr;
+    std::string vacuumFileName = tableName + VACUUM_FILE_SUFFIX;
+    int rowsTotal = countTuples(tableName, recordDescriptor);
+    if(rowsTotal == -1) return -1;
+
+    // left over from an interrupted vacuum.
+    rbfm.destroyFile(vacuumFileName);
+    if(rbfm.createFile(vacuumFileName) == -1) return -1;
+    FileHandle vacuumFileHandle;
+    rbfm.openFile(vacuumFileName, vacuumFileHandle);
+
+    int rowsCopied = copyTuplesForVacuum(tableName, clusterAttribute, recordDescriptor,
+                                         vacuumFileHandle, rowsTotal, progress);
+    if(rowsCopied != rowsTotal && clusterAttribute != "") {
+        rbfm.closeFile(vacuumFileHandle);
+        rbfm.destroyFile(vacuumFileName);
+        rbfm.createFile(vacuumFileName);
+        rbfm.openFile(vacuumFileName, vacuumFileHandle);
+        rowsCopied = copyTuplesForVacuum(tableName, "", recordDescriptor, vacuumFileHandle, rowsTotal, progress);
+    }
 
-    attr.name = "table-id";
-    attr.type = TypeInt;
-    attr.length = (AttrLength)4;
-    columnAttributes.push_back(attr);
+    rbfm.closeFile(vacuumFileHandle);
+    if(rowsCopied != rowsTotal) {
+        rbfm.destroyFile(vacuumFileName);
+        return -1;
+    }
 
-    attr.name = "column-name";
-    attr.type = TypeVarChar;
-    attr.length = (AttrLength)50;
-    columnAttributes.push_back(attr);
+    // the packed file replaces the table in one step, a failed rename leaves the table as it was
+    rbfm.closeFile(this->fileHandle);
+    RC rc = rbfm.renameFile(vacuumFileName, tableName);
+    rbfm.openFile(tableName, this->fileHandle);
+    if(rc == -1) {
+        rbfm.destroyFile(vacuumFileName);
+        return -1;
+    }
 
-    attr.name = "column-type";
-    attr.type = TypeInt;
-    attr.length = (AttrLength)4;
-    columnAttributes.push_back(attr);
+    // every row has been written with the latest version.
+    schemaMigrations.erase(tableName);
+    retireOldSchemaVersions(tableName);
 
-    attr.name = "column-length";
-    attr.type = TypeInt;
+    return rebuildIndexesOnTable(tableName, recordDescriptor);
+}
+
+/**
+ * migrateSchema() - incremental rewrite of the rows of older schema versions.
+ * @argument1 : name of the table
+ * @argument2 : number of slots to examine in this step.
+ *
+ * Each call resumes where the previous one stopped. Rows are rewritten in place with the latest
+ * version so RIDs and indexes stay valid. Rows that no longer fit in their page are left for
+ * vacuumTable(). After a full pass without such rows the old versions are dropped from the catalog,
+ * and reads of the table no longer need any translation.
+ *
+ * Return : 0 if the pass is not over, RM_EOF at the end of a pass, -1 on failure.
+*/
+RC RelationManager::migrateSchema(const std::string &tableName, const unsigned batchSize) {
+    if(isSystemTable(tableName) || !isTableExist(tableName)) return -1;
+    if(columnsMap[tableName].size() <= 1) return RM_EOF;
+
+    if(currFile == "") {
+        rbfm.openFile(tableName, this->fileHandle);
+        this->currFile = tableName;
+    } else if(currFile != tableName) {
+        rbfm.closeFile(this->fileHandle);
+        this->currFile = tableName;
+        rbfm.openFile(tableName, this->fileHandle);
+    }
+
+    // a schema change during a pass makes the rows behind the cursor old again.
+    SchemaMigrationInfo& info = schemaMigrations[tableName];
+    int latestVersion = getLatestTableVersion(tableName);
+    if(info.targetVersion != latestVersion || info.passDone) {
+        info = SchemaMigrationInfo();
+        info.targetVersion = latestVersion;
+    }
+
+    unsigned migrated = 0, skipped = 0;
+    RC rc = rbfm.migrateRecords(this->fileHandle, info.cursor, batchSize, migrated, skipped);
+    if(rc == -1) return -1;
+    info.skipped += skipped;
+    if((int)info.cursor.pageNum < this->fileHandle.getNumberOfPages()) return 0;
+
+    if(info.skipped > 0) {
+        info.passDone = true;
+        return RM_EOF;
+    }
+
+    schemaMigrations.erase(tableName);
+    retireOldSchemaVersions(tableName);
+    return RM_EOF;
+}
+
+/**
+ * setBackgroundSchemaMigration() - piggy back schema migration on the writes to a table.
+ * @argument1 : number of slots to examine after every insert, update and delete, 0 turns it off.
+ *
+ * Return : void.
+*/
+void RelationManager::setBackgroundSchemaMigration(const unsigned batchSize) {
+    this->backgroundMigrationBatch = batchSize;
+}
+
+/**
+ * analyzeTable() - collects the statistics of a table, its columns and its indexes.
+ * @argument1 : name of the table.
+ * @argument2 : number of values sampled per column for the histograms.
+ *
+ * One scan of the table counts the rows and, for every column, the NULLs, the distinct values
+ * (HyperLogLog) and the range of Int and Real values, of which a reservoir sample gives an
+ * equi-depth histogram. Indexes report their height and leaf pages. The rows of the previous
+ * analyze are replaced in the Statistics table, which is created the first time.
+ *
+ * Return : 0 on success, -1 on failure.
+*/
+RC RelationManager::analyzeTable(const std::string &tableName, const unsigned sampleSize) {
+    if(isSystemTable(tableName) || !isTableExist(tableName)) return -1;
+
+    std::vector<Attribute> recordDescriptor;
+    getAttributes(tableName, recordDescriptor);
+    if(recordDescriptor.size() == 0) return -1;
+
+    if(currFile == "") {
+        rbfm.openFile(tableName, this->fileHandle);
+        this->currFile = tableName;
+    } else if(currFile != tableName) {
+        rbfm.closeFile(this->fileHandle);
+        this->currFile = tableName;
+        rbfm.openFile(tableName, this->fileHandle);
+    }
+
+    int rowCount = 0;
+    std::vector<ColumnStatistics> columnStats;
+    if(analyzeColumns(tableName, recordDescriptor, sampleSize, rowCount, columnStats) == -1) return -1;
+    int pages = this->fileHandle.getNumberOfPages();
+
+    std::vector<std::string> indexFileNames;
+    std::vector<IndexStatistics> indexStats;
+    getIndexesOnTable(tableName, recordDescriptor, indexFileNames);
+    for(auto indexFileName : indexFileNames) {
+        std::vector<Attribute> indexAttrs;
+        this->getAttributes(indexFileName, indexAttrs);
+        IXFileHandle* ixFileHandle = getIndexFileHandle(indexFileName);
+        if(ixFileHandle == NULL) return -1;
+        // the shape is taken once the changes held in memory are in the tree
+        if(ixFileHandle->hasDeltaBuffer()) IndexManager::instance().flushDeltaBuffer(*ixFileHandle);
+        IndexStatistics stats;
+        RC rc = IndexManager::instance().getTreeShape(*ixFileHandle, getIndexKeyAttribute(indexFileName, indexAttrs),
+                                                      stats.height, stats.leafPages);
+        stats.pages = ixFileHandle->getNumberOfPages() - ixFileHandle->getNumberOfFreePages();
+        if(rc == -1) return -1;
+        indexStats.push_back(stats);
+    }
+
+    if(deleteStatistics(tableName) == -1 || openStatisticsTable(true) == -1) return -1;
+
+    RC rc = insertStatistics(tableName, tableName, TABLE_STATISTICS, rowCount, pages, NULL, NULL);
+    for(unsigned i = 0; rc == 0 && i < recordDescriptor.size(); i++) {
+        rc = insertStatistics(tableName, recordDescriptor[i].name, COLUMN_STATISTICS, rowCount, -1, &columnStats[i], NULL);
+    }
+    // an index is named after its columns, "a+b" for an index on several columns.
+    std::string suffix = ".idx";
+    for(unsigned i = 0; rc == 0 && i < indexFileNames.size(); i++) {
+        std::string columns = indexFileNames[i].substr(tableName.size() + 1,
+                                                       indexFileNames[i].size() - tableName.size() - 1 - suffix.size());
+        rc = insertStatistics(tableName, columns, INDEX_STATISTICS, -1, indexStats[i].pages, NULL, &indexStats[i]);
+    }
+    return rc;
+}
+
+/**
+ * getTableStatistics() - statistics of a table saved by the last analyzeTable().
+ * @argument1 : name of the table.
+ * @argument2 : statistics (out parameter).
+ *
+ * Return : 0 on success, -1 if the table was not analyzed.
+*/
+RC RelationManager::getTableStatistics(const std::string &tableName, TableStatistics &stats) {
+    void* data = malloc(PAGE_SIZE);
+    std::vector<const char*> fields;
+    RC rc = readStatistics(tableName, tableName, TABLE_STATISTICS, data);
+    if(rc == 0) {
+        getTupleFields(this->statisticsAttributes, data, fields);
+        memcpy(&stats.rowCount, fields[STATS_ROW_COUNT], sizeof(int));
+        memcpy(&stats.pages, fields[STATS_PAGES], sizeof(int));
+    }
+    free(data);
+    return rc;
+}
+
+/**
+ * getColumnStatistics() - statistics of a column saved by the last analyzeTable().
+ * @argument1 : name of the table.
+ * @argument2 : name of the column.
+ * @argument3 : statistics (out parameter).
+ *
+ * Return : 0 on success, -1 if the column was not analyzed.
+*/
+RC RelationManager::getColumnStatistics(const std::string &tableName, const std::string &columnName,
+                                        ColumnStatistics &stats) {
+    void* data = malloc(PAGE_SIZE);
+    std::vector<const char*> fields;
+    RC rc = readStatistics(tableName, columnName, COLUMN_STATISTICS, data);
+    if(rc == 0) {
+        getTupleFields(this->statisticsAttributes, data, fields);
+        memcpy(&stats.rowCount, fields[STATS_ROW_COUNT], sizeof(int));
+        memcpy(&stats.nullFraction, fields[STATS_NULL_FRACTION], sizeof(float));
+        memcpy(&stats.distinctCount, fields[STATS_DISTINCT_COUNT], sizeof(int));
+        stats.hasRange = fields[STATS_MIN_VALUE] != NULL;
+        stats.histogram.clear();
+        if(stats.hasRange) {
+            memcpy(&stats.minValue, fields[STATS_MIN_VALUE], sizeof(float));
+            memcpy(&stats.maxValue, fields[STATS_MAX_VALUE], sizeof(float));
+            int len = 0;
+            memcpy(&len, fields[STATS_HISTOGRAM], sizeof(int));
+            stats.histogram.resize(len / sizeof(float));
+            memcpy(stats.histogram.data(), fields[STATS_HISTOGRAM] + sizeof(int), len);
+        }
+    }
+    free(data);
+    return rc;
+}
+
+/**
+ * getIndexStatistics() - statistics of an index saved by the last analyzeTable() of its table.
+ * @argument1 : name of the table.
+ * @argument2 : column of the index, the columns joined by '+' for an index on several columns.
+ * @argument3 : statistics (out parameter).
+ *
+ * Return : 0 on success, -1 if the index was not analyzed.
+*/
+RC RelationManager::getIndexStatistics(const std::string &tableName, const std::string &attributeName,
+                                       IndexStatistics &stats) {
+    void* data = malloc(PAGE_SIZE);
+    std::vector<const char*> fields;
+    RC rc = readStatistics(tableName, attributeName, INDEX_STATISTICS, data);
+    if(rc == 0) {
+        getTupleFields(this->statisticsAttributes, data, fields);
+        memcpy(&stats.pages, fields[STATS_PAGES], sizeof(int));
+        memcpy(&stats.height, fields[STATS_INDEX_HEIGHT], sizeof(int));
+        memcpy(&stats.leafPages, fields[STATS_LEAF_PAGES], sizeof(int));
+    }
+    free(data);
+    return rc;
+}
+
+/**
+ * add() - add the hash of a value to the sketch.
+ * @argument1 : 64 bit hash of the value.
+ *
+ * The first HLL_PRECISION bits pick a register, which keeps the longest run of leading
+ * zeros (plus one) seen in the remaining bits.
+ *
+ * Return : void.
+*/
+void HyperLogLog::add(unsigned long long hash) {
+    unsigned index = (unsigned)(hash >> (64 - HLL_PRECISION));
+    unsigned long long bits = hash << HLL_PRECISION;
+    unsigned char rank = 1;
+    while(rank <= 64 - HLL_PRECISION && !(bits & (1ULL << 63))) {
+        rank++;
+        bits <<= 1;
+    }
+    if(rank > registers[index]) registers[index] = rank;
+}
+
+/**
+ * estimate() - estimated number of distinct hashes added to the sketch.
+ *
+ * Small counts, which leave registers empty, are estimated by linear counting.
+ *
+ * Return : the estimate.
+*/
+double HyperLogLog::estimate() const {
+    double m = registers.size();
+    double sum = 0;
+    int zeros = 0;
+    for(unsigned char rank : registers) {
+        sum += ldexp(1.0, -rank);
+        if(rank == 0) zeros++;
+    }
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    if(estimate <= 2.5 * m && zeros > 0) estimate = m * log(m / zeros);
+    return estimate;
+}
+
+/**
+ * estimateSelectivity() - estimated fraction of the rows whose value satisfies a condition.
+ * @argument1 : comparison operator.
+ * @argument2 : constant compared with the column.
+ *
+ * NULLs never match. Equality assumes the distinct values are equally frequent, ranges
+ * interpolate linearly inside the buckets of the histogram. A column without a range
+ * (VarChar) falls back to a third of its values for a range condition.
+ *
+ * Return : fraction between 0 and 1.
+*/
+float ColumnStatistics::estimateSelectivity(const CompOp compOp, const float value) const {
+    float nonNull = 1 - nullFraction;
+    if(compOp == NO_OP) return 1;
+    if(rowCount == 0 || nonNull <= 0) return 0;
+
+    float equal = nonNull / std::max(distinctCount, 1);
+    if(hasRange && (value < minValue || value > maxValue)) equal = 0;
+    if(compOp == EQ_OP) return equal;
+    if(compOp == NE_OP) return nonNull - equal;
+    if(!hasRange || histogram.size() < 2) return nonNull / 3;
+
+    // fraction of the values below the constant
+    unsigned buckets = histogram.size() - 1;
+    float below = 1;
+    if(value <= histogram[0]) {
+        below = 0;
+    } else if(value < histogram[buckets]) {
+        unsigned i = 0;
+        while(value >= histogram[i + 1]) i++;
+        below = (i + (value - histogram[i]) / (histogram[i + 1] - histogram[i])) / buckets;
+    }
+    below *= nonNull;
+
+    float selectivity = 0;
+    switch(compOp) {
+        case LT_OP: selectivity = below; break;
+        case LE_OP: selectivity = below + equal; break;
+        case GT_OP: selectivity = nonNull - below - equal; break;
+        case GE_OP: selectivity = nonNull - below; break;
+        default: break;
+    }
+    return std::min(std::max(selectivity, 0.0f), nonNull);
+}
+
+/**
+ * initializeTableAttribute() - defines the schmea of Tables table.
+ * @argument1 : vector of column as out parameter.
+ *
+ * Return : void.
+ */
+void RelationManager::initializeTableAttribute(vector<Attribute> &tableAttributes) {
+    Attribute attr;
+
+    attr.name = "table-id";
+    attr.type = TypeInt;
+    attr.length = (AttrLength)(sizeof(int));
+    tableAttributes.push_back(attr);
+
+    attr.name = "table-name";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength)50;
+    tableAttributes.push_back(attr);
+
+    attr.name = "file-name";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength)50;
+    tableAttributes.push_back(attr);
+
+    attr.name = "version";
+    attr.type = TypeInt;
+    attr.length = (AttrLength)(sizeof(int));
+    tableAttributes.push_back(attr);
+    return;
+}
+
+/**
+ * initializeTableAttribute() - defines the schema of Columns table.
+ * @argument1 : vector of column as out parameter.
+ *
+ * Return : void.
+ */
+void RelationManager::initializeColumnAttribute(vector<Attribute> &columnAttributes) {
+    Attribute attr;
+
+    attr.name = "table-id";
+    attr.type = TypeInt;
+    attr.length = (AttrLength)4;
+    columnAttributes.push_back(attr);
+
+    attr.name = "column-name";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength)50;
+    columnAttributes.push_back(attr);
+
+    attr.name = "column-type";
+    attr.type = TypeInt;
+    attr.length = (AttrLength)4;
+    columnAttributes.push_back(attr);
+
+    attr.name = "column-length";
+    attr.type = TypeInt;
     attr.length = (AttrLength)4;
     columnAttributes.push_back(attr);
 
@@ -712,6 +1393,32 @@ void RelationManager::initializeColumnAttribute(vector<Attribute> &columnAttribu
     return;
 }
 
+/**
+ * initializeStatisticsAttribute() - defines the schema of Statistics table.
+ * @argument1 : vector of column as out parameter.
+ *
+ * A row holds the statistics of a table, of one of its columns or of one of its indexes,
+ * the columns which do not apply to its kind are NULL.
+ *
+ * Return : void.
+ */
+void RelationManager::initializeStatisticsAttribute(vector<Attribute> &statisticsAttributes) {
+    const char* names[] = {"table-name", "object-name", "kind", "row-count", "pages", "null-fraction",
+                           "distinct-count", "min-value", "max-value", "histogram", "index-height", "leaf-pages"};
+    AttrType types[] = {TypeVarChar, TypeVarChar, TypeInt, TypeInt, TypeInt, TypeReal,
+                        TypeInt, TypeReal, TypeReal, TypeVarChar, TypeInt, TypeInt};
+    statisticsAttributes.clear();
+    for(unsigned i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        Attribute attr;
+        attr.name = names[i];
+        attr.type = types[i];
+        attr.length = (AttrLength)(types[i] == TypeVarChar ? 50 : sizeof(int));
+        statisticsAttributes.push_back(attr);
+    }
+    statisticsAttributes[STATS_HISTOGRAM].length = (AttrLength)((STATS_HISTOGRAM_BUCKETS + 1) * sizeof(float));
+    return;
+}
+
 /**
  * createAndInsertTablesData() - insert a new table's data into Tables table.
  * @argument1 : name of the table.
@@ -989,8 +1696,12 @@ int RelationManager::getNewTableVersion(const std::string& tableName) {
     if(columnsMap.find(tableName) == columnsMap.end()) {
         return 1;
     }
-    // would be used when table schemas change.
-    return columnsMap[tableName].size() + 1;
+    // would be used when table schemas change, old versions may have been retired.
+    int maxVersion = 0;
+    for(auto itr : columnsMap[tableName]) {
+        maxVersion = max(maxVersion, itr.first);
+    }
+    return maxVersion + 1;
 }
 
 /**
@@ -1052,84 +1763,6 @@ std::string RelationManager::getTableNameFromId(const int tableID) {
     return "";
 }
 
-/**
- * formatRecordWithLatestSchemaChange() - formats a record with older schema to conform with latest schema.
- * @argument1 : current record descriptor of the record.
- * @argument2 : latest record descriptor without the invalid columns.
- * @argument3 : latest record desciprot with the invalid columns as well.
- *
- * Return : void.
- */
-void RelationManager::formatRecordWithLatestSchemaChange(std::vector<Attribute>& recordDescriptor, 
-                                                         std::vector<Attribute>& recordDescriptorLatest,
-                                                         std::vector<Attribute>& recordDescriptorLatestOriginal, 
-                                                         void* data) {
-
-    int nullBytesLat = ceil((double)recordDescriptorLatestOriginal.size()/CHAR_BIT);
-    int nullBytes = ceil((double)recordDescriptor.size()/CHAR_BIT);
-    char nullField[nullBytes];
-    memcpy((char*)nullField, (char*)data, nullBytes);
-    char nullFieldLat[nullBytesLat];
-    memset((char*)nullFieldLat, 0, nullBytesLat);
-
-    void* formatData = malloc(PAGE_SIZE);
-    int dataOffsetLat = nullBytesLat;
-    int dataOffset = nullBytes;
-
-    int j = 0;
-    for(int i = 0 ; i < (int)recordDescriptor.size(); i++) {
-        int nullBit = nullField[i/CHAR_BIT] & (1 << (CHAR_BIT - 1 - i%CHAR_BIT));
-        if(nullBit == 0) {
-            if (recordDescriptor[i].valid == VALID && recordDescriptorLatest[i].valid == INVALID) {
-                if(recordDescriptor[i].type == TypeInt) {
-                    dataOffset += sizeof(int);
-                } else if(recordDescriptor[i].type == TypeReal) {
-                    dataOffset += sizeof(float);
-                } else {
-                    int len = 0;
-                    memcpy((char*)&len, (char*)data + dataOffset, sizeof(int));
-                    dataOffset += sizeof(int) + len;
-                }
-            } else if (recordDescriptor[i].valid == VALID && recordDescriptorLatest[i].valid == VALID) {
-                if (recordDescriptor[i].type == TypeInt) {
-                    memcpy((char*)formatData + dataOffsetLat, (char*)data + dataOffset, sizeof(int));
-                    dataOffset += sizeof(int);
-                    dataOffsetLat += sizeof(int);
-                } else if (recordDescriptor[i].type == TypeReal) {
-                    memcpy((char*)formatData + dataOffsetLat, (char*)data + dataOffset, sizeof(float));
-                    dataOffset += sizeof(float);
-                    dataOffsetLat += sizeof(float);
-                } else {
-                    int len = 0; 
-                    memcpy((char*)&len, (char*)data + dataOffset, sizeof(int));
-                    memcpy((char*)formatData + dataOffsetLat, (char*)data + dataOffset, sizeof(int) + len);
-                    dataOffset += sizeof(int) + len;
-                    dataOffsetLat += sizeof(int) + len;
-                }
-               j++;
-            }
-        } else {
-            if (recordDescriptor[i].valid == VALID && recordDescriptorLatest[i].valid == VALID) {
-                nullFieldLat[j/CHAR_BIT] |= (1 << (CHAR_BIT - 1 - j%CHAR_BIT));
-                j++;
-            }
-        }
-    }
-
-
-    while(j < (int)recordDescriptorLatestOriginal.size()) {
-        int shift = CHAR_BIT - 1 - j%CHAR_BIT;
-        nullFieldLat[j/CHAR_BIT] |= (1 << (shift));
-        j++;
-    }
-
-    memcpy((char*)formatData, (char*)nullFieldLat, nullBytesLat);
-    memcpy((char*)data, (char*)formatData, dataOffsetLat);
-    free(formatData);
-    return ;
-
-}
-
 /**
  * deleteTableEntryFromCatalog() - delete the entry of a table from catalog.
  * @argument1 : name of the table.
@@ -1151,6 +1784,7 @@ RC RelationManager::deleteTableEntryFromCatalog(const std::string& tableName) {
     this->columnsMap.erase(tableName);
     rbfm.columnsMap.erase(tableName);
     rbfm.tableMap.erase(tableName);
+    rbfm.projectionCache.erase(tableName);
 
     return 0;
 }
@@ -1159,32 +1793,849 @@ RC RelationManager::deleteTableEntryFromCatalog(const std::string& tableName) {
  * populateIndexOnAttribute() - bulk loading of the index data structure (B+ tree in this case).
  * @argument1 : name of the table.
  * @argument2 : name of the index file.
- * @argument3 : record descriptor with only the column on which index is populated.
+ * @argument3 : record descriptor with the column on which index is populated, followed by the INCLUDE columns.
+ * @argument4 : fraction of each B+ tree node filled by the bulk load.
+ *
+ * The entries are sorted (externally if they do not fit in memory) and the tree is built bottom up.
+ * A hash index has no key order to build on, its entries are inserted one by one.
  *
  * Return : 0 on success, -1 on failure.
  */
 RC RelationManager::populateIndexOnAttribute(const std::string& tableName,
                                              const::std::string& indexFileName,
-                                             const std::vector<Attribute>& indexAttr) {
+                                             const std::vector<Attribute>& indexAttr,
+                                             const float fillFactor) {
 
     vector<std::string> indexAttrNames;
-    indexAttrNames.push_back(indexAttr[0].name);
+    for(auto attr : indexAttr) {
+        indexAttrNames.push_back(attr.name);
+    }
     RM_ScanIterator rmsi;
     if(this->scan(tableName, "", NO_OP, NULL, indexAttrNames, rmsi) == -1) return -1;
 
     RID returnedRID;
     void* returnedData = malloc(PAGE_SIZE);
+    void* entry = malloc(PAGE_SIZE);
 
     IXFileHandle ixFileHandle;
     if(IndexManager::instance().openFile(indexFileName, ixFileHandle) == -1) return -1;
 
-    while(rmsi.getNextTuple(returnedRID, returnedData) != RM_EOF) {
-        IndexManager::instance().insertEntry(ixFileHandle, indexAttr[0], (char*)returnedData + 1, returnedRID);
+    IX_BulkLoader bulkLoader;
+    Attribute keyAttr = getIndexKeyAttribute(indexFileName, indexAttr);
+    bool hashIndex = ixFileHandle.isHashIndex();
+    RC rc = hashIndex ? 0 : bulkLoader.initialize(ixFileHandle, keyAttr, fillFactor);
+    while(rc == 0 && rmsi.getNextTuple(returnedRID, returnedData) != RM_EOF) {
+        // NULL values are not indexed
+        if(getIndexEntryFromTuple(indexFileName, indexAttr, returnedData, entry) == -1) continue;
+        rc = hashIndex ? IndexManager::instance().insertEntry(ixFileHandle, keyAttr, entry, returnedRID)
+                       : bulkLoader.addEntry(entry, returnedRID);
     }
+    if(rc == 0 && !hashIndex) rc = bulkLoader.finish();
 
     rmsi.close();
     IndexManager::instance().closeFile(ixFileHandle);
     free(returnedData);
+    free(entry);
+    return rc;
+}
+
+/**
+ * getIndexEntryFromTuple() - build the key passed to the index from a tuple of the index columns.
+ * @argument1 : name of the index file.
+ * @argument2 : key column followed by the INCLUDE columns of the index, or the key columns of a composite index.
+ * @argument3 : tuple with the columns of argument2, in the insertTuple() format.
+ * @argument4 : key value, followed by [RTS n][n bytes] of INCLUDE columns if the index has any,
+ *              or the encoded key of a composite index (out parameter).
+ *
+ * The INCLUDE columns are kept in the tuple format, with their own null bytes.
+ *
+ * Return : 0 on success, -1 if the key is NULL.
+ */
+RC RelationManager::getIndexEntryFromTuple(const std::string& indexFileName, const std::vector<Attribute>& indexAttrs,
+                                           const void* tuple, void* entry) {
+    if(isCompositeIndex(indexFileName)) {
+        IndexManager::instance().encodeCompositeKey(indexAttrs, tuple, entry);
+        return 0;
+    }
+
+    int nullBytes = ceil((double)indexAttrs.size()/CHAR_BIT);
+    const unsigned char* nullIndicator = (const unsigned char*)tuple;
+    if(nullIndicator[0] & (1 << 7)) return -1;
+
+    const char* fields = (const char*)tuple + nullBytes;
+    int keyLen = sizeof(int);
+    if(indexAttrs[0].type == TypeVarChar) {
+        int len = 0;
+        memcpy((char*)&len, fields, sizeof(int));
+        keyLen += len;
+    }
+    memcpy((char*)entry, fields, keyLen);
+    if(indexAttrs.size() == 1) return 0;
+
+    // the INCLUDE column i is column i + 1 of the tuple
+    int includeCount = indexAttrs.size() - 1;
+    int includeNullBytes = ceil((double)includeCount/CHAR_BIT);
+    char* payload = (char*)entry + keyLen + sizeof(RTS);
+    memset(payload, 0, includeNullBytes);
+    int fieldsLen = 0;
+    for(int i = 0; i < includeCount; i++) {
+        if(nullIndicator[(i + 1)/8] & (1 << (7 - (i + 1)%8))) {
+            payload[i/8] |= (1 << (7 - i%8));
+            continue;
+        }
+        int len = sizeof(int);
+        if(indexAttrs[i + 1].type == TypeVarChar) {
+            memcpy((char*)&len, fields + keyLen + fieldsLen, sizeof(int));
+            len += sizeof(int);
+        }
+        fieldsLen += len;
+    }
+    memcpy(payload + includeNullBytes, fields + keyLen, fieldsLen);
+    RTS payloadLen = includeNullBytes + fieldsLen;
+    memcpy((char*)entry + keyLen, (char*)&payloadLen, sizeof(RTS));
+    return 0;
+}
+
+/**
+ * getTupleFromIndexEntry() - build a tuple of the index columns from a key returned by an index scan.
+ * @argument1 : key column followed by the INCLUDE columns of the index.
+ * @argument2 : key returned by the index scan.
+ * @argument3 : tuple with the columns of argument1, in the insertTuple() format (out parameter).
+ *
+ * Return : 0 on success.
+ */
+RC RelationManager::getTupleFromIndexEntry(const std::vector<Attribute>& indexAttrs, const void* entry, void* data) {
+    int nullBytes = ceil((double)indexAttrs.size()/CHAR_BIT);
+    unsigned char* nullIndicator = (unsigned char*)data;
+    memset(nullIndicator, 0, nullBytes);
+
+    int keyLen = sizeof(int);
+    if(indexAttrs[0].type == TypeVarChar) {
+        int len = 0;
+        memcpy((char*)&len, (char*)entry, sizeof(int));
+        keyLen += len;
+    }
+    memcpy((char*)data + nullBytes, (char*)entry, keyLen);
+    if(indexAttrs.size() == 1) return 0;
+
+    int includeCount = indexAttrs.size() - 1;
+    int includeNullBytes = ceil((double)includeCount/CHAR_BIT);
+    RTS payloadLen = 0;
+    memcpy((char*)&payloadLen, (char*)entry + keyLen, sizeof(RTS));
+    const unsigned char* payload = (const unsigned char*)entry + keyLen + sizeof(RTS);
+    for(int i = 0; i < includeCount; i++) {
+        if(payload[i/8] & (1 << (7 - i%8))) {
+            nullIndicator[(i + 1)/8] |= (1 << (7 - (i + 1)%8));
+        }
+    }
+    memcpy((char*)data + nullBytes + keyLen, payload + includeNullBytes, payloadLen - includeNullBytes);
+    return 0;
+}
+
+/**
+ * countTuples() - number of live tuples in a table.
+ * @argument1 : name of the table.
+ * @argument2 : latest columns of the table.
+ *
+ * Return : number of tuples, -1 on failure.
+ */
+int RelationManager::countTuples(const std::string& tableName, const std::vector<Attribute>& recordDescriptor) {
+    vector<std::string> attributeNames;
+    attributeNames.push_back(recordDescriptor[0].name);
+    RM_ScanIterator rmsi;
+    if(this->scan(tableName, "", NO_OP, NULL, attributeNames, rmsi) == -1) return -1;
+
+    RID rid;
+    void* data = malloc(PAGE_SIZE);
+    int count = 0;
+    while(rmsi.getNextTuple(rid, data) != RM_EOF) {
+        count++;
+    }
+
+    rmsi.close();
+    free(data);
+    return count;
+}
+
+/**
+ * copyTuplesForVacuum() - copies the live tuples of a table into the vacuum file.
+ * @argument1 : name of the table.
+ * @argument2 : indexed column giving the copy order, "" for heap order.
+ * @argument3 : latest columns of the table.
+ * @argument4 : filehandle of the vacuum file.
+ * @argument5 : number of live tuples, used for progress reporting.
+ * @argument6 : progress hook, can be NULL.
+ *
+ * Only one tuple is held in memory at a time. In index order, entries whose key no longer
+ * matches the tuple at their RID are stale and skipped.
+ *
+ * Return : number of tuples copied, -1 on failure.
+ */
+int RelationManager::copyTuplesForVacuum(const std::string& tableName,
+                                         const std::string& clusterAttribute,
+                                         const std::vector<Attribute>& recordDescriptor,
+                                         FileHandle& vacuumFileHandle,
+                                         const unsigned rowsTotal,
+                                         ProgressCallback progress) {
+
+    int latestVersion = getLatestTableVersion(tableName);
+    int bufferSize = std::max((int)PAGE_SIZE, getMaxRecordSize(recordDescriptor));
+    void* data = malloc(bufferSize);
+    void* key = malloc(bufferSize);
+    void* value = malloc(bufferSize);
+    RID rid, newRid, prevRid;
+    prevRid.pageNum = -1;
+    prevRid.slotNum = 0;
+    unsigned rowsCopied = 0;
+
+    RM_ScanIterator rmsi;
+    RM_IndexScanIterator rmisi;
+    Attribute clusterAttr;
+    if(clusterAttribute == "") {
+        vector<std::string> attributeNames;
+        attributeNames.push_back(recordDescriptor[0].name);
+        if(this->scan(tableName, "", NO_OP, NULL, attributeNames, rmsi) == -1) {
+            free(data); free(key); free(value);
+            return -1;
+        }
+    } else {
+        for(auto attr : recordDescriptor) {
+            if(attr.name == clusterAttribute) clusterAttr = attr;
+        }
+        if(this->indexScan(tableName, clusterAttribute, NULL, NULL, true, true, rmisi) == -1) {
+            free(data); free(key); free(value);
+            return -1;
+        }
+    }
+
+    while(true) {
+        if(clusterAttribute == "") {
+            if(rmsi.getNextTuple(rid, data) == RM_EOF) break;
+        } else {
+            if(rmisi.getNextEntry(rid, key) == RM_EOF) break;
+            if(rid == prevRid) continue;
+            prevRid = rid;
+            if(this->readAttribute(tableName, rid, clusterAttribute, value) == -1) continue;
+            if(*(unsigned char*)value != 0) continue;
+            int keyLength = sizeof(int);
+            if(clusterAttr.type == TypeVarChar) {
+                memcpy((char*)&keyLength, (char*)key, sizeof(int));
+                keyLength += sizeof(int);
+            }
+            if(memcmp((char*)value + 1, (char*)key, keyLength) != 0) continue;
+        }
+
+        if(this->readTuple(tableName, rid, data) == -1) continue;
+        if(rbfm.appendRecord(vacuumFileHandle, recordDescriptor, data, newRid) == -1) break;
+        if(latestVersion != 1) {
+            rbfm.insertVersionOfRecord(vacuumFileHandle, newRid, (RT)latestVersion);
+        }
+
+        rowsCopied++;
+        if(progress != NULL && rowsCopied % VACUUM_PROGRESS_INTERVAL == 0) {
+            progress(tableName, rowsCopied, rowsTotal);
+        }
+    }
+
+    if(clusterAttribute == "") rmsi.close();
+    else rmisi.close();
+
+    if(progress != NULL) progress(tableName, rowsCopied, rowsTotal);
+    free(data);
+    free(key);
+    free(value);
+    return (int)rowsCopied;
+}
+
+/**
+ * getIndexFileName() - name of the index file on the given columns of a table.
+ * @argument1 : name of the table.
+ * @argument2 : columns of the key.
+ *
+ * Return : table name, '_', the columns joined by '+' and ".idx".
+ */
+std::string RelationManager::getIndexFileName(const std::string& tableName, const std::vector<std::string>& attributeNames) {
+    std::string indexFileName = tableName + "_";
+    for(unsigned i = 0; i < attributeNames.size(); i++) {
+        indexFileName += (i == 0 ? "" : "+") + attributeNames[i];
+    }
+    return indexFileName + ".idx";
+}
+
+/**
+ * isCompositeIndex() - check if an index file is an index on several columns.
+ * @argument1 : name of the index file.
+ *
+ * Return : true if the key has several columns.
+ */
+bool RelationManager::isCompositeIndex(const std::string& indexFileName) {
+    return indexFileName.find('+') != std::string::npos;
+}
+
+/**
+ * getIndexKeyAttribute() - attribute under which the keys of an index are stored in the B+ tree.
+ * @argument1 : name of the index file.
+ * @argument2 : columns of the index.
+ *
+ * Return : the key column, or the VarChar attribute of the encoded key of a composite index.
+ */
+Attribute RelationManager::getIndexKeyAttribute(const std::string& indexFileName, const std::vector<Attribute>& indexAttrs) {
+    if(isCompositeIndex(indexFileName)) return IndexManager::instance().getCompositeKeyAttribute(indexAttrs);
+    return indexAttrs[0];
+}
+
+/**
+ * getIndexesOnTable() - names of the index files on a table.
+ * @argument1 : name of the table.
+ * @argument2 : latest columns of the table.
+ * @argument3 : names of the index files (out parameter).
+ *
+ * Return : void.
+ */
+void RelationManager::getIndexesOnTable(const std::string& tableName, const std::vector<Attribute>& recordDescriptor,
+                                        std::vector<std::string>& indexFileNames) {
+    indexFileNames.clear();
+    std::string prefix = tableName + "_", suffix = ".idx";
+    for(auto& table : this->tableMap) {
+        const std::string& name = table.first;
+        if(name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+           name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) continue;
+
+        // every column of the key must be a column of the table
+        std::string columns = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+        bool isIndex = true;
+        size_t start = 0;
+        while(isIndex && start <= columns.size()) {
+            size_t end = columns.find('+', start);
+            if(end == std::string::npos) end = columns.size();
+            std::string column = columns.substr(start, end - start);
+            isIndex = std::any_of(recordDescriptor.begin(), recordDescriptor.end(),
+                                  [&column](const Attribute& attr) { return attr.name == column; });
+            start = end + 1;
+        }
+        if(isIndex) indexFileNames.push_back(name);
+    }
+}
+
+/**
+ * rebuildIndexesOnTable() - re-populates every index of a table, used after the RIDs changed.
+ * @argument1 : name of the table.
+ * @argument2 : latest columns of the table.
+ *
+ * Return : 0 on success, -1 on failure.
+ */
+RC RelationManager::rebuildIndexesOnTable(const std::string& tableName, const std::vector<Attribute>& recordDescriptor) {
+    std::vector<std::string> indexFileNames;
+    getIndexesOnTable(tableName, recordDescriptor, indexFileNames);
+    for(auto indexFileName : indexFileNames) {
+        std::vector<Attribute> indexAttr;
+        this->getAttributes(indexFileName, indexAttr);
+        bool includePayload = !isCompositeIndex(indexFileName) && indexAttr.size() > 1;
+        if(closeIndexFile(indexFileName) == -1) return -1;
+        // the index is rebuilt of the same kind
+        IXFileHandle ixFileHandle;
+        IndexKind indexKind = BTREE_INDEX;
+        if(IndexManager::instance().openFile(indexFileName, ixFileHandle) == 0) {
+            indexKind = ixFileHandle.getIndexKind();
+            IndexManager::instance().closeFile(ixFileHandle);
+        }
+        IndexManager::instance().destroyFile(indexFileName);
+        RC rc = indexKind == HASH_INDEX ? IndexManager::instance().createFile(indexFileName, HASH_INDEX)
+                                        : IndexManager::instance().createFile(indexFileName, false, includePayload);
+        if(rc == -1) return -1;
+        if(populateIndexOnAttribute(tableName, indexFileName, indexAttr) == -1) return -1;
+    }
+    return 0;
+}
+
+/**
+ * getIndexFileHandle() - open handle of an index file.
+ * @argument1 : name of the index file.
+ *
+ * The file is opened on the first call and stays open for the writes and the scans that follow,
+ * instead of an open, a header read and a header write per tuple. The changes go to the file
+ * unless the index was given a delta buffer by setIndexDeltaBuffer().
+ *
+ * Return : handle of the index file, NULL if it can not be opened.
+ */
+IXFileHandle* RelationManager::getIndexFileHandle(const std::string& indexFileName) {
+    auto itr = this->indexFileHandles.find(indexFileName);
+    if(itr != this->indexFileHandles.end()) return itr->second;
+
+    std::vector<Attribute> indexAttrs;
+    if(this->getAttributes(indexFileName, indexAttrs) == -1 || indexAttrs.empty()) return NULL;
+    IXFileHandle* ixFileHandle = new IXFileHandle();
+    if(IndexManager::instance().openFile(indexFileName, *ixFileHandle) == -1) {
+        delete ixFileHandle;
+        return NULL;
+    }
+    // kept by an index rebuilt under a delta buffer
+    if(this->deltaBufferIndexes.find(indexFileName) != this->deltaBufferIndexes.end()) {
+        IndexManager::instance().setDeltaBuffer(*ixFileHandle, getIndexKeyAttribute(indexFileName, indexAttrs));
+    }
+    this->indexFileHandles[indexFileName] = ixFileHandle;
+    return ixFileHandle;
+}
+
+/**
+ * acquireIndexFileHandle() - open handle of an index file for a scan.
+ * @argument1 : name of the index file.
+ *
+ * The handle is not closed, so the index is neither destroyed nor rebuilt, until the scan
+ * calls releaseIndexFileHandle().
+ *
+ * Return : handle of the index file, NULL if it can not be opened.
+ */
+IXFileHandle* RelationManager::acquireIndexFileHandle(const std::string& indexFileName) {
+    IXFileHandle* ixFileHandle = getIndexFileHandle(indexFileName);
+    if(ixFileHandle != NULL) this->indexScans[indexFileName]++;
+    return ixFileHandle;
+}
+
+/**
+ * releaseIndexFileHandle() - end of a scan of an index file.
+ * @argument1 : name of the index file.
+ *
+ * Return : void.
+ */
+void RelationManager::releaseIndexFileHandle(const std::string& indexFileName) {
+    auto itr = this->indexScans.find(indexFileName);
+    if(itr == this->indexScans.end()) return;
+    if(--itr->second == 0) this->indexScans.erase(itr);
+}
+
+/**
+ * setIndexDeltaBuffer() - hold the changes of an index in memory.
+ * @argument1 : name of the table
+ * @argument2 : column of the index, the columns of an index on several columns joined by '+'.
+ *
+ * The inserts and deletes of the writes to the table are kept in the delta buffer of the open
+ * handle and merged into the B+ tree when it is full, on analyzeTable() or when the handle is
+ * closed. Until then the file on disk and other handles of it miss them. Hash indexes, indexes
+ * with posting lists and indexes with INCLUDE columns have no delta buffer.
+ *
+ * Return : 0 on success, -1 on failure
+ */
+RC RelationManager::setIndexDeltaBuffer(const std::string &tableName, const std::string &attributeName) {
+    std::string indexFileName = tableName + "_" + attributeName + ".idx";
+    if(isSystemTable(tableName) || !isTableExist(indexFileName)) return -1;
+
+    IXFileHandle* ixFileHandle = getIndexFileHandle(indexFileName);
+    if(ixFileHandle == NULL) return -1;
+    if(!ixFileHandle->hasDeltaBuffer()) {
+        std::vector<Attribute> indexAttrs;
+        this->getAttributes(indexFileName, indexAttrs);
+        if(IndexManager::instance().setDeltaBuffer(*ixFileHandle, getIndexKeyAttribute(indexFileName, indexAttrs)) == -1) {
+            return -1;
+        }
+    }
+    this->deltaBufferIndexes.insert(indexFileName);
+    return 0;
+}
+
+/**
+ * getTableIndexes() - open indexes of a table, with the position of their columns in the table.
+ * @argument1 : name of the table.
+ * @argument2 : latest columns of the table.
+ *
+ * The list is built on the first write to the table and kept until an index of the table is
+ * created or destroyed or the columns of the table change.
+ *
+ * Return : indexes of the table.
+ */
+std::vector<TableIndex>& RelationManager::getTableIndexes(const std::string& tableName,
+                                                          const std::vector<Attribute>& recordDescriptor) {
+    auto itr = this->tableIndexes.find(tableName);
+    if(itr != this->tableIndexes.end()) return itr->second;
+
+    std::vector<TableIndex>& indexes = this->tableIndexes[tableName];
+    std::vector<std::string> indexFileNames;
+    getIndexesOnTable(tableName, recordDescriptor, indexFileNames);
+    for(auto indexFileName : indexFileNames) {
+        TableIndex index;
+        index.fileName = indexFileName;
+        index.ixFileHandle = getIndexFileHandle(indexFileName);
+        if(index.ixFileHandle == NULL) continue;
+        this->getAttributes(indexFileName, index.indexAttrs);
+        index.keyAttr = getIndexKeyAttribute(indexFileName, index.indexAttrs);
+        for(auto& attr : index.indexAttrs) {
+            auto isColumn = [&attr](const Attribute& column) { return column.name == attr.name; };
+            index.positions.push_back(std::find_if(recordDescriptor.begin(), recordDescriptor.end(), isColumn) -
+                                      recordDescriptor.begin());
+        }
+        indexes.push_back(index);
+    }
+    return indexes;
+}
+
+/**
+ * updateIndexEntries() - change the entries of the indexes of a table for a written tuple.
+ * @argument1 : name of the table.
+ * @argument2 : latest columns of the table.
+ * @argument3 : tuple before the write, NULL for an insert.
+ * @argument4 : tuple after the write, NULL for a delete.
+ * @argument5 : rid of the tuple.
+ *
+ * The keys are taken from the tuples passed, no page of the table is read. An update leaving the
+ * columns of an index unchanged leaves its entry in place. A failed change of an index does not
+ * undo the write to the table.
+ *
+ * Return : void.
+ */
+void RelationManager::updateIndexEntries(const std::string& tableName, const std::vector<Attribute>& recordDescriptor,
+                                         const void* oldData, const void* newData, const RID& rid) {
+    std::vector<TableIndex>& indexes = getTableIndexes(tableName, recordDescriptor);
+    if(indexes.empty()) return;
+
+    std::vector<const char*> oldFields, newFields;
+    if(oldData != NULL) getTupleFields(recordDescriptor, oldData, oldFields);
+    if(newData != NULL) getTupleFields(recordDescriptor, newData, newFields);
+    char* oldTuple = (char*)malloc(PAGE_SIZE);
+    char* newTuple = (char*)malloc(PAGE_SIZE);
+    void* entry = malloc(PAGE_SIZE);
+    for(auto& index : indexes) {
+        int oldLength = oldData == NULL ? 0 : getIndexTuple(index, oldFields, oldTuple);
+        int newLength = newData == NULL ? 0 : getIndexTuple(index, newFields, newTuple);
+        if(oldData != NULL && newData != NULL && oldLength == newLength && memcmp(oldTuple, newTuple, oldLength) == 0) {
+            continue;
+        }
+        // NULL keys are not indexed
+        if(oldData != NULL && getIndexEntryFromTuple(index.fileName, index.indexAttrs, oldTuple, entry) == 0) {
+            IndexManager::instance().deleteEntry(*index.ixFileHandle, index.keyAttr, entry, rid);
+        }
+        if(newData != NULL && getIndexEntryFromTuple(index.fileName, index.indexAttrs, newTuple, entry) == 0) {
+            IndexManager::instance().insertEntry(*index.ixFileHandle, index.keyAttr, entry, rid);
+        }
+    }
+    free(oldTuple);
+    free(newTuple);
+    free(entry);
+}
+
+/**
+ * closeIndexFile() - close the handle of an index file kept open, before the file is destroyed or rebuilt.
+ * @argument1 : name of the index file.
+ *
+ * The changes held by its delta buffer are merged into the file. A handle read by an open
+ * scan is not closed.
+ *
+ * Return : 0 on success, -1 if the index is under an open scan.
+ */
+RC RelationManager::closeIndexFile(const std::string& indexFileName) {
+    if(this->indexScans.find(indexFileName) != this->indexScans.end()) return -1;
+    auto itr = this->indexFileHandles.find(indexFileName);
+    if(itr == this->indexFileHandles.end()) return 0;
+    // the lists of the tables point to the handles
+    this->tableIndexes.clear();
+    IndexManager::instance().closeFile(*itr->second);
+    delete itr->second;
+    this->indexFileHandles.erase(itr);
+    return 0;
+}
+
+/**
+ * closeIndexFiles() - close every index file kept open.
+ *
+ * Return : void.
+ */
+void RelationManager::closeIndexFiles() {
+    this->tableIndexes.clear();
+    for(auto& indexFileHandle : this->indexFileHandles) {
+        IndexManager::instance().closeFile(*indexFileHandle.second);
+        delete indexFileHandle.second;
+    }
+    this->indexFileHandles.clear();
+}
+
+/**
+ * runBackgroundSchemaMigration() - one throttled migration step after a write to a table.
+ * @argument1 : name of the table.
+ *
+ * Return : void.
+ */
+void RelationManager::runBackgroundSchemaMigration(const std::string& tableName) {
+    if(this->backgroundMigrationBatch == 0 || columnsMap[tableName].size() <= 1) return;
+
+    // the last pass could not move every row, wait for the next schema change or vacuum.
+    auto itr = schemaMigrations.find(tableName);
+    if(itr != schemaMigrations.end() && itr->second.passDone &&
+       itr->second.targetVersion == getLatestTableVersion(tableName)) return;
+
+    migrateSchema(tableName, this->backgroundMigrationBatch);
+}
+
+/**
+ * retireOldSchemaVersions() - removes all but the latest version of a table from the catalog.
+ * @argument1 : name of the table.
+ *
+ * Call this only when no row of the table references an old version.
+ *
+ * Return : void.
+ */
+void RelationManager::retireOldSchemaVersions(const std::string& tableName) {
+    int latestVersion = getLatestTableVersion(tableName);
+    auto& versions = this->columnsMap[tableName];
+    for(auto itr = versions.begin(); itr != versions.end(); ) {
+        if(itr->first == latestVersion) {
+            itr++;
+            continue;
+        }
+        for(auto rid : itr->second.ridAttribute) {
+            rbfm.deleteRecord(this->columnFileHandle, this->columnAttributes, rid);
+        }
+        rbfm.columnsMap[tableName].erase(itr->first);
+        rbfm.projectionCache[tableName].erase(itr->first);
+        itr = versions.erase(itr);
+    }
+}
+
+/**
+ * openStatisticsTable() - make the Statistics table the current file.
+ * @argument1 : create and register the table in the catalog if it does not exist.
+ *
+ * Return : 0 on success, -1 if the table does not exist or cannot be created.
+ */
+RC RelationManager::openStatisticsTable(const bool create) {
+    if(!isTableExist(STATISTICS_FILE)) {
+        if(!create || !isCatalogInitialized()) return -1;
+        if(rbfm.createFile(STATISTICS_FILE) == -1) return -1;
+        int table_id = -1;
+        createAndInsertTablesData(STATISTICS_FILE, table_id);
+        createAndInsertColumnsData(STATISTICS_FILE, this->statisticsAttributes, table_id);
+    }
+
+    if(currFile == "") {
+        rbfm.openFile(STATISTICS_FILE, this->fileHandle);
+        this->currFile = STATISTICS_FILE;
+    } else if(currFile != STATISTICS_FILE) {
+        rbfm.closeFile(this->fileHandle);
+        this->currFile = STATISTICS_FILE;
+        rbfm.openFile(STATISTICS_FILE, this->fileHandle);
+    }
+    return 0;
+}
+
+/**
+ * deleteStatistics() - removes the rows of a table from the Statistics table.
+ * @argument1 : name of the table.
+ *
+ * Return : 0 on success, -1 on failure.
+ */
+RC RelationManager::deleteStatistics(const std::string& tableName) {
+    if(!isTableExist(STATISTICS_FILE)) return 0;
+    if(openStatisticsTable(false) == -1) return -1;
+
+    int len = tableName.size();
+    void* value = malloc(sizeof(int) + len);
+    memcpy((char*)value, &len, sizeof(int));
+    memcpy((char*)value + sizeof(int), tableName.c_str(), len);
+    std::vector<std::string> attributeNames(1, this->statisticsAttributes[STATS_KIND].name);
+    RM_ScanIterator rmsi;
+    RC rc = this->scan(STATISTICS_FILE, this->statisticsAttributes[STATS_TABLE_NAME].name, EQ_OP, value,
+                       attributeNames, rmsi);
+    free(value);
+    if(rc == -1) return -1;
+
+    // the rows are deleted once the scan is over.
+    RID rid;
+    std::vector<RID> rids;
+    void* data = malloc(PAGE_SIZE);
+    while(rmsi.getNextTuple(rid, data) != RM_EOF) {
+        rids.push_back(rid);
+    }
+    rmsi.close();
+    free(data);
+
+    for(auto statisticsRID : rids) {
+        if(rbfm.deleteRecord(this->fileHandle, this->statisticsAttributes, statisticsRID) == -1) return -1;
+    }
+    return 0;
+}
+
+/**
+ * insertStatistics() - insert a row into the Statistics table, which must be the current file.
+ * @argument1 : name of the table.
+ * @argument2 : name of the table, of the column or of the index the row is about.
+ * @argument3 : kind of the row.
+ * @argument4 : number of rows, NULL if negative.
+ * @argument5 : number of pages, NULL if negative.
+ * @argument6 : statistics of a column, NULL for other kinds.
+ * @argument7 : statistics of an index, NULL for other kinds.
+ *
+ * Return : 0 on success, -1 on failure.
+ */
+RC RelationManager::insertStatistics(const std::string& tableName, const std::string& objectName,
+                                     const StatisticsKind kind, const int rowCount, const int pages,
+                                     const ColumnStatistics* columnStats, const IndexStatistics* indexStats) {
+    int nullBytes = ceil((double)this->statisticsAttributes.size()/CHAR_BIT);
+    char* data = (char*)malloc(PAGE_SIZE);
+    memset(data, 0, nullBytes);
+    int dataOffset = nullBytes;
+    unsigned field = 0;
+    // appends the next field, a NULL value sets its bit.
+    auto append = [&](const void* value, int len, bool isVarChar) {
+        if(value == NULL) {
+            data[field / CHAR_BIT] |= 1 << (CHAR_BIT - 1 - field % CHAR_BIT);
+        } else {
+            if(isVarChar) {
+                memcpy(data + dataOffset, &len, sizeof(int));
+                dataOffset += sizeof(int);
+            }
+            memcpy(data + dataOffset, value, len);
+            dataOffset += len;
+        }
+        field++;
+    };
+
+    bool hasRange = columnStats != NULL && columnStats->hasRange;
+    append(tableName.c_str(), tableName.size(), true);
+    append(objectName.c_str(), objectName.size(), true);
+    append(&kind, sizeof(int), false);
+    append(rowCount < 0 ? NULL : &rowCount, sizeof(int), false);
+    append(pages < 0 ? NULL : &pages, sizeof(int), false);
+    append(columnStats ? &columnStats->nullFraction : NULL, sizeof(float), false);
+    append(columnStats ? &columnStats->distinctCount : NULL, sizeof(int), false);
+    append(hasRange ? &columnStats->minValue : NULL, sizeof(float), false);
+    append(hasRange ? &columnStats->maxValue : NULL, sizeof(float), false);
+    append(hasRange ? columnStats->histogram.data() : NULL, hasRange ? columnStats->histogram.size() * sizeof(float) : 0, true);
+    append(indexStats ? &indexStats->height : NULL, sizeof(int), false);
+    append(indexStats ? &indexStats->leafPages : NULL, sizeof(int), false);
+
+    RID rid;
+    RC rc = rbfm.insertRecord(this->fileHandle, this->statisticsAttributes, data, rid);
+    free(data);
+    return rc == -1 ? -1 : 0;
+}
+
+/**
+ * readStatistics() - read a row of the Statistics table.
+ * @argument1 : name of the table.
+ * @argument2 : name of the table, of the column or of the index the row is about.
+ * @argument3 : kind of the row.
+ * @argument4 : the row with every column (out parameter).
+ *
+ * Return : 0 on success, -1 if there is no such row.
+ */
+RC RelationManager::readStatistics(const std::string& tableName, const std::string& objectName,
+                                   const StatisticsKind kind, void* data) {
+    if(openStatisticsTable(false) == -1) return -1;
+
+    int len = tableName.size();
+    void* value = malloc(sizeof(int) + len);
+    memcpy((char*)value, &len, sizeof(int));
+    memcpy((char*)value + sizeof(int), tableName.c_str(), len);
+    std::vector<std::string> attributeNames;
+    for(auto attr : this->statisticsAttributes) {
+        attributeNames.push_back(attr.name);
+    }
+    RM_ScanIterator rmsi;
+    RC rc = this->scan(STATISTICS_FILE, this->statisticsAttributes[STATS_TABLE_NAME].name, EQ_OP, value,
+                       attributeNames, rmsi);
+    free(value);
+    if(rc == -1) return -1;
+
+    RID rid;
+    std::vector<const char*> fields;
+    bool found = false;
+    while(!found && rmsi.getNextTuple(rid, data) != RM_EOF) {
+        getTupleFields(this->statisticsAttributes, data, fields);
+        int rowKind = -1;
+        memcpy(&rowKind, fields[STATS_KIND], sizeof(int));
+        memcpy(&len, fields[STATS_OBJECT_NAME], sizeof(int));
+        found = rowKind == kind && objectName == std::string(fields[STATS_OBJECT_NAME] + sizeof(int), len);
+    }
+    rmsi.close();
+    return found ? 0 : -1;
+}
+
+/**
+ * analyzeColumns() - scans a table for the statistics of its columns.
+ * @argument1 : name of the table.
+ * @argument2 : latest columns of the table.
+ * @argument3 : number of values sampled per Int or Real column.
+ * @argument4 : number of rows (out parameter).
+ * @argument5 : statistics of each column (out parameter).
+ *
+ * The distinct values are counted on every row, the sample is drawn with a reservoir and a
+ * fixed seed so that the same table gives the same histogram.
+ *
+ * Return : 0 on success, -1 on failure.
+ */
+RC RelationManager::analyzeColumns(const std::string& tableName, const std::vector<Attribute>& recordDescriptor,
+                                   const unsigned sampleSize, int& rowCount, std::vector<ColumnStatistics>& columnStats) {
+    std::vector<std::string> attributeNames;
+    for(auto attr : recordDescriptor) {
+        attributeNames.push_back(attr.name);
+    }
+    RM_ScanIterator rmsi;
+    if(this->scan(tableName, "", NO_OP, NULL, attributeNames, rmsi) == -1) return -1;
+
+    unsigned columns = recordDescriptor.size();
+    std::vector<HyperLogLog> sketches(columns);
+    std::vector<std::vector<float>> samples(columns);
+    std::vector<int> nulls(columns, 0), values(columns, 0);
+    std::vector<const char*> fields;
+    std::mt19937 generator;
+    columnStats.assign(columns, ColumnStatistics());
+    rowCount = 0;
+
+    RID rid;
+    void* data = malloc(PAGE_SIZE);
+    while(rmsi.getNextTuple(rid, data) != RM_EOF) {
+        rowCount++;
+        getTupleFields(recordDescriptor, data, fields);
+        for(unsigned i = 0; i < columns; i++) {
+            if(fields[i] == NULL) {
+                nulls[i]++;
+                continue;
+            }
+            sketches[i].add(BloomFilter::hashValue(recordDescriptor[i].type, fields[i]));
+            if(recordDescriptor[i].type == TypeVarChar) continue;
+
+            float number = 0;
+            if(recordDescriptor[i].type == TypeInt) {
+                int intValue = 0;
+                memcpy(&intValue, fields[i], sizeof(int));
+                number = intValue;
+            } else {
+                memcpy(&number, fields[i], sizeof(float));
+            }
+            ColumnStatistics& stats = columnStats[i];
+            if(!stats.hasRange || number < stats.minValue) stats.minValue = number;
+            if(!stats.hasRange || number > stats.maxValue) stats.maxValue = number;
+            stats.hasRange = true;
+
+            // value k replaces a random one of the sample with probability sampleSize / (k + 1).
+            if(samples[i].size() < sampleSize) {
+                samples[i].push_back(number);
+            } else {
+                unsigned slot = generator() % ((unsigned)values[i] + 1);
+                if(slot < sampleSize) samples[i][slot] = number;
+            }
+            values[i]++;
+        }
+    }
+    rmsi.close();
+    free(data);
+
+    for(unsigned i = 0; i < columns; i++) {
+        ColumnStatistics& stats = columnStats[i];
+        int nonNull = rowCount - nulls[i];
+        stats.rowCount = rowCount;
+        stats.nullFraction = rowCount == 0 ? 0 : (float)nulls[i] / rowCount;
+        stats.distinctCount = nonNull == 0 ? 0 : std::min(std::max((int)round(sketches[i].estimate()), 1), nonNull);
+
+        // bucket j of the equi-depth histogram spans the values j/B to (j+1)/B of the sorted sample.
+        std::vector<float>& sample = samples[i];
+        if(sample.empty()) continue;
+        std::sort(sample.begin(), sample.end());
+        unsigned buckets = std::min((unsigned)sample.size(), STATS_HISTOGRAM_BUCKETS);
+        for(unsigned j = 0; j <= buckets; j++) {
+            stats.histogram.push_back(sample[(size_t)j * (sample.size() - 1) / buckets]);
+        }
+        stats.histogram.front() = stats.minValue;
+        stats.histogram.back() = stats.maxValue;
+    }
     return 0;
 }
 
@@ -1195,7 +2646,7 @@ RC RelationManager::populateIndexOnAttribute(const std::string& tableName,
  * Return : true if system, false otherwise.
  */
 bool RelationManager::isSystemTable(const std::string &tableName) {
-    return (tableName == TABLES_FILE || tableName == COLUMNS_FILE);
+    return (tableName == TABLES_FILE || tableName == COLUMNS_FILE || tableName == STATISTICS_FILE);
 }
 
 /**
@@ -13,6 +13,99 @@
 //System files
 #define TABLES_FILE "Tables"
 #define COLUMNS_FILE "Columns"
+//Statistics of the analyzed tables, registered in the catalog by the first analyzeTable().
+#define STATISTICS_FILE "Statistics"
+//Scratch file used while a table is being vacuumed.
+#define VACUUM_FILE_SUFFIX ".vacuum"
+
+// Number of rows copied between two progress reports of vacuumTable().
+const unsigned VACUUM_PROGRESS_INTERVAL = 500;
+
+// Progress hook for long running table maintenance (vacuumTable).
+typedef void (*ProgressCallback)(const std::string &tableName, unsigned rowsDone, unsigned rowsTotal);
+
+// Number of slots examined by one step of the schema migration.
+const unsigned SCHEMA_MIGRATION_BATCH = 100;
+
+// Progress of the incremental rewrite of old-version rows of a table.
+struct SchemaMigrationInfo {
+    RID cursor;             // last slot examined.
+    int targetVersion;      // version the current pass migrates to.
+    unsigned skipped;       // old rows left in place during the current pass.
+    bool passDone;          // a pass ended with rows left in place, only vacuumTable() can finish it.
+
+    SchemaMigrationInfo() {
+        cursor.pageNum = 0;
+        cursor.slotNum = 0;
+        targetVersion = -1;
+        skipped = 0;
+        passDone = false;
+    }
+};
+
+// Number of Int/Real values kept per column by analyzeTable() to build the histogram.
+const unsigned STATS_SAMPLE_SIZE = 1000;
+
+// Number of buckets of an equi-depth histogram.
+const unsigned STATS_HISTOGRAM_BUCKETS = 16;
+
+// A HyperLogLog sketch has 2^HLL_PRECISION registers, about 3% error on the distinct count.
+const unsigned HLL_PRECISION = 10;
+
+// Kind of the rows of the Statistics table.
+typedef enum { TABLE_STATISTICS = 0, COLUMN_STATISTICS, INDEX_STATISTICS } StatisticsKind;
+
+// Sketch of the number of distinct values of a column, in a fixed amount of memory.
+class HyperLogLog {
+private:
+    std::vector<unsigned char> registers;
+public:
+    HyperLogLog() : registers(1 << HLL_PRECISION, 0) {}
+
+    // hash of a value from BloomFilter::hashValue().
+    void add(unsigned long long hash);
+
+    double estimate() const;
+};
+
+struct TableStatistics {
+    int rowCount;
+    int pages;                  // pages of the heap file.
+
+    TableStatistics() : rowCount(0), pages(0) {}
+};
+
+struct ColumnStatistics {
+    int rowCount;
+    float nullFraction;
+    int distinctCount;          // estimated number of distinct non NULL values.
+    bool hasRange;              // min, max and histogram are only kept for Int and Real columns.
+    float minValue;
+    float maxValue;
+    std::vector<float> histogram;   // bounds of the equi-depth buckets, from minValue to maxValue.
+
+    ColumnStatistics() : rowCount(0), nullFraction(0), distinctCount(0), hasRange(false), minValue(0), maxValue(0) {}
+
+    // Estimated fraction of the rows whose value satisfies "value op constant".
+    float estimateSelectivity(const CompOp compOp, const float value) const;
+};
+
+struct IndexStatistics {
+    int height;
+    int leafPages;
+    int pages;                  // pages of the index file in use.
+
+    IndexStatistics() : height(0), leafPages(0), pages(0) {}
+};
+
+// Index of a table kept open by RelationManager for the writes to the table.
+struct TableIndex {
+    std::string fileName;
+    std::vector<Attribute> indexAttrs;      // columns of the index, see getIndexEntryFromTuple()
+    std::vector<int> positions;             // position of each of them in the latest columns of the table
+    Attribute keyAttr;                      // attribute under which the keys are indexed
+    IXFileHandle* ixFileHandle;             // owned by RelationManager::indexFileHandles
+};
 
 // RM_ScanIterator is an iterator to go through tuples
 class RM_ScanIterator {
@@ -48,25 +141,32 @@ public:
 class RM_IndexScanIterator {
 private:
     IX_ScanIterator ixsi;
-    IXFileHandle ixFileHandle;
+    IXFileHandle* ixFileHandle;             // index file kept open by RelationManager until the scan is closed
+    std::string indexFileName;
+    Attribute attribute;
     IndexManager& ixm;
 public:
-    RM_IndexScanIterator() : ixm(IndexManager::instance()) { }
+    RM_IndexScanIterator() : ixFileHandle(NULL), ixm(IndexManager::instance()) { }
 
-    ~RM_IndexScanIterator() = default;
+    ~RM_IndexScanIterator() {
+        close();
+    }
     
  
     RC initializeScanIterator(const string &tableName, const string &attributeName,
                               const void *lowKey, const void *highKey,
                               bool lowKeyInclusive, bool highKeyInclusive);
 
+    RC initializeScanIterator(const string &indexFileName, const Attribute &attribute,
+                              const void *lowKey, const void *highKey,
+                              bool lowKeyInclusive, bool highKeyInclusive);
+
     RC getNextEntry(RID &rid, void *key);
 
-    RC close() {
-        ixsi.close();
-        this->ixm.closeFile(this->ixFileHandle);
-        return 0;
-    }
+    // Copy of the Bloom filter of the keys of the index, see IndexManager::getKeyFilter()
+    RC getKeyFilter(BloomFilter &filter);
+
+    RC close();
 
 };
 
@@ -99,6 +199,9 @@ public:
 
     RC readTuple(const std::string &tableName, const RID &rid, void *data);
 
+    // Reads the tuples of a batch of rids in page order, tuple i is returned at data + i*tupleSize.
+    RC readTuples(const std::string &tableName, const std::vector<RID> &rids, void *data, const int tupleSize);
+
     // Print a tuple that is passed to this utility method.
     // The format is the same as printRecord().
     RC printTuple(const std::vector<Attribute> &attrs, const void *data);
@@ -120,10 +223,44 @@ public:
     RC dropAttribute(const std::string &tableName, const std::string &attributeName);
 
     // QE IX related
-    RC createIndex(const std::string &tableName, const std::string &attributeName);
+    RC createIndex(const std::string &tableName, const std::string &attributeName,
+                   const float fillFactor = BULK_LOAD_FILL_FACTOR);
+
+    // Covering index, the values of the INCLUDE columns are stored in the index entries.
+    RC createIndex(const std::string &tableName, const std::string &attributeName,
+                   const std::vector<std::string> &includeAttributes,
+                   const float fillFactor = BULK_LOAD_FILL_FACTOR,
+                   const IndexKind indexKind = BTREE_INDEX);
+
+    // Index of the given kind, a hash index answers equality scans by reading one bucket.
+    RC createIndex(const std::string &tableName, const std::string &attributeName, const IndexKind indexKind);
+
+    // Key column followed by the INCLUDE columns of the index on attributeName.
+    RC getIndexAttributes(const std::string &tableName, const std::string &attributeName,
+                          std::vector<Attribute> &attrs);
+
+    // Tuple of the index columns from a key returned by an index scan, no heap page is read.
+    RC getTupleFromIndexEntry(const std::vector<Attribute> &indexAttrs, const void *entry, void *data);
 
     RC destroyIndex(const std::string &tableName, const std::string &attributeName);
 
+    // Index on several columns, ordered by the first column, then by the second and so on.
+    RC createCompositeIndex(const std::string &tableName, const std::vector<std::string> &attributeNames,
+                            const float fillFactor = BULK_LOAD_FILL_FACTOR);
+
+    RC destroyCompositeIndex(const std::string &tableName, const std::vector<std::string> &attributeNames);
+
+    // Range scan on the first prefixColumns columns of an index on several columns,
+    // the bounds hold the values of these columns one after the other.
+    RC compositeIndexScan(const std::string &tableName,
+                          const std::vector<std::string> &attributeNames,
+                          const void *lowKey,
+                          const void *highKey,
+                          const unsigned prefixColumns,
+                          bool lowKeyInclusive,
+                          bool highKeyInclusive,
+                          RM_IndexScanIterator &rm_IndexScanIterator);
+
     // indexScan returns an iterator to allow the caller to go through qualified entries in index
     RC indexScan(const std::string &tableName,
                  const std::string &attributeName,
@@ -133,12 +270,50 @@ public:
                  bool highKeyInclusive,
                  RM_IndexScanIterator &rm_IndexScanIterator);
 
+    // Rewrites the table into packed pages, optionally clustered on an indexed attribute.
+    // RIDs handed out before the vacuum are no longer valid after it.
+    RC vacuumTable(const std::string &tableName,
+                   const std::string &clusterAttribute = "",
+                   ProgressCallback progress = NULL);
+
+    // Rewrites rows of older schema versions in the latest version, examining batchSize slots per call.
+    // Returns RM_EOF at the end of a pass over the table.
+    RC migrateSchema(const std::string &tableName, const unsigned batchSize = SCHEMA_MIGRATION_BATCH);
+
+    // Run one migration step after every write to a table with old versions, 0 turns it off.
+    void setBackgroundSchemaMigration(const unsigned batchSize);
+
+    // Collects the statistics of a table, its columns and its indexes into the Statistics table.
+    // The histograms are built from a sample of sampleSize values per column.
+    RC analyzeTable(const std::string &tableName, const unsigned sampleSize = STATS_SAMPLE_SIZE);
+
+    // Statistics saved by the last analyzeTable() of the table, -1 if it was never analyzed.
+    RC getTableStatistics(const std::string &tableName, TableStatistics &stats);
+
+    RC getColumnStatistics(const std::string &tableName, const std::string &columnName, ColumnStatistics &stats);
+
+    // Statistics of the index on attributeName, the columns of an index on several columns are joined by '+'.
+    RC getIndexStatistics(const std::string &tableName, const std::string &attributeName, IndexStatistics &stats);
+
     vector<Attribute> getAttributesForVersion(const std::string& tableName, const int version);
 
     RC getLatestTableVersion(const std::string& tableName);
 
     bool isTableExist(const std::string& tableName);
 
+    // Open handle of an index file, kept until the index is destroyed or rebuilt. NULL if it can not be opened.
+    IXFileHandle* getIndexFileHandle(const std::string& indexFileName);
+
+    // Same handle for a scan, the index is not destroyed or rebuilt until releaseIndexFileHandle().
+    IXFileHandle* acquireIndexFileHandle(const std::string& indexFileName);
+
+    void releaseIndexFileHandle(const std::string& indexFileName);
+
+    // Holds the inserts and deletes of the B+ tree index on attributeName in memory, merged into the file
+    // when the buffer is full, on analyzeTable() or when the index is closed. The columns of an index
+    // on several columns are joined by '+'.
+    RC setIndexDeltaBuffer(const std::string &tableName, const std::string &attributeName);
+
 
 protected:
     RelationManager();                                                  // Prevent construction
@@ -148,10 +323,17 @@ protected:
 private:
     vector<Attribute> tableAttributes;
     vector<Attribute> columnAttributes;
+    vector<Attribute> statisticsAttributes;
     FileHandle tableFileHandle;
     FileHandle columnFileHandle;
     std::unordered_map<std::string, std::unordered_map<int, ColumnTableInfo>> columnsMap;
     std::unordered_map<std::string, TablesTableInfo> tableMap;
+    std::unordered_map<std::string, SchemaMigrationInfo> schemaMigrations;
+    std::unordered_map<std::string, IXFileHandle*> indexFileHandles;
+    std::unordered_map<std::string, int> indexScans;            // open scans of each index file
+    std::unordered_set<std::string> deltaBufferIndexes;         // index files given a delta buffer
+    std::unordered_map<std::string, std::vector<TableIndex>> tableIndexes;
+    unsigned backgroundMigrationBatch;
     RecordBasedFileManager& rbfm;
 
     void initializeTableAttribute(vector<Attribute>& tableAttributes);
@@ -186,11 +368,6 @@ private:
 
     std::string getTableNameFromId(const int tableID);
 
-    void formatRecordWithLatestSchemaChange(std::vector<Attribute>& recordDescriptor, 
-                                            std::vector<Attribute>& recordDescriptorLatest, 
-                                            std::vector<Attribute>& recordDescriptorLatestOriginal,
-                                            void* data);
-
     RC deleteTableEntryFromCatalog(const std::string& tableName);
 
     RC deleteTableFile(const std::string tableName);
@@ -201,10 +378,63 @@ private:
 
     RC populateIndexOnAttribute(const std::string& tableName,
                                 const::std::string& indexFileName,
-                                const std::vector<Attribute>& indexAttrNames);
+                                const std::vector<Attribute>& indexAttrNames,
+                                const float fillFactor = BULK_LOAD_FILL_FACTOR);
+
+    RC getIndexEntryFromTuple(const std::string& indexFileName, const std::vector<Attribute>& indexAttrs,
+                              const void* tuple, void* entry);
+
+    std::vector<TableIndex>& getTableIndexes(const std::string& tableName, const std::vector<Attribute>& recordDescriptor);
+
+    void updateIndexEntries(const std::string& tableName, const std::vector<Attribute>& recordDescriptor,
+                            const void* oldData, const void* newData, const RID& rid);
+
+    RC closeIndexFile(const std::string& indexFileName);
+
+    void closeIndexFiles();
+
+    std::string getIndexFileName(const std::string& tableName, const std::vector<std::string>& attributeNames);
+
+    bool isCompositeIndex(const std::string& indexFileName);
+
+    Attribute getIndexKeyAttribute(const std::string& indexFileName, const std::vector<Attribute>& indexAttrs);
+
+    void getIndexesOnTable(const std::string& tableName, const std::vector<Attribute>& recordDescriptor,
+                           std::vector<std::string>& indexFileNames);
 
     bool isSystemTable(const std::string& tableName);
 
+    int countTuples(const std::string& tableName, const std::vector<Attribute>& recordDescriptor);
+
+    int copyTuplesForVacuum(const std::string& tableName,
+                            const std::string& clusterAttribute,
+                            const std::vector<Attribute>& recordDescriptor,
+                            FileHandle& vacuumFileHandle,
+                            const unsigned rowsTotal,
+                            ProgressCallback progress);
+
+    RC rebuildIndexesOnTable(const std::string& tableName, const std::vector<Attribute>& recordDescriptor);
+
+    void runBackgroundSchemaMigration(const std::string& tableName);
+
+    void retireOldSchemaVersions(const std::string& tableName);
+
+    void initializeStatisticsAttribute(vector<Attribute>& statisticsAttributes);
+
+    RC openStatisticsTable(const bool create);
+
+    RC deleteStatistics(const std::string& tableName);
+
+    RC insertStatistics(const std::string& tableName, const std::string& objectName, const StatisticsKind kind,
+                        const int rowCount, const int pages, const ColumnStatistics* columnStats,
+                        const IndexStatistics* indexStats);
+
+    RC readStatistics(const std::string& tableName, const std::string& objectName, const StatisticsKind kind,
+                      void* data);
+
+    RC analyzeColumns(const std::string& tableName, const std::vector<Attribute>& recordDescriptor,
+                      const unsigned sampleSize, int& rowCount, std::vector<ColumnStatistics>& columnStats);
+
     bool isCatalogInitialized();
 };
 
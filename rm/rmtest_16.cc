@@ -0,0 +1,143 @@
+#include "rm_test_util.h"
+
+unsigned lastProgressReport = 0;
+
+void vacuumProgress(const std::string &tableName, unsigned rowsDone, unsigned rowsTotal) {
+    lastProgressReport = rowsDone;
+    std::cout << "Vacuum " << tableName << ": " << rowsDone << "/" << rowsTotal << " rows" << std::endl;
+}
+
+long fileSize(const std::string &fileName) {
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    return (long) file.tellg();
+}
+
+RC TEST_RM_16(const std::string &tableName) {
+    // Functions Tested
+    // 1. Insert, delete and update tuples to fragment the heap file
+    // 2. Vacuum the table clustered on an indexed attribute **
+    // 3. Scan and index scan on the vacuumed table
+    std::cout << std::endl << "***** In RM Test Case 16 *****" << std::endl;
+
+    RID rid;
+    unsigned tupleSize = 0;
+    int numTuples = 2000;
+    void *tuple = malloc(200);
+    void *returnedData = malloc(200);
+    std::vector<RID> rids;
+
+    std::vector<Attribute> attrs;
+    RC rc = rm.getAttributes(tableName, attrs);
+    assert(rc == success && "RelationManager::getAttributes() should not fail.");
+
+    int nullAttributesIndicatorActualSize = getActualByteForNullsIndicator(attrs.size());
+    auto *nullsIndicator = (unsigned char *) malloc(nullAttributesIndicatorActualSize);
+    memset(nullsIndicator, 0, nullAttributesIndicatorActualSize);
+
+    rc = rm.createIndex(tableName, "Age");
+    assert(rc == success && "RelationManager::createIndex() should not fail.");
+
+    // Ages are inserted in descending order so that clustering on Age reverses the heap order.
+    for (int i = 0; i < numTuples; i++) {
+        std::string name(5 + i % 20, 'a' + i % 26);
+        prepareTuple(attrs.size(), nullsIndicator, name.size(), name, numTuples - i, 170.5, i, tuple, &tupleSize);
+        rc = rm.insertTuple(tableName, tuple, rid);
+        assert(rc == success && "RelationManager::insertTuple() should not fail.");
+        rids.push_back(rid);
+    }
+
+    // Delete one third of the table and grow some of the remaining tuples to force forwarding.
+    int numLive = 0;
+    for (int i = 0; i < numTuples; i++) {
+        if (i % 3 == 0) {
+            rc = rm.deleteTuple(tableName, rids[i]);
+            assert(rc == success && "RelationManager::deleteTuple() should not fail.");
+            continue;
+        }
+        numLive++;
+        if (i % 5 == 1) {
+            std::string name(60, 'z');
+            prepareTuple(attrs.size(), nullsIndicator, name.size(), name, numTuples - i, 170.5, i, tuple, &tupleSize);
+            rc = rm.updateTuple(tableName, tuple, rids[i]);
+            assert(rc == success && "RelationManager::updateTuple() should not fail.");
+        }
+    }
+
+    long sizeBefore = fileSize(tableName);
+
+    rc = rm.vacuumTable(tableName, "Age", vacuumProgress);
+    assert(rc == success && "RelationManager::vacuumTable() should not fail.");
+
+    long sizeAfter = fileSize(tableName);
+    if (sizeAfter >= sizeBefore || lastProgressReport != (unsigned) numLive) {
+        std::cout << "***** [FAIL] Test Case 16 Failed: file was not compacted. *****" << std::endl << std::endl;
+        free(tuple);
+        free(returnedData);
+        free(nullsIndicator);
+        return -1;
+    }
+
+    // The heap order should follow the Age index after the vacuum.
+    RM_ScanIterator rmsi;
+    std::vector<std::string> attributes;
+    attributes.push_back("Age");
+    attributes.push_back("Salary");
+    rc = rm.scan(tableName, "", NO_OP, NULL, attributes, rmsi);
+    assert(rc == success && "RelationManager::scan() should not fail.");
+
+    int count = 0;
+    int prevAge = 0;
+    bool failed = false;
+    while (rmsi.getNextTuple(rid, returnedData) != RM_EOF) {
+        int age = *(int *) ((char *) returnedData + 1);
+        int salary = *(int *) ((char *) returnedData + 5);
+        if (age < prevAge || salary % 3 == 0 || age != numTuples - salary) {
+            failed = true;
+        }
+        prevAge = age;
+        count++;
+    }
+    rmsi.close();
+
+    // Every index entry must point to the new location of its tuple.
+    RM_IndexScanIterator rmisi;
+    rc = rm.indexScan(tableName, "Age", NULL, NULL, true, true, rmisi);
+    assert(rc == success && "RelationManager::indexScan() should not fail.");
+
+    int indexCount = 0;
+    int key = 0;
+    while (rmisi.getNextEntry(rid, &key) != RM_EOF) {
+        rc = rm.readAttribute(tableName, rid, "Age", returnedData);
+        if (rc != success || *(int *) ((char *) returnedData + 1) != key) {
+            failed = true;
+        }
+        indexCount++;
+    }
+    rmisi.close();
+
+    free(tuple);
+    free(returnedData);
+    free(nullsIndicator);
+
+    if (failed || count != numLive || indexCount != numLive) {
+        std::cout << "***** [FAIL] Test Case 16 Failed *****" << std::endl << std::endl;
+        return -1;
+    }
+
+    rc = rm.destroyIndex(tableName, "Age");
+    assert(rc == success && "RelationManager::destroyIndex() should not fail.");
+
+    rc = rm.deleteTable(tableName);
+    assert(rc == success && "RelationManager::deleteTable() should not fail.");
+
+    std::cout << "***** RM Test Case 16 finished. The result will be examined. *****" << std::endl << std::endl;
+    return success;
+}
+
+int main() {
+    // Drop the table for the case where we execute this test multiple times.
+    rm.destroyIndex("tbl_vacuum", "Age");
+    rm.deleteTable("tbl_vacuum");
+    createTable("tbl_vacuum");
+    return TEST_RM_16("tbl_vacuum");
+}
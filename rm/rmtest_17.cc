@@ -0,0 +1,121 @@
+#include "rm_test_util.h"
+
+// Tuple in the schema (EmpName, Age, Salary, SSN) left after the schema changes of the test.
+void prepareMigratedTuple(const std::string &name, const int age, const int salary, const int ssn,
+                          const bool ssnIsNull, void *buffer, unsigned *tupleSize) {
+    unsigned offset = 0;
+    unsigned char nullIndicator = ssnIsNull ? (1 << 4) : 0;
+    memcpy((char *) buffer + offset, &nullIndicator, 1);
+    offset += 1;
+
+    int nameLength = name.size();
+    memcpy((char *) buffer + offset, &nameLength, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buffer + offset, name.c_str(), nameLength);
+    offset += nameLength;
+    memcpy((char *) buffer + offset, &age, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buffer + offset, &salary, sizeof(int));
+    offset += sizeof(int);
+    if (!ssnIsNull) {
+        memcpy((char *) buffer + offset, &ssn, sizeof(int));
+        offset += sizeof(int);
+    }
+    *tupleSize = offset;
+}
+
+RC TEST_RM_17(const std::string &tableName) {
+    // Functions Tested
+    // 1. Insert tuples, add and drop attributes
+    // 2. Incremental schema migration **
+    // 3. Read tuples after the old versions have been retired
+    std::cout << std::endl << "***** In RM Test Case 17 *****" << std::endl;
+
+    RID rid;
+    unsigned tupleSize = 0;
+    int numOldTuples = 300;
+    int numNewTuples = 50;
+    void *tuple = malloc(200);
+    void *returnedData = malloc(200);
+    std::vector<RID> rids;
+
+    std::vector<Attribute> attrs;
+    RC rc = rm.getAttributes(tableName, attrs);
+    assert(rc == success && "RelationManager::getAttributes() should not fail.");
+
+    unsigned char nullsIndicator = 0;
+    for (int i = 0; i < numOldTuples; i++) {
+        std::string name(5 + i % 10, 'a' + i % 26);
+        prepareTuple(attrs.size(), &nullsIndicator, name.size(), name, i, 160.5, 1000 + i, tuple, &tupleSize);
+        rc = rm.insertTuple(tableName, tuple, rid);
+        assert(rc == success && "RelationManager::insertTuple() should not fail.");
+        rids.push_back(rid);
+    }
+
+    Attribute attr;
+    attr.name = "SSN";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    rc = rm.addAttribute(tableName, attr);
+    assert(rc == success && "RelationManager::addAttribute() should not fail.");
+
+    rc = rm.dropAttribute(tableName, "Height");
+    assert(rc == success && "RelationManager::dropAttribute() should not fail.");
+
+    for (int i = numOldTuples; i < numOldTuples + numNewTuples; i++) {
+        std::string name(5 + i % 10, 'a' + i % 26);
+        prepareMigratedTuple(name, i, 1000 + i, i * 7, false, tuple, &tupleSize);
+        rc = rm.insertTuple(tableName, tuple, rid);
+        assert(rc == success && "RelationManager::insertTuple() should not fail.");
+        rids.push_back(rid);
+    }
+
+    // Migrate in small batches until the pass completes.
+    int steps = 0;
+    while ((rc = rm.migrateSchema(tableName, 20)) == success) {
+        steps++;
+    }
+    assert(rc == RM_EOF && "RelationManager::migrateSchema() should not fail.");
+
+    bool failed = steps < 2 || rbfm.columnsMap[tableName].size() != 1;
+
+    // Add one more column, the version numbering must continue after the retired versions.
+    attr.name = "Bonus";
+    rc = rm.addAttribute(tableName, attr);
+    assert(rc == success && "RelationManager::addAttribute() should not fail.");
+
+    for (int i = 0; i < numOldTuples + numNewTuples; i++) {
+        std::string name(5 + i % 10, 'a' + i % 26);
+        bool isOld = i < numOldTuples;
+        prepareMigratedTuple(name, i, 1000 + i, i * 7, isOld, tuple, &tupleSize);
+        // Bonus is always null.
+        *(unsigned char *) tuple |= (1 << 3);
+
+        rc = rm.readTuple(tableName, rids[i], returnedData);
+        assert(rc == success && "RelationManager::readTuple() should not fail.");
+        if (memcmp(tuple, returnedData, tupleSize) != 0) {
+            failed = true;
+        }
+    }
+
+    free(tuple);
+    free(returnedData);
+
+    if (failed) {
+        std::cout << "***** [FAIL] Test Case 17 Failed *****" << std::endl << std::endl;
+        return -1;
+    }
+
+    rc = rm.deleteTable(tableName);
+    assert(rc == success && "RelationManager::deleteTable() should not fail.");
+
+    std::cout << "***** RM Test Case 17 finished. The result will be examined. *****" << std::endl << std::endl;
+    return success;
+}
+
+int main() {
+    // Drop the table for the case where we execute this test multiple times.
+    rm.deleteTable("tbl_migrate");
+    createTable("tbl_migrate");
+    return TEST_RM_17("tbl_migrate");
+}
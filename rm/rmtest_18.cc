@@ -0,0 +1,216 @@
+#include "rm_test_util.h"
+
+const int numTuples = 4000;
+
+// Tuple (Id, Grp, Score, Name), Score is NULL for every fourth tuple and Name takes 200 values.
+void prepareStatsTuple(const int id, void *buffer) {
+    unsigned offset = 0;
+    unsigned char nullIndicator = id % 4 == 3 ? (1 << 5) : 0;
+    memcpy((char *) buffer + offset, &nullIndicator, 1);
+    offset += 1;
+
+    int grp = id % 50;
+    memcpy((char *) buffer + offset, &id, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buffer + offset, &grp, sizeof(int));
+    offset += sizeof(int);
+    if (id % 4 != 3) {
+        float score = id * 0.5f;
+        memcpy((char *) buffer + offset, &score, sizeof(float));
+        offset += sizeof(float);
+    }
+    std::string name = "name_" + std::to_string(id % 200);
+    int nameLength = name.size();
+    memcpy((char *) buffer + offset, &nameLength, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buffer + offset, name.c_str(), nameLength);
+}
+
+RC createStatsTable(const std::string &tableName) {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "Id";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    attrs.push_back(attr);
+
+    attr.name = "Grp";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    attrs.push_back(attr);
+
+    attr.name = "Score";
+    attr.type = TypeReal;
+    attr.length = (AttrLength) 4;
+    attrs.push_back(attr);
+
+    attr.name = "Name";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength) 20;
+    attrs.push_back(attr);
+
+    return rm.createTable(tableName, attrs);
+}
+
+void insertStatsTuples(const std::string &tableName, const int first, const int last) {
+    void *tuple = malloc(100);
+    RID rid;
+    for (int id = first; id < last; id++) {
+        prepareStatsTuple(id, tuple);
+        RC rc = rm.insertTuple(tableName, tuple, rid);
+        assert(rc == success && "RelationManager::insertTuple() should not fail.");
+    }
+    free(tuple);
+}
+
+bool isClose(const float value, const float expected, const float tolerance) {
+    return value >= expected - tolerance && value <= expected + tolerance;
+}
+
+// Checks the statistics of a column, the distinct count within 10%.
+bool checkColumn(const std::string &tableName, const std::string &column, const int rows, const float nullFraction,
+                 const int distinctCount, const bool hasRange, const float minValue, const float maxValue) {
+    ColumnStatistics stats;
+    if (rm.getColumnStatistics(tableName, column, stats) != success) {
+        std::cout << "No statistics for " << column << std::endl;
+        return false;
+    }
+    std::cout << column << ": rows " << stats.rowCount << ", null fraction " << stats.nullFraction
+              << ", distinct " << stats.distinctCount << " (exact " << distinctCount << ")";
+    if (stats.hasRange) std::cout << ", range [" << stats.minValue << ", " << stats.maxValue << "]";
+    std::cout << std::endl;
+
+    bool valid = stats.rowCount == rows && isClose(stats.nullFraction, nullFraction, 0.001) &&
+                 isClose(stats.distinctCount, distinctCount, distinctCount * 0.1f) && stats.hasRange == hasRange;
+    if (hasRange) {
+        valid = valid && stats.minValue == minValue && stats.maxValue == maxValue &&
+                stats.histogram.size() == STATS_HISTOGRAM_BUCKETS + 1;
+        // the bounds of a uniform column are evenly spaced.
+        for (unsigned j = 0; valid && j < stats.histogram.size(); j++) {
+            float expected = minValue + (maxValue - minValue) * j / STATS_HISTOGRAM_BUCKETS;
+            if (!isClose(stats.histogram[j], expected, (maxValue - minValue) * 0.05f)) valid = false;
+            if (j > 0 && stats.histogram[j] < stats.histogram[j - 1]) valid = false;
+        }
+    } else {
+        valid = valid && stats.histogram.empty();
+    }
+    if (!valid) std::cout << "Wrong statistics for " << column << std::endl;
+    return valid;
+}
+
+// Rows of the Statistics table about a table.
+int countStatisticsRows(const std::string &tableName) {
+    int len = tableName.size();
+    void *value = malloc(sizeof(int) + len);
+    memcpy((char *) value, &len, sizeof(int));
+    memcpy((char *) value + sizeof(int), tableName.c_str(), len);
+    std::vector<std::string> attributeNames(1, "object-name");
+    RM_ScanIterator rmsi;
+    RC rc = rm.scan(STATISTICS_FILE, "table-name", EQ_OP, value, attributeNames, rmsi);
+    assert(rc == success && "RelationManager::scan() should not fail.");
+
+    RID rid;
+    void *data = malloc(PAGE_SIZE);
+    int rows = 0;
+    while (rmsi.getNextTuple(rid, data) != RM_EOF) {
+        rows++;
+    }
+    rmsi.close();
+    free(data);
+    free(value);
+    return rows;
+}
+
+RC TEST_RM_18(const std::string &tableName) {
+    // Functions Tested
+    // 1. analyzeTable() collects the statistics of the table, its columns and its indexes **
+    // 2. The statistics are kept in the Statistics table and replaced by the next analyze **
+    // 3. Selectivity estimates from the statistics of a column **
+    // 4. deleteTable() removes the statistics of the table
+    std::cout << std::endl << "***** In RM Test Case 18 *****" << std::endl;
+
+    TableStatistics tableStats;
+    bool valid = rm.getTableStatistics(tableName, tableStats) != success;
+
+    insertStatsTuples(tableName, 0, numTuples);
+    RC rc = rm.createIndex(tableName, "Id");
+    assert(rc == success && "RelationManager::createIndex() should not fail.");
+    rc = rm.createIndex(tableName, "Grp", HASH_INDEX);
+    assert(rc == success && "RelationManager::createIndex() should not fail.");
+
+    rc = rm.analyzeTable(tableName);
+    assert(rc == success && "RelationManager::analyzeTable() should not fail.");
+
+    rc = rm.getTableStatistics(tableName, tableStats);
+    assert(rc == success && "RelationManager::getTableStatistics() should not fail.");
+    std::cout << "Rows: " << tableStats.rowCount << ", pages: " << tableStats.pages << std::endl;
+    if (tableStats.rowCount != numTuples || tableStats.pages < 10) valid = false;
+
+    valid = checkColumn(tableName, "Id", numTuples, 0, numTuples, true, 0, numTuples - 1) && valid;
+    valid = checkColumn(tableName, "Grp", numTuples, 0, 50, true, 0, 49) && valid;
+    valid = checkColumn(tableName, "Score", numTuples, 0.25, numTuples * 3 / 4, true, 0, (numTuples - 2) * 0.5f) && valid;
+    valid = checkColumn(tableName, "Name", numTuples, 0, 200, false, 0, 0) && valid;
+
+    IndexStatistics btreeStats, hashStats;
+    rc = rm.getIndexStatistics(tableName, "Id", btreeStats);
+    assert(rc == success && "RelationManager::getIndexStatistics() should not fail.");
+    rc = rm.getIndexStatistics(tableName, "Grp", hashStats);
+    assert(rc == success && "RelationManager::getIndexStatistics() should not fail.");
+    std::cout << "Id index: height " << btreeStats.height << ", leaf pages " << btreeStats.leafPages
+              << ", pages " << btreeStats.pages << std::endl;
+    std::cout << "Grp hash index: buckets " << hashStats.leafPages << ", pages " << hashStats.pages << std::endl;
+    if (btreeStats.height < 2 || btreeStats.leafPages < 2 || btreeStats.pages <= btreeStats.leafPages) valid = false;
+    if (hashStats.height != 1 || hashStats.leafPages < 1) valid = false;
+
+    // Id < 1000 holds a quarter of the rows, Grp = 7 one in fifty, NULL scores never match.
+    ColumnStatistics idStats, grpStats, scoreStats;
+    rm.getColumnStatistics(tableName, "Id", idStats);
+    rm.getColumnStatistics(tableName, "Grp", grpStats);
+    rm.getColumnStatistics(tableName, "Score", scoreStats);
+    float idRange = idStats.estimateSelectivity(LT_OP, 1000);
+    float grpEqual = grpStats.estimateSelectivity(EQ_OP, 7);
+    float scoreRange = scoreStats.estimateSelectivity(GE_OP, 0);
+    std::cout << "Selectivity of Id < 1000: " << idRange << ", Grp = 7: " << grpEqual
+              << ", Score >= 0: " << scoreRange << std::endl;
+    if (!isClose(idRange, 0.25, 0.03) || !isClose(grpEqual, 0.02, 0.003) || !isClose(scoreRange, 0.75, 0.01)) {
+        valid = false;
+    }
+    if (idStats.estimateSelectivity(GT_OP, numTuples) != 0 || idStats.estimateSelectivity(EQ_OP, -5) != 0) {
+        valid = false;
+    }
+
+    // A second analyze replaces the rows of the first one.
+    insertStatsTuples(tableName, numTuples, 2 * numTuples);
+    rc = rm.analyzeTable(tableName);
+    assert(rc == success && "RelationManager::analyzeTable() should not fail.");
+    rm.getTableStatistics(tableName, tableStats);
+    if (tableStats.rowCount != 2 * numTuples) valid = false;
+    valid = checkColumn(tableName, "Id", 2 * numTuples, 0, 2 * numTuples, true, 0, 2 * numTuples - 1) && valid;
+    std::cout << "Rows of the Statistics table: " << countStatisticsRows(tableName) << std::endl;
+    if (countStatisticsRows(tableName) != 1 + 4 + 2) valid = false;
+
+    rc = rm.destroyIndex(tableName, "Grp");
+    assert(rc == success && "RelationManager::destroyIndex() should not fail.");
+    rc = rm.destroyIndex(tableName, "Id");
+    assert(rc == success && "RelationManager::destroyIndex() should not fail.");
+    rc = rm.deleteTable(tableName);
+    assert(rc == success && "RelationManager::deleteTable() should not fail.");
+    if (countStatisticsRows(tableName) != 0 || rm.getTableStatistics(tableName, tableStats) == success) valid = false;
+
+    if (!valid) {
+        std::cout << "***** [FAIL] Test Case 18 Failed *****" << std::endl << std::endl;
+        return -1;
+    }
+
+    std::cout << "***** RM Test Case 18 finished. The result will be examined. *****" << std::endl << std::endl;
+    return success;
+}
+
+int main() {
+    // Drop the table for the case where we execute this test multiple times.
+    rm.destroyIndex("tbl_stats", "Grp");
+    rm.destroyIndex("tbl_stats", "Id");
+    rm.deleteTable("tbl_stats");
+    createStatsTable("tbl_stats");
+    return TEST_RM_18("tbl_stats");
+}
@@ -0,0 +1,295 @@
+#include "rm_test_util.h"
+
+const int numTuples = 3000;
+const std::string indexTableName = "tbl_idxmaint";
+
+// Row of the table, Grp is NULL when it is -1.
+struct IndexedRow {
+    int id;
+    int grp;
+    std::string name;
+    float score;
+    bool live;
+};
+
+// Tuple (Id, Grp, Name, Score) of a row.
+void prepareIndexedTuple(const IndexedRow &row, void *buffer) {
+    unsigned offset = 0;
+    unsigned char nullIndicator = row.grp == -1 ? (1 << 6) : 0;
+    memcpy((char *) buffer + offset, &nullIndicator, 1);
+    offset += 1;
+    memcpy((char *) buffer + offset, &row.id, sizeof(int));
+    offset += sizeof(int);
+    if (row.grp != -1) {
+        memcpy((char *) buffer + offset, &row.grp, sizeof(int));
+        offset += sizeof(int);
+    }
+    int nameLength = row.name.size();
+    memcpy((char *) buffer + offset, &nameLength, sizeof(int));
+    offset += sizeof(int);
+    memcpy((char *) buffer + offset, row.name.c_str(), nameLength);
+    offset += nameLength;
+    memcpy((char *) buffer + offset, &row.score, sizeof(float));
+}
+
+IndexedRow makeIndexedRow(const int id) {
+    IndexedRow row;
+    row.id = id;
+    row.grp = id % 7 == 3 ? -1 : id % 40;
+    row.name = "row_" + std::to_string(id % 500);
+    row.score = id * 0.25f;
+    row.live = true;
+    return row;
+}
+
+RC createIndexedTable() {
+    std::vector<Attribute> attrs;
+    Attribute attr;
+    attr.name = "Id";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    attrs.push_back(attr);
+
+    attr.name = "Grp";
+    attr.type = TypeInt;
+    attr.length = (AttrLength) 4;
+    attrs.push_back(attr);
+
+    attr.name = "Name";
+    attr.type = TypeVarChar;
+    attr.length = (AttrLength) 20;
+    attrs.push_back(attr);
+
+    attr.name = "Score";
+    attr.type = TypeReal;
+    attr.length = (AttrLength) 4;
+    attrs.push_back(attr);
+
+    return rm.createTable(indexTableName, attrs);
+}
+
+// Value of a column of a tuple of the table, false if it is NULL.
+bool getIndexedField(const void *tuple, const unsigned column, std::string &value) {
+    unsigned char nullIndicator = *(unsigned char *) tuple;
+    const char *field = (const char *) tuple + 1;
+    for (unsigned i = 0; i <= column; i++) {
+        if (nullIndicator & (1 << (7 - i))) {
+            if (i == column) return false;
+            continue;
+        }
+        int length = sizeof(int);
+        if (i == 2) length += *(const int *) field;
+        if (i == column) value.assign(field, length);
+        field += length;
+    }
+    return true;
+}
+
+int countKeys(const std::vector<IndexedRow> &rows, const bool nullGrp) {
+    int count = 0;
+    for (auto &row : rows) {
+        if (row.live && (nullGrp || row.grp != -1)) count++;
+    }
+    return count;
+}
+
+// Every entry of the index on a column points to a tuple holding its key, one entry per non NULL key.
+bool checkColumnIndex(const std::string &column, const unsigned position, const int expected) {
+    RM_IndexScanIterator rmisi;
+    RC rc = rm.indexScan(indexTableName, column, NULL, NULL, true, true, rmisi);
+    assert(rc == success && "RelationManager::indexScan() should not fail.");
+    std::vector<Attribute> indexAttrs;
+    rm.getIndexAttributes(indexTableName, column, indexAttrs);
+
+    RID rid;
+    char key[PAGE_SIZE], tuple[PAGE_SIZE], included[PAGE_SIZE];
+    int entries = 0;
+    bool valid = true;
+    while (rmisi.getNextEntry(rid, key) != RM_EOF) {
+        entries++;
+        std::string value, score;
+        if (rm.readTuple(indexTableName, rid, tuple) != success || !getIndexedField(tuple, position, value) ||
+            memcmp(key, value.c_str(), value.size()) != 0) {
+            valid = false;
+            continue;
+        }
+        // the INCLUDE column is the one of the tuple
+        if (indexAttrs.size() > 1) {
+            rm.getTupleFromIndexEntry(indexAttrs, key, included);
+            getIndexedField(tuple, 3, score);
+            if (memcmp(included + 1 + value.size(), score.c_str(), sizeof(float)) != 0) valid = false;
+        }
+    }
+    rmisi.close();
+    std::cout << "Index on " << column << ": " << entries << " entries, " << expected << " expected" << std::endl;
+    if (!valid) std::cout << "An entry of the index on " << column << " does not match its tuple." << std::endl;
+    return valid && entries == expected;
+}
+
+// The composite index holds every live row, each looked up by its (Grp, Id) finds it alone.
+bool checkCompositeIndex(const std::vector<IndexedRow> &rows) {
+    std::vector<std::string> columns = {"Grp", "Id"};
+    RM_IndexScanIterator rmisi;
+    RC rc = rm.compositeIndexScan(indexTableName, columns, NULL, NULL, 0, true, true, rmisi);
+    assert(rc == success && "RelationManager::compositeIndexScan() should not fail.");
+    RID rid;
+    char key[PAGE_SIZE], tuple[PAGE_SIZE];
+    int entries = 0;
+    while (rmisi.getNextEntry(rid, key) != RM_EOF) entries++;
+    rmisi.close();
+    bool valid = entries == countKeys(rows, true);
+
+    for (unsigned i = 0; i < rows.size() && valid; i += 7) {
+        if (!rows[i].live || rows[i].grp == -1) continue;
+        int bound[2] = {rows[i].grp, rows[i].id};
+        rc = rm.compositeIndexScan(indexTableName, columns, bound, bound, 2, true, true, rmisi);
+        assert(rc == success && "RelationManager::compositeIndexScan() should not fail.");
+        int found = 0;
+        while (rmisi.getNextEntry(rid, key) != RM_EOF) {
+            std::string id;
+            if (rm.readTuple(indexTableName, rid, tuple) == success && getIndexedField(tuple, 0, id) &&
+                memcmp(id.c_str(), &rows[i].id, sizeof(int)) == 0) {
+                found++;
+            }
+        }
+        rmisi.close();
+        if (found != 1) valid = false;
+    }
+    std::cout << "Index on (Grp, Id): " << entries << " entries, " << countKeys(rows, true) << " expected" << std::endl;
+    return valid;
+}
+
+bool checkIndexes(const std::vector<IndexedRow> &rows) {
+    bool valid = checkColumnIndex("Id", 0, countKeys(rows, true));
+    valid = checkColumnIndex("Grp", 1, countKeys(rows, false)) && valid;
+    valid = checkColumnIndex("Name", 2, countKeys(rows, true)) && valid;
+    return checkCompositeIndex(rows) && valid;
+}
+
+RC TEST_RM_19() {
+    // Functions Tested
+    // 1. insertTuple(), deleteTuple() and updateTuple() keep the B+ tree, hash, covering and composite indexes in step **
+    // 2. The index files stay open between the writes, the B+ tree given a delta buffer holds the changes **
+    // 3. Index scans see the changes not merged yet
+    // 4. An index under an open scan is neither destroyed nor rebuilt
+    // 5. The indexes are right after vacuumTable() and after an index is destroyed and created again
+    std::cout << std::endl << "***** In RM Test Case 19 *****" << std::endl;
+
+    RC rc = rm.createIndex(indexTableName, "Id");
+    assert(rc == success && "RelationManager::createIndex() should not fail.");
+    rc = rm.createIndex(indexTableName, "Grp", HASH_INDEX);
+    assert(rc == success && "RelationManager::createIndex() should not fail.");
+    rc = rm.createIndex(indexTableName, "Name", std::vector<std::string>(1, "Score"));
+    assert(rc == success && "RelationManager::createIndex() should not fail.");
+    rc = rm.createCompositeIndex(indexTableName, {"Grp", "Id"});
+    assert(rc == success && "RelationManager::createCompositeIndex() should not fail.");
+    rc = rm.setIndexDeltaBuffer(indexTableName, "Id");
+    assert(rc == success && "RelationManager::setIndexDeltaBuffer() should not fail.");
+    // a hash index has no delta buffer
+    bool valid = rm.setIndexDeltaBuffer(indexTableName, "Grp") != success;
+
+    std::vector<IndexedRow> rows;
+    std::vector<RID> rids;
+    void *tuple = malloc(PAGE_SIZE);
+    RID rid;
+    for (int id = 0; id < numTuples; id++) {
+        rows.push_back(makeIndexedRow(id));
+        prepareIndexedTuple(rows.back(), tuple);
+        rc = rm.insertTuple(indexTableName, tuple, rid);
+        assert(rc == success && "RelationManager::insertTuple() should not fail.");
+        rids.push_back(rid);
+    }
+
+    // The handle of the B+ tree was not opened again for each tuple, its inserts are still held.
+    // The composite index was not given a delta buffer, its inserts went to the file.
+    IXFileHandle *idHandle = rm.getIndexFileHandle(indexTableName + "_Id.idx");
+    IXFileHandle *compositeHandle = rm.getIndexFileHandle(indexTableName + "_Grp+Id.idx");
+    valid = idHandle != NULL && idHandle->hasDeltaBuffer() && idHandle->getNumberOfDeltaEntries() > 0 && valid;
+    valid = compositeHandle != NULL && !compositeHandle->hasDeltaBuffer() && valid;
+    std::cout << "Changes held for the index on Id: " << (idHandle == NULL ? 0 : idHandle->getNumberOfDeltaEntries())
+              << std::endl;
+    valid = checkIndexes(rows) && valid;
+
+    // Every third row is deleted, every fourth of the others gets new keys and every fifth is written unchanged.
+    for (unsigned i = 0; i < rows.size(); i++) {
+        if (i % 3 == 0) {
+            rc = rm.deleteTuple(indexTableName, rids[i]);
+            assert(rc == success && "RelationManager::deleteTuple() should not fail.");
+            rows[i].live = false;
+        } else if (i % 4 == 0 || i % 5 == 0) {
+            if (i % 4 == 0) {
+                rows[i].id += 100000;
+                rows[i].grp = rows[i].grp == -1 ? 41 : (i % 8 == 0 ? -1 : rows[i].grp + 1);
+                rows[i].name = "new_" + std::to_string(i % 300);
+                rows[i].score += 1;
+            }
+            prepareIndexedTuple(rows[i], tuple);
+            rc = rm.updateTuple(indexTableName, tuple, rids[i]);
+            assert(rc == success && "RelationManager::updateTuple() should not fail.");
+        }
+    }
+    // a deleted tuple is not deleted again
+    if (rm.deleteTuple(indexTableName, rids[0]) == success) valid = false;
+    valid = checkIndexes(rows) && valid;
+
+    // The scan keeps reading the index while it is refused to destroy it or to rebuild it.
+    RM_IndexScanIterator rmisi;
+    rc = rm.indexScan(indexTableName, "Id", NULL, NULL, true, true, rmisi);
+    assert(rc == success && "RelationManager::indexScan() should not fail.");
+    char key[PAGE_SIZE];
+    if (rm.destroyIndex(indexTableName, "Id") == success || rm.vacuumTable(indexTableName) == success ||
+        rmisi.getNextEntry(rid, key) == RM_EOF) {
+        valid = false;
+    }
+    rmisi.close();
+
+    // New rids for every row, the indexes are rebuilt.
+    rc = rm.vacuumTable(indexTableName);
+    assert(rc == success && "RelationManager::vacuumTable() should not fail.");
+    valid = checkIndexes(rows) && valid;
+
+    // An index created again holds the rows written while it was gone.
+    rc = rm.destroyIndex(indexTableName, "Id");
+    assert(rc == success && "RelationManager::destroyIndex() should not fail.");
+    for (int id = numTuples; id < numTuples + 200; id++) {
+        rows.push_back(makeIndexedRow(id));
+        prepareIndexedTuple(rows.back(), tuple);
+        rc = rm.insertTuple(indexTableName, tuple, rid);
+        assert(rc == success && "RelationManager::insertTuple() should not fail.");
+    }
+    rc = rm.createIndex(indexTableName, "Id");
+    assert(rc == success && "RelationManager::createIndex() should not fail.");
+    for (int id = numTuples + 200; id < numTuples + 300; id++) {
+        rows.push_back(makeIndexedRow(id));
+        prepareIndexedTuple(rows.back(), tuple);
+        rc = rm.insertTuple(indexTableName, tuple, rid);
+        assert(rc == success && "RelationManager::insertTuple() should not fail.");
+    }
+    valid = checkIndexes(rows) && valid;
+    free(tuple);
+
+    if (!valid) {
+        std::cout << "***** [FAIL] Test Case 19 Failed *****" << std::endl << std::endl;
+        return -1;
+    }
+
+    std::cout << "***** RM Test Case 19 finished. The result will be examined. *****" << std::endl << std::endl;
+    return success;
+}
+
+void cleanUp() {
+    rm.destroyCompositeIndex(indexTableName, {"Grp", "Id"});
+    rm.destroyIndex(indexTableName, "Name");
+    rm.destroyIndex(indexTableName, "Grp");
+    rm.destroyIndex(indexTableName, "Id");
+    rm.deleteTable(indexTableName);
+}
+
+int main() {
+    // Drop the table for the case where we execute this test multiple times.
+    cleanUp();
+    createIndexedTable();
+    RC rc = TEST_RM_19();
+    cleanUp();
+    return rc;
+}